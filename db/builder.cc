@@ -87,7 +87,9 @@ Status BuildTable(
     EventLogger* event_logger, int job_id, const Env::IOPriority io_priority,
     std::vector<TableProperties>* table_properties_vec, int level,
     double compaction_load, const uint64_t creation_time,
-    const uint64_t oldest_key_time, Env::WriteLifeTimeHint write_hint) {
+    const uint64_t oldest_key_time, Env::WriteLifeTimeHint write_hint,
+    Status (*get_base_value_callback)(void*, const Slice&, LazyBuffer*),
+    void* get_base_value_arg) {
   assert((column_family_id ==
           TablePropertiesCollectorFactory::Context::kUnknownColumnFamily) ==
          column_family_name.empty());
@@ -153,6 +155,7 @@ Status BuildTable(
                       true /* internal key corruption is not ok */,
                       snapshots.empty() ? 0 : snapshots.back(),
                       snapshot_checker);
+    merge.SetBaseValueCallback(get_base_value_callback, get_base_value_arg);
 
     struct BuilderSeparateHelper : public SeparateHelper {
       std::vector<FileMetaData>* output = nullptr;
@@ -345,6 +348,8 @@ Status BuildTable(
           nullptr, ioptions.info_log,
           true /* internal key corruption is not ok */,
           snapshots.empty() ? 0 : snapshots.back(), snapshot_checker);
+      merge_ptr->SetBaseValueCallback(get_base_value_callback,
+                                      get_base_value_arg);
       return new CompactionIterator(
           second_pass_iter_storage.iter.get(), &separate_helper, nullptr,
           internal_comparator.user_comparator(), merge_ptr, kMaxSequenceNumber,
@@ -16,6 +16,7 @@
 #include "options/cf_options.h"
 #include "rocksdb/comparator.h"
 #include "rocksdb/env.h"
+#include "rocksdb/lazy_buffer.h"
 #include "rocksdb/listener.h"
 #include "rocksdb/options.h"
 #include "rocksdb/status.h"
@@ -64,6 +65,8 @@ TableBuilder* NewTableBuilder(
 //
 // @param column_family_name Name of the column family that is also identified
 //    by column_family_id, or empty string if unknown.
+// @param get_base_value_callback Reads the value of a user key from the data
+//    older than *iter, see MergeHelper::SetBaseValueCallback(). May be nullptr.
 extern Status BuildTable(
     const std::string& dbname, VersionSet* versions_, Env* env,
     const ImmutableCFOptions& options,
@@ -88,6 +91,9 @@ extern Status BuildTable(
     std::vector<TableProperties>* table_properties = nullptr, int level = -1,
     double compaction_load = 0, const uint64_t creation_time = 0,
     const uint64_t oldest_key_time = 0,
-    Env::WriteLifeTimeHint write_hint = Env::WLTH_NOT_SET);
+    Env::WriteLifeTimeHint write_hint = Env::WLTH_NOT_SET,
+    Status (*get_base_value_callback)(void*, const Slice&,
+                                      LazyBuffer*) = nullptr,
+    void* get_base_value_arg = nullptr);
 
 }  // namespace rocksdb
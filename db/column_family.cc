@@ -460,12 +460,21 @@ ColumnFamilyData::ColumnFamilyData(
       queued_for_garbage_collection_(false),
       prev_compaction_needed_bytes_(0),
       allow_2pc_(db_options.allow_2pc),
-      last_memtable_id_(0) {
+      last_memtable_id_(0),
+      numa_node_(-1) {
   Ref();
 
   // Convert user defined table properties collector factories to internal ones.
   GetIntTblPropCollectorFactory(ioptions_, &int_tbl_prop_collector_factories_);
 
+  // Column families are spread over the NUMA nodes by their ids
+  if (db_options.numa_aware) {
+    int numa_nodes = port::NumaNodeCount();
+    if (numa_nodes > 1) {
+      numa_node_ = static_cast<int>(id_ % numa_nodes);
+    }
+  }
+
   // if _dummy_versions is nullptr, then this is a dummy column family.
   if (_dummy_versions != nullptr) {
     internal_stats_.reset(
@@ -972,7 +981,7 @@ MemTable* ColumnFamilyData::ConstructNewMemtable(
     SequenceNumber earliest_seq) {
   return new MemTable(internal_comparator_, ioptions_, mutable_cf_options,
                       needs_dup_key_check, write_buffer_manager_, earliest_seq,
-                      id_);
+                      id_, numa_node_);
 }
 
 void ColumnFamilyData::CreateNewMemtable(
@@ -166,6 +166,10 @@ class ColumnFamilyData {
   uint32_t GetID() const { return id_; }
   // thread-safe
   const std::string& GetName() const { return name_; }
+  // The NUMA node the memtables allocate their arenas on, -1 if the memory
+  // is not bound to a node.
+  // thread-safe
+  int numa_node() const { return numa_node_; }
 
   // Ref() can only be called from a context where the caller can guarantee
   // that ColumnFamilyData is alive (while holding a non-zero ref already,
@@ -497,6 +501,8 @@ class ColumnFamilyData {
   // Memtable id to track flush.
   std::atomic<uint64_t> last_memtable_id_;
 
+  int numa_node_;
+
   // Directories corresponding to cf_paths.
   std::vector<std::unique_ptr<Directory>> data_dirs_;
 };
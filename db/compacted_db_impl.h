@@ -31,6 +31,22 @@ class CompactedDBImpl : public DBImpl {
       const std::vector<Slice>& keys, std::vector<std::string>* values)
     override;
 
+  // The version never changes, Get() already references values in place
+  using DB::GetPinned;
+  virtual Status GetPinned(const ReadOptions& options,
+                           ColumnFamilyHandle* column_family, const Slice& key,
+                           LazyBuffer* value) override {
+    return Get(options, column_family, key, value);
+  }
+  using DB::MultiGetPinned;
+  virtual std::vector<Status> MultiGetPinned(
+      const ReadOptions& options,
+      const std::vector<ColumnFamilyHandle*>& column_family,
+      const std::vector<Slice>& keys,
+      std::vector<LazyBuffer>* values) override {
+    return DB::MultiGetPinned(options, column_family, keys, values);
+  }
+
   using DBImpl::Put;
   virtual Status Put(const WriteOptions& /*options*/,
                      ColumnFamilyHandle* /*column_family*/,
@@ -200,6 +200,7 @@ Compaction::Compaction(CompactionParams&& params)
       partial_compaction_(params.partial_compaction),
       compaction_type_(params.compaction_type),
       input_range_(std::move(params.input_range)),
+      deleted_range_(std::move(params.deleted_range)),
       inputs_(std::move(params.inputs)),
       grandparents_(std::move(params.grandparents)),
       score_(params.score),
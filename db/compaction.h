@@ -96,6 +96,7 @@ struct CompactionParams {
   bool partial_compaction = false;
   CompactionType compaction_type = kKeyValueCompaction;
   std::vector<SelectedRange> input_range = {};
+  std::vector<SelectedRange> deleted_range = {};
   CompactionReason compaction_reason = CompactionReason::kUnknown;
 
   CompactionParams(VersionStorageInfo* _input_version,
@@ -289,6 +290,12 @@ class Compaction {
   // Range limit for inputs
   std::vector<SelectedRange>& input_range() { return input_range_; };
 
+  // Ranges cut off from every input level by a map compaction, the data and
+  // range tombstones within are dropped without being read
+  const std::vector<SelectedRange>& deleted_range() const {
+    return deleted_range_;
+  }
+
   // Add all inputs to this compaction as delete operations to *edit.
   void AddInputDeletions(VersionEdit* edit);
 
@@ -475,6 +482,9 @@ class Compaction {
   // Range limit for inputs
   std::vector<SelectedRange> input_range_;
 
+  // Ranges dropped from inputs
+  const std::vector<SelectedRange> deleted_range_;
+
   // Compaction input files organized by level. Constant after construction
   const std::vector<CompactionInputFiles> inputs_;
 
@@ -268,10 +268,23 @@ void CompactionIterator::InvokeFilterIfNeeded(bool* need_skip,
     compaction_filter_value_.clear();
     compaction_filter_skip_until_.Clear();
     auto doFilter = [&]() {
-      filter = compaction_filter_->FilterV2(
-          compaction_->level(), ikey_.user_key,
-          CompactionFilter::ValueType::kValue, value_meta_, value_,
-          &compaction_filter_value_, compaction_filter_skip_until_.rep());
+      filter = CompactionFilter::Decision::kUndetermined;
+      if (ikey_.type == kTypeValueIndex) {
+        // Try to decide without fetching the separated value
+        filter = compaction_filter_->FilterValueMeta(
+            compaction_->level(), ikey_.user_key, value_meta_,
+            compaction_filter_skip_until_.rep());
+        if (filter == CompactionFilter::Decision::kChangeValue) {
+          assert(false);
+          filter = CompactionFilter::Decision::kUndetermined;
+        }
+      }
+      if (filter == CompactionFilter::Decision::kUndetermined) {
+        filter = compaction_filter_->FilterV2(
+            compaction_->level(), ikey_.user_key,
+            CompactionFilter::ValueType::kValue, value_meta_, value_,
+            &compaction_filter_value_, compaction_filter_skip_until_.rep());
+      }
     };
     auto sample = filter_sample_interval_;
     if (env_ && sample && (filter_hit_count_ & (sample - 1)) == 0) {
@@ -82,6 +82,7 @@
 #include "util/logging.h"
 #include "util/mutexlock.h"
 #include "util/random.h"
+#include "util/rate_limiter.h"
 #include "util/sst_file_manager_impl.h"
 #include "util/stop_watch.h"
 #include "util/string_util.h"
@@ -1175,15 +1176,21 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
 void CompactionJob::ProcessCompaction(SubcompactionState* sub_compact) {
   // SetThreadSched(kSchedIdle);
   switch (sub_compact->compaction->compaction_type()) {
-    case kKeyValueCompaction:
+    case kKeyValueCompaction: {
+      IOClassGuard io_class_guard(sub_compact->compaction->start_level() == 0
+                                      ? RateLimiter::IOClass::kL0Compaction
+                                      : RateLimiter::IOClass::kCompaction);
       ProcessKeyValueCompaction(sub_compact);
       break;
+    }
     case kMapCompaction:
       assert(false);
       break;
-    case kGarbageCollection:
+    case kGarbageCollection: {
+      IOClassGuard io_class_guard(RateLimiter::IOClass::kGarbageCollection);
       ProcessGarbageCollection(sub_compact);
       break;
+    }
     default:
       assert(false);
       break;
@@ -2327,7 +2334,82 @@ Status CompactionJob::InstallCompactionResults(
 
   auto cfd = compaction->column_family_data();
   if (compaction->compaction_type() == kMapCompaction &&
-      !compaction->input_range().empty()) {
+      !compaction->deleted_range().empty()) {
+    MapBuilder map_builder(job_id_, db_options_, env_options_, versions_,
+                           stats_, dbname_);
+    std::vector<MapBuilderOutput> output;
+    std::vector<Range> deleted_range;
+    for (auto& dr : compaction->deleted_range()) {
+      deleted_range.emplace_back(dr.start, dr.limit, dr.include_start,
+                                 dr.include_limit);
+    }
+    auto uc = cfd->user_comparator();
+    auto overlap = [&](const FileMetaData* f) {
+      for (auto& r : deleted_range) {
+        if (uc->Compare(f->smallest.user_key(), r.limit) < 0 &&
+            uc->Compare(f->largest.user_key(), r.start) >= 0) {
+          return true;
+        }
+      }
+      return false;
+    };
+    db_mutex_->Unlock();
+    Status s;
+    // Cut deleted ranges off each level separately, keep the shape of levels
+    for (auto& input_level : *compaction->inputs()) {
+      if (std::none_of(input_level.files.begin(), input_level.files.end(),
+                       overlap)) {
+        continue;
+      }
+      output.emplace_back();
+      auto& o = output.back();
+      o.level = input_level.level;
+      s = map_builder.Build({input_level}, deleted_range, {},
+                            input_level.level,
+                            input_level.files.front()->fd.GetPathId(), cfd,
+                            compaction->input_version(),
+                            compact_->compaction->edit(), &o.file_meta,
+                            &o.prop);
+      if (!s.ok()) {
+        break;
+      }
+      if (o.file_meta.fd.file_size == 0) {
+        output.pop_back();
+        continue;
+      }
+      // test map sst
+      DependenceMap empty_dependence_map;
+      InternalIterator* iter = cfd->table_cache()->NewIterator(
+          ReadOptions(), env_options_, cfd->internal_comparator(), o.file_meta,
+          empty_dependence_map, nullptr /* range_del_agg */,
+          mutable_cf_options.prefix_extractor.get(), nullptr,
+          cfd->internal_stats()->GetFileReadHist(o.level), false,
+          nullptr /* arena */, false /* skip_filters */, o.level);
+      s = iter->status();
+
+      if (s.ok() && paranoid_file_checks_) {
+        for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        }
+        s = iter->status();
+      }
+      delete iter;
+      if (!s.ok()) {
+        break;
+      }
+    }
+    db_mutex_->Lock();
+    if (!s.ok()) {
+      return s;
+    }
+    for (auto& o : output) {
+      compact_->sub_compact_states[0].outputs.emplace_back();
+      auto current = compact_->sub_compact_states[0].current_output();
+      current->meta = std::move(o.file_meta);
+      current->finished = true;
+      current->table_properties.reset(o.prop.release());
+    }
+  } else if (compaction->compaction_type() == kMapCompaction &&
+             !compaction->input_range().empty()) {
     MapBuilder map_builder(job_id_, db_options_, env_options_, versions_,
                            stats_, dbname_);
     std::vector<MapBuilderOutput> output;
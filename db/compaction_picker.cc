@@ -23,7 +23,9 @@
 
 #include "db/column_family.h"
 #include "db/map_builder.h"
+#include "db/range_tombstone_fragmenter.h"
 #include "monitoring/statistics.h"
+#include "table/table_reader.h"
 #include "util/c_style_callback.h"
 #include "util/filename.h"
 #include "util/log_buffer.h"
@@ -2167,6 +2169,13 @@ class LevelCompactionBuilder {
   // Pick lazy compaction
   Compaction* PickLazyCompaction(const std::vector<SequenceNumber>& snapshots);
 
+  // Collect into deleted_range_ the ranges of the range tombstones of level
+  // which hide every key they overlap in [level, bottommost_level] and are
+  // visible to every snapshot. Such ranges are cut off from these levels by
+  // MapBuilder without reading any data, the tombstones are dropped with them.
+  Status PickDeletedRange(int level, int bottommost_level,
+                          SequenceNumber earliest_snapshot);
+
   // Pick the initial files to compact to the next level. (or together
   // in Intra-L0 compactions)
   void SetupInitialFiles();
@@ -2217,6 +2226,7 @@ class LevelCompactionBuilder {
   std::vector<FileMetaData*> grandparents_;
   CompactionType compaction_type_ = CompactionType::kKeyValueCompaction;
   std::vector<SelectedRange> input_range_ = {};
+  std::vector<SelectedRange> deleted_range_ = {};
   CompactionReason compaction_reason_ = CompactionReason::kUnknown;
 
   const MutableCFOptions& mutable_cf_options_;
@@ -2766,6 +2776,42 @@ Compaction* LevelCompactionBuilder::PickLazyCompaction(
     return Status::OK();
   };
 
+  SequenceNumber earliest_snapshot =
+      snapshots.empty() ? kMaxSequenceNumber : snapshots.front();
+  for (int i = 1; i <= bottommost_level; ++i) {
+    if (!vstorage_->has_range_deletion(i)) {
+      continue;
+    }
+    bool being_compacted = false;
+    for (int j = i; j <= bottommost_level; ++j) {
+      being_compacted |= sorted_runs[j].being_compacted;
+    }
+    if (being_compacted) {
+      continue;
+    }
+    auto s = PickDeletedRange(i, bottommost_level, earliest_snapshot);
+    if (!s.ok()) {
+      ROCKS_LOG_BUFFER(log_buffer_,
+                       "[%s] PickCompaction deleted_range error %s.",
+                       cf_name_.c_str(), s.getState());
+      return nullptr;
+    }
+    if (!deleted_range_.empty()) {
+      for (int j = i; j <= bottommost_level; ++j) {
+        compaction_inputs_.emplace_back();
+        compaction_inputs_.back().level = j;
+        compaction_inputs_.back().files = vstorage_->LevelFiles(j);
+      }
+      output_level_ = bottommost_level;
+      start_level_score_ = 0;
+      compaction_type_ = kMapCompaction;
+      compaction_reason_ = CompactionReason::kRangeDeletion;
+      TEST_SYNC_POINT_CALLBACK(
+          "LevelCompactionBuilder::PickLazyCompaction:DeletedRange",
+          &deleted_range_);
+      return GetCompaction();
+    }
+  }
   for (int i = 1; i < bottommost_level; ++i) {
     if (!vstorage_->has_range_deletion(i)) {
       continue;
@@ -2855,6 +2901,200 @@ Compaction* LevelCompactionBuilder::PickLazyCompaction(
                                          log_buffer_);
 }
 
+Status LevelCompactionBuilder::PickDeletedRange(
+    int level, int bottommost_level, SequenceNumber earliest_snapshot) {
+  // Give up a range instead of reading too many keys under db mutex
+  const size_t kMaxKeysToCheck = 64;
+  auto picker = compaction_picker_;
+  auto uc = ioptions_.user_comparator;
+  auto& dependence_map = vstorage_->dependence_map();
+  ReadOptions options;
+  options.fill_cache = false;
+  options.total_order_seek = true;
+  auto new_iter = [&](const FileMetaData* f, TableReader** reader_ptr) {
+    DependenceMap empty_dependence_map;
+    return picker->table_cache()->NewIterator(
+        options, picker->env_options(), ioptions_.internal_comparator, *f,
+        empty_dependence_map, nullptr,
+        mutable_cf_options_.prefix_extractor.get(), reader_ptr, nullptr,
+        false, nullptr, true, -1);
+  };
+  auto overlap = [uc](const FileMetaData* f, const Slice& start,
+                      const Slice& end) {
+    return uc->Compare(f->smallest.user_key(), end) < 0 &&
+           uc->Compare(f->largest.user_key(), start) >= 0;
+  };
+  // Are all keys of f in [start, end) older than seq ? A tombstone only
+  // covers keys with a smaller seqno, and the keys of an ingested file all
+  // share the seqno of its tombstones, so an equal seqno needs the key scan
+  auto file_older = [&](const FileMetaData* f, const Slice& start,
+                        const Slice& end, SequenceNumber seq, bool* older) {
+    *older = f->fd.largest_seqno < seq;
+    if (*older) {
+      return Status::OK();
+    }
+    std::unique_ptr<InternalIterator> iter(new_iter(f, nullptr));
+    InternalKey seek_key(start, kMaxSequenceNumber, kValueTypeForSeek);
+    size_t count = 0;
+    ParsedInternalKey ikey;
+    for (iter->Seek(seek_key.Encode()); iter->Valid(); iter->Next()) {
+      if (!ParseInternalKey(iter->key(), &ikey)) {
+        return Status::Corruption("CompactionPicker bad internal key");
+      }
+      if (uc->Compare(ikey.user_key, end) >= 0) {
+        break;
+      }
+      if (ikey.sequence >= seq || ++count > kMaxKeysToCheck) {
+        return Status::OK();
+      }
+    }
+    *older = true;
+    return iter->status();
+  };
+  // Are all keys of level in [start, end) older than seq ?
+  auto level_older = [&](int l, const Slice& start, const Slice& end,
+                         SequenceNumber seq, bool* older) {
+    *older = true;
+    MapSstElement map_element;
+    for (auto f : vstorage_->LevelFiles(l)) {
+      if (!overlap(f, start, end)) {
+        continue;
+      }
+      if (!f->prop.is_map_sst() || f->fd.largest_seqno < seq) {
+        auto s = file_older(f, start, end, seq, older);
+        if (!s.ok() || !*older) {
+          return s;
+        }
+        continue;
+      }
+      std::unique_ptr<InternalIterator> iter(new_iter(f, nullptr));
+      InternalKey seek_key(start, kMaxSequenceNumber, kValueTypeForSeek);
+      for (iter->Seek(seek_key.Encode()); iter->Valid(); iter->Next()) {
+        if (!CompactionPicker::ReadMapElement(map_element, iter.get(),
+                                              log_buffer_, cf_name_)) {
+          return Status::Corruption("CompactionPicker bad map element");
+        }
+        if (uc->Compare(ExtractUserKey(map_element.smallest_key), end) >= 0) {
+          break;
+        }
+        for (auto& link : map_element.link) {
+          auto find = dependence_map.find(link.file_number);
+          if (find == dependence_map.end()) {
+            return Status::Corruption("CompactionPicker missing dependence");
+          }
+          auto s = file_older(find->second, start, end, seq, older);
+          if (!s.ok() || !*older) {
+            return s;
+          }
+        }
+      }
+      if (!iter->status().ok()) {
+        return iter->status();
+      }
+    }
+    return Status::OK();
+  };
+  // Are all keys of upper levels in [start, end) newer than seq ?
+  auto upper_newer = [&](const Slice& start, const Slice& end,
+                         SequenceNumber seq) {
+    for (int l = 0; l < level; ++l) {
+      for (auto f : vstorage_->LevelFiles(l)) {
+        if (f->fd.smallest_seqno <= seq && overlap(f, start, end)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  };
+
+  // Fragments are read once per file, later picks don't touch the table
+  auto load_tombstones = [&](FileMetaData* f) {
+    if (f->range_tombstones) {
+      return Status::OK();
+    }
+    TableReader* reader = nullptr;
+    std::unique_ptr<InternalIterator> iter(new_iter(f, &reader));
+    if (!iter->status().ok()) {
+      return iter->status();
+    }
+    auto tombstones = std::make_shared<std::vector<FileRangeTombstone>>();
+    std::unique_ptr<FragmentedRangeTombstoneIterator> tombstone_iter(
+        reader->NewRangeTombstoneIterator(options));
+    if (tombstone_iter != nullptr) {
+      for (tombstone_iter->SeekToFirst(); tombstone_iter->Valid();
+           tombstone_iter->Next()) {
+        tombstones->push_back({tombstone_iter->start_key().ToString(),
+                               tombstone_iter->end_key().ToString(),
+                               tombstone_iter->seq()});
+      }
+      if (!tombstone_iter->status().ok()) {
+        return tombstone_iter->status();
+      }
+    }
+    f->range_tombstones = std::move(tombstones);
+    return Status::OK();
+  };
+
+  for (auto f : vstorage_->LevelFiles(level)) {
+    if (!f->prop.has_range_deletions() ||
+        (f->prop.is_map_sst() && !f->prop.map_handle_range_deletions())) {
+      continue;
+    }
+    auto s = load_tombstones(f);
+    if (!s.ok()) {
+      return s;
+    }
+    Slice last_start;
+    bool has_last = false;
+    // Fragments are ordered by start key, seqno desc within each fragment,
+    // the first seqno visible to every snapshot covers the most keys
+    for (auto& tombstone : *f->range_tombstones) {
+      SequenceNumber seq = tombstone.seq;
+      Slice start = tombstone.start_key;
+      Slice end = tombstone.end_key;
+      if (seq > earliest_snapshot ||
+          (has_last && uc->Compare(start, last_start) == 0)) {
+        continue;
+      }
+      last_start = start;
+      has_last = true;
+      // Truncate to file boundaries, the largest key may be inclusive
+      if (uc->Compare(start, f->smallest.user_key()) < 0) {
+        start = f->smallest.user_key();
+      }
+      if (uc->Compare(end, f->largest.user_key()) > 0) {
+        end = f->largest.user_key();
+      }
+      if (uc->Compare(start, end) >= 0 || !upper_newer(start, end, seq)) {
+        continue;
+      }
+      bool older = true;
+      for (int l = level; older && l <= bottommost_level; ++l) {
+        s = level_older(l, start, end, seq, &older);
+        if (!s.ok()) {
+          return s;
+        }
+      }
+      if (!older) {
+        continue;
+      }
+      if (!deleted_range_.empty() &&
+          uc->Compare(deleted_range_.back().limit, start) == 0) {
+        deleted_range_.back().limit.assign(end.data(), end.size());
+      } else {
+        deleted_range_.emplace_back(start, end, true, false);
+      }
+    }
+  }
+  if (!deleted_range_.empty()) {
+    ROCKS_LOG_BUFFER(log_buffer_,
+                     "[%s] PickCompaction %" ROCKSDB_PRIszt
+                     " deleted ranges at level %d",
+                     cf_name_.c_str(), deleted_range_.size(), level);
+  }
+  return Status::OK();
+}
+
 Compaction* LevelCompactionBuilder::GetCompaction() {
   CompactionParams params(vstorage_, ioptions_, mutable_cf_options_);
   params.inputs = std::move(compaction_inputs_);
@@ -2875,6 +3115,7 @@ Compaction* LevelCompactionBuilder::GetCompaction() {
   params.score = start_level_score_;
   params.compaction_type = compaction_type_;
   params.input_range = std::move(input_range_);
+  params.deleted_range = std::move(deleted_range_);
   params.compaction_reason = compaction_reason_;
 
   auto c = new Compaction(std::move(params));
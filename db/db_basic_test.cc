@@ -426,6 +426,55 @@ TEST_F(DBBasicTest, ManifestRollOver) {
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBBasicTest, BackgroundManifestRollOver) {
+  Options options = CurrentOptions();
+  options.max_manifest_edit_count = 8;
+  options.background_manifest_rollover = true;
+  options.disable_auto_compactions = true;
+  Reopen(options);
+
+  rocksdb::SyncPoint::GetInstance()->LoadDependency(
+      {{"VersionSet::WriteManifestSnapshot:Captured",
+        "DBBasicTest::BackgroundManifestRollOver:Captured"},
+       {"DBBasicTest::BackgroundManifestRollOver:TailFlushed",
+        "VersionSet::WriteManifestSnapshot:Written"},
+       {"DBImpl::BGWorkManifestSnapshot:end",
+        "DBBasicTest::BackgroundManifestRollOver:Prepared"}});
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  // The edits of these flushes exceed max_manifest_edit_count
+  int num_keys = 0;
+  for (; num_keys < 10; ++num_keys) {
+    ASSERT_OK(Put(Key(num_keys), "v" + ToString(num_keys)));
+    ASSERT_OK(Flush());
+  }
+  TEST_SYNC_POINT("DBBasicTest::BackgroundManifestRollOver:Captured");
+  uint64_t manifest_file_number = dbfull()->TEST_Current_Manifest_FileNo();
+
+  // Committed to the current manifest file while the snapshot is written
+  ASSERT_OK(Put(Key(num_keys), "v" + ToString(num_keys)));
+  ++num_keys;
+  ASSERT_OK(Flush());
+  ASSERT_EQ(manifest_file_number, dbfull()->TEST_Current_Manifest_FileNo());
+  TEST_SYNC_POINT("DBBasicTest::BackgroundManifestRollOver:TailFlushed");
+  TEST_SYNC_POINT("DBBasicTest::BackgroundManifestRollOver:Prepared");
+  ASSERT_EQ(manifest_file_number, dbfull()->TEST_Current_Manifest_FileNo());
+
+  // The next manifest write switches to the new manifest file
+  ASSERT_OK(Put(Key(num_keys), "v" + ToString(num_keys)));
+  ++num_keys;
+  ASSERT_OK(Flush());
+  ASSERT_GT(dbfull()->TEST_Current_Manifest_FileNo(), manifest_file_number);
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  Reopen(options);
+  ASSERT_EQ(ToString(num_keys), FilesPerLevel());
+  for (int i = 0; i < num_keys; ++i) {
+    ASSERT_EQ("v" + ToString(i), Get(Key(i)));
+  }
+}
+
 TEST_F(DBBasicTest, IdentityAcrossRestarts) {
   do {
     std::string id1;
@@ -764,6 +813,94 @@ TEST_F(DBBasicTest, MultiGetSimple) {
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBBasicTest, GetPinned) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  Reopen(options);
+  std::string large_value(1000, 'v');
+  ASSERT_OK(Put("mem", large_value + "mem"));
+  ASSERT_OK(Put("small", "s"));
+  ASSERT_OK(Put("sst", large_value + "sst"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("mem", large_value + "mem"));
+
+  LazyBuffer mem_value, small_value, sst_value, missing_value;
+  ASSERT_OK(db_->GetPinned(ReadOptions(), "mem", &mem_value));
+  ASSERT_OK(db_->GetPinned(ReadOptions(), "small", &small_value));
+  ASSERT_OK(db_->GetPinned(ReadOptions(), "sst", &sst_value));
+  ASSERT_TRUE(db_->GetPinned(ReadOptions(), "missing", &missing_value)
+                  .IsNotFound());
+
+  // Pinned values outlive the memtables and SSTs they came from
+  ASSERT_OK(Put("mem", "new"));
+  ASSERT_OK(Put("sst", "new"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(large_value + "mem", mem_value.ToString());
+  ASSERT_EQ("s", small_value.ToString());
+  ASSERT_EQ(large_value + "sst", sst_value.ToString());
+  ASSERT_EQ("new", Get("mem"));
+
+  std::vector<Slice> keys({"mem", "missing", "small"});
+  std::vector<LazyBuffer> values;
+  std::vector<Status> s = db_->MultiGetPinned(ReadOptions(), keys, &values);
+  ASSERT_EQ(keys.size(), values.size());
+  ASSERT_OK(s[0]);
+  ASSERT_EQ("new", values[0].ToString());
+  ASSERT_TRUE(s[1].IsNotFound());
+  ASSERT_OK(s[2]);
+  ASSERT_EQ("s", values[2].ToString());
+}
+
+TEST_F(DBBasicTest, HotKeyCache) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.statistics = rocksdb::CreateDBStatistics();
+  options.hot_key_cache = NewLRUCache(1 << 20);
+  Reopen(options);
+  ASSERT_OK(Put("a", "va"));
+  ASSERT_OK(Put("b", "vb"));
+  ASSERT_EQ("va", Get("a"));
+  ASSERT_EQ("va", Get("a"));
+  ASSERT_EQ(1, TestGetTickerCount(options, HOT_KEY_CACHE_HIT));
+
+  // Entries survive flushes and compactions
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("va", Get("a"));
+  ASSERT_EQ(2, TestGetTickerCount(options, HOT_KEY_CACHE_HIT));
+
+  // A write invalidates the key, the new value is not served to an older
+  // snapshot
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Put("a", "va2"));
+  ASSERT_EQ("va2", Get("a"));
+  ASSERT_EQ("va", Get("a", snapshot));
+  ASSERT_EQ("va2", Get("a"));
+  ASSERT_EQ(3, TestGetTickerCount(options, HOT_KEY_CACHE_HIT));
+  db_->ReleaseSnapshot(snapshot);
+  ASSERT_OK(Delete("a"));
+  ASSERT_EQ("NOT_FOUND", Get("a"));
+
+  ASSERT_EQ("vb", Get("b"));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "b",
+                             "c"));
+  ASSERT_EQ("NOT_FOUND", Get("b"));
+
+#ifndef ROCKSDB_LITE
+  // Ingested files do not go through the memtable
+  ASSERT_OK(Put("c", "vc"));
+  ASSERT_EQ("vc", Get("c"));
+  std::string file = dbname_ + "/hot_key_cache.sst";
+  SstFileWriter writer(EnvOptions(), options);
+  ASSERT_OK(writer.Open(file));
+  ASSERT_OK(writer.Put("c", "vc2"));
+  ASSERT_OK(writer.Finish());
+  ASSERT_OK(db_->IngestExternalFile({file}, IngestExternalFileOptions()));
+  ASSERT_EQ("vc2", Get("c"));
+#endif  // !ROCKSDB_LITE
+}
+
 TEST_F(DBBasicTest, MultiGetEmpty) {
   do {
     CreateAndReopenWithCF({"pikachu"}, CurrentOptions());
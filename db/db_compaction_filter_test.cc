@@ -9,11 +9,13 @@
 
 #include "db/db_test_util.h"
 #include "port/stack_trace.h"
+#include "rocksdb/value_extractor.h"
 
 namespace rocksdb {
 
 static int cfilter_count = 0;
 static int cfilter_skips = 0;
+static int cfilter_value_meta_count = 0;
 
 // This is a static filter used for filtering
 // kvs during the compaction process.
@@ -133,6 +135,48 @@ class SkipEvenFilter : public CompactionFilter {
   virtual const char* Name() const override { return "DeleteFilter"; }
 };
 
+// Remove the separated values starting with 'd' by their value meta
+class ValueMetaFilter : public CompactionFilter {
+ public:
+  virtual Decision FilterValueMeta(int /*level*/, const Slice& /*key*/,
+                                   const Slice& value_meta,
+                                   std::string* /*skip_until*/) const override {
+    cfilter_value_meta_count++;
+    return value_meta == "d" ? Decision::kRemove : Decision::kKeep;
+  }
+
+  virtual bool Filter(int /*level*/, const Slice& /*key*/,
+                      const Slice& /*value*/, std::string* /*new_value*/,
+                      bool* /*value_changed*/) const override {
+    cfilter_count++;
+    return false;
+  }
+
+  virtual const char* Name() const override { return "ValueMetaFilter"; }
+};
+
+// The first byte of the value is its value meta
+class FirstByteExtractor : public ValueExtractor {
+ public:
+  virtual Status Extract(const Slice& /*key*/, const Slice& value,
+                         std::string* output) const override {
+    output->assign(value.data(), std::min<size_t>(value.size(), 1));
+    return Status::OK();
+  }
+};
+
+class FirstByteExtractorFactory : public ValueExtractorFactory {
+ public:
+  virtual std::unique_ptr<ValueExtractor> CreateValueExtractor(
+      const Context& /*context*/) const override {
+    return std::unique_ptr<ValueExtractor>(new FirstByteExtractor());
+  }
+
+  virtual const char* Name() const override {
+    return "FirstByteExtractorFactory";
+  }
+};
+
 class DelayFilter : public CompactionFilter {
  public:
   explicit DelayFilter(DBTestBase* d) : db_test(d) {}
@@ -842,6 +886,42 @@ TEST_F(DBTestCompactionFilter, SkipUntil) {
   }
 }
 
+TEST_F(DBTestCompactionFilter, FilterValueMeta) {
+  ValueMetaFilter filter;
+  Options options = CurrentOptions();
+  options.blob_size = 16;
+  options.value_meta_extractor_factory =
+      std::make_shared<FirstByteExtractorFactory>();
+  options.compaction_filter = &filter;
+  options.disable_auto_compactions = true;
+  options.enable_lazy_compaction = false;
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 100; ++i) {
+    std::string value(1, i % 2 == 0 ? 'k' : 'd');
+    value.append(100, 'v');
+    ASSERT_OK(Put(Key(i), value));
+  }
+  // Not separated, decided by the value
+  ASSERT_OK(Put("small", "d"));
+  ASSERT_OK(Flush());
+
+  cfilter_count = 0;
+  cfilter_value_meta_count = 0;
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(100, cfilter_value_meta_count);
+  ASSERT_EQ(1, cfilter_count);
+
+  for (int i = 0; i < 100; ++i) {
+    if (i % 2 == 0) {
+      ASSERT_EQ("k" + std::string(100, 'v'), Get(Key(i)));
+    } else {
+      ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+    }
+  }
+  ASSERT_EQ("d", Get("small"));
+}
+
 TEST_F(DBTestCompactionFilter, SkipUntilWithBloomFilter) {
   BlockBasedTableOptions table_options;
   table_options.whole_key_filtering = false;
@@ -234,6 +234,8 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       bg_flush_scheduled_(0),
       num_running_flushes_(0),
       bg_purge_scheduled_(0),
+      bg_table_warm_up_scheduled_(0),
+      bg_manifest_snapshot_scheduled_(0),
       disable_delete_obsolete_files_(0),
       pending_purge_obsolete_files_(0),
       delete_obsolete_files_last_run_(env_->NowMicros()),
@@ -346,6 +348,9 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
                                    : mutable_db_options_.max_open_files - 10;
   table_cache_ = NewLRUCache(table_cache_size,
                              immutable_db_options_.table_cache_numshardbits);
+  if (immutable_db_options_.hot_key_cache) {
+    hot_key_cache_.reset(new HotKeyCache(immutable_db_options_.hot_key_cache));
+  }
 
   versions_.reset(new VersionSet(dbname_, &immutable_db_options_, env_options_,
                                  seq_per_batch, table_cache_.get(),
@@ -570,7 +575,8 @@ Status DBImpl::CloseHelper() {
   while (true) {
     int bg_scheduled = bg_bottom_compaction_scheduled_ +
                        bg_compaction_scheduled_ + bg_flush_scheduled_ +
-                       bg_purge_scheduled_ - bg_unscheduled;
+                       bg_purge_scheduled_ + bg_table_warm_up_scheduled_ +
+                       bg_manifest_snapshot_scheduled_ - bg_unscheduled;
     if (bg_scheduled || pending_purge_obsolete_files_ ||
         error_handler_.IsRecoveryInProgress() || !console_runner_.closed_) {
       TEST_SYNC_POINT("DBImpl::~DBImpl:WaitJob");
@@ -580,6 +586,8 @@ Status DBImpl::CloseHelper() {
       bg_compaction_scheduled_ = 0;
       bg_flush_scheduled_ = 0;
       bg_purge_scheduled_ = 0;
+      bg_table_warm_up_scheduled_ = 0;
+      bg_manifest_snapshot_scheduled_ = 0;
       break;
     }
   }
@@ -1421,10 +1429,50 @@ Status DBImpl::Get(const ReadOptions& read_options,
   return s;
 }
 
+Status DBImpl::GetPinned(const ReadOptions& read_options,
+                         ColumnFamilyHandle* column_family, const Slice& key,
+                         LazyBuffer* value) {
+  auto s = GetImpl(read_options, column_family, key, value,
+                   nullptr /* value_found */, nullptr /* callback */,
+                   true /* pin_in_place */);
+  assert(!s.ok() || value->valid());
+  return s;
+}
+
+namespace {
+struct PinnedValueState {
+  LazyBuffer value;
+  DBImpl* db;
+  SuperVersion* super_version;
+};
+
+void ReleasePinnedValue(void* arg1, void* /*arg2*/) {
+  auto state = reinterpret_cast<PinnedValueState*>(arg1);
+  // Drop the value first, it may reference the memtables or the SSTs
+  state->value.reset();
+  state->db->CleanupSuperVersion(state->super_version);
+  delete state;
+}
+}  // namespace
+
+void DBImpl::PinValueToSuperVersion(SuperVersion* sv, LazyBuffer* value) {
+  assert(value->valid());
+  if (value->size() <= sizeof(LazyBufferContext)) {
+    // Cheaper to copy into the local storage than to hold sv
+    LazyBuffer copy(value->slice(), true, value->file_number());
+    *value = std::move(copy);
+    return;
+  }
+  uint64_t file_number = value->file_number();
+  auto state = new PinnedValueState{std::move(*value), this, sv->Ref()};
+  value->reset(state->value.slice(),
+               Cleanable(&ReleasePinnedValue, state, nullptr), file_number);
+}
+
 Status DBImpl::GetImpl(const ReadOptions& read_options,
                        ColumnFamilyHandle* column_family, const Slice& key,
                        LazyBuffer* lazy_val, bool* value_found,
-                       ReadCallback* callback) {
+                       ReadCallback* callback, bool pin_in_place) {
   LatencyHistGuard guard(&read_latency_reporter_);
   read_qps_reporter_.AddCount(1);
 
@@ -1444,6 +1492,9 @@ Status DBImpl::GetImpl(const ReadOptions& read_options,
     }
   }
 
+  uint64_t hot_key_epoch =
+      hot_key_cache_ != nullptr ? hot_key_cache_->Epoch() : 0;
+
   // Acquire SuperVersion
   SuperVersion* sv = GetAndRefSuperVersion(cfd);
 
@@ -1496,6 +1547,19 @@ Status DBImpl::GetImpl(const ReadOptions& read_options,
 
   bool skip_memtable = (read_options.read_tier == kPersistedTier &&
                         has_unpersisted_data_.load(std::memory_order_relaxed));
+  // Compaction filters change values without any write
+  const bool use_hot_key_cache =
+      hot_key_cache_ != nullptr && callback == nullptr &&
+      value_found == nullptr && !skip_memtable &&
+      !read_options.ignore_range_deletions &&
+      cfd->ioptions()->compaction_filter == nullptr &&
+      cfd->ioptions()->compaction_filter_factory == nullptr;
+  if (use_hot_key_cache &&
+      hot_key_cache_->Lookup(cfd->GetID(), key, snapshot, lazy_val, stats_)) {
+    ReturnAndCleanupSuperVersion(cfd, sv);
+    RecordTick(stats_, NUMBER_KEYS_READ);
+    return Status::OK();
+  }
   bool done = false;
   if (!skip_memtable) {
     if (sv->mem->Get(lkey, lazy_val, &s, &merge_context,
@@ -1523,8 +1587,25 @@ Status DBImpl::GetImpl(const ReadOptions& read_options,
   }
 
   if (s.ok()) {
-    lazy_val->pin(LazyBufferPinLevel::DB);
-    s = lazy_val->fetch();
+    if (pin_in_place) {
+      // lazy_val is pinned at LazyBufferPinLevel::Internal by now, keep sv
+      // alive along with it instead of copying
+      s = lazy_val->fetch();
+      if (s.ok()) {
+        PinValueToSuperVersion(sv, lazy_val);
+      }
+    } else {
+      lazy_val->pin(LazyBufferPinLevel::DB);
+      s = lazy_val->fetch();
+    }
+    // A memtable switched since sv was acquired may hold writes older than
+    // snapshot, the value is only known to be the one at snapshot if sv is
+    // still current
+    if (s.ok() && use_hot_key_cache &&
+        sv->version_number == cfd->GetSuperVersionNumber()) {
+      hot_key_cache_->Insert(cfd->GetID(), key, snapshot, hot_key_epoch,
+                             lazy_val->slice());
+    }
   }
 
   {
@@ -1638,6 +1719,22 @@ std::vector<Status> DBImpl::MultiGet(
     const ReadOptions& read_options,
     const std::vector<ColumnFamilyHandle*>& column_family,
     const std::vector<Slice>& keys, std::vector<std::string>* values) {
+  return MultiGetImpl(read_options, column_family, keys, values, nullptr);
+}
+
+std::vector<Status> DBImpl::MultiGetPinned(
+    const ReadOptions& read_options,
+    const std::vector<ColumnFamilyHandle*>& column_family,
+    const std::vector<Slice>& keys, std::vector<LazyBuffer>* values) {
+  return MultiGetImpl(read_options, column_family, keys, nullptr, values);
+}
+
+std::vector<Status> DBImpl::MultiGetImpl(
+    const ReadOptions& read_options,
+    const std::vector<ColumnFamilyHandle*>& column_family,
+    const std::vector<Slice>& keys, std::vector<std::string>* values,
+    std::vector<LazyBuffer>* pinned_values) {
+  assert((values == nullptr) != (pinned_values == nullptr));
   LatencyHistGuard guard(&read_latency_reporter_);
   read_qps_reporter_.AddCount(keys.size());
   StopWatch sw(env_, stats_, DB_MULTIGET);
@@ -1679,7 +1776,12 @@ std::vector<Status> DBImpl::MultiGet(
   // Note: this always resizes the values array
   size_t num_keys = keys.size();
   std::vector<Status> stat_list(num_keys);
-  values->resize(num_keys);
+  if (values != nullptr) {
+    values->resize(num_keys);
+  } else {
+    pinned_values->clear();
+    pinned_values->resize(num_keys);
+  }
 
   // Keep track of bytes that we read for statistics-recording later
   uint64_t bytes_read = 0;
@@ -1695,8 +1797,10 @@ std::vector<Status> DBImpl::MultiGet(
     // Contain a list of merge operations if merge occurs.
     MergeContext merge_context;
     Status& s = stat_list[i];
-    std::string* value = &(*values)[i];
-    LazyBuffer lazy_val(value);
+    std::string* value = values != nullptr ? &(*values)[i] : nullptr;
+    LazyBuffer local_val = value != nullptr ? LazyBuffer(value) : LazyBuffer();
+    LazyBuffer& lazy_val =
+        values != nullptr ? local_val : (*pinned_values)[i];
 
     LookupKey lkey(keys[i], snapshot);
     auto cfh = reinterpret_cast<ColumnFamilyHandleImpl*>(column_family[i]);
@@ -1728,10 +1832,17 @@ std::vector<Status> DBImpl::MultiGet(
       RecordTick(stats_, MEMTABLE_MISS);
     }
     if (s.ok()) {
-      s = std::move(lazy_val).dump(value);
+      if (value != nullptr) {
+        s = std::move(lazy_val).dump(value);
+      } else {
+        s = lazy_val.fetch();
+        if (s.ok()) {
+          PinValueToSuperVersion(super_version, &lazy_val);
+        }
+      }
     }
     if (s.ok()) {
-      bytes_read += value->size();
+      bytes_read += value != nullptr ? value->size() : lazy_val.size();
       num_found++;
     }
     counting--;
@@ -2771,6 +2882,9 @@ Status DBImpl::DeleteFile(std::string name) {
       InstallSuperVersionAndScheduleWork(
           cfd, &job_context.superversion_contexts[0],
           *cfd->GetLatestMutableCFOptions(), FlushReason::kDeleteFiles);
+      if (hot_key_cache_ != nullptr) {
+        hot_key_cache_->BumpEpoch();
+      }
     }
     FindObsoleteFiles(&job_context, false);
   }  // lock released here
@@ -3091,6 +3205,9 @@ Status DBImpl::DeleteFilesInRanges(ColumnFamilyHandle* column_family,
       InstallSuperVersionAndScheduleWork(
           cfd, &job_context.superversion_contexts[0],
           *cfd->GetLatestMutableCFOptions(), FlushReason::kDeleteFiles);
+      if (hot_key_cache_ != nullptr) {
+        hot_key_cache_->BumpEpoch();
+      }
     }
     for (auto* deleted_file : deleted_files) {
       deleted_file->being_compacted = false;
@@ -3929,6 +4046,9 @@ Status DBImpl::IngestExternalFile(
     if (status.ok()) {
       InstallSuperVersionAndScheduleWork(cfd, &sv_context, *mutable_cf_options,
                                          FlushReason::kExternalFileIngestion);
+      if (hot_key_cache_ != nullptr) {
+        hot_key_cache_->BumpEpoch();
+      }
     }
 
     // Resume writes to the DB
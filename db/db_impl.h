@@ -27,6 +27,7 @@
 #include "db/external_sst_file_ingestion_job.h"
 #include "db/flush_job.h"
 #include "db/flush_scheduler.h"
+#include "db/hot_key_cache.h"
 #include "db/internal_stats.h"
 #include "db/log_writer.h"
 #include "db/logs_with_prep_tracker.h"
@@ -110,11 +111,18 @@ class DBImpl : public DB {
                      ColumnFamilyHandle* column_family, const Slice& key,
                      LazyBuffer* value) override;
 
+  using DB::GetPinned;
+  virtual Status GetPinned(const ReadOptions& options,
+                           ColumnFamilyHandle* column_family, const Slice& key,
+                           LazyBuffer* value) override;
+
   // Function that Get and KeyMayExist call with no_io true or false
   // Note: 'value_found' from KeyMayExist propagates here
+  // If pin_in_place is true, resident values are not copied, see GetPinned()
   Status GetImpl(const ReadOptions& options, ColumnFamilyHandle* column_family,
                  const Slice& key, LazyBuffer* value,
-                 bool* value_found = nullptr, ReadCallback* callback = nullptr);
+                 bool* value_found = nullptr, ReadCallback* callback = nullptr,
+                 bool pin_in_place = false);
 
   using DB::MultiGet;
   virtual std::vector<Status> MultiGet(
@@ -123,6 +131,13 @@ class DBImpl : public DB {
       const std::vector<Slice>& keys,
       std::vector<std::string>* values) override;
 
+  using DB::MultiGetPinned;
+  virtual std::vector<Status> MultiGetPinned(
+      const ReadOptions& options,
+      const std::vector<ColumnFamilyHandle*>& column_family,
+      const std::vector<Slice>& keys,
+      std::vector<LazyBuffer>* values) override;
+
   virtual Status CreateColumnFamily(const ColumnFamilyOptions& cf_options,
                                     const std::string& column_family,
                                     ColumnFamilyHandle** handle) override;
@@ -638,6 +653,9 @@ class DBImpl : public DB {
 
   bool allow_2pc() const { return immutable_db_options_.allow_2pc; }
 
+  // nullptr unless DBOptions::hot_key_cache is set
+  HotKeyCache* hot_key_cache() const { return hot_key_cache_.get(); }
+
   const std::string& bytedance_tags() const { return bytedance_tags_; }
 
   using QPSReporter = CountReporterHandle&;
@@ -839,8 +857,21 @@ class DBImpl : public DB {
   // Actual implementation of Close()
   Status CloseImpl();
 
+  // Shared by MultiGet() and MultiGetPinned(), exactly one of values and
+  // pinned_values is not nullptr
+  std::vector<Status> MultiGetImpl(
+      const ReadOptions& options,
+      const std::vector<ColumnFamilyHandle*>& column_family,
+      const std::vector<Slice>& keys, std::vector<std::string>* values,
+      std::vector<LazyBuffer>* pinned_values);
+
+  // Hands a reference of sv over to the fetched *value, so the memory *value
+  // references stays valid after the caller releases sv
+  void PinValueToSuperVersion(SuperVersion* sv, LazyBuffer* value);
+
  private:
   friend class DB;
+  friend class DBImplSecondary;
   friend class ErrorHandler;
   friend class InternalStats;
   friend class PessimisticTransaction;
@@ -1098,6 +1129,11 @@ class DBImpl : public DB {
 
   void MaybeScheduleFlushOrCompaction();
 
+  // Open the table files DB::Open() has left closed, see
+  // DBOptions::lazy_open_table_files.
+  // REQUIRES: mutex_ held
+  void ScheduleTableWarmUp();
+
   // A flush request specifies the column families to flush as well as the
   // largest memtable id to persist for each column family. Once all the
   // memtables whose IDs are smaller than or equal to this per-column-family
@@ -1123,12 +1159,16 @@ class DBImpl : public DB {
   static void BGWorkBottomCompaction(void* arg);
   static void BGWorkFlush(void* db);
   static void BGWorkPurge(void* arg);
+  static void BGWorkTableWarmUp(void* db);
+  static void BGWorkManifestSnapshot(void* db);
   static void UnscheduleCallback(void* arg);
   void BackgroundCallCompaction(PrepickedCompaction* prepicked_compaction,
                                 Env::Priority bg_thread_pri);
   void BackgroundCallGarbageCollection();
   void BackgroundCallFlush();
   void BackgroundCallPurge();
+  void BackgroundCallTableWarmUp();
+  void BackgroundCallManifestSnapshot();
   Status BackgroundCompaction(bool* madeProgress, JobContext* job_context,
                               LogBuffer* log_buffer,
                               PrepickedCompaction* prepicked_compaction);
@@ -1187,6 +1227,9 @@ class DBImpl : public DB {
   // table_cache_ provides its own synchronization
   std::shared_ptr<Cache> table_cache_;
 
+  // hot_key_cache_ provides its own synchronization
+  std::unique_ptr<HotKeyCache> hot_key_cache_;
+
   // Lock over the persistent DB state.  Non-nullptr iff successfully acquired.
   FileLock* db_lock_;
 
@@ -1466,6 +1509,13 @@ class DBImpl : public DB {
   // number of background obsolete file purge jobs, submitted to the HIGH pool
   int bg_purge_scheduled_;
 
+  // number of background table warm up jobs, submitted to the LOW pool
+  int bg_table_warm_up_scheduled_;
+
+  // number of background manifest snapshot jobs, submitted to the LOW pool,
+  // see DBOptions::background_manifest_rollover
+  int bg_manifest_snapshot_scheduled_;
+
   // Information for a manual compaction
   struct ManualCompactionState {
     ColumnFamilyData* cfd;
@@ -1834,6 +1834,14 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     }
   }
 
+  // Writing the snapshot of a new manifest file must not hold up flushes
+  if (bg_manifest_snapshot_scheduled_ == 0 &&
+      versions_->NeedsManifestSnapshot()) {
+    bg_manifest_snapshot_scheduled_++;
+    env_->Schedule(&DBImpl::BGWorkManifestSnapshot, this, Env::Priority::LOW,
+                   this);
+  }
+
   if (bg_compaction_paused_ > 0) {
     // we paused the background compaction
     return;
@@ -1877,6 +1885,17 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
   }
 }
 
+void DBImpl::ScheduleTableWarmUp() {
+  mutex_.AssertHeld();
+  if (!immutable_db_options_.lazy_open_table_files ||
+      mutable_db_options_.max_open_files != -1 ||
+      shutting_down_.load(std::memory_order_acquire)) {
+    return;
+  }
+  bg_table_warm_up_scheduled_++;
+  env_->Schedule(&DBImpl::BGWorkTableWarmUp, this, Env::Priority::LOW, this);
+}
+
 DBImpl::BGJobLimits DBImpl::GetBGJobLimits() const {
   mutex_.AssertHeld();
   bool need_speedup_compaction = write_controller_.NeedSpeedupCompaction();
@@ -2081,6 +2100,20 @@ void DBImpl::BGWorkPurge(void* db) {
   TEST_SYNC_POINT("DBImpl::BGWorkPurge:end");
 }
 
+void DBImpl::BGWorkTableWarmUp(void* db) {
+  IOSTATS_SET_THREAD_POOL_ID(Env::Priority::LOW);
+  TEST_SYNC_POINT("DBImpl::BGWorkTableWarmUp:start");
+  reinterpret_cast<DBImpl*>(db)->BackgroundCallTableWarmUp();
+  TEST_SYNC_POINT("DBImpl::BGWorkTableWarmUp:end");
+}
+
+void DBImpl::BGWorkManifestSnapshot(void* db) {
+  IOSTATS_SET_THREAD_POOL_ID(Env::Priority::LOW);
+  TEST_SYNC_POINT("DBImpl::BGWorkManifestSnapshot:start");
+  reinterpret_cast<DBImpl*>(db)->BackgroundCallManifestSnapshot();
+  TEST_SYNC_POINT("DBImpl::BGWorkManifestSnapshot:end");
+}
+
 void DBImpl::UnscheduleCallback(void* arg) {
   CompactionArg ca = *(reinterpret_cast<CompactionArg*>(arg));
   delete reinterpret_cast<CompactionArg*>(arg);
@@ -2376,6 +2409,115 @@ void DBImpl::BackgroundCallCompaction(PrepickedCompaction* prepicked_compaction,
   }
 }
 
+void DBImpl::BackgroundCallTableWarmUp() {
+  struct WarmUpFile {
+    ColumnFamilyData* cfd;
+    FileMetaData* f;
+    int level;
+    std::shared_ptr<const SliceTransform> prefix_extractor;
+  };
+  std::vector<WarmUpFile> files;
+  autovector<ColumnFamilyData*> cfds;
+  autovector<Version*> versions;
+
+  mutex_.Lock();
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped()) {
+      continue;
+    }
+    // The files stay alive with the version, the version with the cfd
+    cfd->Ref();
+    cfds.push_back(cfd);
+    Version* v = cfd->current();
+    v->Ref();
+    versions.push_back(v);
+    auto& prefix_extractor = cfd->GetLatestMutableCFOptions()->prefix_extractor;
+    auto* vstorage = v->storage_info();
+    for (int level = -1; level < vstorage->num_levels(); ++level) {
+      for (auto f : vstorage->LevelFiles(level)) {
+        if (f->table_reader_handle == nullptr) {
+          files.push_back({cfd, f, level, prefix_extractor});
+        }
+      }
+    }
+  }
+  mutex_.Unlock();
+
+  // The upper levels hold the newest and most read data, they are opened
+  // first. The blob files at level -1 are read through the key files, they
+  // come last.
+  std::stable_sort(files.begin(), files.end(),
+                   [](const WarmUpFile& a, const WarmUpFile& b) {
+                     return static_cast<unsigned>(a.level) <
+                            static_cast<unsigned>(b.level);
+                   });
+  uint64_t start_micros = env_->NowMicros();
+  size_t num_opened = 0;
+  for (auto& file : files) {
+    if (shutting_down_.load(std::memory_order_acquire)) {
+      break;
+    }
+    ColumnFamilyData* cfd = file.cfd;
+    Cache::Handle* handle = nullptr;
+    Status s = cfd->table_cache()->FindTable(
+        env_options_, cfd->internal_comparator(), file.f->fd, &handle,
+        file.prefix_extractor.get(), false /* no_io */,
+        true /* record_read_stats */,
+        file.level >= 0 ? cfd->internal_stats()->GetFileReadHist(file.level)
+                        : nullptr,
+        false /* skip_filters */, file.level,
+        false /* prefetch_index_and_filter_in_cache */,
+        file.f->prop.is_map_sst());
+    if (s.ok()) {
+      // The table cache has an infinite capacity, the table stays open
+      cfd->table_cache()->ReleaseHandle(handle);
+      ++num_opened;
+    } else {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "[%s] Failed to warm up table file #%" PRIu64 ": %s",
+                     cfd->GetName().c_str(), file.f->fd.GetNumber(),
+                     s.ToString().c_str());
+    }
+  }
+  ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                 "Warmed up %" ROCKSDB_PRIszt " of %" ROCKSDB_PRIszt
+                 " table files in %" PRIu64 " ms",
+                 num_opened, files.size(),
+                 (env_->NowMicros() - start_micros) / 1000);
+
+  mutex_.Lock();
+  for (auto v : versions) {
+    v->Unref();
+  }
+  for (auto cfd : cfds) {
+    if (cfd->Unref()) {
+      delete cfd;
+    }
+  }
+  bg_table_warm_up_scheduled_--;
+  bg_cv_.SignalAll();
+  // IMPORTANT: there should be no code after calling SignalAll. This call may
+  // signal the DB destructor that it's OK to proceed with destruction.
+  mutex_.Unlock();
+}
+
+void DBImpl::BackgroundCallManifestSnapshot() {
+  mutex_.Lock();
+  if (!shutting_down_.load(std::memory_order_acquire)) {
+    Status s = versions_->WriteManifestSnapshot(&mutex_);
+    if (!s.ok()) {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "Failed to write manifest snapshot in background: %s",
+                     s.ToString().c_str());
+    }
+  }
+  bg_manifest_snapshot_scheduled_--;
+  bg_cv_.SignalAll();
+  // IMPORTANT: there should be no code after calling SignalAll. This call may
+  // signal the DB destructor that it's OK to proceed with destruction.
+  mutex_.Unlock();
+}
+
 void DBImpl::BackgroundCallGarbageCollection() {
   bool made_progress = false;
   JobContext job_context(next_job_id_.fetch_add(1), true);
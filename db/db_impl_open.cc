@@ -1338,6 +1338,7 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
     *dbptr = impl;
     impl->opened_successfully_ = true;
     impl->MaybeScheduleFlushOrCompaction();
+    impl->ScheduleTableWarmUp();
   }
   impl->FillLogWriterPool();
   impl->mutex_.Unlock();
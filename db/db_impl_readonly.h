@@ -24,7 +24,24 @@ class DBImplReadOnly : public DBImpl {
                      ColumnFamilyHandle* column_family, const Slice& key,
                      LazyBuffer* value) override;
 
+  // The SuperVersion never changes in read only mode, Get() already
+  // references resident values in place
+  using DB::GetPinned;
+  virtual Status GetPinned(const ReadOptions& options,
+                           ColumnFamilyHandle* column_family, const Slice& key,
+                           LazyBuffer* value) override {
+    return Get(options, column_family, key, value);
+  }
+
   // TODO: Implement ReadOnly MultiGet?
+  using DB::MultiGetPinned;
+  virtual std::vector<Status> MultiGetPinned(
+      const ReadOptions& options,
+      const std::vector<ColumnFamilyHandle*>& column_family,
+      const std::vector<Slice>& keys,
+      std::vector<LazyBuffer>* values) override {
+    return DB::MultiGetPinned(options, column_family, keys, values);
+  }
 
   using DBImpl::NewIterator;
   virtual Iterator* NewIterator(const ReadOptions&,
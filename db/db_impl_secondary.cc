@@ -0,0 +1,500 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/db_impl_secondary.h"
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#include <inttypes.h>
+
+#include "db/column_family.h"
+#include "db/version_set.h"
+#include "db/write_batch_internal.h"
+#include "util/auto_roll_logger.h"
+#include "util/file_reader_writer.h"
+#include "util/filename.h"
+#if !defined(_MSC_VER) && !defined(__APPLE__)
+#include <sys/unistd.h>
+#include <table/terark_zip_table.h>
+#endif
+
+namespace rocksdb {
+
+#ifndef ROCKSDB_LITE
+
+namespace {
+
+// Collects the column families a write batch updates
+class ColumnFamilyCollector : public WriteBatch::Handler {
+ public:
+  Status PutCF(uint32_t column_family_id, const Slice& /*key*/,
+               const Slice& /*value*/) override {
+    return Add(column_family_id);
+  }
+  Status DeleteCF(uint32_t column_family_id, const Slice& /*key*/) override {
+    return Add(column_family_id);
+  }
+  Status SingleDeleteCF(uint32_t column_family_id,
+                        const Slice& /*key*/) override {
+    return Add(column_family_id);
+  }
+  Status DeleteRangeCF(uint32_t column_family_id, const Slice& /*begin_key*/,
+                       const Slice& /*end_key*/) override {
+    return Add(column_family_id);
+  }
+  Status MergeCF(uint32_t column_family_id, const Slice& /*key*/,
+                 const Slice& /*value*/) override {
+    return Add(column_family_id);
+  }
+  Status MarkBeginPrepare(bool /*unprepare*/) override { return Status::OK(); }
+  Status MarkEndPrepare(const Slice& /*xid*/) override { return Status::OK(); }
+  Status MarkNoop(bool /*empty_batch*/) override { return Status::OK(); }
+  Status MarkRollback(const Slice& /*xid*/) override { return Status::OK(); }
+  Status MarkCommit(const Slice& /*xid*/) override { return Status::OK(); }
+
+  const std::unordered_set<uint32_t>& column_families() const {
+    return column_families_;
+  }
+
+ private:
+  Status Add(uint32_t column_family_id) {
+    column_families_.insert(column_family_id);
+    return Status::OK();
+  }
+
+  std::unordered_set<uint32_t> column_families_;
+};
+
+}  // namespace
+
+DBImplSecondary::DBImplSecondary(const DBOptions& db_options,
+                                 const std::string& dbname)
+    : DBImplReadOnly(db_options, dbname) {
+  ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                 "Opening the db in secondary mode");
+  LogFlush(immutable_db_options_.info_log);
+}
+
+DBImplSecondary::~DBImplSecondary() {}
+
+void DBImplSecondary::LogReporter::Corruption(size_t bytes, const Status& s) {
+  ROCKS_LOG_WARN(info_log, "%s%s: dropping %d bytes; %s",
+                 (this->status == nullptr ? "(ignoring error) " : ""),
+                 fname.c_str(), static_cast<int>(bytes),
+                 s.ToString().c_str());
+  if (this->status != nullptr && this->status->ok()) {
+    *this->status = s;
+  }
+}
+
+Status DBImplSecondary::Recover(
+    const std::vector<ColumnFamilyDescriptor>& column_families) {
+  mutex_.AssertHeld();
+
+  Status s = static_cast<ReactiveVersionSet*>(versions_.get())
+                 ->Recover(column_families);
+  if (immutable_db_options_.paranoid_checks && s.ok()) {
+    s = CheckConsistency(true /* read_only */);
+  }
+  if (!s.ok()) {
+    return s;
+  }
+
+  default_cf_handle_ = new ColumnFamilyHandleImpl(
+      versions_->GetColumnFamilySet()->GetDefault(), this, &mutex_);
+  default_cf_internal_stats_ = default_cf_handle_->cfd()->internal_stats();
+  single_column_family_mode_ =
+      versions_->GetColumnFamilySet()->NumberOfColumnFamilies() == 1;
+
+  std::unordered_set<ColumnFamilyData*> cfds_changed;
+  autovector<MemTable*> memtables_to_free;
+  s = RecoverLogFiles(&cfds_changed, &memtables_to_free);
+  // Nothing is flushed from the memtables filled just now
+  assert(memtables_to_free.empty());
+  return s;
+}
+
+Status DBImplSecondary::RecoverLogFiles(
+    std::unordered_set<ColumnFamilyData*>* cfds_changed,
+    autovector<MemTable*>* memtables_to_free) {
+  mutex_.AssertHeld();
+
+  // The records of WALs older than the log number of every column family are
+  // all flushed
+  uint64_t min_log_number = port::kMaxUint64;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (!cfd->IsDropped()) {
+      min_log_number = std::min(min_log_number, cfd->GetLogNumber());
+    }
+  }
+  log_readers_.erase(log_readers_.begin(),
+                     log_readers_.lower_bound(min_log_number));
+
+  std::vector<std::string> filenames;
+  Status s = env_->GetChildren(immutable_db_options_.wal_dir, &filenames);
+  if (!s.ok()) {
+    return s;
+  }
+  for (auto& filename : filenames) {
+    uint64_t number;
+    FileType type;
+    if (!ParseFileName(filename, &number, &type) || type != kLogFile ||
+        number < min_log_number || log_readers_.count(number) > 0) {
+      continue;
+    }
+    std::unique_ptr<LogReaderContainer> container(new LogReaderContainer);
+    s = NewLogReader(number, container.get());
+    if (s.IsNotFound()) {
+      // The primary deleted it after flushing the memtables
+      s = Status::OK();
+      continue;
+    }
+    if (!s.ok()) {
+      return s;
+    }
+    log_readers_.emplace(number, std::move(container));
+  }
+
+  SequenceNumber next_sequence = versions_->LastSequence() + 1;
+  for (auto& pair : log_readers_) {
+    s = ReadLogFile(pair.first, &next_sequence, cfds_changed,
+                    memtables_to_free);
+    if (!s.ok()) {
+      break;
+    }
+  }
+  if (next_sequence > versions_->LastSequence() + 1) {
+    versions_->SetLastAllocatedSequence(next_sequence - 1);
+    versions_->SetLastPublishedSequence(next_sequence - 1);
+    versions_->SetLastSequence(next_sequence - 1);
+  }
+  return s;
+}
+
+Status DBImplSecondary::NewLogReader(uint64_t log_number,
+                                     LogReaderContainer* container) {
+  std::string fname = LogFileName(immutable_db_options_.wal_dir, log_number);
+  std::unique_ptr<SequentialFile> file;
+  Status s = env_->NewSequentialFile(fname, &file,
+                                     env_->OptimizeForLogRead(env_options_));
+  if (!s.ok()) {
+    return s;
+  }
+  container->reporter.env = env_;
+  container->reporter.info_log = immutable_db_options_.info_log.get();
+  container->reporter.fname = fname;
+  if (!immutable_db_options_.paranoid_checks ||
+      immutable_db_options_.wal_recovery_mode ==
+          WALRecoveryMode::kSkipAnyCorruptedRecords) {
+    container->reporter.status = nullptr;
+  } else {
+    container->reporter.status = &container->status;
+  }
+  std::unique_ptr<SequentialFileReader> file_reader(
+      new SequentialFileReader(std::move(file), fname));
+  container->reader.reset(new log::FragmentBufferedReader(
+      immutable_db_options_.info_log, std::move(file_reader),
+      &container->reporter, true /* checksum */, log_number));
+  return s;
+}
+
+Status DBImplSecondary::ReadLogFile(
+    uint64_t log_number, SequenceNumber* next_sequence,
+    std::unordered_set<ColumnFamilyData*>* cfds_changed,
+    autovector<MemTable*>* memtables_to_free) {
+  mutex_.AssertHeld();
+  auto& container = log_readers_[log_number];
+  assert(container != nullptr);
+
+  Status s;
+  if (container->reader->IsOldRecordReached()) {
+    // The primary recycled the log, and what the reader buffered past the
+    // records replayed may be overwritten since. Read it again from the start.
+    s = NewLogReader(log_number, container.get());
+    if (s.IsNotFound()) {
+      return Status::OK();
+    }
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  std::string scratch;
+  Slice record;
+  WriteBatch batch;
+  bool older_logs_reread = false;
+  while (container->status.ok() &&
+         container->reader->ReadRecord(
+             &record, &scratch, immutable_db_options_.wal_recovery_mode)) {
+    if (record.size() < WriteBatchInternal::kHeader) {
+      container->reporter.Corruption(
+          record.size(), Status::Corruption("log record too small"));
+      continue;
+    }
+    WriteBatchInternal::SetContents(&batch, record);
+    SequenceNumber sequence = WriteBatchInternal::Sequence(&batch);
+    if (sequence < container->min_sequence) {
+      continue;
+    }
+    if (sequence > *next_sequence && !older_logs_reread) {
+      // The primary may have appended the missing records to an older WAL
+      // after it was read, catch up with them first
+      older_logs_reread = true;
+      for (auto iter = log_readers_.begin();
+           iter != log_readers_.end() && iter->first < log_number; ++iter) {
+        s = ReadLogFile(iter->first, next_sequence, cfds_changed,
+                        memtables_to_free);
+        if (!s.ok()) {
+          return s;
+        }
+      }
+    }
+
+    ColumnFamilyCollector collector;
+    s = batch.Iterate(&collector);
+    if (!s.ok()) {
+      container->reporter.Corruption(record.size(), s);
+      continue;
+    }
+    for (uint32_t column_family_id : collector.column_families()) {
+      auto cfd =
+          versions_->GetColumnFamilySet()->GetColumnFamily(column_family_id);
+      if (cfd == nullptr || cfd->IsDropped() ||
+          cfd->GetLogNumber() > log_number) {
+        continue;
+      }
+      // Every memtable only holds the records of one WAL, so it is dropped
+      // as soon as the primary flushes that WAL
+      auto iter = cfd_to_current_log_.find(column_family_id);
+      if (iter != cfd_to_current_log_.end() && iter->second < log_number &&
+          !cfd->mem()->IsEmpty()) {
+        cfd->mem()->SetNextLogNumber(log_number);
+        cfd->imm()->Add(cfd->mem(), memtables_to_free);
+        MemTable* new_mem = cfd->ConstructNewMemtable(
+            *cfd->GetLatestMutableCFOptions(), seq_per_batch_, sequence);
+        new_mem->Ref();
+        cfd->SetMemtable(new_mem);
+      }
+      if (iter == cfd_to_current_log_.end()) {
+        cfd_to_current_log_.emplace(column_family_id, log_number);
+      } else if (iter->second < log_number) {
+        iter->second = log_number;
+      }
+      cfds_changed->insert(cfd);
+    }
+
+    s = WriteBatchInternal::InsertInto(
+        &batch, column_family_memtables_.get(), nullptr /* flush_scheduler */,
+        true /* ignore_missing_column_families */, log_number, this,
+        false /* concurrent_memtable_writes */, next_sequence,
+        nullptr /* has_valid_writes */, seq_per_batch_, batch_per_txn_);
+    MaybeIgnoreError(&s);
+    if (!s.ok()) {
+      container->reporter.Corruption(record.size(), s);
+      continue;
+    }
+  }
+  if (container->reader->IsOldRecordReached()) {
+    container->min_sequence = *next_sequence;
+  }
+  return container->status;
+}
+
+void DBImplSecondary::RemoveFlushedMemTables(
+    ColumnFamilyData* cfd, autovector<MemTable*>* memtables_to_free) {
+  mutex_.AssertHeld();
+  uint64_t log_number = cfd->GetLogNumber();
+  auto iter = cfd_to_current_log_.find(cfd->GetID());
+  if (iter != cfd_to_current_log_.end() && iter->second < log_number) {
+    if (!cfd->mem()->IsEmpty()) {
+      cfd->mem()->SetNextLogNumber(iter->second + 1);
+      cfd->imm()->Add(cfd->mem(), memtables_to_free);
+      MemTable* new_mem =
+          cfd->ConstructNewMemtable(*cfd->GetLatestMutableCFOptions(),
+                                    seq_per_batch_, versions_->LastSequence());
+      new_mem->Ref();
+      cfd->SetMemtable(new_mem);
+    }
+    cfd_to_current_log_.erase(iter);
+  }
+  cfd->imm()->RemoveOldMemTables(log_number, memtables_to_free);
+}
+
+Status DBImplSecondary::TryCatchUpWithPrimary() {
+  Status s;
+  std::unordered_set<ColumnFamilyData*> cfds_changed;
+  autovector<MemTable*> memtables_to_free;
+  SuperVersionContext sv_context(/* create_superversion */ true);
+  std::vector<ObsoleteFileInfo> obsolete_files;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    s = static_cast<ReactiveVersionSet*>(versions_.get())
+            ->ReadAndApply(&mutex_, &cfds_changed);
+    if (s.ok()) {
+      for (auto cfd : cfds_changed) {
+        RemoveFlushedMemTables(cfd, &memtables_to_free);
+      }
+      s = RecoverLogFiles(&cfds_changed, &memtables_to_free);
+    }
+    // What is applied so far is consistent even if the catch up fails
+    for (auto cfd : cfds_changed) {
+      if (cfd->IsDropped()) {
+        continue;
+      }
+      sv_context.NewSuperVersion();
+      cfd->InstallSuperVersion(&sv_context, &mutex_);
+    }
+    // The files installed may hold anything ingested by the primary
+    if (hot_key_cache_ != nullptr && !cfds_changed.empty()) {
+      hot_key_cache_->BumpEpoch();
+    }
+    // The primary deletes the files no longer referenced, the secondary only
+    // drops their metadata
+    std::vector<std::string> obsolete_manifests;
+    versions_->GetObsoleteFiles(&obsolete_files, &obsolete_manifests,
+                                port::kMaxUint64);
+  }
+  for (auto& f : obsolete_files) {
+    if (f.metadata->table_reader_handle) {
+      table_cache_->Release(f.metadata->table_reader_handle);
+    }
+    TableCache::Evict(table_cache_.get(), f.metadata->fd.GetNumber());
+    f.DeleteMetadata();
+  }
+  for (auto m : memtables_to_free) {
+    delete m;
+  }
+  sv_context.Clean();
+  return s;
+}
+
+Status DB::OpenAsSecondary(const Options& options, const std::string& dbname,
+                           const std::string& secondary_path, DB** dbptr) {
+  *dbptr = nullptr;
+
+  DBOptions db_options(options);
+  ColumnFamilyOptions cf_options(options);
+  std::vector<ColumnFamilyDescriptor> column_families;
+  column_families.push_back(
+      ColumnFamilyDescriptor(kDefaultColumnFamilyName, cf_options));
+  std::vector<ColumnFamilyHandle*> handles;
+
+  Status s = DB::OpenAsSecondary(db_options, dbname, secondary_path,
+                                 column_families, &handles, dbptr);
+  if (s.ok()) {
+    assert(handles.size() == 1);
+    // i can delete the handle since DBImpl is always holding a
+    // reference to default column family
+    delete handles[0];
+  }
+  return s;
+}
+
+Status DB::OpenAsSecondary(
+    const DBOptions& db_options, const std::string& dbname,
+    const std::string& secondary_path,
+    const std::vector<ColumnFamilyDescriptor>& column_families,
+    std::vector<ColumnFamilyHandle*>* handles, DB** dbptr) {
+  *dbptr = nullptr;
+  handles->clear();
+
+  // The primary may delete a table file before the secondary opens it
+  if (db_options.max_open_files != -1) {
+    return Status::InvalidArgument(
+        "Secondary instance requires max_open_files = -1");
+  }
+
+  SuperVersionContext sv_context(/* create_superversion */ true);
+#if !defined(_MSC_VER) && !defined(__APPLE__)
+  const char* terarkdb_localTempDir = getenv("TerarkZipTable_localTempDir");
+  const char* terarkConfigString = getenv("TerarkConfigString");
+  if (terarkdb_localTempDir || terarkConfigString) {
+    if (terarkdb_localTempDir &&
+        ::access(terarkdb_localTempDir, R_OK | W_OK) != 0) {
+      return Status::InvalidArgument(
+          "Must exists, and Permission ReadWrite is required on "
+          "env TerarkZipTable_localTempDir",
+          terarkdb_localTempDir);
+    }
+#ifdef WITH_TERARK_ZIP
+    TerarkZipMultiCFOptionsFromEnv(db_options, column_families, dbname);
+#endif
+  }
+#endif
+  // Keep the info log away from the LOG of the primary
+  DBOptions tmp_opts(db_options);
+  Status s;
+  if (tmp_opts.info_log == nullptr) {
+    s = CreateLoggerFromOptions(secondary_path, tmp_opts, &tmp_opts.info_log);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  DBImplSecondary* impl = new DBImplSecondary(tmp_opts, dbname);
+  impl->versions_.reset(new ReactiveVersionSet(
+      dbname, &impl->immutable_db_options_, impl->env_options_,
+      impl->seq_per_batch_, impl->table_cache_.get(),
+      impl->write_buffer_manager_, &impl->write_controller_));
+  impl->column_family_memtables_.reset(
+      new ColumnFamilyMemTablesImpl(impl->versions_->GetColumnFamilySet()));
+  impl->mutex_.Lock();
+  s = impl->Recover(column_families);
+  if (s.ok()) {
+    // set column family handles
+    for (auto cf : column_families) {
+      auto cfd =
+          impl->versions_->GetColumnFamilySet()->GetColumnFamily(cf.name);
+      if (cfd == nullptr) {
+        s = Status::InvalidArgument("Column family not found: ", cf.name);
+        break;
+      }
+      handles->push_back(new ColumnFamilyHandleImpl(cfd, impl, &impl->mutex_));
+    }
+  }
+  if (s.ok()) {
+    for (auto cfd : *impl->versions_->GetColumnFamilySet()) {
+      sv_context.NewSuperVersion();
+      cfd->InstallSuperVersion(&sv_context, &impl->mutex_);
+    }
+  }
+  impl->mutex_.Unlock();
+  sv_context.Clean();
+  if (s.ok()) {
+    *dbptr = impl;
+    for (auto* h : *handles) {
+      impl->NewThreadStatusCfInfo(
+          reinterpret_cast<ColumnFamilyHandleImpl*>(h)->cfd());
+    }
+  } else {
+    for (auto h : *handles) {
+      delete h;
+    }
+    handles->clear();
+    delete impl;
+  }
+  return s;
+}
+
+#else  // !ROCKSDB_LITE
+
+Status DB::OpenAsSecondary(const Options& /*options*/,
+                           const std::string& /*dbname*/,
+                           const std::string& /*secondary_path*/,
+                           DB** /*dbptr*/) {
+  return Status::NotSupported("Not supported in ROCKSDB_LITE.");
+}
+
+Status DB::OpenAsSecondary(
+    const DBOptions& /*db_options*/, const std::string& /*dbname*/,
+    const std::string& /*secondary_path*/,
+    const std::vector<ColumnFamilyDescriptor>& /*column_families*/,
+    std::vector<ColumnFamilyHandle*>* /*handles*/, DB** /*dbptr*/) {
+  return Status::NotSupported("Not supported in ROCKSDB_LITE.");
+}
+#endif  // !ROCKSDB_LITE
+
+}  // namespace rocksdb
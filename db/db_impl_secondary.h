@@ -0,0 +1,161 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#ifndef ROCKSDB_LITE
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "db/db_impl_readonly.h"
+#include "db/log_reader.h"
+
+namespace rocksdb {
+
+// A read only instance sharing the files of a primary instance that keeps
+// writing the same DB. TryCatchUpWithPrimary() replays the VersionEdits the
+// primary appended to its MANIFEST since the last call, and tails its WALs
+// into the memtables of the secondary. The secondary never writes or deletes
+// any file of the DB, its info log lives in its own directory.
+class DBImplSecondary : public DBImplReadOnly {
+ public:
+  DBImplSecondary(const DBOptions& options, const std::string& dbname);
+  virtual ~DBImplSecondary();
+
+  // Unlike the read only instance, the SuperVersion changes on every catch
+  // up, reads go through the regular path of DBImpl
+  using DB::Get;
+  virtual Status Get(const ReadOptions& options,
+                     ColumnFamilyHandle* column_family, const Slice& key,
+                     LazyBuffer* value) override {
+    return DBImpl::Get(options, column_family, key, value);
+  }
+
+  using DB::GetPinned;
+  virtual Status GetPinned(const ReadOptions& options,
+                           ColumnFamilyHandle* column_family, const Slice& key,
+                           LazyBuffer* value) override {
+    return DBImpl::GetPinned(options, column_family, key, value);
+  }
+
+  using DB::MultiGetPinned;
+  virtual std::vector<Status> MultiGetPinned(
+      const ReadOptions& options,
+      const std::vector<ColumnFamilyHandle*>& column_family,
+      const std::vector<Slice>& keys,
+      std::vector<LazyBuffer>* values) override {
+    return DBImpl::MultiGetPinned(options, column_family, keys, values);
+  }
+
+  using DBImpl::NewIterator;
+  virtual Iterator* NewIterator(const ReadOptions& options,
+                                ColumnFamilyHandle* column_family) override {
+    return DBImpl::NewIterator(options, column_family);
+  }
+
+  virtual Status NewIterators(
+      const ReadOptions& options,
+      const std::vector<ColumnFamilyHandle*>& column_families,
+      std::vector<Iterator*>* iterators) override {
+    return DBImpl::NewIterators(options, column_families, iterators);
+  }
+
+  using DBImpl::CreateColumnFamily;
+  virtual Status CreateColumnFamily(const ColumnFamilyOptions& /*options*/,
+                                    const std::string& /*column_family*/,
+                                    ColumnFamilyHandle** /*handle*/) override {
+    return Status::NotSupported("Not supported operation in secondary mode.");
+  }
+
+  using DBImpl::CreateColumnFamilies;
+  virtual Status CreateColumnFamilies(
+      const ColumnFamilyOptions& /*options*/,
+      const std::vector<std::string>& /*column_family_names*/,
+      std::vector<ColumnFamilyHandle*>* /*handles*/) override {
+    return Status::NotSupported("Not supported operation in secondary mode.");
+  }
+
+  virtual Status CreateColumnFamilies(
+      const std::vector<ColumnFamilyDescriptor>& /*column_families*/,
+      std::vector<ColumnFamilyHandle*>* /*handles*/) override {
+    return Status::NotSupported("Not supported operation in secondary mode.");
+  }
+
+  virtual Status DropColumnFamily(
+      ColumnFamilyHandle* /*column_family*/) override {
+    return Status::NotSupported("Not supported operation in secondary mode.");
+  }
+
+  virtual Status DropColumnFamilies(
+      const std::vector<ColumnFamilyHandle*>& /*column_families*/) override {
+    return Status::NotSupported("Not supported operation in secondary mode.");
+  }
+
+  virtual Status TryCatchUpWithPrimary() override;
+
+ private:
+  friend class DB;
+
+  struct LogReporter : public log::Reader::Reporter {
+    Env* env;
+    Logger* info_log;
+    std::string fname;
+    Status* status;  // nullptr if immutable_db_options_.paranoid_checks==false
+    virtual void Corruption(size_t bytes, const Status& s) override;
+  };
+
+  // Follows one WAL of the primary
+  struct LogReaderContainer {
+    LogReporter reporter;
+    Status status;
+    std::unique_ptr<log::FragmentBufferedReader> reader;
+    // Records below it were replayed before the log was reopened
+    SequenceNumber min_sequence = 0;
+  };
+
+  // Open the WAL log_number into container, NotFound if the primary deleted
+  // it.
+  Status NewLogReader(uint64_t log_number, LogReaderContainer* container);
+
+  // REQUIRES: mutex_ held
+  Status Recover(const std::vector<ColumnFamilyDescriptor>& column_families);
+
+  // Open the WALs not older than the oldest one still holding unflushed data
+  // and replay the records appended to them since the last call.
+  // REQUIRES: mutex_ held
+  Status RecoverLogFiles(std::unordered_set<ColumnFamilyData*>* cfds_changed,
+                         autovector<MemTable*>* memtables_to_free);
+
+  // Replay the records available in log_readers_[log_number].
+  // REQUIRES: mutex_ held
+  Status ReadLogFile(uint64_t log_number, SequenceNumber* next_sequence,
+                     std::unordered_set<ColumnFamilyData*>* cfds_changed,
+                     autovector<MemTable*>* memtables_to_free);
+
+  // The memtables of cfd holding records already flushed by the primary are
+  // dropped.
+  // REQUIRES: mutex_ held
+  void RemoveFlushedMemTables(ColumnFamilyData* cfd,
+                              autovector<MemTable*>* memtables_to_free);
+
+  // Readers of the WALs being tailed, keyed by log number
+  std::map<uint64_t, std::unique_ptr<LogReaderContainer>> log_readers_;
+  // The WAL the records in the mutable memtable of each column family are
+  // replayed from
+  std::unordered_map<uint32_t, uint64_t> cfd_to_current_log_;
+
+  // No copying allowed
+  DBImplSecondary(const DBImplSecondary&);
+  void operator=(const DBImplSecondary&);
+};
+
+}  // namespace rocksdb
+
+#endif  // !ROCKSDB_LITE
@@ -26,8 +26,16 @@ class DBMemTableTest : public DBTestBase {
 
 class MockMemTableRep : public MemTableRep {
  public:
-  explicit MockMemTableRep(Allocator* allocator, MemTableRep* rep)
-      : MemTableRep(allocator), rep_(rep), num_insert_with_hint_(0) {}
+  explicit MockMemTableRep(Allocator* allocator, MemTableRep* rep,
+                           const InternalKeyComparator* icmp = nullptr,
+                           bool batch_insert = false)
+      : MemTableRep(allocator),
+        rep_(rep),
+        icmp_(icmp),
+        batch_insert_(batch_insert),
+        num_insert_with_hint_(0),
+        num_insert_batch_(0),
+        last_batch_count_(0) {}
 
   virtual KeyHandle Allocate(const size_t len, char** buf) override {
     return rep_->Allocate(len, buf);
@@ -43,6 +51,22 @@ class MockMemTableRep : public MemTableRep {
     last_hint_out_ = *hint;
   }
 
+  virtual bool InsertKeyValueBatch(const Slice* internal_keys,
+                                   const Slice* values, size_t count,
+                                   bool concurrently) override {
+    num_insert_batch_++;
+    last_batch_count_ = count;
+    for (size_t i = 1; i < count; ++i) {
+      EXPECT_LT(icmp_->Compare(internal_keys[i - 1], internal_keys[i]), 0);
+    }
+    return MemTableRep::InsertKeyValueBatch(internal_keys, values, count,
+                                            concurrently);
+  }
+
+  virtual bool IsBatchInsertSupported() const override {
+    return batch_insert_;
+  }
+
   virtual bool Contains(const Slice& internal_key) const override {
     return rep_->Contains(internal_key);
   }
@@ -64,16 +88,25 @@ class MockMemTableRep : public MemTableRep {
   void* last_hint_in() { return last_hint_in_; }
   void* last_hint_out() { return last_hint_out_; }
   int num_insert_with_hint() { return num_insert_with_hint_; }
+  int num_insert_batch() { return num_insert_batch_; }
+  size_t last_batch_count() { return last_batch_count_; }
 
  private:
   std::unique_ptr<MemTableRep> rep_;
+  const InternalKeyComparator* icmp_;
+  bool batch_insert_;
   void* last_hint_in_;
   void* last_hint_out_;
   int num_insert_with_hint_;
+  int num_insert_batch_;
+  size_t last_batch_count_;
 };
 
 class MockMemTableRepFactory : public MemTableRepFactory {
  public:
+  explicit MockMemTableRepFactory(bool batch_insert = false)
+      : batch_insert_(batch_insert) {}
+
   using MemTableRepFactory::CreateMemTableRep;
   virtual MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator& cmp,
                                          bool needs_dup_key_check,
@@ -83,7 +116,8 @@ class MockMemTableRepFactory : public MemTableRepFactory {
     SkipListFactory factory;
     MemTableRep* skiplist_rep = factory.CreateMemTableRep(
         cmp, needs_dup_key_check, allocator, transform, logger);
-    mock_rep_ = new MockMemTableRep(allocator, skiplist_rep);
+    mock_rep_ = new MockMemTableRep(allocator, skiplist_rep, cmp.icomparator(),
+                                    batch_insert_);
     return mock_rep_;
   }
 
@@ -106,6 +140,7 @@ class MockMemTableRepFactory : public MemTableRepFactory {
   uint32_t GetLastColumnFamilyId() { return last_column_family_id_; }
 
  private:
+  bool batch_insert_;
   MockMemTableRep* mock_rep_;
   // workaround since there's no port::kMaxUint32 yet.
   uint32_t last_column_family_id_ = static_cast<uint32_t>(-1);
@@ -256,6 +291,202 @@ TEST_F(DBMemTableTest, InsertWithHint) {
   ASSERT_EQ("vvv", Get("whitelisted"));
 }
 
+TEST_F(DBMemTableTest, BatchInsert) {
+  Options options;
+  options.allow_concurrent_memtable_write = false;
+  options.create_if_missing = true;
+  options.memtable_factory.reset(new MockMemTableRepFactory(true));
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  options.max_successive_merges = 2;
+  options.env = env_;
+  Reopen(options);
+  MockMemTableRep* rep =
+      reinterpret_cast<MockMemTableRepFactory*>(options.memtable_factory.get())
+          ->rep();
+
+  // the entries of a write batch reach the rep at once, sorted
+  WriteBatch batch;
+  ASSERT_OK(batch.Put("k3", "v3"));
+  ASSERT_OK(batch.Put("k1", "v1"));
+  ASSERT_OK(batch.Delete("k2"));
+  ASSERT_OK(batch.Put("k2", "v2"));
+  ASSERT_OK(db_->Write(WriteOptions(), &batch));
+  ASSERT_EQ(1, rep->num_insert_batch());
+  ASSERT_EQ(4, rep->last_batch_count());
+  ASSERT_EQ("v1", Get("k1"));
+  ASSERT_EQ("v2", Get("k2"));
+  ASSERT_EQ("v3", Get("k3"));
+
+  // a single entry is added directly
+  ASSERT_OK(Put("k4", "v4"));
+  ASSERT_EQ(1, rep->num_insert_batch());
+
+  // merges see the entries buffered before them
+  batch.Clear();
+  ASSERT_OK(batch.Put("k5", "a"));
+  ASSERT_OK(batch.Put("k6", "v6"));
+  ASSERT_OK(batch.Merge("k5", "b"));
+  ASSERT_OK(batch.Merge("k5", "c"));
+  ASSERT_OK(batch.Put("k0", "v0"));
+  ASSERT_OK(db_->Write(WriteOptions(), &batch));
+  ASSERT_EQ(2, rep->num_insert_batch());
+  ASSERT_EQ("a,b,c", Get("k5"));
+  ASSERT_EQ("v6", Get("k6"));
+  ASSERT_EQ("v0", Get("k0"));
+
+  ASSERT_OK(Flush());
+  ASSERT_EQ("v1", Get("k1"));
+  ASSERT_EQ("a,b,c", Get("k5"));
+}
+
+TEST_F(DBMemTableTest, BatchInsertWithDeleteRange) {
+  std::vector<std::shared_ptr<MemTableRepFactory>> factories;
+  factories.emplace_back(new MockMemTableRepFactory(true));
+#ifdef WITH_TERARK_ZIP
+  factories.emplace_back(NewPatriciaTrieRepFactory());
+#endif
+  for (auto& factory : factories) {
+    Options options;
+    options.allow_concurrent_memtable_write = false;
+    options.create_if_missing = true;
+    options.memtable_factory = factory;
+    options.env = env_;
+    DestroyAndReopen(options);
+
+    ASSERT_OK(Put("a1", "old"));
+    ASSERT_OK(Put("b1", "old"));
+    // the range tombstone lands between point keys buffered for the rep
+    WriteBatch batch;
+    ASSERT_OK(batch.Put("a2", "v"));
+    ASSERT_OK(batch.Put("c1", "v"));
+    ASSERT_OK(batch.DeleteRange("a", "b5"));
+    ASSERT_OK(batch.Put("b2", "v"));
+    ASSERT_OK(batch.Delete("c1"));
+    ASSERT_OK(db_->Write(WriteOptions(), &batch));
+
+    for (int i = 0; i < 2; ++i) {
+      ASSERT_EQ("NOT_FOUND", Get("a1"));
+      ASSERT_EQ("NOT_FOUND", Get("a2"));
+      ASSERT_EQ("NOT_FOUND", Get("b1"));
+      ASSERT_EQ("v", Get("b2"));
+      ASSERT_EQ("NOT_FOUND", Get("c1"));
+      ASSERT_OK(Flush());
+    }
+  }
+}
+
+TEST_F(DBMemTableTest, FlatSortedRep) {
+  Options options;
+  options.allow_concurrent_memtable_write = true;
+  options.create_if_missing = true;
+  options.disable_auto_compactions = true;
+  options.max_write_buffer_number = 4;
+  options.memtable_factory.reset(new FlatSortedRepFactory(4));
+  options.env = env_;
+  Reopen(options);
+
+  // Enough entries for a parallel sort, sharing a prefix
+  const int kNumThreads = 4;
+  const int kNumKeys = 1 << 17;
+  auto key = [](int i) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%08d", i);
+    return std::string(buf);
+  };
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = t; i < kNumKeys; i += kNumThreads) {
+        ASSERT_OK(Put(key(i), "v" + ToString(i)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Put(key(7), "new"));
+  ASSERT_OK(Delete(key(8)));
+  ASSERT_OK(Put("a", "va"));
+
+  auto verify = [&] {
+    ASSERT_EQ("new", Get(key(7)));
+    ASSERT_EQ("v7", Get(key(7), snapshot));
+    ASSERT_EQ("NOT_FOUND", Get(key(8)));
+    ASSERT_EQ("v8", Get(key(8), snapshot));
+    ASSERT_EQ("va", Get("a"));
+    ASSERT_EQ("NOT_FOUND", Get("b"));
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ("a", iter->key().ToString());
+    int count = 0;
+    std::string prev;
+    for (iter->Next(); iter->Valid(); iter->Next()) {
+      ASSERT_LT(prev, iter->key().ToString());
+      prev = iter->key().ToString();
+      ++count;
+    }
+    ASSERT_EQ(kNumKeys - 1, count);
+    iter->SeekForPrev(key(8));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(key(7), iter->key().ToString());
+  };
+  // The mutable memtable is scanned
+  verify();
+  // The immutable memtable is sorted
+  ASSERT_OK(dbfull()->TEST_SwitchMemtable());
+  verify();
+  ASSERT_OK(Flush());
+  verify();
+  db_->ReleaseSnapshot(snapshot);
+}
+
+TEST_F(DBMemTableTest, FlatSortedRepReadWhileSorting) {
+  Options options;
+  options.create_if_missing = true;
+  options.disable_auto_compactions = true;
+  options.max_write_buffer_number = 4;
+  options.memtable_factory.reset(new FlatSortedRepFactory(4));
+  options.env = env_;
+  Reopen(options);
+
+  // Enough entries to sort in the background
+  const int kNumKeys = 1 << 17;
+  WriteBatch batch;
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(batch.Put("key" + ToString(i), "v"));
+  }
+  ASSERT_OK(db_->Write(WriteOptions(), &batch));
+
+  // Readers of the memtable being marked read only never miss a key
+  std::atomic<bool> stop(false);
+  std::atomic<int> misses(0);
+  std::vector<port::Thread> readers;
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&, t] {
+      Random rnd(301 + t);
+      while (!stop.load()) {
+        std::string value;
+        Status s = db_->Get(ReadOptions(),
+                            "key" + ToString(rnd.Uniform(kNumKeys)), &value);
+        if (!s.ok() || value != "v") {
+          misses.fetch_add(1);
+        }
+      }
+    });
+  }
+  env_->SleepForMicroseconds(10000);
+  ASSERT_OK(dbfull()->TEST_SwitchMemtable());
+  env_->SleepForMicroseconds(100000);
+  ASSERT_OK(Flush());
+  stop.store(true);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  ASSERT_EQ(0, misses.load());
+}
+
 TEST_F(DBMemTableTest, ColumnFamilyId) {
   // Verifies MemTableRepFactory is told the right column family id.
   Options options;
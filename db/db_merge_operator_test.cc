@@ -153,6 +153,99 @@ TEST_F(DBMergeOperatorTest, MergeErrorOnWrite) {
   VerifyDBInternal({{"k1", "corrupted"}, {"k1", "v2"}, {"k1", "v1"}});
 }
 
+TEST_F(DBMergeOperatorTest, CollapseMergeOperands) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.merge_operator = MergeOperators::CreateStringAppendOperator(',');
+  options.collapse_merge_operands = true;
+  options.disable_auto_compactions = true;
+  options.env = env_;
+  Reopen(options);
+
+  // The first operand of a key is kept, the following ones are folded into
+  // the entry in the memtable
+  ASSERT_OK(Merge("k1", "a"));
+  ASSERT_OK(Merge("k1", "b"));
+  ASSERT_OK(Merge("k1", "c"));
+  ASSERT_EQ("a,b,c", Get("k1"));
+  ASSERT_EQ("[ a,b,c, a,b, a ]", AllEntriesFor("k1"));
+  ASSERT_OK(Delete("k2"));
+  ASSERT_OK(Merge("k2", "x"));
+  ASSERT_EQ("x", Get("k2"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("[ a,b,c ]", AllEntriesFor("k1"));
+  ASSERT_EQ("[ x ]", AllEntriesFor("k2"));
+
+  // The operands of a flush are merged with the value in the SSTs
+  ASSERT_OK(Merge("k1", "d"));
+  ASSERT_OK(Merge("k3", "y"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("[ a,b,c,d, a,b,c ]", AllEntriesFor("k1"));
+  ASSERT_EQ("a,b,c,d", Get("k1"));
+  ASSERT_EQ("y", Get("k3"));
+
+  // Snapshots still read the values they were taken at
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Merge("k1", "e"));
+  ASSERT_OK(Merge("k3", "z"));
+  ASSERT_EQ("a,b,c,d,e", Get("k1"));
+  ASSERT_EQ("a,b,c,d", Get("k1", snapshot));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("a,b,c,d,e", Get("k1"));
+  ASSERT_EQ("a,b,c,d", Get("k1", snapshot));
+  ASSERT_EQ("y,z", Get("k3"));
+  ASSERT_EQ("y", Get("k3", snapshot));
+  db_->ReleaseSnapshot(snapshot);
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("[ a,b,c,d,e ]", AllEntriesFor("k1"));
+  ASSERT_EQ("[ y,z ]", AllEntriesFor("k3"));
+}
+
+TEST_F(DBMergeOperatorTest, CollapseMergeOperandsConcurrentWrites) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.merge_operator = MergeOperators::CreateStringAppendOperator(',');
+  options.collapse_merge_operands = true;
+  options.allow_concurrent_memtable_write = true;
+  options.disable_auto_compactions = true;
+  options.env = env_;
+  Reopen(options);
+
+  // Batches with merges are never inserted in parallel, the operands of
+  // every writer are folded into the newest entry of the key
+  const int kNumThreads = 4;
+  const int kNumMerges = 100;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < kNumMerges; ++i) {
+        ASSERT_OK(db_->Merge(WriteOptions(), "k", "x"));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  std::string expected = "x";
+  for (int i = 1; i < kNumThreads * kNumMerges; ++i) {
+    expected += ",x";
+  }
+  ASSERT_EQ(expected, Get("k"));
+  ASSERT_EQ(0, AllEntriesFor("k").find("[ " + expected + ", "));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("[ " + expected + " ]", AllEntriesFor("k"));
+
+  // A merge into a column family without merge operator is kept as is
+  options.merge_operator = nullptr;
+  DestroyAndReopen(options);
+  WriteBatch batch;
+  ASSERT_OK(batch.Put("k", "v"));
+  ASSERT_OK(batch.Merge("k", "x"));
+  ASSERT_OK(db_->Write(WriteOptions(), &batch));
+  ASSERT_EQ("[ x, v ]", AllEntriesFor("k"));
+}
+
 TEST_F(DBMergeOperatorTest, MergeErrorOnIteration) {
   Options options;
   options.create_if_missing = true;
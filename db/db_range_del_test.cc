@@ -1513,6 +1513,110 @@ TEST_F(DBRangeDelTest, RangeTombstoneWrittenToMinimalSsts) {
   ASSERT_EQ(1, num_range_deletions);
 }
 
+TEST_F(DBRangeDelTest, LazyCompactionDropsCoveredRanges) {
+  Options options = CurrentOptions();
+  options.enable_lazy_compaction = true;
+  DestroyAndReopen(options);
+
+  std::vector<std::string> deleted;
+  SyncPoint::GetInstance()->SetCallBack(
+      "LevelCompactionBuilder::PickLazyCompaction:DeletedRange",
+      [&](void* arg) {
+        auto deleted_range = static_cast<std::vector<SelectedRange>*>(arg);
+        for (auto& r : *deleted_range) {
+          deleted.emplace_back(r.start + "-" + r.limit);
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // The tombstone and the keys it covers are kept in different files, a
+  // compaction merging them while the snapshot is alive would leave them in
+  // one file, which is read to check the keys below the tombstone
+  ASSERT_OK(dbfull()->SetOptions({{"disable_auto_compactions", "true"}}));
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), "v" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(10), Key(90)));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+
+  // The snapshot still sees the covered keys
+  ASSERT_TRUE(deleted.empty());
+  ReadOptions read_opts;
+  read_opts.snapshot = snapshot;
+  std::string value;
+  ASSERT_OK(db_->Get(read_opts, Key(50), &value));
+  ASSERT_EQ("v50", value);
+  ASSERT_EQ("NOT_FOUND", Get(Key(50)));
+  db_->ReleaseSnapshot(snapshot);
+
+  ASSERT_OK(dbfull()->SetOptions({{"disable_auto_compactions", "false"}}));
+  ASSERT_OK(Put(Key(100), "v100"));
+  ASSERT_OK(Flush());
+  dbfull()->TEST_WaitForCompact();
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ(1, deleted.size());
+  ASSERT_EQ(Key(10) + "-" + Key(90), deleted[0]);
+  for (int i = 0; i <= 100; ++i) {
+    ASSERT_EQ(i < 10 || i >= 90 ? "v" + ToString(i) : "NOT_FOUND", Get(Key(i)));
+  }
+  // Tombstones are gone with the ranges they covered
+  auto cfd = static_cast<ColumnFamilyHandleImpl*>(db_->DefaultColumnFamily())
+                 ->cfd();
+  auto vstorage = cfd->current()->storage_info();
+  for (int i = 0; i < vstorage->num_levels(); ++i) {
+    ASSERT_FALSE(vstorage->has_range_deletion(i));
+  }
+}
+
+TEST_F(DBRangeDelTest, LazyCompactionKeepsIngestedPuts) {
+  Options options = CurrentOptions();
+  options.enable_lazy_compaction = true;
+  DestroyAndReopen(options);
+
+  std::vector<std::string> deleted;
+  SyncPoint::GetInstance()->SetCallBack(
+      "LevelCompactionBuilder::PickLazyCompaction:DeletedRange",
+      [&](void* arg) {
+        auto deleted_range = static_cast<std::vector<SelectedRange>*>(arg);
+        for (auto& r : *deleted_range) {
+          deleted.emplace_back(r.start + "-" + r.limit);
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // Every key of an ingested file gets the seqno of its range tombstone, the
+  // tombstone does not cover them
+  std::string file = dbname_ + "/ingested.sst";
+  SstFileWriter writer(EnvOptions(), options);
+  ASSERT_OK(writer.Open(file));
+  ASSERT_OK(writer.DeleteRange(Key(10), Key(90)));
+  for (int i = 20; i < 30; ++i) {
+    ASSERT_OK(writer.Put(Key(i), "v" + ToString(i)));
+  }
+  ASSERT_OK(writer.Finish());
+  ASSERT_OK(db_->IngestExternalFile({file}, IngestExternalFileOptions()));
+
+  ASSERT_OK(Put(Key(100), "v100"));
+  ASSERT_OK(Flush());
+  dbfull()->TEST_WaitForCompact();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_TRUE(deleted.empty());
+  for (int i = 20; i < 30; ++i) {
+    ASSERT_EQ("v" + ToString(i), Get(Key(i)));
+  }
+  ASSERT_EQ("v100", Get(Key(100)));
+}
+
 #endif  // ROCKSDB_LITE
 
 }  // namespace rocksdb
@@ -0,0 +1,242 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/db_test_util.h"
+#include "port/stack_trace.h"
+
+namespace rocksdb {
+
+#ifndef ROCKSDB_LITE
+class DBSecondaryTest : public DBTestBase {
+ public:
+  DBSecondaryTest()
+      : DBTestBase("/db_secondary_test"),
+        secondary_path_(test::PerThreadDBPath(env_, "/db_secondary_test_sec")),
+        db_secondary_(nullptr) {
+    env_->DeleteDir(secondary_path_);
+  }
+
+  ~DBSecondaryTest() {
+    CloseSecondary();
+    env_->DeleteDir(secondary_path_);
+  }
+
+ protected:
+  Status OpenSecondary(Options options) {
+    options.max_open_files = -1;
+    return DB::OpenAsSecondary(options, dbname_, secondary_path_,
+                               &db_secondary_);
+  }
+
+  void CloseSecondary() {
+    delete db_secondary_;
+    db_secondary_ = nullptr;
+  }
+
+  std::string GetSecondary(const std::string& key) {
+    std::string value;
+    Status s = db_secondary_->Get(ReadOptions(), key, &value);
+    if (s.IsNotFound()) {
+      return "NOT_FOUND";
+    }
+    if (!s.ok()) {
+      return s.ToString();
+    }
+    return value;
+  }
+
+  std::string IterateSecondary() {
+    std::string result;
+    std::unique_ptr<Iterator> iter(db_secondary_->NewIterator(ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      result += iter->key().ToString() + "=" + iter->value().ToString() + ";";
+    }
+    EXPECT_OK(iter->status());
+    return result;
+  }
+
+  std::string secondary_path_;
+  DB* db_secondary_;
+};
+
+TEST_F(DBSecondaryTest, OpenAsSecondary) {
+  Options options = CurrentOptions();
+  options.env = env_;
+  Reopen(options);
+  ASSERT_OK(Put("a", "va"));
+  ASSERT_OK(Put("b", "vb"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("b", "vb2"));
+  ASSERT_OK(Put("c", "vc"));
+
+  ASSERT_OK(OpenSecondary(options));
+  ASSERT_EQ("va", GetSecondary("a"));
+  ASSERT_EQ("vb2", GetSecondary("b"));
+  ASSERT_EQ("vc", GetSecondary("c"));
+  ASSERT_EQ("a=va;b=vb2;c=vc;", IterateSecondary());
+
+  ASSERT_TRUE(db_secondary_->Put(WriteOptions(), "d", "vd").IsNotSupported());
+  ASSERT_TRUE(db_->TryCatchUpWithPrimary().IsNotSupported());
+}
+
+TEST_F(DBSecondaryTest, MaxOpenFilesMustBeUnlimited) {
+  Options options = CurrentOptions();
+  options.env = env_;
+  Reopen(options);
+  options.max_open_files = 100;
+  ASSERT_TRUE(DB::OpenAsSecondary(options, dbname_, secondary_path_,
+                                  &db_secondary_)
+                  .IsInvalidArgument());
+  ASSERT_EQ(nullptr, db_secondary_);
+}
+
+TEST_F(DBSecondaryTest, CatchUpWithPrimary) {
+  Options options = CurrentOptions();
+  options.env = env_;
+  options.disable_auto_compactions = true;
+  Reopen(options);
+  ASSERT_OK(Put("a", "va"));
+  ASSERT_OK(OpenSecondary(options));
+
+  // Records appended to the WAL the secondary is already tailing
+  ASSERT_OK(Put("b", "vb"));
+  ASSERT_EQ("NOT_FOUND", GetSecondary("b"));
+  ASSERT_OK(db_secondary_->TryCatchUpWithPrimary());
+  ASSERT_EQ("vb", GetSecondary("b"));
+
+  // An iterator keeps the data of its creation
+  std::unique_ptr<Iterator> iter(db_secondary_->NewIterator(ReadOptions()));
+
+  // Flushes switch to new WALs, the flushed memtables are dropped
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("a", "va2"));
+  ASSERT_OK(Delete("b"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("c", "vc"));
+  ASSERT_OK(db_secondary_->TryCatchUpWithPrimary());
+  ASSERT_EQ("va2", GetSecondary("a"));
+  ASSERT_EQ("NOT_FOUND", GetSecondary("b"));
+  ASSERT_EQ("vc", GetSecondary("c"));
+  ASSERT_EQ("a=va2;c=vc;", IterateSecondary());
+
+  // The files replaced by the compaction are deleted by the primary, only
+  // the secondary may still hold them open
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_OK(db_secondary_->TryCatchUpWithPrimary());
+  ASSERT_EQ("a=va2;c=vc;", IterateSecondary());
+
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ++count;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(2, count);
+  iter.reset();
+
+  // Nothing new
+  ASSERT_OK(db_secondary_->TryCatchUpWithPrimary());
+  ASSERT_EQ("a=va2;c=vc;", IterateSecondary());
+}
+
+TEST_F(DBSecondaryTest, CatchUpWithRecycledLog) {
+  Options options = CurrentOptions();
+  options.env = env_;
+  options.disable_auto_compactions = true;
+  options.recycle_log_file_num = 1;
+  Reopen(options);
+  // Fill a WAL with records that stay in the file once it is recycled
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put("old" + ToString(i), std::string(1000, 'v')));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("a", "va"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("b", "vb"));
+  ASSERT_OK(OpenSecondary(options));
+  ASSERT_EQ("vb", GetSecondary("b"));
+
+  // The secondary stops at the records of the previous instance of the log,
+  // and reads what the primary writes over them later
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK(Put("c" + ToString(i), std::string(100, 'c')));
+    ASSERT_OK(db_secondary_->TryCatchUpWithPrimary());
+    ASSERT_EQ(std::string(100, 'c'), GetSecondary("c" + ToString(i)));
+  }
+  ASSERT_OK(Delete("old0"));
+  ASSERT_OK(db_secondary_->TryCatchUpWithPrimary());
+  ASSERT_EQ("NOT_FOUND", GetSecondary("old0"));
+  ASSERT_EQ("va", GetSecondary("a"));
+  ASSERT_EQ("vb", GetSecondary("b"));
+}
+
+TEST_F(DBSecondaryTest, SwitchManifest) {
+  Options options = CurrentOptions();
+  options.env = env_;
+  options.disable_auto_compactions = true;
+  Reopen(options);
+  ASSERT_OK(Put("a", "va"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(OpenSecondary(options));
+  ASSERT_EQ("va", GetSecondary("a"));
+
+  // Every reopen of the primary writes a new MANIFEST
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK(Put("k" + ToString(i), "v" + ToString(i)));
+    ASSERT_OK(Flush());
+    Reopen(options);
+  }
+  ASSERT_OK(Put("a", "va2"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_secondary_->TryCatchUpWithPrimary());
+  ASSERT_EQ("a=va2;k0=v0;k1=v1;k2=v2;", IterateSecondary());
+}
+
+TEST_F(DBSecondaryTest, ColumnFamilies) {
+  Options options = CurrentOptions();
+  options.env = env_;
+  CreateAndReopenWithCF({"pikachu", "eevee"}, options);
+  ASSERT_OK(Put(1, "a", "va1"));
+  ASSERT_OK(Put(2, "a", "va2"));
+  ASSERT_OK(Flush(1));
+
+  // Only a subset of the column families is opened
+  std::vector<ColumnFamilyDescriptor> column_families;
+  column_families.emplace_back(kDefaultColumnFamilyName, options);
+  column_families.emplace_back("pikachu", options);
+  DBOptions db_options(options);
+  db_options.max_open_files = -1;
+  std::vector<ColumnFamilyHandle*> handles;
+  ASSERT_OK(DB::OpenAsSecondary(db_options, dbname_, secondary_path_,
+                                column_families, &handles, &db_secondary_));
+  ASSERT_EQ(2, handles.size());
+  std::string value;
+  ASSERT_OK(db_secondary_->Get(ReadOptions(), handles[1], "a", &value));
+  ASSERT_EQ("va1", value);
+
+  ASSERT_OK(Put(1, "b", "vb1"));
+  ASSERT_OK(Put(2, "b", "vb2"));
+  ASSERT_OK(Flush(2));
+  ASSERT_OK(db_secondary_->TryCatchUpWithPrimary());
+  ASSERT_OK(db_secondary_->Get(ReadOptions(), handles[1], "b", &value));
+  ASSERT_EQ("vb1", value);
+  ASSERT_TRUE(db_secondary_->DropColumnFamily(handles[1]).IsNotSupported());
+
+  for (auto h : handles) {
+    delete h;
+  }
+}
+#endif  // !ROCKSDB_LITE
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  rocksdb::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
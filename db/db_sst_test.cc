@@ -823,6 +823,61 @@ TEST_F(DBSSTTest, OpenDBWithInfiniteMaxOpenFiles) {
   }
 }
 
+TEST_F(DBSSTTest, LazyOpenTableFiles) {
+  Options options;
+  options.create_if_missing = true;
+  options.disable_auto_compactions = true;
+  options.max_open_files = -1;
+  options.lazy_open_table_files = true;
+  options.statistics = rocksdb::CreateDBStatistics();
+  options = CurrentOptions(options);
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 6; i++) {
+    ASSERT_OK(Put(Key(i), "v" + Key(i)));
+    ASSERT_OK(Flush());
+  }
+  MoveFilesToLevel(2);
+  for (int i = 6; i < 12; i++) {
+    ASSERT_OK(Put(Key(i), "v" + Key(i)));
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ("6,0,6", FilesPerLevel(0));
+  Close();
+
+  rocksdb::SyncPoint::GetInstance()->LoadDependency(
+      {{"DBSSTTest::LazyOpenTableFiles:Opened",
+        "DBImpl::BGWorkTableWarmUp:start"},
+       {"DBImpl::BGWorkTableWarmUp:end",
+        "DBSSTTest::LazyOpenTableFiles:WarmedUp"}});
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  // Nothing is opened by DB::Open(), a read opens the file it needs
+  Reopen(options);
+  std::vector<std::vector<FileMetaData>> files;
+  dbfull()->TEST_GetFilesMetaData(db_->DefaultColumnFamily(), &files);
+  for (const auto& level : files) {
+    for (const auto& file : level) {
+      ASSERT_TRUE(file.table_reader_handle == nullptr);
+    }
+  }
+  uint64_t num_opens = TestGetTickerCount(options, NO_FILE_OPENS);
+  ASSERT_EQ("v" + Key(11), Get(Key(11)));
+  ASSERT_EQ(num_opens + 1, TestGetTickerCount(options, NO_FILE_OPENS));
+
+  // The background job opens all the others
+  TEST_SYNC_POINT("DBSSTTest::LazyOpenTableFiles:Opened");
+  TEST_SYNC_POINT("DBSSTTest::LazyOpenTableFiles:WarmedUp");
+  ASSERT_EQ(num_opens + 12, TestGetTickerCount(options, NO_FILE_OPENS));
+  for (int i = 0; i < 12; i++) {
+    ASSERT_EQ("v" + Key(i), Get(Key(i)));
+  }
+  ASSERT_EQ(num_opens + 12, TestGetTickerCount(options, NO_FILE_OPENS));
+
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(DBSSTTest, GetTotalSstFilesSize) {
   // We don't propagate oldest-key-time table property on compaction and
   // just write 0 as default value. This affect the exact table size, since
@@ -182,6 +182,61 @@ TEST_F(ExternalSSTFileBasicTest, Basic) {
   DestroyAndRecreateExternalSSTFilesDir();
 }
 
+TEST_F(ExternalSSTFileBasicTest, IngestFileWithBlob) {
+  Options options = CurrentOptions();
+  options.blob_size = 64;
+  options.target_file_size_base = 16 << 10;
+  DestroyAndReopen(options);
+  // Overlapping key forces a global seqno, that the blob ssts must share
+  ASSERT_OK(Put(Key(50), "old"));
+  ASSERT_OK(Flush());
+
+  auto value_of = [](int k) {
+    return k % 2 == 0 ? std::string(200, 'a' + k % 26) : Key(k) + "_val";
+  };
+  SstFileWriter sst_file_writer(EnvOptions(), options);
+  std::string file1 = sst_files_dir_ + "file1.sst";
+  ASSERT_OK(sst_file_writer.OpenWithBlob(file1));
+  for (int k = 0; k < 300; k++) {
+    ASSERT_OK(sst_file_writer.Put(Key(k), value_of(k)));
+  }
+  ExternalSstFileInfo file1_info;
+  ASSERT_OK(sst_file_writer.Finish(&file1_info));
+  ASSERT_EQ(file1_info.num_entries, 300);
+  ASSERT_GE(file1_info.blob_file_paths.size(), 2);
+
+  // The key sst can't be ingested without its blob ssts
+  IngestExternalFileOptions ifo;
+  ASSERT_NOK(db_->IngestExternalFile({file1}, ifo));
+  ASSERT_NOK(db_->IngestExternalFile(file1_info.blob_file_paths, ifo));
+
+  std::vector<std::string> files = file1_info.blob_file_paths;
+  files.push_back(file1);
+  ASSERT_OK(db_->IngestExternalFile(files, ifo));
+  ASSERT_EQ(db_->GetLatestSequenceNumber(), 2U);
+
+  auto verify = [&] {
+    for (int k = 0; k < 300; k++) {
+      ASSERT_EQ(Get(Key(k)), value_of(k));
+    }
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    int k = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), k++) {
+      ASSERT_EQ(iter->key(), Key(k));
+      ASSERT_EQ(iter->value(), value_of(k));
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(k, 300);
+  };
+  verify();
+  Reopen(options);
+  verify();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  verify();
+
+  DestroyAndRecreateExternalSSTFilesDir();
+}
+
 TEST_F(ExternalSSTFileBasicTest, NoCopy) {
   Options options = CurrentOptions();
   const ImmutableCFOptions ioptions(options);
@@ -15,6 +15,7 @@
 
 #include <algorithm>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "db/version_edit.h"
@@ -54,15 +55,52 @@ Status ExternalSstFileIngestionJob::Prepare(
     }
   }
 
+  // Every blob sst must hold the separated values of exactly one of the
+  // other files, blob ssts go to level -1 and don't take part in the key
+  // range checks
+  std::unordered_map<uint64_t, size_t> blob_files;
+  for (size_t i = 0; i < files_to_ingest_.size(); i++) {
+    if (files_to_ingest_[i].is_blob) {
+      for (auto file_number :
+           files_to_ingest_[i].table_properties.inheritance_chain) {
+        if (!blob_files.emplace(file_number, i).second) {
+          return Status::InvalidArgument("Duplicate external blob file");
+        }
+      }
+    }
+  }
+  for (size_t i = 0; i < files_to_ingest_.size(); i++) {
+    if (files_to_ingest_[i].is_blob) {
+      continue;
+    }
+    for (auto& dependence : files_to_ingest_[i].table_properties.dependence) {
+      auto find = blob_files.find(dependence.file_number);
+      if (find == blob_files.end()) {
+        return Status::InvalidArgument(
+            "Blob file of external file is missing",
+            files_to_ingest_[i].external_file_path);
+      }
+      files_to_ingest_[find->second].depended_by = i;
+      blob_files.erase(find);
+    }
+  }
+  if (!blob_files.empty()) {
+    return Status::InvalidArgument("External blob file is not used");
+  }
+
   const Comparator* ucmp = cfd_->internal_comparator().user_comparator();
-  auto num_files = files_to_ingest_.size();
+  size_t num_files = static_cast<size_t>(
+      std::count_if(files_to_ingest_.begin(), files_to_ingest_.end(),
+                    [](const IngestedFileInfo& f) { return !f.is_blob; }));
   if (num_files == 0) {
     return Status::InvalidArgument("The list of files is empty");
   } else if (num_files > 1) {
     // Verify that passed files dont have overlapping ranges
     autovector<const IngestedFileInfo*> sorted_files;
-    for (size_t i = 0; i < num_files; i++) {
-      sorted_files.push_back(&files_to_ingest_[i]);
+    for (size_t i = 0; i < files_to_ingest_.size(); i++) {
+      if (!files_to_ingest_[i].is_blob) {
+        sorted_files.push_back(&files_to_ingest_[i]);
+      }
     }
     std::sort(sorted_files.begin(), sorted_files.end(),
               TERARK_FIELD_P(smallest_user_key) < *ucmp);
@@ -138,6 +176,9 @@ Status ExternalSstFileIngestionJob::NeedsFlush(bool* flush_needed,
                                                SuperVersion* super_version) {
   autovector<Range> ranges;
   for (const IngestedFileInfo& file_to_ingest : files_to_ingest_) {
+    if (file_to_ingest.is_blob) {
+      continue;
+    }
     ranges.emplace_back(file_to_ingest.smallest_user_key,
                         file_to_ingest.largest_user_key);
   }
@@ -178,6 +219,9 @@ Status ExternalSstFileIngestionJob::Run() {
   // The levels that the files will be ingested into
 
   for (IngestedFileInfo& f : files_to_ingest_) {
+    if (f.is_blob) {
+      continue;
+    }
     SequenceNumber assigned_seqno = 0;
     if (ingestion_options_.ingest_behind) {
       status = CheckLevelForIngestedBehindFile(&f);
@@ -206,12 +250,41 @@ Status ExternalSstFileIngestionJob::Run() {
     prop.flags |= f.table_properties.num_range_deletions > 0
                       ? 0
                       : TablePropertyCache::kNoRangeDeletions;
+    prop.dependence = f.table_properties.dependence;
     edit_.AddFile(f.picked_level, f.fd.GetNumber(), f.fd.GetPathId(),
                   f.fd.GetFileSize(), f.smallest_internal_key(),
                   f.largest_internal_key(), f.assigned_seqno, f.assigned_seqno,
                   ingestion_options_.marked_for_compaction, prop);
   }
 
+  // Blob ssts are linked into level -1 in the same edit as the files
+  // depending on them
+  auto& dependence_map = cfd_->current()->storage_info()->dependence_map();
+  for (IngestedFileInfo& f : files_to_ingest_) {
+    if (!f.is_blob) {
+      continue;
+    }
+    for (auto file_number : f.table_properties.inheritance_chain) {
+      if (dependence_map.count(file_number) > 0) {
+        return Status::InvalidArgument(
+            "External blob file number conflicts with an existing file",
+            f.external_file_path);
+      }
+    }
+    // A separated value is read with the sequence number of its key
+    f.picked_level = -1;
+    f.assigned_seqno = files_to_ingest_[f.depended_by].assigned_seqno;
+    TablePropertyCache prop;
+    prop.num_entries = f.table_properties.num_entries;
+    prop.raw_key_size = f.table_properties.raw_key_size;
+    prop.raw_value_size = f.table_properties.raw_value_size;
+    prop.flags |= TablePropertyCache::kNoRangeDeletions;
+    prop.inheritance_chain = f.table_properties.inheritance_chain;
+    edit_.AddFile(-1, f.fd.GetNumber(), f.fd.GetPathId(), f.fd.GetFileSize(),
+                  f.smallest_internal_key(), f.largest_internal_key(),
+                  f.assigned_seqno, f.assigned_seqno, false, prop);
+  }
+
   if (consumed_seqno) {
     versions_->SetLastAllocatedSequence(last_seqno + 1);
     versions_->SetLastPublishedSequence(last_seqno + 1);
@@ -240,7 +313,11 @@ void ExternalSstFileIngestionJob::UpdateStats() {
       stats.bytes_moved = f.fd.GetFileSize();
     }
     stats.num_output_files = 1;
-    cfd_->internal_stats()->AddCompactionStats(f.picked_level, stats);
+    // Blob ssts are accounted to the level of the file depending on them
+    cfd_->internal_stats()->AddCompactionStats(
+        f.is_blob ? files_to_ingest_[f.depended_by].picked_level
+                  : f.picked_level,
+        stats);
     cfd_->internal_stats()->AddCFStats(InternalStats::BYTES_INGESTED_ADD_FILE,
                                        f.fd.GetFileSize());
     total_keys += f.num_entries;
@@ -421,6 +498,7 @@ Status ExternalSstFileIngestionJob::GetIngestedFileInfo(
   file_to_ingest->cf_id = static_cast<uint32_t>(props->column_family_id);
 
   file_to_ingest->table_properties = *props;
+  file_to_ingest->is_blob = !props->inheritance_chain.empty();
 
   return status;
 }
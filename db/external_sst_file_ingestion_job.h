@@ -50,6 +50,11 @@ struct IngestedFileInfo {
   SequenceNumber assigned_seqno = 0;
   // Level inside the DB we picked for the external file.
   int picked_level = 0;
+  // Whether this is a blob sst written by SstFileWriter::OpenWithBlob(),
+  // its inheritance chain holds the numbers the value indexes refer to
+  bool is_blob = false;
+  // For a blob sst, index of the ingested file whose values it holds
+  size_t depended_by = 0;
   // Whether to copy or link the external sst file. copy_file will be set to
   // false if ingestion_options.move_files is true and underlying FS
   // supports link operation. Need to provide a default value to make the
@@ -35,6 +35,7 @@
 #include "port/port.h"
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
+#include "rocksdb/merge_operator.h"
 #include "rocksdb/statistics.h"
 #include "rocksdb/status.h"
 #include "rocksdb/table.h"
@@ -51,6 +52,7 @@
 #include "util/log_buffer.h"
 #include "util/logging.h"
 #include "util/mutexlock.h"
+#include "util/rate_limiter.h"
 #include "util/stop_watch.h"
 #include "util/sync_point.h"
 
@@ -125,6 +127,7 @@ FlushJob::FlushJob(
       flush_load_(flush_load),
       edit_(nullptr),
       base_(nullptr),
+      collapse_merge_operands_(false),
       pick_memtable_called(false) {
   // Update the thread status to indicate flush.
   ReportStartedFlush();
@@ -188,6 +191,15 @@ void FlushJob::PickMemTable() {
 
   base_ = cfd_->current();
   base_->Ref();  // it is likely that we do not need this reference
+
+  // base_ holds everything beneath the picked memtables only if no older
+  // memtable is left unflushed, nor may older data be ingested behind
+  auto merge_operator = cfd_->ioptions()->merge_operator;
+  collapse_merge_operands_ =
+      mutable_cf_options_.collapse_merge_operands &&
+      merge_operator != nullptr && merge_operator->IsAssociative() &&
+      !db_options_.allow_ingest_behind &&
+      m->GetID() == cfd_->imm()->GetEarliestMemTableID();
 }
 
 Status FlushJob::Run(LogsWithPrepTracker* prep_tracker) {
@@ -195,6 +207,7 @@ Status FlushJob::Run(LogsWithPrepTracker* prep_tracker) {
   db_mutex_->AssertHeld();
   assert(pick_memtable_called);
   AutoThreadOperationStageUpdater stage_run(ThreadStatus::STAGE_FLUSH_RUN);
+  IOClassGuard io_class_guard(RateLimiter::IOClass::kFlush);
   if (mems_.empty()) {
     ROCKS_LOG_BUFFER(log_buffer_, "[%s] Nothing in memtable to flush",
                      cfd_->GetName().c_str());
@@ -370,6 +383,23 @@ Status FlushJob::WriteLevel0Table() {
         }
         return range_del_iters;
       };
+      auto get_base_value = [&](const Slice& user_key, LazyBuffer* value) {
+        LookupKey lkey(user_key, kMaxSequenceNumber);
+        MergeContext merge_context;
+        SequenceNumber max_covering_tombstone_seq = 0;
+        Status get_s;
+        base_->Get(ReadOptions(), user_key, lkey, value, &get_s,
+                   &merge_context, &max_covering_tombstone_seq);
+        if (get_s.ok()) {
+          get_s = value->fetch();
+        }
+        return get_s;
+      };
+      Status (*get_base_value_callback)(void*, const Slice&, LazyBuffer*) =
+          nullptr;
+      if (collapse_merge_operands_) {
+        get_base_value_callback = c_style_callback(get_base_value);
+      }
       s = BuildTable(
           dbname_, versions_, db_options_.env, *cfd_->ioptions(),
           mutable_cf_options_, env_options_, cfd_->table_cache(),
@@ -382,7 +412,8 @@ Status FlushJob::WriteLevel0Table() {
           mutable_cf_options_.paranoid_file_checks, cfd_->internal_stats(),
           TableFileCreationReason::kFlush, event_logger_, job_context_->job_id,
           Env::IO_HIGH, &table_properties_, 0 /* level */, flush_load_,
-          current_time, oldest_key_time, write_hint);
+          current_time, oldest_key_time, write_hint, get_base_value_callback,
+          &get_base_value);
       LogFlush(db_options_.info_log);
     }
     ROCKS_LOG_INFO(db_options_.info_log,
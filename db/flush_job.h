@@ -141,6 +141,9 @@ class FlushJob {
   autovector<MemTable*> mems_;
   VersionEdit* edit_;
   Version* base_;
+  // Merge operands are merged with the values in base_, see
+  // ColumnFamilyOptions::collapse_merge_operands
+  bool collapse_merge_operands_;
   bool pick_memtable_called;
 };
 
@@ -0,0 +1,116 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/hot_key_cache.h"
+
+#include <algorithm>
+
+#include "monitoring/statistics.h"
+#include "util/coding.h"
+#include "util/hash.h"
+
+namespace rocksdb {
+
+namespace {
+
+struct HotKeyEntry {
+  SequenceNumber seq;
+  uint64_t epoch;
+  std::string value;
+};
+
+void DeleteHotKeyEntry(const Slice& /*key*/, void* value) {
+  delete reinterpret_cast<HotKeyEntry*>(value);
+}
+
+void UpdateMax(std::atomic<SequenceNumber>* seq, SequenceNumber new_seq) {
+  SequenceNumber curr = seq->load(std::memory_order_relaxed);
+  while (curr < new_seq &&
+         !seq->compare_exchange_weak(curr, new_seq,
+                                     std::memory_order_acq_rel)) {
+  }
+}
+
+}  // namespace
+
+HotKeyCache::HotKeyCache(std::shared_ptr<Cache> cache)
+    : cache_(std::move(cache)),
+      stripes_(new std::atomic<SequenceNumber>[kNumStripes]),
+      invalidate_all_seq_(0),
+      epoch_(0) {
+  // If the same cache is shared by multiple instances, we need to
+  // disambiguate its entries.
+  PutVarint64(&cache_id_, cache_->NewId());
+  for (size_t i = 0; i < kNumStripes; ++i) {
+    stripes_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+std::atomic<SequenceNumber>& HotKeyCache::Stripe(uint32_t cf_id,
+                                                 const Slice& user_key) {
+  return stripes_[Hash(user_key.data(), user_key.size(), cf_id) &
+                  (kNumStripes - 1)];
+}
+
+SequenceNumber HotKeyCache::LastWrite(uint32_t cf_id, const Slice& user_key) {
+  return std::max(Stripe(cf_id, user_key).load(std::memory_order_acquire),
+                  invalidate_all_seq_.load(std::memory_order_acquire));
+}
+
+void HotKeyCache::MakeKey(uint32_t cf_id, const Slice& user_key,
+                          std::string* key) const {
+  key->reserve(cache_id_.size() + sizeof(uint32_t) + user_key.size());
+  key->assign(cache_id_);
+  PutFixed32(key, cf_id);
+  key->append(user_key.data(), user_key.size());
+}
+
+bool HotKeyCache::Lookup(uint32_t cf_id, const Slice& user_key,
+                         SequenceNumber snapshot, LazyBuffer* value,
+                         Statistics* stats) {
+  std::string key;
+  MakeKey(cf_id, user_key, &key);
+  auto handle = cache_->Lookup(key);
+  bool found = false;
+  if (handle != nullptr) {
+    auto entry = reinterpret_cast<HotKeyEntry*>(cache_->Value(handle));
+    // The value is unchanged from the last write up to the entry, a
+    // snapshot in that range reads the same value
+    SequenceNumber last_write = LastWrite(cf_id, user_key);
+    if (last_write <= entry->seq && last_write <= snapshot &&
+        entry->epoch == Epoch()) {
+      value->reset(entry->value, true);
+      found = true;
+    }
+    cache_->Release(handle);
+  }
+  RecordTick(stats, found ? HOT_KEY_CACHE_HIT : HOT_KEY_CACHE_MISS);
+  return found;
+}
+
+void HotKeyCache::Insert(uint32_t cf_id, const Slice& user_key,
+                         SequenceNumber snapshot, uint64_t epoch,
+                         const Slice& value) {
+  if (LastWrite(cf_id, user_key) > snapshot || epoch != Epoch()) {
+    // Stale already
+    return;
+  }
+  std::string key;
+  MakeKey(cf_id, user_key, &key);
+  auto entry = new HotKeyEntry{snapshot, epoch, value.ToString()};
+  size_t charge = sizeof(HotKeyEntry) + key.size() + value.size();
+  cache_->Insert(key, entry, charge, &DeleteHotKeyEntry);
+}
+
+void HotKeyCache::Invalidate(uint32_t cf_id, const Slice& user_key,
+                             SequenceNumber seq) {
+  UpdateMax(&Stripe(cf_id, user_key), seq);
+}
+
+void HotKeyCache::InvalidateAll(SequenceNumber seq) {
+  UpdateMax(&invalidate_all_seq_, seq);
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,82 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "rocksdb/cache.h"
+#include "rocksdb/lazy_buffer.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/types.h"
+
+namespace rocksdb {
+
+class Statistics;
+
+// A DB wide cache of the values returned by Get(), keyed by
+// <column family id, user key>. Unlike the row cache of TableCache, the
+// entries do not depend on the SST holding the key, so they survive flushes
+// and compactions.
+//
+// An entry remembers the sequence number of the snapshot it was read from.
+// Every write bumps the sequence number of the stripe its key hashes to in
+// the memtable insert path, before the write becomes visible. An entry is
+// only served to a snapshot no earlier than the last write of its stripe,
+// and only if that write is not newer than the entry itself, which makes
+// the lookups safe against racing writes without any erase. Range deletions
+// do the same for all the keys. Changes not going through the memtable
+// (ingestion, file deletion) bump the epoch of the cache, the entries read
+// before are dropped.
+//
+// All methods are thread safe.
+class HotKeyCache {
+ public:
+  explicit HotKeyCache(std::shared_ptr<Cache> cache);
+
+  // Readers take the epoch before acquiring the SuperVersion they read from.
+  uint64_t Epoch() const { return epoch_.load(std::memory_order_acquire); }
+
+  // Return true and fill value if the value of user_key in column family
+  // cf_id is cached and still valid for snapshot.
+  bool Lookup(uint32_t cf_id, const Slice& user_key, SequenceNumber snapshot,
+              LazyBuffer* value, Statistics* stats);
+
+  // Cache the value of user_key in column family cf_id read from snapshot,
+  // epoch is taken before the read.
+  void Insert(uint32_t cf_id, const Slice& user_key, SequenceNumber snapshot,
+              uint64_t epoch, const Slice& value);
+
+  // user_key is written at seq in column family cf_id.
+  void Invalidate(uint32_t cf_id, const Slice& user_key, SequenceNumber seq);
+
+  // Anything may be written at seq.
+  void InvalidateAll(SequenceNumber seq);
+
+  // Drop every entry. Called after a change not going through the memtable
+  // is installed.
+  void BumpEpoch() { epoch_.fetch_add(1, std::memory_order_acq_rel); }
+
+ private:
+  static const size_t kNumStripes = 1 << 16;
+
+  std::atomic<SequenceNumber>& Stripe(uint32_t cf_id, const Slice& user_key);
+
+  // The sequence number of the last write which may have changed user_key
+  SequenceNumber LastWrite(uint32_t cf_id, const Slice& user_key);
+
+  void MakeKey(uint32_t cf_id, const Slice& user_key, std::string* key) const;
+
+  std::shared_ptr<Cache> cache_;
+  std::string cache_id_;
+  std::unique_ptr<std::atomic<SequenceNumber>[]> stripes_;
+  std::atomic<SequenceNumber> invalidate_all_seq_;
+  std::atomic<uint64_t> epoch_;
+};
+
+}  // namespace rocksdb
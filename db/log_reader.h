@@ -55,14 +55,14 @@ class Reader {
          std::unique_ptr<SequentialFileReader>&& file, Reporter* reporter,
          bool checksum, uint64_t log_num, bool retry_after_eof);
 
-  ~Reader();
+  virtual ~Reader();
 
   // Read the next record into *record.  Returns true if read
   // successfully, false if we hit end of the input.  May use
   // "*scratch" as temporary storage.  The contents filled in *record
   // will only be valid until the next mutating operation on this
   // reader or the next mutation to *scratch.
-  bool ReadRecord(Slice* record, std::string* scratch,
+  virtual bool ReadRecord(Slice* record, std::string* scratch,
                   WALRecoveryMode wal_recovery_mode =
                       WALRecoveryMode::kTolerateCorruptedTailRecords);
 
@@ -81,11 +81,11 @@ class Reader {
   // Also aligns the file position indicator to the start of the next block
   // by reading the rest of the data from the EOF position to the end of the
   // block that was partially read.
-  void UnmarkEOF();
+  virtual void UnmarkEOF();
 
   SequentialFileReader* file() { return file_.get(); }
 
- private:
+ protected:
   std::shared_ptr<Logger> info_log_;
   const std::unique_ptr<SequentialFileReader> file_;
   Reporter* const reporter_;
@@ -139,15 +139,62 @@ class Reader {
   // Read some more
   bool ReadMore(size_t* drop_size, int *error);
 
+  // Read the rest of the block the EOF was hit in
+  void UnmarkEOFInternal();
+
   // Reports dropped bytes to the reporter.
   // buffer_ must be updated to remove the dropped bytes prior to invocation.
   void ReportCorruption(size_t bytes, const char* reason);
   void ReportDrop(size_t bytes, const Status& reason);
 
+ private:
   // No copying allowed
   Reader(const Reader&);
   void operator=(const Reader&);
 };
 
+// A reader following a log file that is still being appended to. Unlike
+// Reader, hitting EOF in the middle of a record is not an error: the
+// fragments read so far are kept and ReadRecord() resumes from them on the
+// next call, once the writer has appended the rest. ReadRecord() never blocks
+// waiting for more data.
+class FragmentBufferedReader : public Reader {
+ public:
+  FragmentBufferedReader(std::shared_ptr<Logger> info_log,
+                         std::unique_ptr<SequentialFileReader>&& file,
+                         Reporter* reporter, bool checksum, uint64_t log_num)
+      : Reader(info_log, std::move(file), reporter, checksum, log_num,
+               false /* retry_after_eof */),
+        in_fragmented_record_(false) {}
+
+  // `wal_recovery_mode` is ignored, trailing incomplete records are always
+  // tolerated
+  virtual bool ReadRecord(Slice* record, std::string* scratch,
+                          WALRecoveryMode wal_recovery_mode =
+                              WALRecoveryMode::kTolerateCorruptedTailRecords)
+      override;
+
+  virtual void UnmarkEOF() override;
+
+  // A recycled log holds records of its previous instance past the last one
+  // written, ReadRecord() stops there. The bytes buffered from that point are
+  // stale, so the file has to be reopened to read what is written later.
+  bool IsOldRecordReached() const { return old_record_reached_; }
+
+ private:
+  // Returns false if no complete physical record is available yet, or on
+  // a read error, which is returned in *fragment_type_or_err
+  bool TryReadFragment(Slice* fragment, size_t* drop_size,
+                       unsigned int* fragment_type_or_err);
+
+  // Returns false on a read error
+  bool TryReadMore(size_t* drop_size, int* error);
+
+  std::string fragments_;
+  bool in_fragmented_record_;
+  uint64_t prospective_record_offset_ = 0;
+  bool old_record_reached_ = false;
+};
+
 }  // namespace log
 }  // namespace rocksdb
@@ -54,6 +54,7 @@ ImmutableMemTableOptions::ImmutableMemTableOptions(
       inplace_update_num_locks(mutable_cf_options.inplace_update_num_locks),
       inplace_callback(ioptions.inplace_callback),
       max_successive_merges(mutable_cf_options.max_successive_merges),
+      collapse_merge_operands(mutable_cf_options.collapse_merge_operands),
       statistics(ioptions.statistics),
       merge_operator(ioptions.merge_operator),
       info_log(ioptions.info_log) {}
@@ -63,7 +64,8 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
                    const MutableCFOptions& mutable_cf_options,
                    bool needs_dup_key_check,
                    WriteBufferManager* write_buffer_manager,
-                   SequenceNumber latest_seq, uint32_t column_family_id)
+                   SequenceNumber latest_seq, uint32_t column_family_id,
+                   int numa_node)
     : comparator_(cmp),
       moptions_(ioptions, mutable_cf_options),
       refs_(0),
@@ -75,11 +77,10 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
                write_buffer_manager->cost_to_cache()))
                  ? &mem_tracker_
                  : nullptr,
-             mutable_cf_options.memtable_huge_page_size),
+             mutable_cf_options.memtable_huge_page_size, numa_node),
       table_(mutable_cf_options.memtable_factory->CreateMemTableRep(
-          comparator_, needs_dup_key_check, &arena_,
-          mutable_cf_options.prefix_extractor.get(), ioptions.info_log,
-          column_family_id)),
+          comparator_, needs_dup_key_check, &arena_, ioptions,
+          mutable_cf_options, column_family_id)),
       range_del_table_(SkipListFactory().CreateMemTableRep(
           comparator_, needs_dup_key_check, &arena_, nullptr /* transform */,
           ioptions.info_log, column_family_id)),
@@ -545,7 +546,74 @@ bool MemTable::Add(SequenceNumber s, ValueType type,
         return res;
       }
     }
+  } else {
+    bool res = table->InsertKeyValueConcurrently(internal_key.Encode(), value);
+    if (UNLIKELY(!res)) {
+      return res;
+    }
+  }
+  PostAdd(s, type, key, encoded_len, allow_concurrent, post_process_info);
+  return true;
+}
 
+void MemTable::AddBatch(BatchEntry* entries, size_t count,
+                        bool allow_concurrent,
+                        MemTablePostProcessInfo* post_process_info) {
+  if (count == 1) {
+    bool res __attribute__((__unused__));
+    res = Add(entries->seq, entries->type, entries->key, entries->value,
+              allow_concurrent, post_process_info);
+    assert(res);
+    return;
+  }
+  const Comparator* ucmp = comparator_.comparator.user_comparator();
+  std::sort(entries, entries + count,
+            [ucmp](const BatchEntry& l, const BatchEntry& r) {
+              int c = ucmp->Compare(l.key, r.key);
+              return c != 0 ? c < 0 : l.seq > r.seq;
+            });
+  size_t keys_size = 0;
+  for (size_t i = 0; i < count; ++i) {
+    assert(entries[i].type != kTypeRangeDeletion);
+    keys_size += entries[i].key.size() + 8;
+  }
+  std::unique_ptr<char[]> keys_buffer(new char[keys_size]);
+  std::vector<Slice> internal_keys(count);
+  std::vector<Slice> values(count);
+  char* p = keys_buffer.get();
+  for (size_t i = 0; i < count; ++i) {
+    auto& entry = entries[i];
+    memcpy(p, entry.key.data(), entry.key.size());
+    EncodeFixed64(p + entry.key.size(),
+                  PackSequenceAndType(entry.seq, entry.type));
+    internal_keys[i] = Slice(p, entry.key.size() + 8);
+    values[i] = entry.value;
+    p += internal_keys[i].size();
+  }
+  bool res __attribute__((__unused__));
+  res = table_->InsertKeyValueBatch(internal_keys.data(), values.data(), count,
+                                    allow_concurrent);
+  assert(res);
+  // the smallest sequence number goes first, it may become first_seqno_
+  size_t first = 0;
+  for (size_t i = 1; i < count; ++i) {
+    if (entries[i].seq < entries[first].seq) {
+      first = i;
+    }
+  }
+  for (size_t k = 0; k < count; ++k) {
+    size_t i = k == 0 ? first : k - 1 < first ? k - 1 : k;
+    auto& entry = entries[i];
+    PostAdd(entry.seq, entry.type, entry.key,
+            MemTableRep::EncodeKeyValueSize(internal_keys[i], entry.value),
+            allow_concurrent, post_process_info);
+  }
+}
+
+void MemTable::PostAdd(SequenceNumber s, ValueType type, const Slice& key,
+                       size_t encoded_len, bool allow_concurrent,
+                       MemTablePostProcessInfo* post_process_info) {
+  if (!allow_concurrent) {
     // this is a bit ugly, but is the way to avoid locked instructions
     // when incrementing an atomic
     num_entries_.store(num_entries_.load(std::memory_order_relaxed) + 1,
@@ -576,11 +644,6 @@ bool MemTable::Add(SequenceNumber s, ValueType type,
     assert(post_process_info == nullptr);
     UpdateFlushState();
   } else {
-    bool res = table->InsertKeyValueConcurrently(internal_key.Encode(), value);
-    if (UNLIKELY(!res)) {
-      return res;
-    }
-
     assert(post_process_info != nullptr);
     post_process_info->num_entries++;
     post_process_info->data_size += encoded_len;
@@ -610,7 +673,6 @@ bool MemTable::Add(SequenceNumber s, ValueType type,
                          std::memory_order_relaxed);
   }
   UpdateOldestKeyTime();
-  return true;
 }
 
 // Callback from MemTable::Get()
@@ -50,6 +50,7 @@ struct ImmutableMemTableOptions {
                                    Slice delta_value,
                                    std::string* merged_value);
   size_t max_successive_merges;
+  bool collapse_merge_operands;
   Statistics* statistics;
   MergeOperator* merge_operator;
   Logger* info_log;
@@ -98,12 +99,15 @@ class MemTable {
   // If the earliest sequence number is not known, kMaxSequenceNumber may be
   // used, but this may prevent some transactions from succeeding until the
   // first key is inserted into the memtable.
+  //
+  // numa_node, if >= 0, is the NUMA node the arena allocates its blocks on.
   explicit MemTable(const InternalKeyComparator& comparator,
                     const ImmutableCFOptions& ioptions,
                     const MutableCFOptions& mutable_cf_options,
                     bool needs_dup_key_check,
                     WriteBufferManager* write_buffer_manager,
-                    SequenceNumber earliest_seq, uint32_t column_family_id);
+                    SequenceNumber earliest_seq, uint32_t column_family_id,
+                    int numa_node = -1);
 
   // Do not delete this MemTable unless Unref() indicates it not in use.
   ~MemTable();
@@ -178,6 +182,28 @@ class MemTable {
            const Slice& value, bool allow_concurrent = false,
            MemTablePostProcessInfo* post_process_info = nullptr);
 
+  struct BatchEntry {
+    SequenceNumber seq;
+    ValueType type;
+    Slice key;  // user key
+    Slice value;
+  };
+
+  // Same as calling Add() on every entry, but the entries are sorted by
+  // internal key in place and inserted by one call of
+  // MemTableRep::InsertKeyValueBatch(). Range deletions must go through
+  // Add().
+  //
+  // REQUIRES: no <key, seq> of the entries is in the memtable.
+  void AddBatch(BatchEntry* entries, size_t count, bool allow_concurrent,
+                MemTablePostProcessInfo* post_process_info);
+
+  // Returns true if the write path should buffer the entries of a write
+  // batch for AddBatch()
+  bool IsBatchInsertSupported() const {
+    return table_->IsBatchInsertSupported();
+  }
+
   // If memtable contains a value for key, store it in *value and return true.
   // If memtable contains a deletion for key, store a NotFound() error
   // in *status and return true.
@@ -485,6 +511,12 @@ class MemTable {
   // Updates flush_state_ using ShouldFlushNow()
   void UpdateFlushState();
 
+  // Updates the counters, the bloom filter and the sequence numbers once
+  // the entry of encoded_len bytes is in the rep
+  void PostAdd(SequenceNumber s, ValueType type, const Slice& key,
+               size_t encoded_len, bool allow_concurrent,
+               MemTablePostProcessInfo* post_process_info);
+
   void UpdateOldestKeyTime();
 
   // No copying allowed
@@ -490,6 +490,30 @@ void MemTableList::Add(MemTable* m, autovector<MemTable*>* to_delete) {
   }
 }
 
+void MemTableList::RemoveOldMemTables(uint64_t log_number,
+                                      autovector<MemTable*>* to_delete) {
+  assert(to_delete != nullptr);
+  InstallNewVersion();
+  auto& memlist = current_->memlist_;
+  autovector<MemTable*> old_memtables;
+  // The oldest memtable is at the back of the list
+  for (auto it = memlist.rbegin(); it != memlist.rend(); ++it) {
+    MemTable* mem = *it;
+    if (mem->GetNextLogNumber() > log_number) {
+      break;
+    }
+    old_memtables.push_back(mem);
+  }
+  for (auto mem : old_memtables) {
+    assert(!mem->flush_in_progress_);
+    current_->Remove(mem, to_delete);
+    --num_flush_not_started_;
+    if (num_flush_not_started_ == 0) {
+      imm_flush_needed.store(false, std::memory_order_release);
+    }
+  }
+}
+
 // Returns an estimate of the number of bytes of data in use.
 size_t MemTableList::ApproximateUnflushedMemTablesMemoryUsage() {
   size_t total_size = 0;
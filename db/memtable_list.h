@@ -227,6 +227,12 @@ class MemTableList {
   // Takes ownership of the referenced held on *m by the caller of Add().
   void Add(MemTable* m, autovector<MemTable*>* to_delete);
 
+  // Remove the memtables holding only records of logs older than
+  // `log_number`, which another instance writing the same DB has already
+  // flushed. Used by the secondary instance tailing the WALs of the primary.
+  void RemoveOldMemTables(uint64_t log_number,
+                          autovector<MemTable*>* to_delete);
+
   // Returns an estimate of the number of bytes of data in use.
   size_t ApproximateMemoryUsage();
 
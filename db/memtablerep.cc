@@ -95,6 +95,20 @@ bool MemTableRep::InsertKeyValueConcurrently(const Slice& internal_key,
   return true;
 }
 
+bool MemTableRep::InsertKeyValueBatch(const Slice* internal_keys,
+                                      const Slice* values, size_t count,
+                                      bool concurrently) {
+  bool res = true;
+  for (size_t i = 0; i < count; ++i) {
+    if (concurrently) {
+      res &= InsertKeyValueConcurrently(internal_keys[i], values[i]);
+    } else {
+      res &= InsertKeyValue(internal_keys[i], values[i]);
+    }
+  }
+  return res;
+}
+
 KeyHandle MemTableRep::Allocate(const size_t len, char** buf) {
   *buf = allocator_->Allocate(len);
   return static_cast<KeyHandle>(*buf);
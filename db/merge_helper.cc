@@ -39,6 +39,8 @@ MergeHelper::MergeHelper(Env* env, const Comparator* user_comparator,
       latest_snapshot_(latest_snapshot),
       snapshot_checker_(snapshot_checker),
       level_(level),
+      get_base_value_callback_(nullptr),
+      get_base_value_arg_(nullptr),
       keys_(),
       filter_timer_(env_),
       total_filter_time_(0U),
@@ -313,14 +315,31 @@ Status MergeHelper::MergeUntil(
   // without a Put/Delete) if we are certain that we have seen the end of key.
   bool surely_seen_the_beginning =
       (hit_the_next_user_key || !iter->Valid()) && at_bottom;
+  // The operands reaching the end of the key are merged with the value
+  // beneath the input, unless a range tombstone may lie in between.
+  LazyBuffer base_value;
+  bool has_base_value = false;
+  if (!surely_seen_the_beginning && get_base_value_callback_ != nullptr &&
+      (hit_the_next_user_key || !iter->Valid()) &&
+      (range_del_agg == nullptr || range_del_agg->IsEmpty())) {
+    Status base_s = get_base_value_callback_(get_base_value_arg_,
+                                             orig_ikey.user_key, &base_value);
+    if (base_s.ok()) {
+      surely_seen_the_beginning = true;
+      has_base_value = true;
+    } else if (base_s.IsNotFound()) {
+      surely_seen_the_beginning = true;
+    }
+  }
   if (surely_seen_the_beginning) {
-    // do a final merge with nullptr as the existing value and say
-    // bye to the merge type (it's now converted to a Put)
+    // do a final merge with nullptr (or the base value) as the existing value
+    // and say bye to the merge type (it's now converted to a Put)
     assert(kTypeMerge == orig_ikey.type || kTypeMergeIndex == orig_ikey.type);
     assert(merge_context_.GetNumOperands() >= 1);
     assert(merge_context_.GetNumOperands() == keys_.size());
     LazyBuffer merge_result;
-    s = TimedFullMerge(user_merge_operator_, orig_ikey.user_key, nullptr,
+    s = TimedFullMerge(user_merge_operator_, orig_ikey.user_key,
+                       has_base_value ? &base_value : nullptr,
                        merge_context_.GetOperands(), &merge_result, logger_,
                        stats_, env_);
     if (s.ok()) {
@@ -122,6 +122,20 @@ class MergeHelper {
   uint64_t TotalFilterTime() const { return total_filter_time_; }
   bool HasOperator() const { return user_merge_operator_ != nullptr; }
 
+  // Set a callback reading the value of a user key beneath the input of
+  // MergeUntil, i.e. from the data older than everything the iterator covers.
+  // A chain of merge operands reaching the end of its user key is then fully
+  // merged with that value into a Put instead of being partially merged.
+  // The callback returns NotFound if there is no such value, any other error
+  // keeps the operands.
+  void SetBaseValueCallback(Status (*get_base_value_callback)(void*,
+                                                              const Slice&,
+                                                              LazyBuffer*),
+                            void* get_base_value_arg) {
+    get_base_value_callback_ = get_base_value_callback;
+    get_base_value_arg_ = get_base_value_arg;
+  }
+
   // If compaction filter returned REMOVE_AND_SKIP_UNTIL, this method will
   // return true and fill *until with the key to which we should skip.
   // If true, keys() and values() are empty.
@@ -155,6 +169,8 @@ class MergeHelper {
   SequenceNumber latest_snapshot_;
   const SnapshotChecker* const snapshot_checker_;
   int level_;
+  Status (*get_base_value_callback_)(void*, const Slice&, LazyBuffer*);
+  void* get_base_value_arg_;
 
   // the scratch area that holds the result of MergeUntil
   // valid up to the next MergeUntil call
@@ -302,7 +302,12 @@ class VersionBuilder::Rep {
   }
 
   void CalculateDependence(bool finish, bool is_open_db = false) {
-    if (!finish && (!is_open_db || new_deleted_files_ < 65536)) {
+    // During recovery the map is only shrunk once the deleted files are a
+    // fair share of it, so that replaying a MANIFEST stays linear
+    if (!finish &&
+        (!is_open_db ||
+         new_deleted_files_ <
+             std::max<size_t>(65536, dependence_map_.size() / 2))) {
       return;
     }
     ++dependence_version_;
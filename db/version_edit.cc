@@ -54,6 +54,7 @@ enum CustomTag : uint32_t {
   kMinLogNumberToKeepHack = 3,
   kPropertyCache = 64,
   kPathId = 65,
+  kDependence = 66,
 };
 // If this bit for the custom tag is set, opening DB should fail if
 // we don't know this field.
@@ -188,10 +189,8 @@ bool VersionEdit::EncodeTo(std::string* dst) const {
       PutVarint32(dst, CustomTag::kPropertyCache);
       std::string encode_property_cache;
       encode_property_cache.push_back((char)f.prop.purpose);
-      PutVarint64(&encode_property_cache, f.prop.dependence.size());
-      for (auto& dependence : f.prop.dependence) {
-        PutVarint64(&encode_property_cache, dependence.file_number);
-      }
+      // The dependence list is written in kDependence
+      PutVarint64(&encode_property_cache, 0);
       PutVarint64(&encode_property_cache, f.prop.num_entries);
       PutVarint32Varint64(&encode_property_cache, f.prop.max_read_amp,
                           DoubleToU64(f.prop.read_amp));
@@ -199,15 +198,28 @@ bool VersionEdit::EncodeTo(std::string* dst) const {
       for (auto file_number : f.prop.inheritance_chain) {
         PutVarint64(&encode_property_cache, file_number);
       }
-      for (auto& dependence : f.prop.dependence) {
-        PutVarint64(&encode_property_cache, dependence.entry_count);
-      }
       PutVarint64(&encode_property_cache, f.prop.num_deletions);
       encode_property_cache.push_back(char(f.prop.flags));
       PutVarint64Varint64(&encode_property_cache, f.prop.raw_key_size,
                           f.prop.raw_value_size);
       PutLengthPrefixedSlice(dst, encode_property_cache);
     }
+    if (!f.prop.dependence.empty()) {
+      // The files a map sst depends on were mostly created together, the
+      // file numbers are written as the delta from the previous one
+      PutVarint32(dst, CustomTag::kDependence);
+      std::string encode_dependence;
+      PutVarint64(&encode_dependence, f.prop.dependence.size());
+      uint64_t last_file_number = 0;
+      for (auto& dependence : f.prop.dependence) {
+        PutVarsignedint64(&encode_dependence,
+                          static_cast<int64_t>(dependence.file_number -
+                                               last_file_number));
+        PutVarint64(&encode_dependence, dependence.entry_count);
+        last_file_number = dependence.file_number;
+      }
+      PutLengthPrefixedSlice(dst, encode_dependence);
+    }
     TEST_SYNC_POINT_CALLBACK("VersionEdit::EncodeTo:NewFile4:CustomizeFields",
                              dst);
 
@@ -383,6 +395,27 @@ const char* VersionEdit::DecodeNewFile4From(Slice* input) {
             }
           }
           break;
+        case kDependence: {
+          const char* error_msg = "dependence field";
+          uint64_t size;
+          if (!GetVarint64(&field, &size)) {
+            return error_msg;
+          }
+          f.prop.dependence.clear();
+          f.prop.dependence.reserve(size);
+          uint64_t file_number = 0;
+          for (size_t i = 0; i < size; ++i) {
+            uint64_t delta, entry_count;
+            if (!GetVarint64(&field, &delta) ||
+                !GetVarint64(&field, &entry_count)) {
+              return error_msg;
+            }
+            file_number += static_cast<uint64_t>(zigzagToI64(delta));
+            f.prop.dependence.emplace_back(
+                Dependence{file_number, entry_count});
+          }
+          break;
+        }
         default:
           if ((custom_tag & kCustomTagNonSafeIgnoreMask) != 0) {
             // Should not proceed if cannot understand it
@@ -10,6 +10,7 @@
 #pragma once
 #include <algorithm>
 #include <atomic>
+#include <memory>
 #include <set>
 #include <string>
 #include <utility>
@@ -85,6 +86,13 @@ struct FileSampledStats {
   mutable std::atomic<uint64_t> num_reads_sampled;
 };
 
+// A range tombstone fragment of a file, see FileMetaData::range_tombstones
+struct FileRangeTombstone {
+  std::string start_key;
+  std::string end_key;
+  SequenceNumber seq;
+};
+
 struct TablePropertyCache {
   enum {
     kMapHandleRangeDeletions = 1ULL << 0,
@@ -143,6 +151,10 @@ struct FileMetaData {
 
   TablePropertyCache prop;  // Cache some TableProperty fields into manifest
 
+  // Range tombstone fragments in FragmentedRangeTombstoneIterator order,
+  // loaded once by the compaction picker, only accessed under db mutex
+  std::shared_ptr<const std::vector<FileRangeTombstone>> range_tombstones;
+
   FileMetaData()
       : table_reader_handle(nullptr),
         compensated_file_size(0),
@@ -379,6 +391,7 @@ class VersionEdit {
 
  private:
   friend class VersionSet;
+  friend class ReactiveVersionSet;
   friend class Version;
 
   bool GetLevel(Slice* input, int* level, const char** msg);
@@ -101,6 +101,34 @@ TEST_F(VersionEditTest, EncodeDecodeNewFile4) {
   ASSERT_EQ(3U, new_files[2].second.prop.dependence[1].file_number);
 }
 
+TEST_F(VersionEditTest, EncodeDecodeDependence) {
+  static const uint64_t kBig = 1ull << 50;
+
+  // Dependences are not required to be sorted by file number
+  std::vector<Dependence> dependence = {
+      {kBig + 10, 5}, {kBig + 12, 0}, {kBig + 11, 7}, {3, 1}, {kBig, 2}};
+  TablePropertyCache prop = GetPropCache(1);
+  prop.dependence = dependence;
+
+  VersionEdit edit;
+  edit.AddFile(3, 300, 0, 100, InternalKey("foo", kBig + 500, kTypeValue),
+               InternalKey("zoo", kBig + 600, kTypeDeletion), kBig + 500,
+               kBig + 600, false, prop);
+  TestEncodeDecode(edit);
+
+  std::string encoded;
+  edit.EncodeTo(&encoded);
+  VersionEdit parsed;
+  Status s = parsed.DecodeFrom(encoded);
+  ASSERT_TRUE(s.ok()) << s.ToString();
+  auto& parsed_dependence = parsed.GetNewFiles()[0].second.prop.dependence;
+  ASSERT_EQ(dependence.size(), parsed_dependence.size());
+  for (size_t i = 0; i < dependence.size(); ++i) {
+    ASSERT_EQ(dependence[i].file_number, parsed_dependence[i].file_number);
+    ASSERT_EQ(dependence[i].entry_count, parsed_dependence[i].entry_count);
+  }
+}
+
 TEST_F(VersionEditTest, ForwardCompatibleNewFile4) {
   static const uint64_t kBig = 1ull << 50;
   VersionEdit edit;
@@ -691,6 +691,13 @@ class BaseReferencedVersionBuilder {
         version_(cfd->current()) {
     version_->Ref();
   }
+  BaseReferencedVersionBuilder(ColumnFamilyData* cfd, Version* base_version)
+      : version_builder_(new VersionBuilder(
+            cfd->current()->version_set()->env_options(), cfd->table_cache(),
+            base_version->storage_info(), cfd->ioptions()->info_log)),
+        version_(base_version) {
+    version_->Ref();
+  }
   ~BaseReferencedVersionBuilder() {
     delete version_builder_;
     version_->Unref();
@@ -3099,16 +3106,44 @@ Status VersionSet::ProcessManifestWrites(
   uint64_t new_manifest_file_size = 0;
   Status s;
 
+  // Set when switching to the manifest file prepared by
+  // WriteManifestSnapshot()
+  std::unique_ptr<log::Writer> prepared_log;
+  std::vector<std::string> prepared_tail_records;
+  uint64_t discarded_manifest_file_number = 0;
+
   assert(pending_manifest_file_number_ == 0);
+  // The manifest file is rolled over in background, unless it falls too far
+  // behind
+  uint64_t rollover_ratio = db_options_->background_manifest_rollover ? 2 : 1;
   if (!descriptor_log_ ||
-      manifest_file_size_ > db_options_->max_manifest_file_size ||
-      manifest_edit_count_ > db_options_->max_manifest_edit_count) {
+      manifest_file_size_ / rollover_ratio >
+          db_options_->max_manifest_file_size ||
+      manifest_edit_count_ / rollover_ratio >
+          db_options_->max_manifest_edit_count) {
     pending_manifest_file_number_ = NewFileNumber();
     batch_edits.back()->SetNextFile(next_file_number_.load());
     new_descriptor_log = true;
+    if (prepared_manifest_ != nullptr) {
+      if (prepared_manifest_->log != nullptr) {
+        discarded_manifest_file_number = prepared_manifest_->file_number;
+      }
+      // Otherwise WriteManifestSnapshot() deletes the file when it is done
+      prepared_manifest_.reset();
+    }
+  } else if (!new_descriptor_log && prepared_manifest_ != nullptr &&
+             prepared_manifest_->log != nullptr) {
+    pending_manifest_file_number_ = prepared_manifest_->file_number;
+    prepared_log = std::move(prepared_manifest_->log);
+    prepared_tail_records = std::move(prepared_manifest_->tail_records);
+    prepared_manifest_.reset();
+    batch_edits.back()->SetNextFile(next_file_number_.load());
+    new_descriptor_log = true;
   } else {
     pending_manifest_file_number_ = manifest_file_number_;
   }
+  // Records of this batch, kept for the manifest file being prepared
+  std::vector<std::string> batch_records;
 
   if (new_descriptor_log) {
     // if we are writing out new snapshot make sure to persist max column
@@ -3133,6 +3168,11 @@ Status VersionSet::ProcessManifestWrites(
 
     TEST_SYNC_POINT("VersionSet::LogAndApply:WriteManifest");
 
+    if (discarded_manifest_file_number != 0) {
+      env_->DeleteFile(
+          DescriptorFileName(dbname_, discarded_manifest_file_number));
+    }
+
     if (!first_writer.edit_list.front()->IsColumnFamilyManipulation()) {
       bool load_essence_sst =
           column_family_set_->get_table_cache()->GetCapacity() ==
@@ -3152,7 +3192,22 @@ Status VersionSet::ProcessManifestWrites(
 
     // This is fine because everything inside of this block is serialized --
     // only one thread can be here at the same time
-    if (new_descriptor_log) {
+    if (prepared_log != nullptr) {
+      // The snapshot is already in the file, catch up with the edits
+      // committed since it was taken
+      ROCKS_LOG_INFO(db_options_->info_log,
+                     "Switching to manifest %" PRIu64 " with %" ROCKSDB_PRIszt
+                     " edits to catch up\n",
+                     pending_manifest_file_number_,
+                     prepared_tail_records.size());
+      descriptor_log_ = std::move(prepared_log);
+      for (auto& record : prepared_tail_records) {
+        s = descriptor_log_->AddRecord(record);
+        if (!s.ok()) {
+          break;
+        }
+      }
+    } else if (new_descriptor_log) {
       // create new manifest file
       ROCKS_LOG_INFO(db_options_->info_log, "Creating manifest %" PRIu64 "\n",
                      pending_manifest_file_number_);
@@ -3195,6 +3250,9 @@ Status VersionSet::ProcessManifestWrites(
         if (!s.ok()) {
           break;
         }
+        if (db_options_->background_manifest_rollover) {
+          batch_records.emplace_back(std::move(record));
+        }
       }
       if (s.ok()) {
         s = SyncManifest(env_, db_options_, descriptor_log_->file());
@@ -3234,6 +3292,12 @@ Status VersionSet::ProcessManifestWrites(
     obsolete_manifests_.emplace_back(
         DescriptorFileName("", manifest_file_number_));
   }
+  // The snapshot of the manifest file being prepared may predate this batch
+  if (s.ok() && prepared_manifest_ != nullptr) {
+    for (auto& record : batch_records) {
+      prepared_manifest_->tail_records.emplace_back(std::move(record));
+    }
+  }
 
   // Install the new versions
   if (s.ok()) {
@@ -3286,11 +3350,12 @@ Status VersionSet::ProcessManifestWrites(
     }
     manifest_file_number_ = pending_manifest_file_number_;
     manifest_file_size_ = new_manifest_file_size;
+    // A new manifest file starts with the snapshot, followed by the edits
+    // it caught up with and this batch
     if (new_descriptor_log) {
-      manifest_edit_count_ = 0;
-    } else {
-      manifest_edit_count_ += batch_edits.size();
+      manifest_edit_count_ = prepared_tail_records.size();
     }
+    manifest_edit_count_ += batch_edits.size();
     prev_log_number_ = first_writer.edit_list.front()->prev_log_number_;
   } else {
     std::string version_edits;
@@ -3603,41 +3668,215 @@ Status VersionSet::ApplyOneVersionEdit(
   return Status::OK();
 }
 
-Status VersionSet::Recover(
-    const std::vector<ColumnFamilyDescriptor>& column_families,
-    bool read_only) {
-  std::unordered_map<std::string, ColumnFamilyOptions> cf_name_to_options;
-  for (auto cf : column_families) {
-    cf_name_to_options.insert({cf.name, cf.options});
+namespace {
+
+// A batch of MANIFEST records and the edits decoded from them
+struct ManifestRecordBatch {
+  std::vector<std::string> records;
+  std::vector<VersionEdit> edits;
+  std::vector<Status> decode_status;
+  // No more records can be read after this batch
+  bool done = false;
+};
+
+// Number of records decoded per batch during recovery
+const size_t kManifestRecordBatchSize = 4096;
+// A decoding thread is added for every this many records in a batch
+const size_t kManifestRecordsPerDecodeThread = 256;
+
+// Reads batches of records from a MANIFEST and decodes them in background.
+// The threads are kept for the whole replay: one reads the records and
+// takes part in decoding them, the helpers are started when a batch is large
+// enough to need them, up to `max_threads` threads in total.
+class ManifestRecordDecoder {
+ public:
+  ManifestRecordDecoder(log::Reader* reader, Status* reader_status,
+                        int max_threads)
+      : reader_(reader),
+        reader_status_(reader_status),
+        max_threads_(static_cast<size_t>(std::max(max_threads, 1))),
+        cv_(&mu_),
+        batch_(nullptr),
+        next_record_idx_(0),
+        requested_(0),
+        decoding_(0),
+        finished_(0),
+        busy_(0),
+        stop_(false) {
+    reader_thread_ = port::Thread([this] { ReaderLoop(); });
+  }
+
+  ~ManifestRecordDecoder() {
+    Wait();
+    mu_.Lock();
+    stop_ = true;
+    cv_.SignalAll();
+    mu_.Unlock();
+    reader_thread_.join();
+    for (auto& t : helpers_) {
+      t.join();
+    }
+  }
+
+  // Start reading and decoding the next batch into `batch`
+  void Prefetch(ManifestRecordBatch* batch) {
+    mu_.Lock();
+    assert(finished_ == requested_);
+    batch_ = batch;
+    ++requested_;
+    cv_.SignalAll();
+    mu_.Unlock();
+  }
+
+  // Wait for the batch passed to the last Prefetch()
+  void Wait() {
+    mu_.Lock();
+    while (finished_ != requested_) {
+      cv_.Wait();
+    }
+    mu_.Unlock();
   }
-  // keeps track of column families in manifest that were not found in
-  // column families parameters. if those column families are not dropped
-  // by subsequent manifest records, Recover() will return failure status
-  std::unordered_map<int, std::string> column_families_not_found;
 
-  // Read "CURRENT" file, which contains a pointer to the current manifest file
-  std::string manifest_filename;
-  Status s =
-      ReadFileToString(env_, CurrentFileName(dbname_), &manifest_filename);
+ private:
+  void ReaderLoop() {
+    uint64_t gen = 0;
+    while (true) {
+      mu_.Lock();
+      while (!stop_ && requested_ == gen) {
+        cv_.Wait();
+      }
+      if (stop_) {
+        mu_.Unlock();
+        return;
+      }
+      gen = requested_;
+      ManifestRecordBatch* batch = batch_;
+      mu_.Unlock();
+
+      batch->records.clear();
+      batch->done = false;
+      Slice record;
+      std::string scratch;
+      while (batch->records.size() < kManifestRecordBatchSize) {
+        if (!reader_status_->ok() || !reader_->ReadRecord(&record, &scratch)) {
+          batch->done = true;
+          break;
+        }
+        batch->records.emplace_back(record.data(), record.size());
+      }
+      size_t count = batch->records.size();
+      batch->edits.clear();
+      batch->edits.resize(count);
+      batch->decode_status.clear();
+      batch->decode_status.resize(count);
+
+      size_t num_threads = std::min(
+          max_threads_, count / kManifestRecordsPerDecodeThread + 1);
+      mu_.Lock();
+      while (helpers_.size() + 1 < num_threads) {
+        helpers_.emplace_back([this, gen] { HelperLoop(gen - 1); });
+      }
+      next_record_idx_.store(0);
+      busy_ = helpers_.size() + 1;
+      decoding_ = gen;
+      cv_.SignalAll();
+      mu_.Unlock();
+
+      Decode(batch);
+    }
+  }
+
+  void HelperLoop(uint64_t gen) {
+    while (true) {
+      mu_.Lock();
+      while (!stop_ && decoding_ == gen) {
+        cv_.Wait();
+      }
+      if (stop_) {
+        mu_.Unlock();
+        return;
+      }
+      gen = decoding_;
+      ManifestRecordBatch* batch = batch_;
+      mu_.Unlock();
+
+      Decode(batch);
+    }
+  }
+
+  void Decode(ManifestRecordBatch* batch) {
+    size_t count = batch->records.size();
+    while (true) {
+      size_t i = next_record_idx_.fetch_add(1);
+      if (i >= count) {
+        break;
+      }
+      batch->decode_status[i] = batch->edits[i].DecodeFrom(batch->records[i]);
+    }
+    mu_.Lock();
+    if (--busy_ == 0) {
+      finished_ = decoding_;
+      cv_.SignalAll();
+    }
+    mu_.Unlock();
+  }
+
+  log::Reader* reader_;
+  Status* reader_status_;
+  const size_t max_threads_;
+  port::Mutex mu_;
+  port::CondVar cv_;
+  port::Thread reader_thread_;
+  std::vector<port::Thread> helpers_;
+  ManifestRecordBatch* batch_;
+  std::atomic<size_t> next_record_idx_;
+  // Generations of the batches requested, being decoded and decoded
+  uint64_t requested_;
+  uint64_t decoding_;
+  uint64_t finished_;
+  // Threads still decoding the current batch
+  size_t busy_;
+  bool stop_;
+};
+
+}  // namespace
+
+Status VersionSet::GetCurrentManifestPath(std::string* manifest_path,
+                                          uint64_t* manifest_file_number) {
+  assert(manifest_path != nullptr);
+  assert(manifest_file_number != nullptr);
+  std::string fname;
+  Status s = ReadFileToString(env_, CurrentFileName(dbname_), &fname);
   if (!s.ok()) {
     return s;
   }
-  if (manifest_filename.empty() || manifest_filename.back() != '\n') {
+  if (fname.empty() || fname.back() != '\n') {
     return Status::Corruption("CURRENT file does not end with newline");
   }
   // remove the trailing '\n'
-  manifest_filename.resize(manifest_filename.size() - 1);
+  fname.resize(fname.size() - 1);
   FileType type;
-  bool parse_ok =
-      ParseFileName(manifest_filename, &manifest_file_number_, &type);
+  bool parse_ok = ParseFileName(fname, manifest_file_number, &type);
   if (!parse_ok || type != kDescriptorFile) {
     return Status::Corruption("CURRENT file corrupted");
   }
+  *manifest_path = dbname_ + "/" + fname;
+  return Status::OK();
+}
+
+Status VersionSet::Recover(
+    const std::vector<ColumnFamilyDescriptor>& column_families,
+    bool read_only) {
+  // Read "CURRENT" file, which contains a pointer to the current manifest file
+  std::string manifest_filename;
+  Status s = GetCurrentManifestPath(&manifest_filename, &manifest_file_number_);
+  if (!s.ok()) {
+    return s;
+  }
 
   ROCKS_LOG_INFO(db_options_->info_log, "Recovering from manifest file: %s\n",
                  manifest_filename.c_str());
 
-  manifest_filename = dbname_ + "/" + manifest_filename;
   std::unique_ptr<SequentialFileReader> manifest_file_reader;
   {
     std::unique_ptr<SequentialFile> manifest_file;
@@ -3650,12 +3889,43 @@ Status VersionSet::Recover(
         new SequentialFileReader(std::move(manifest_file), manifest_filename));
   }
   uint64_t current_manifest_file_size;
-  uint64_t current_manifest_edit_count = 0;
   s = env_->GetFileSize(manifest_filename, &current_manifest_file_size);
   if (!s.ok()) {
     return s;
   }
 
+  Status reader_status;
+  VersionSet::LogReporter reporter;
+  reporter.status = &reader_status;
+  log::Reader reader(nullptr, std::move(manifest_file_reader), &reporter,
+                     true /* checksum */, 0 /* log_number */,
+                     false /* retry_after_eof */);
+  // An incomplete trailing atomic group is ignored
+  std::vector<VersionEdit> atomic_group;
+  s = ReplayManifest(column_families, read_only,
+                     read_only /* tables_are_immortal */, &reader,
+                     &reader_status, &atomic_group);
+  if (s.ok()) {
+    manifest_file_size_ = current_manifest_file_size;
+  }
+  return s;
+}
+
+Status VersionSet::ReplayManifest(
+    const std::vector<ColumnFamilyDescriptor>& column_families,
+    bool read_only, bool tables_are_immortal, log::Reader* reader,
+    Status* reader_status, std::vector<VersionEdit>* atomic_group) {
+  std::unordered_map<std::string, ColumnFamilyOptions> cf_name_to_options;
+  for (auto cf : column_families) {
+    cf_name_to_options.insert({cf.name, cf.options});
+  }
+  // keeps track of column families in manifest that were not found in
+  // column families parameters. if those column families are not dropped
+  // by subsequent manifest records, Recover() will return failure status
+  std::unordered_map<int, std::string> column_families_not_found;
+
+  Status s;
+  uint64_t current_manifest_edit_count = 0;
   bool have_log_number = false;
   bool have_prev_log_number = false;
   bool have_next_file = false;
@@ -3684,75 +3954,84 @@ Status VersionSet::Recover(
   builders.insert({0, new BaseReferencedVersionBuilder(default_cfd)});
 
   {
-    VersionSet::LogReporter reporter;
-    reporter.status = &s;
-    log::Reader reader(nullptr, std::move(manifest_file_reader), &reporter,
-                       true /* checksum */, 0 /* log_number */,
-                       false /* retry_after_eof */);
-    Slice record;
-    std::string scratch;
-    std::vector<VersionEdit> replay_buffer;
-    size_t num_entries_decoded = 0;
-    while (reader.ReadRecord(&record, &scratch) && s.ok()) {
-      VersionEdit edit;
-      s = edit.DecodeFrom(record);
-      if (!s.ok()) {
-        break;
+    std::vector<VersionEdit>& replay_buffer = *atomic_group;
+    replay_buffer.clear();
+    // The edits are decoded in parallel by batch, the next batch is read and
+    // decoded while the current one is applied
+    ManifestRecordDecoder decoder(reader, reader_status,
+                                  db_options_->max_file_opening_threads);
+    ManifestRecordBatch batch, next_batch;
+    decoder.Prefetch(&batch);
+    decoder.Wait();
+    while (true) {
+      if (!batch.done) {
+        decoder.Prefetch(&next_batch);
       }
-      ++current_manifest_edit_count;
-
-      if (edit.is_in_atomic_group_) {
-        if (replay_buffer.empty()) {
-          replay_buffer.resize(edit.remaining_entries_ + 1);
-          TEST_SYNC_POINT_CALLBACK("VersionSet::Recover:FirstInAtomicGroup",
-                                   &edit);
-        }
-        ++num_entries_decoded;
-        if (num_entries_decoded + edit.remaining_entries_ !=
-            static_cast<uint32_t>(replay_buffer.size())) {
-          TEST_SYNC_POINT_CALLBACK(
-              "VersionSet::Recover:IncorrectAtomicGroupSize", &edit);
-          s = Status::Corruption("corrupted atomic group");
+      for (size_t i = 0; i < batch.edits.size(); ++i) {
+        s = batch.decode_status[i];
+        if (!s.ok()) {
           break;
         }
-        replay_buffer[num_entries_decoded - 1] = std::move(edit);
-        if (num_entries_decoded == replay_buffer.size()) {
-          TEST_SYNC_POINT_CALLBACK("VersionSet::Recover:LastInAtomicGroup",
-                                   &edit);
-          for (auto& e : replay_buffer) {
-            e.set_open_db(true);
-            s = ApplyOneVersionEdit(
-                e, cf_name_to_options, column_families_not_found, builders,
-                &have_log_number, &log_number, &have_prev_log_number,
-                &previous_log_number, &have_next_file, &next_file,
-                &have_last_sequence, &last_sequence, &min_log_number_to_keep,
-                &max_column_family);
-            if (!s.ok()) {
-              break;
+        VersionEdit& edit = batch.edits[i];
+        ++current_manifest_edit_count;
+
+        if (edit.is_in_atomic_group_) {
+          if (replay_buffer.empty()) {
+            TEST_SYNC_POINT_CALLBACK("VersionSet::Recover:FirstInAtomicGroup",
+                                     &edit);
+          } else if (replay_buffer.back().remaining_entries_ !=
+                     edit.remaining_entries_ + 1) {
+            TEST_SYNC_POINT_CALLBACK(
+                "VersionSet::Recover:IncorrectAtomicGroupSize", &edit);
+            s = Status::Corruption("corrupted atomic group");
+            break;
+          }
+          replay_buffer.push_back(std::move(edit));
+          if (replay_buffer.back().remaining_entries_ == 0) {
+            TEST_SYNC_POINT_CALLBACK("VersionSet::Recover:LastInAtomicGroup",
+                                     &replay_buffer.back());
+            for (auto& e : replay_buffer) {
+              e.set_open_db(true);
+              s = ApplyOneVersionEdit(
+                  e, cf_name_to_options, column_families_not_found, builders,
+                  &have_log_number, &log_number, &have_prev_log_number,
+                  &previous_log_number, &have_next_file, &next_file,
+                  &have_last_sequence, &last_sequence, &min_log_number_to_keep,
+                  &max_column_family);
+              if (!s.ok()) {
+                break;
+              }
             }
+            replay_buffer.clear();
           }
-          replay_buffer.clear();
-          num_entries_decoded = 0;
+          TEST_SYNC_POINT("VersionSet::Recover:AtomicGroup");
+        } else {
+          if (!replay_buffer.empty()) {
+            TEST_SYNC_POINT_CALLBACK(
+                "VersionSet::Recover:AtomicGroupMixedWithNormalEdits", &edit);
+            s = Status::Corruption("corrupted atomic group");
+            break;
+          }
+          edit.set_open_db(true);
+          s = ApplyOneVersionEdit(
+              edit, cf_name_to_options, column_families_not_found, builders,
+              &have_log_number, &log_number, &have_prev_log_number,
+              &previous_log_number, &have_next_file, &next_file,
+              &have_last_sequence, &last_sequence, &min_log_number_to_keep,
+              &max_column_family);
         }
-        TEST_SYNC_POINT("VersionSet::Recover:AtomicGroup");
-      } else {
-        if (!replay_buffer.empty()) {
-          TEST_SYNC_POINT_CALLBACK(
-              "VersionSet::Recover:AtomicGroupMixedWithNormalEdits", &edit);
-          s = Status::Corruption("corrupted atomic group");
+        if (!s.ok()) {
           break;
         }
-        edit.set_open_db(true);
-        s = ApplyOneVersionEdit(
-            edit, cf_name_to_options, column_families_not_found, builders,
-            &have_log_number, &log_number, &have_prev_log_number,
-            &previous_log_number, &have_next_file, &next_file,
-            &have_last_sequence, &last_sequence, &min_log_number_to_keep,
-            &max_column_family);
       }
-      if (!s.ok()) {
+      decoder.Wait();
+      if (!s.ok() || batch.done) {
         break;
       }
+      std::swap(batch, next_batch);
+    }
+    if (s.ok()) {
+      s = *reader_status;
     }
   }
 
@@ -3808,7 +4087,7 @@ Status VersionSet::Recover(
       if (cfd->IsDropped()) {
         continue;
       }
-      if (read_only) {
+      if (tables_are_immortal) {
         cfd->table_cache()->SetTablesAreImmortal();
       }
       assert(cfd->initialized());
@@ -3816,11 +4095,16 @@ Status VersionSet::Recover(
       assert(builders_iter != builders.end());
       auto* builder = builders_iter->second->version_builder();
 
+      // The secondary instance has to keep the files replaced by the primary
+      // open, it never opens them lazily
       bool load_essence_sst =
           GetColumnFamilySet()->get_table_cache()->GetCapacity() ==
-          TableCache::kInfiniteCapacity;
+              TableCache::kInfiniteCapacity &&
+          (!db_options_->lazy_open_table_files ||
+           (read_only && !tables_are_immortal));
       // if unlimited table cache, pre-load all table handle. otherwise only
-      // pre-load map sst.
+      // pre-load map sst. DBImpl warms up the others in background when they
+      // are opened lazily.
       // Need to do it out of the mutex.
       builder->LoadTableHandlers(
           cfd->internal_stats(), false /* prefetch_index_and_filter_in_cache */,
@@ -3841,7 +4125,6 @@ Status VersionSet::Recover(
       AppendVersion(cfd, v);
     }
 
-    manifest_file_size_ = current_manifest_file_size;
     manifest_edit_count_ = current_manifest_edit_count;
     next_file_number_.store(next_file + 1);
     last_allocated_sequence_ = last_sequence;
@@ -3857,7 +4140,8 @@ Status VersionSet::Recover(
         "prev_log_number is %lu,"
         "max_column_family is %u,"
         "min_log_number_to_keep is %lu\n",
-        manifest_filename.c_str(), (unsigned long)manifest_file_number_,
+        DescriptorFileName(dbname_, manifest_file_number_).c_str(),
+        (unsigned long)manifest_file_number_,
         (unsigned long)next_file_number_.load(), (unsigned long)last_sequence_,
         (unsigned long)log_number, (unsigned long)prev_log_number_,
         column_family_set_->GetMaxColumnFamily(), min_log_number_to_keep_2pc());
@@ -4274,56 +4558,153 @@ Status VersionSet::WriteSnapshot(log::Writer* log) {
       continue;
     }
     assert(cfd->initialized());
-    {
-      // Store column family info
-      VersionEdit edit;
-      if (cfd->GetID() != 0) {
-        // default column family is always there,
-        // no need to explicitly write it
-        edit.AddColumnFamily(cfd->GetName());
-        edit.SetColumnFamily(cfd->GetID());
-      }
-      edit.SetComparatorName(
-          cfd->internal_comparator().user_comparator()->Name());
-      std::string record;
-      if (!edit.EncodeTo(&record)) {
-        return Status::Corruption("Unable to Encode VersionEdit:" +
-                                  edit.DebugString(true));
-      }
-      Status s = log->AddRecord(record);
-      if (!s.ok()) {
-        return s;
-      }
+    Status s = WriteColumnFamilySnapshot(log, cfd, cfd->current(),
+                                         cfd->GetLogNumber());
+    if (!s.ok()) {
+      return s;
     }
+  }
 
-    {
-      // Save files
-      VersionEdit edit;
+  return Status::OK();
+}
+
+Status VersionSet::WriteColumnFamilySnapshot(log::Writer* log,
+                                             ColumnFamilyData* cfd,
+                                             Version* version,
+                                             uint64_t log_number) {
+  {
+    // Store column family info
+    VersionEdit edit;
+    if (cfd->GetID() != 0) {
+      // default column family is always there,
+      // no need to explicitly write it
+      edit.AddColumnFamily(cfd->GetName());
       edit.SetColumnFamily(cfd->GetID());
+    }
+    edit.SetComparatorName(
+        cfd->internal_comparator().user_comparator()->Name());
+    std::string record;
+    if (!edit.EncodeTo(&record)) {
+      return Status::Corruption("Unable to Encode VersionEdit:" +
+                                edit.DebugString(true));
+    }
+    Status s = log->AddRecord(record);
+    if (!s.ok()) {
+      return s;
+    }
+  }
 
-      for (int level = -1; level < cfd->NumberLevels(); level++) {
-        for (const auto& f :
-             cfd->current()->storage_info()->LevelFiles(level)) {
-          edit.AddFile(level, f->fd.GetNumber(), f->fd.GetPathId(),
-                       f->fd.GetFileSize(), f->smallest, f->largest,
-                       f->fd.smallest_seqno, f->fd.largest_seqno,
-                       f->marked_for_compaction, f->prop);
-        }
-      }
-      edit.SetLogNumber(cfd->GetLogNumber());
-      std::string record;
-      if (!edit.EncodeTo(&record)) {
-        return Status::Corruption("Unable to Encode VersionEdit:" +
-                                  edit.DebugString(true));
+  {
+    // Save files
+    VersionEdit edit;
+    edit.SetColumnFamily(cfd->GetID());
+
+    for (int level = -1; level < cfd->NumberLevels(); level++) {
+      for (const auto& f : version->storage_info()->LevelFiles(level)) {
+        edit.AddFile(level, f->fd.GetNumber(), f->fd.GetPathId(),
+                     f->fd.GetFileSize(), f->smallest, f->largest,
+                     f->fd.smallest_seqno, f->fd.largest_seqno,
+                     f->marked_for_compaction, f->prop);
       }
-      Status s = log->AddRecord(record);
+    }
+    edit.SetLogNumber(log_number);
+    std::string record;
+    if (!edit.EncodeTo(&record)) {
+      return Status::Corruption("Unable to Encode VersionEdit:" +
+                                edit.DebugString(true));
+    }
+    return log->AddRecord(record);
+  }
+}
+
+bool VersionSet::NeedsManifestSnapshot() const {
+  return db_options_->background_manifest_rollover &&
+         prepared_manifest_ == nullptr &&
+         (manifest_file_size_ > db_options_->max_manifest_file_size ||
+          manifest_edit_count_ > db_options_->max_manifest_edit_count);
+}
+
+Status VersionSet::WriteManifestSnapshot(InstrumentedMutex* mu) {
+  mu->AssertHeld();
+  if (!NeedsManifestSnapshot()) {
+    return Status::OK();
+  }
+  // Unlike WriteSnapshot(), column families may be added or dropped while
+  // the file is written, the versions to write are taken under the mutex
+  struct ColumnFamilySnapshot {
+    ColumnFamilyData* cfd;
+    Version* version;
+    uint64_t log_number;
+  };
+  std::vector<ColumnFamilySnapshot> snapshots;
+  for (auto cfd : *column_family_set_) {
+    if (cfd->IsDropped()) {
+      continue;
+    }
+    assert(cfd->initialized());
+    cfd->Ref();
+    cfd->current()->Ref();
+    snapshots.emplace_back(
+        ColumnFamilySnapshot{cfd, cfd->current(), cfd->GetLogNumber()});
+  }
+  uint64_t file_number = NewFileNumber();
+  prepared_manifest_.reset(new PreparedManifest);
+  prepared_manifest_->file_number = file_number;
+  EnvOptions opt_env_opts = env_->OptimizeForManifestWrite(env_options_);
+  mu->Unlock();
+
+  TEST_SYNC_POINT("VersionSet::WriteManifestSnapshot:Captured");
+  ROCKS_LOG_INFO(db_options_->info_log,
+                 "Creating manifest %" PRIu64 " in background\n",
+                 file_number);
+  std::string descriptor_fname = DescriptorFileName(dbname_, file_number);
+  std::unique_ptr<log::Writer> log;
+  std::unique_ptr<WritableFile> descriptor_file;
+  Status s =
+      NewWritableFile(env_, descriptor_fname, &descriptor_file, opt_env_opts);
+  if (s.ok()) {
+    descriptor_file->SetPreallocationBlockSize(
+        db_options_->manifest_preallocation_size);
+    std::unique_ptr<WritableFileWriter> file_writer(new WritableFileWriter(
+        std::move(descriptor_file), descriptor_fname, opt_env_opts, nullptr,
+        db_options_->listeners));
+    log.reset(new log::Writer(std::move(file_writer), 0, false));
+    for (auto& snapshot : snapshots) {
+      s = WriteColumnFamilySnapshot(log.get(), snapshot.cfd, snapshot.version,
+                                    snapshot.log_number);
       if (!s.ok()) {
-        return s;
+        break;
       }
     }
   }
+  if (s.ok()) {
+    s = SyncManifest(env_, db_options_, log->file());
+  }
+  if (!s.ok()) {
+    ROCKS_LOG_ERROR(db_options_->info_log, "MANIFEST snapshot write %s\n",
+                    s.ToString().c_str());
+  }
+  TEST_SYNC_POINT("VersionSet::WriteManifestSnapshot:Written");
+  mu->Lock();
 
-  return Status::OK();
+  for (auto& snapshot : snapshots) {
+    snapshot.version->Unref();
+    if (snapshot.cfd->Unref()) {
+      delete snapshot.cfd;
+    }
+  }
+  if (prepared_manifest_ != nullptr &&
+      prepared_manifest_->file_number == file_number) {
+    if (s.ok()) {
+      prepared_manifest_->log = std::move(log);
+      return s;
+    }
+    prepared_manifest_.reset();
+  }
+  // Failed, or a manifest write has rolled over the manifest file meanwhile
+  log.reset();
+  env_->DeleteFile(descriptor_fname);
+  return s;
 }
 
 // TODO(aekmekji): in CompactionJob::GenSubcompactionBoundaries(), this
@@ -4758,4 +5139,279 @@ uint64_t VersionSet::GetTotalSstFilesSize(Version* dummy_versions) {
   return total_files_size;
 }
 
+ReactiveVersionSet::ReactiveVersionSet(const std::string& dbname,
+                                       const ImmutableDBOptions* _db_options,
+                                       const EnvOptions& _env_options,
+                                       bool _seq_per_batch, Cache* table_cache,
+                                       WriteBufferManager* write_buffer_manager,
+                                       WriteController* write_controller)
+    : VersionSet(dbname, _db_options, _env_options, _seq_per_batch,
+                 table_cache, write_buffer_manager, write_controller) {
+  manifest_reporter_.status = &manifest_reader_status_;
+}
+
+ReactiveVersionSet::~ReactiveVersionSet() {}
+
+Status ReactiveVersionSet::Recover(
+    const std::vector<ColumnFamilyDescriptor>& column_families) {
+  std::string manifest_path;
+  Status s = GetCurrentManifestPath(&manifest_path, &manifest_file_number_);
+  if (!s.ok()) {
+    return s;
+  }
+  ROCKS_LOG_INFO(db_options_->info_log,
+                 "Recovering from manifest file in secondary mode: %s\n",
+                 manifest_path.c_str());
+  s = OpenManifest(manifest_path);
+  if (s.ok()) {
+    // The files are deleted by the primary, they are not immortal here
+    s = ReplayManifest(column_families, true /* read_only */,
+                       false /* tables_are_immortal */, manifest_reader_.get(),
+                       &manifest_reader_status_, &atomic_group_);
+  }
+  if (!s.ok()) {
+    manifest_reader_.reset();
+  }
+  return s;
+}
+
+Status ReactiveVersionSet::OpenManifest(const std::string& manifest_path) {
+  std::unique_ptr<SequentialFile> manifest_file;
+  Status s = env_->NewSequentialFile(
+      manifest_path, &manifest_file,
+      env_->OptimizeForManifestRead(env_options_));
+  if (!s.ok()) {
+    return s;
+  }
+  std::unique_ptr<SequentialFileReader> manifest_file_reader(
+      new SequentialFileReader(std::move(manifest_file), manifest_path));
+  manifest_reader_status_ = Status::OK();
+  manifest_reader_.reset(new log::FragmentBufferedReader(
+      nullptr, std::move(manifest_file_reader), &manifest_reporter_,
+      true /* checksum */, 0 /* log_number */));
+  atomic_group_.clear();
+  return s;
+}
+
+Status ReactiveVersionSet::ReadAndApply(
+    InstrumentedMutex* mu,
+    std::unordered_set<ColumnFamilyData*>* cfds_changed) {
+  assert(cfds_changed != nullptr);
+  mu->AssertHeld();
+
+  std::unordered_map<uint32_t, std::unique_ptr<BaseReferencedVersionBuilder>>
+      builders;
+  // The versions are rebuilt from scratch if the MANIFEST has to be (re)opened
+  bool rebuild = manifest_reader_ == nullptr;
+  Status s;
+  while (true) {
+    if (rebuild && manifest_reader_ == nullptr) {
+      std::string manifest_path;
+      s = GetCurrentManifestPath(&manifest_path, &manifest_file_number_);
+      if (s.ok()) {
+        ROCKS_LOG_INFO(db_options_->info_log,
+                       "Switching to manifest file: %s\n",
+                       manifest_path.c_str());
+        s = OpenManifest(manifest_path);
+      }
+      if (!s.ok()) {
+        break;
+      }
+    }
+    s = ReadEdits(rebuild, &builders, cfds_changed);
+    if (!s.ok()) {
+      break;
+    }
+    std::string manifest_path;
+    uint64_t manifest_file_number;
+    s = GetCurrentManifestPath(&manifest_path, &manifest_file_number);
+    if (!s.ok() || manifest_file_number == manifest_file_number_) {
+      break;
+    }
+    // The primary has switched to a new MANIFEST. It starts with a snapshot
+    // of every column family, the edits left behind are of no use.
+    builders.clear();
+    manifest_reader_.reset();
+    rebuild = true;
+  }
+
+  if (rebuild && !s.ok()) {
+    // A partial snapshot would lose files, start over on the next call
+    manifest_reader_.reset();
+    return s;
+  }
+  if (rebuild) {
+    // Column families missing from the snapshot have been dropped
+    std::vector<ColumnFamilyData*> dropped;
+    for (auto cfd : *column_family_set_) {
+      if (!cfd->IsDropped() && builders.count(cfd->GetID()) == 0) {
+        dropped.push_back(cfd);
+      }
+    }
+    for (auto cfd : dropped) {
+      cfd->SetDropped();
+      cfds_changed->erase(cfd);
+      if (cfd->Unref()) {
+        delete cfd;
+      }
+    }
+  }
+
+  bool load_essence_sst =
+      GetColumnFamilySet()->get_table_cache()->GetCapacity() ==
+      TableCache::kInfiniteCapacity;
+  for (auto& pair : builders) {
+    ColumnFamilyData* cfd = column_family_set_->GetColumnFamily(pair.first);
+    if (cfd == nullptr || cfd->IsDropped()) {
+      continue;
+    }
+    auto* builder = pair.second->version_builder();
+    builder->LoadTableHandlers(
+        cfd->internal_stats(), false /* prefetch_index_and_filter_in_cache */,
+        cfd->GetLatestMutableCFOptions()->prefix_extractor.get(),
+        load_essence_sst, db_options_->max_file_opening_threads);
+    builder->UpgradeFileMetaData(
+        cfd->GetLatestMutableCFOptions()->prefix_extractor.get(),
+        db_options_->max_file_opening_threads);
+
+    Version* v =
+        new Version(cfd, this, env_options_, *cfd->GetLatestMutableCFOptions(),
+                    current_version_number_++);
+    builder->SaveTo(v->storage_info());
+    v->PrepareApply(*cfd->GetLatestMutableCFOptions());
+    AppendVersion(cfd, v);
+    cfds_changed->insert(cfd);
+  }
+  return s;
+}
+
+Status ReactiveVersionSet::ReadEdits(
+    bool rebuild,
+    std::unordered_map<uint32_t, std::unique_ptr<BaseReferencedVersionBuilder>>*
+        builders,
+    std::unordered_set<ColumnFamilyData*>* cfds_changed) {
+  assert(manifest_reader_ != nullptr);
+  Status s;
+  Slice record;
+  std::string scratch;
+  while (s.ok() && manifest_reader_status_.ok() &&
+         manifest_reader_->ReadRecord(&record, &scratch)) {
+    VersionEdit edit;
+    s = edit.DecodeFrom(record);
+    if (!s.ok()) {
+      break;
+    }
+    ++manifest_edit_count_;
+    if (edit.is_in_atomic_group_) {
+      if (!atomic_group_.empty() &&
+          atomic_group_.back().remaining_entries_ !=
+              edit.remaining_entries_ + 1) {
+        s = Status::Corruption("corrupted atomic group");
+        break;
+      }
+      atomic_group_.push_back(std::move(edit));
+      if (atomic_group_.back().remaining_entries_ == 0) {
+        for (auto& e : atomic_group_) {
+          s = ApplyOneVersionEditToBuilder(e, rebuild, builders, cfds_changed);
+          if (!s.ok()) {
+            break;
+          }
+        }
+        atomic_group_.clear();
+      }
+    } else if (!atomic_group_.empty()) {
+      s = Status::Corruption("corrupted atomic group");
+    } else {
+      s = ApplyOneVersionEditToBuilder(edit, rebuild, builders, cfds_changed);
+    }
+  }
+  if (s.ok()) {
+    s = manifest_reader_status_;
+  }
+  if (!s.ok()) {
+    // Start over from CURRENT on the next call
+    manifest_reader_.reset();
+  }
+  return s;
+}
+
+Status ReactiveVersionSet::ApplyOneVersionEditToBuilder(
+    VersionEdit& edit, bool rebuild,
+    std::unordered_map<uint32_t, std::unique_ptr<BaseReferencedVersionBuilder>>*
+        builders,
+    std::unordered_set<ColumnFamilyData*>* cfds_changed) {
+  // Column families not opened by the secondary, or added by the primary
+  // after the secondary was opened, are not followed
+  ColumnFamilyData* cfd =
+      column_family_set_->GetColumnFamily(edit.column_family_);
+  if (cfd != nullptr && cfd->IsDropped()) {
+    cfd = nullptr;
+  }
+  if (cfd != nullptr && edit.is_column_family_drop_) {
+    builders->erase(cfd->GetID());
+    cfds_changed->erase(cfd);
+    cfd->SetDropped();
+    if (cfd->Unref()) {
+      delete cfd;
+    }
+    cfd = nullptr;
+  } else if (cfd != nullptr) {
+    auto iter = builders->find(cfd->GetID());
+    if (iter == builders->end()) {
+      BaseReferencedVersionBuilder* builder;
+      if (rebuild) {
+        builder = new BaseReferencedVersionBuilder(
+            cfd, new Version(cfd, this, env_options_,
+                             *cfd->GetLatestMutableCFOptions(),
+                             current_version_number_++));
+      } else {
+        builder = new BaseReferencedVersionBuilder(cfd);
+      }
+      iter = builders
+                 ->emplace(cfd->GetID(),
+                           std::unique_ptr<BaseReferencedVersionBuilder>(
+                               builder))
+                 .first;
+    }
+    edit.set_open_db(true);
+    iter->second->version_builder()->Apply(&edit);
+
+    if (edit.has_log_number_ && edit.log_number_ > cfd->GetLogNumber()) {
+      cfd->SetLogNumber(edit.log_number_);
+    }
+    if (edit.has_comparator_ &&
+        edit.comparator_ != cfd->user_comparator()->Name()) {
+      return Status::InvalidArgument(
+          cfd->user_comparator()->Name(),
+          "does not match existing comparator " + edit.comparator_);
+    }
+  }
+
+  if (edit.has_prev_log_number_) {
+    prev_log_number_ = edit.prev_log_number_;
+    MarkFileNumberUsed(edit.prev_log_number_);
+  }
+  if (edit.has_log_number_) {
+    MarkFileNumberUsed(edit.log_number_);
+  }
+  if (edit.has_next_file_number_ &&
+      edit.next_file_number_ + 1 > next_file_number_.load()) {
+    next_file_number_.store(edit.next_file_number_ + 1);
+  }
+  if (edit.has_max_column_family_) {
+    column_family_set_->UpdateMaxColumnFamily(std::max(
+        column_family_set_->GetMaxColumnFamily(), edit.max_column_family_));
+  }
+  if (edit.has_min_log_number_to_keep_) {
+    MarkMinLogNumberToKeep2PC(edit.min_log_number_to_keep_);
+  }
+  if (edit.has_last_sequence_ && edit.last_sequence_ > last_sequence_) {
+    // The WALs replayed may be ahead of the MANIFEST
+    last_allocated_sequence_ = edit.last_sequence_;
+    last_published_sequence_ = edit.last_sequence_;
+    last_sequence_ = edit.last_sequence_;
+  }
+  return Status::OK();
+}
+
 }  // namespace rocksdb
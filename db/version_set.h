@@ -25,6 +25,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -733,6 +734,7 @@ class Version : public SeparateHelper, private LazyBufferState {
 
  private:
   Env* env_;
+  friend class ReactiveVersionSet;
   friend class VersionSet;
 
   const InternalKeyComparator* internal_comparator() const {
@@ -844,7 +846,7 @@ class VersionSet {
              const EnvOptions& env_options, bool seq_per_batch,
              Cache* table_cache, WriteBufferManager* write_buffer_manager,
              WriteController* write_controller);
-  ~VersionSet();
+  virtual ~VersionSet();
 
   // Apply *edit to the current version to form a new descriptor that
   // is both saved to persistent state and installed as the new
@@ -890,7 +892,7 @@ class VersionSet {
   // The across-multi-cf batch version. If edit_lists contain more than
   // 1 version edits, caller must ensure that no edit in the []list is column
   // family manipulation.
-  Status LogAndApply(
+  virtual Status LogAndApply(
       const autovector<ColumnFamilyData*>& cfds,
       const autovector<const MutableCFOptions*>& mutable_cf_options_list,
       const autovector<autovector<VersionEdit*>>& edit_lists,
@@ -1049,6 +1051,19 @@ class VersionSet {
   // Return the size of the current manifest file
   uint64_t manifest_file_size() const { return manifest_file_size_; }
 
+  // Return true if background_manifest_rollover is set, the current manifest
+  // file reached the limits to roll over and no new manifest file is being
+  // prepared.
+  // REQUIRES: db mutex held
+  virtual bool NeedsManifestSnapshot() const;
+
+  // Write the current versions to a new manifest file without blocking the
+  // manifest writes. The next manifest write after it is done appends the
+  // edits committed in the meantime to the new file and switches to it.
+  // Will release *mu while writing the file.
+  // REQUIRES: *mu is held on entry.
+  Status WriteManifestSnapshot(InstrumentedMutex* mu);
+
   // verify that the files that we started with for a compaction
   // still exist in the current version and in the same original level.
   // This ensures that a concurrent compaction did not erroneously
@@ -1083,7 +1098,7 @@ class VersionSet {
     return CreateColumnFamily(cf_options, edit);
   }
 
- private:
+ protected:
   struct ManifestWriter;
 
   friend class Version;
@@ -1106,11 +1121,28 @@ class VersionSet {
   // Save current contents to *log
   Status WriteSnapshot(log::Writer* log);
 
+  // Save the column family and the files of `version` to *log
+  Status WriteColumnFamilySnapshot(log::Writer* log, ColumnFamilyData* cfd,
+                                   Version* version, uint64_t log_number);
+
   void AppendVersion(ColumnFamilyData* column_family_data, Version* v);
 
   ColumnFamilyData* CreateColumnFamily(const ColumnFamilyOptions& cf_options,
                                        VersionEdit* edit);
 
+  // Read CURRENT, which names the MANIFEST in use
+  Status GetCurrentManifestPath(std::string* manifest_path,
+                                uint64_t* manifest_file_number);
+
+  // Replay the MANIFEST read by `reader` on top of empty column families and
+  // install the recovered versions, corruptions hit by the reader are
+  // reported in *reader_status. An atomic group the MANIFEST ends in the
+  // middle of is not applied, its edits are left in *atomic_group.
+  Status ReplayManifest(
+      const std::vector<ColumnFamilyDescriptor>& column_families,
+      bool read_only, bool tables_are_immortal, log::Reader* reader,
+      Status* reader_status, std::vector<VersionEdit>* atomic_group);
+
   Status ApplyOneVersionEdit(
       VersionEdit& edit,
       const std::unordered_map<std::string, ColumnFamilyOptions>& name_to_opts,
@@ -1174,21 +1206,100 @@ class VersionSet {
   std::vector<ObsoleteFileInfo> obsolete_files_;
   std::vector<std::string> obsolete_manifests_;
 
+  // A manifest file written by WriteManifestSnapshot()
+  struct PreparedManifest {
+    uint64_t file_number;
+    // Set once the snapshot is written and synced
+    std::unique_ptr<log::Writer> log;
+    // The records written to the current manifest file after the snapshot
+    // was taken, they are appended to the new file before switching to it
+    std::vector<std::string> tail_records;
+  };
+  std::unique_ptr<PreparedManifest> prepared_manifest_;
+
   const bool seq_per_batch_;
 
   // env options for all reads and writes except compactions
   EnvOptions env_options_;
 
+  void LogAndApplyCFHelper(VersionEdit* edit);
+
+ private:
   // No copying allowed
   VersionSet(const VersionSet&);
   void operator=(const VersionSet&);
 
-  void LogAndApplyCFHelper(VersionEdit* edit);
-
  public:
   void LogAndApplyHelper(ColumnFamilyData* cfd, VersionBuilder* b, Version* v,
                          VersionEdit* edit, InstrumentedMutex* mu,
                          bool apply = true);
 };
 
+// The VersionSet of a secondary instance. Instead of writing a MANIFEST it
+// follows the one written by the primary instance of the same DB.
+class ReactiveVersionSet : public VersionSet {
+ public:
+  ReactiveVersionSet(const std::string& dbname,
+                     const ImmutableDBOptions* db_options,
+                     const EnvOptions& env_options, bool seq_per_batch,
+                     Cache* table_cache,
+                     WriteBufferManager* write_buffer_manager,
+                     WriteController* write_controller);
+  ~ReactiveVersionSet() override;
+
+  // The secondary instance never writes the MANIFEST
+  using VersionSet::LogAndApply;
+  Status LogAndApply(
+      const autovector<ColumnFamilyData*>& /*cfds*/,
+      const autovector<const MutableCFOptions*>& /*mutable_cf_options_list*/,
+      const autovector<autovector<VersionEdit*>>& /*edit_lists*/,
+      InstrumentedMutex* /*mu*/, Directory* /*db_directory*/,
+      bool /*new_descriptor_log*/,
+      const ColumnFamilyOptions* /*new_cf_options*/) override {
+    return Status::NotSupported("Not supported operation in secondary mode.");
+  }
+
+  bool NeedsManifestSnapshot() const override { return false; }
+
+  // Recover from the MANIFEST named by CURRENT, which is kept open for
+  // ReadAndApply(). Column families of the MANIFEST missing from
+  // `column_families` are ignored.
+  Status Recover(const std::vector<ColumnFamilyDescriptor>& column_families);
+
+  // Apply the edits appended to the MANIFEST since the last call. If the
+  // primary has switched to a new MANIFEST meanwhile, the versions are rebuilt
+  // from the snapshot it starts with. The column families getting a new
+  // version are added to *cfds_changed.
+  // REQUIRES: *mu is held on entry.
+  Status ReadAndApply(InstrumentedMutex* mu,
+                      std::unordered_set<ColumnFamilyData*>* cfds_changed);
+
+ private:
+  // Open the MANIFEST named by CURRENT, REQUIRES: manifest_file_number_ is
+  // the number of that MANIFEST.
+  Status OpenManifest(const std::string& manifest_path);
+
+  // Apply the complete edits available in the MANIFEST to `builders`. If
+  // `rebuild`, builders of column families start from empty versions.
+  Status ReadEdits(
+      bool rebuild,
+      std::unordered_map<uint32_t,
+                         std::unique_ptr<BaseReferencedVersionBuilder>>*
+          builders,
+      std::unordered_set<ColumnFamilyData*>* cfds_changed);
+
+  Status ApplyOneVersionEditToBuilder(
+      VersionEdit& edit, bool rebuild,
+      std::unordered_map<uint32_t,
+                         std::unique_ptr<BaseReferencedVersionBuilder>>*
+          builders,
+      std::unordered_set<ColumnFamilyData*>* cfds_changed);
+
+  std::unique_ptr<log::FragmentBufferedReader> manifest_reader_;
+  LogReporter manifest_reporter_;
+  Status manifest_reader_status_;
+  // Edits of an atomic group whose end is not read yet
+  std::vector<VersionEdit> atomic_group_;
+};
+
 }  // namespace rocksdb
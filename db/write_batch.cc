@@ -1036,6 +1036,14 @@ class MemTableInserter : public WriteBatch::Handler {
   using DupDetector = std::aligned_storage<sizeof(DuplicateDetector)>::type;
   DupDetector duplicate_detector_;
   bool dup_dectector_on_;
+  // The puts and deletes of batch_mem_ are buffered for MemTable::AddBatch()
+  // if its rep supports batch insert. Nothing that needs a result per key
+  // (seq_per_batch, recovery) is buffered.
+  const bool batch_memtable_writes_;
+  MemTable* batch_mem_;
+  ColumnFamilyData* batch_cfd_;
+  std::vector<MemTable::BatchEntry> batch_entries_;
+  HotKeyCache* const hot_key_cache_;
 
   MemPostInfoMap& GetPostMap() {
     assert(concurrent_memtable_writes_);
@@ -1094,7 +1102,11 @@ class MemTableInserter : public WriteBatch::Handler {
         write_before_prepare_(!batch_per_txn),
         unprepared_batch_(false),
         duplicate_detector_(),
-        dup_dectector_on_(false) {
+        dup_dectector_on_(false),
+        batch_memtable_writes_(!seq_per_batch && recovering_log_number == 0),
+        batch_mem_(nullptr),
+        batch_cfd_(nullptr),
+        hot_key_cache_(db_ != nullptr ? db_->hot_key_cache() : nullptr) {
     assert(cf_mems_);
   }
 
@@ -1132,6 +1144,19 @@ class MemTableInserter : public WriteBatch::Handler {
 
   SequenceNumber sequence() const { return sequence_; }
 
+  // Insert the entries buffered for MemTable::AddBatch(), must be called
+  // before PostProcess() and before the batches are released
+  void AddBatchToMemTable() {
+    if (batch_entries_.empty()) {
+      return;
+    }
+    batch_mem_->AddBatch(batch_entries_.data(), batch_entries_.size(),
+                         concurrent_memtable_writes_,
+                         get_post_process_info(batch_mem_));
+    batch_entries_.clear();
+    CheckMemtableFull(batch_cfd_);
+  }
+
   void PostProcess() {
     assert(concurrent_memtable_writes_);
     // If post info was not created there is nothing
@@ -1206,13 +1231,17 @@ class MemTableInserter : public WriteBatch::Handler {
       return seek_status;
     }
     Status ret_status;
+    InvalidateHotKey(column_family_id, key);
 
     MemTable* mem = cf_mems_->GetMemTable();
     auto* moptions = mem->GetImmutableMemTableOptions();
     // inplace_update_support is inconsistent with snapshots, and therefore with
     // any kind of transactions including the ones that use seq_per_batch
     assert(!seq_per_batch_ || !moptions->inplace_update_support);
-    if (!moptions->inplace_update_support) {
+    if (!moptions->inplace_update_support && batch_memtable_writes_ &&
+        mem->IsBatchInsertSupported()) {
+      AddToBatch(mem, value_type, key, value);
+    } else if (!moptions->inplace_update_support) {
       bool mem_res =
           mem->Add(sequence_, value_type, key, value,
                    concurrent_memtable_writes_, get_post_process_info(mem));
@@ -1291,10 +1320,26 @@ class MemTableInserter : public WriteBatch::Handler {
     return PutCFImpl(column_family_id, key, value, kTypeValue);
   }
 
-  Status DeleteImpl(uint32_t /*column_family_id*/, const Slice& key,
+  Status DeleteImpl(uint32_t column_family_id, const Slice& key,
                     const Slice& value, ValueType delete_type) {
     Status ret_status;
+    if (delete_type != kTypeRangeDeletion) {
+      InvalidateHotKey(column_family_id, key);
+    } else if (hot_key_cache_ != nullptr) {
+      hot_key_cache_->InvalidateAll(sequence_);
+    }
     MemTable* mem = cf_mems_->GetMemTable();
+    if (batch_memtable_writes_ && mem->IsBatchInsertSupported()) {
+      if (delete_type != kTypeRangeDeletion) {
+        AddToBatch(mem, delete_type, key, value);
+        MaybeAdvanceSeq();
+        CheckMemtableFull();
+        return ret_status;
+      }
+      // Range tombstones go to range_del_table_, which AddBatch() does not
+      // handle, so keep them in sequence order with the point keys before
+      AddBatchToMemTable();
+    }
     bool mem_res =
         mem->Add(sequence_, delete_type, key, value,
                  concurrent_memtable_writes_, get_post_process_info(mem));
@@ -1436,6 +1481,8 @@ class MemTableInserter : public WriteBatch::Handler {
   virtual Status MergeCF(uint32_t column_family_id, const Slice& key,
                          const Slice& value) override {
     assert(!concurrent_memtable_writes_);
+    // max_successive_merges reads the memtable
+    AddBatchToMemTable();
     // optimize for non-recovery mode
     if (UNLIKELY(write_after_commit_ && rebuilding_trx_ != nullptr)) {
       WriteBatchInternal::Merge(rebuilding_trx_, column_family_id, key, value);
@@ -1459,6 +1506,7 @@ class MemTableInserter : public WriteBatch::Handler {
     }
 
     Status ret_status;
+    InvalidateHotKey(column_family_id, key);
     MemTable* mem = cf_mems_->GetMemTable();
     auto* moptions = mem->GetImmutableMemTableOptions();
     bool perform_merge = false;
@@ -1480,22 +1528,51 @@ class MemTableInserter : public WriteBatch::Handler {
       }
     }
 
+    // With collapse_merge_operands, the operand is folded as soon as the key
+    // has an entry in the memtable. The value beneath the memtable is read
+    // at most once per key, the following merges find it in the memtable.
+    LazyBuffer get_value;
+    LazyBuffer* existing_value = &get_value;
+    bool get_value_found = false;
+    if (!perform_merge && moptions->collapse_merge_operands &&
+        moptions->merge_operator != nullptr &&
+        moptions->merge_operator->IsAssociative() && db_ != nullptr &&
+        recovering_log_number_ == 0) {
+      LookupKey lkey(key, sequence_);
+      MergeContext merge_context;
+      SequenceNumber max_covering_tombstone_seq = 0;
+      Status s;
+      if (mem->Get(lkey, &get_value, &s, &merge_context,
+                   &max_covering_tombstone_seq, ReadOptions())) {
+        if (s.ok() || s.IsNotFound()) {
+          perform_merge = true;
+          get_value_found = true;
+          if (s.IsNotFound()) {
+            existing_value = nullptr;
+          }
+        }
+      } else if (s.IsMergeInProgress()) {
+        perform_merge = true;
+        get_value.clear();
+      }
+    }
+
     if (perform_merge) {
       // 1) Get the existing value
-      LazyBuffer get_value;
-
-      // Pass in the sequence number so that we also include previous merge
-      // operations in the same batch.
-      SnapshotImpl read_from_snapshot;
-      read_from_snapshot.number_ = sequence_;
-      ReadOptions read_options;
-      read_options.snapshot = &read_from_snapshot;
+      if (!get_value_found) {
+        // Pass in the sequence number so that we also include previous merge
+        // operations in the same batch.
+        SnapshotImpl read_from_snapshot;
+        read_from_snapshot.number_ = sequence_;
+        ReadOptions read_options;
+        read_options.snapshot = &read_from_snapshot;
 
-      auto cf_handle = cf_mems_->GetColumnFamilyHandle();
-      if (cf_handle == nullptr) {
-        cf_handle = db_->DefaultColumnFamily();
+        auto cf_handle = cf_mems_->GetColumnFamilyHandle();
+        if (cf_handle == nullptr) {
+          cf_handle = db_->DefaultColumnFamily();
+        }
+        db_->Get(read_options, cf_handle, key, &get_value);
       }
-      db_->Get(read_options, cf_handle, key, &get_value);
 
       // 2) Apply this merge
       auto merge_operator = moptions->merge_operator;
@@ -1506,7 +1583,7 @@ class MemTableInserter : public WriteBatch::Handler {
       operands.emplace_back(value);
 
       Status merge_status = MergeHelper::TimedFullMerge(
-          merge_operator, key, &get_value, operands, &new_value,
+          merge_operator, key, existing_value, operands, &new_value,
           moptions->info_log, moptions->statistics, Env::Default());
 
       if (!merge_status.ok()) {
@@ -1554,9 +1631,10 @@ class MemTableInserter : public WriteBatch::Handler {
     return ret_status;
   }
 
-  void CheckMemtableFull() {
+  void CheckMemtableFull() { CheckMemtableFull(cf_mems_->current()); }
+
+  void CheckMemtableFull(ColumnFamilyData* cfd) {
     if (flush_scheduler_ != nullptr) {
-      auto* cfd = cf_mems_->current();
       assert(cfd != nullptr);
       if (cfd->mem()->ShouldScheduleFlush() &&
           cfd->mem()->MarkFlushScheduled()) {
@@ -1705,6 +1783,23 @@ class MemTableInserter : public WriteBatch::Handler {
   }
 
  private:
+  // Must be called before the write of key at sequence_ is visible
+  void InvalidateHotKey(uint32_t column_family_id, const Slice& key) {
+    if (hot_key_cache_ != nullptr) {
+      hot_key_cache_->Invalidate(column_family_id, key, sequence_);
+    }
+  }
+
+  void AddToBatch(MemTable* mem, ValueType type, const Slice& key,
+                  const Slice& value) {
+    if (mem != batch_mem_) {
+      AddBatchToMemTable();
+      batch_mem_ = mem;
+      batch_cfd_ = cf_mems_->current();
+    }
+    batch_entries_.push_back({sequence_, type, key, value});
+  }
+
   MemTablePostProcessInfo* get_post_process_info(MemTable* mem) {
     if (!concurrent_memtable_writes_) {
       // No need to batch counters locally if we don't use concurrent mode.
@@ -1742,11 +1837,13 @@ Status WriteBatchInternal::InsertInto(
     inserter.set_log_number_ref(w->log_ref);
     w->status = w->batch->Iterate(&inserter);
     if (!w->status.ok()) {
+      inserter.AddBatchToMemTable();
       return w->status;
     }
     assert(!seq_per_batch || w->batch_cnt != 0);
     assert(!seq_per_batch || inserter.sequence() - w->sequence == w->batch_cnt);
   }
+  inserter.AddBatchToMemTable();
   return Status::OK();
 }
 
@@ -1767,6 +1864,7 @@ Status WriteBatchInternal::InsertInto(
   SetSequence(writer->batch, sequence);
   inserter.set_log_number_ref(writer->log_ref);
   Status s = writer->batch->Iterate(&inserter);
+  inserter.AddBatchToMemTable();
   assert(!seq_per_batch || batch_cnt != 0);
   assert(!seq_per_batch || inserter.sequence() - sequence == batch_cnt);
   if (concurrent_memtable_writes) {
@@ -1786,6 +1884,7 @@ Status WriteBatchInternal::InsertInto(
                             concurrent_memtable_writes, has_valid_writes,
                             seq_per_batch, batch_per_txn);
   Status s = batch->Iterate(&inserter);
+  inserter.AddBatchToMemTable();
   if (next_seq != nullptr) {
     *next_seq = inserter.sequence();
   }
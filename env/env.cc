@@ -359,6 +359,7 @@ void AssignEnvOptions(EnvOptions* env_options, const DBOptions& options) {
   env_options->use_mmap_writes = options.allow_mmap_writes;
   env_options->use_direct_reads = options.use_direct_reads;
   env_options->use_aio_reads = options.use_aio_reads;
+  env_options->use_io_uring = options.use_io_uring;
   env_options->set_fd_cloexec = options.is_fd_close_on_exec;
   env_options->bytes_per_sync = options.bytes_per_sync;
   env_options->compaction_readahead_size = options.compaction_readahead_size;
@@ -432,6 +433,7 @@ void EnvOptions::InitFromEnvVar() {
   FROM_ENV_bool(use_direct_reads);
   FROM_ENV_bool(use_direct_writes);
   FROM_ENV_bool(use_aio_reads);
+  FROM_ENV_bool(use_io_uring);
 }
 
 }  // namespace rocksdb
@@ -39,6 +39,11 @@ class IOProfRandomAccessFile : public RandomAccessFileWrapper {
     return RandomAccessFileWrapper::Prefetch(offset, n);
   }
 
+  Status MultiRead(ReadRequest* reqs, size_t num_reqs) override {
+    IOProfiler::Scope _scope_(BOOST_CURRENT_FUNCTION);
+    return RandomAccessFileWrapper::MultiRead(reqs, num_reqs);
+  }
+
   Status FsRead(uint64_t offset, size_t len, Slice* result,
                 void* buf) const override {
     IOProfiler::Scope _scope_(BOOST_CURRENT_FUNCTION);
@@ -844,6 +844,118 @@ TEST_F(EnvPosixTest, PositionedAppend) {
 }
 #endif  // !ROCKSDB_LITE
 
+TEST_F(EnvPosixTest, IOUringRead) {
+  // Falls back to pread() if io_uring is not supported
+  std::string fname = test::PerThreadDBPath(env_, "io_uring_testfile");
+  Random rnd(301);
+  std::string data;
+  test::RandomString(&rnd, 1 << 16, &data);
+  {
+    std::unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, EnvOptions()));
+    ASSERT_OK(wfile->Append(data));
+    ASSERT_OK(wfile->Close());
+  }
+  EnvOptions options;
+  options.use_io_uring = true;
+  std::unique_ptr<RandomAccessFile> file;
+  ASSERT_OK(env_->NewRandomAccessFile(fname, &file, options));
+  std::string scratch(data.size(), '\0');
+  Slice result;
+  for (size_t offset : {size_t{0}, size_t{1}, size_t{4095}, size_t{60000}}) {
+    ASSERT_OK(file->Read(offset, 4096, &result, &scratch[0]));
+    ASSERT_EQ(Slice(data.data() + offset,
+                    std::min<size_t>(4096, data.size() - offset)),
+              result);
+  }
+  // Past the end of the file
+  ASSERT_OK(file->Read(data.size(), 4096, &result, &scratch[0]));
+  ASSERT_EQ(0, result.size());
+  ASSERT_OK(env_->DeleteFile(fname));
+}
+
+TEST_F(EnvPosixTest, IOUringReadFallback) {
+  // The reads of a failed ring are done again with pread()
+  std::string fname = test::PerThreadDBPath(env_, "io_uring_fallback_testfile");
+  Random rnd(301);
+  std::string data;
+  test::RandomString(&rnd, 1 << 16, &data);
+  {
+    std::unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, EnvOptions()));
+    ASSERT_OK(wfile->Append(data));
+    ASSERT_OK(wfile->Close());
+  }
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "IOUring::Read:Enter", [](void* arg) { *static_cast<int*>(arg) = EAGAIN; });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  EnvOptions options;
+  options.use_io_uring = true;
+  std::unique_ptr<RandomAccessFile> file;
+  ASSERT_OK(env_->NewRandomAccessFile(fname, &file, options));
+  std::string scratch(data.size(), '\0');
+  Slice result;
+  ASSERT_OK(file->Read(4095, 4096, &result, &scratch[0]));
+  ASSERT_EQ(Slice(data.data() + 4095, 4096), result);
+
+  const size_t kNumReqs = 10;
+  const size_t kLen = 1000;
+  std::vector<ReadRequest> reqs(kNumReqs);
+  for (size_t i = 0; i < kNumReqs; ++i) {
+    reqs[i].offset = i * 4099;
+    reqs[i].len = kLen;
+    reqs[i].scratch = &scratch[i * kLen];
+  }
+  ASSERT_OK(file->MultiRead(reqs.data(), reqs.size()));
+  for (auto& req : reqs) {
+    ASSERT_OK(req.status);
+    ASSERT_EQ(Slice(data.data() + req.offset, kLen), req.result);
+  }
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_OK(env_->DeleteFile(fname));
+}
+
+TEST_F(EnvPosixTest, MultiRead) {
+  std::string fname = test::PerThreadDBPath(env_, "multi_read_testfile");
+  Random rnd(301);
+  std::string data;
+  test::RandomString(&rnd, 1 << 16, &data);
+  {
+    std::unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, EnvOptions()));
+    ASSERT_OK(wfile->Append(data));
+    ASSERT_OK(wfile->Close());
+  }
+  for (bool use_io_uring : {false, true}) {
+    EnvOptions options;
+    options.use_io_uring = use_io_uring;
+    std::unique_ptr<RandomAccessFile> file;
+    ASSERT_OK(env_->NewRandomAccessFile(fname, &file, options));
+    // More requests than the entries of a ring, the last ones end past the
+    // end of the file
+    const size_t kNumReqs = 100;
+    const size_t kLen = 1000;
+    std::string scratch(kNumReqs * kLen, '\0');
+    std::vector<ReadRequest> reqs(kNumReqs);
+    for (size_t i = 0; i < kNumReqs; ++i) {
+      reqs[i].offset = (i * 7919) % (data.size() + kLen);
+      reqs[i].len = kLen;
+      reqs[i].scratch = &scratch[i * kLen];
+    }
+    ASSERT_OK(file->MultiRead(reqs.data(), reqs.size()));
+    for (auto& req : reqs) {
+      ASSERT_OK(req.status);
+      size_t offset = std::min<size_t>(req.offset, data.size());
+      ASSERT_EQ(Slice(data.data() + offset,
+                      std::min(kLen, data.size() - offset)),
+                req.result);
+    }
+  }
+  ASSERT_OK(env_->DeleteFile(fname));
+}
+
 // Only works in linux platforms
 TEST_P(EnvPosixTestWithParam, RandomAccessUniqueID) {
   // Create file.
@@ -30,6 +30,7 @@
 #include <sys/syscall.h>
 #include <sys/sysmacros.h>
 #endif
+#include <memory>
 #ifdef WITH_TERARK_ZIP
 #include <terark/thread/fiber_aio.hpp>
 #endif
@@ -307,6 +308,251 @@ size_t PosixHelper::GetUniqueIdFromFile(int fd, char* id, size_t max_size) {
   return static_cast<size_t>(rid - id);
 }
 #endif
+#ifdef ROCKSDB_IOURING_PRESENT
+/*
+ * IOUring
+ */
+namespace {
+const unsigned kIOUringEntries = 64;
+
+std::atomic<bool> io_uring_disabled(false);
+
+int IOUringSetup(unsigned entries, io_uring_params* p) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+}
+
+int IOUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete,
+                 unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit,
+                                  min_complete, flags, nullptr, 0));
+}
+}  // namespace
+
+IOUring::IOUring()
+    : ring_fd_(-1),
+      sq_entries_(0),
+      sq_ring_size_(0),
+      cq_ring_size_(0),
+      sqes_size_(0),
+      sq_ring_(nullptr),
+      cq_ring_(nullptr),
+      sqes_(nullptr),
+      sq_tail_(nullptr),
+      sq_mask_(0),
+      sq_array_(nullptr),
+      cq_head_(nullptr),
+      cq_tail_(nullptr),
+      cq_mask_(0),
+      cqes_(nullptr),
+      in_flight_(0),
+      broken_(false) {}
+
+IOUring::~IOUring() {
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+  }
+}
+
+IOUring* IOUring::ThreadLocal() {
+  static thread_local std::unique_ptr<IOUring> ring;
+  if (ring != nullptr && ring->broken_) {
+    if (ring->in_flight_ > 0) {
+      // Requests that could not be drained may still complete, unmapping
+      // the ring under them is not safe
+      ring.release();
+    } else {
+      ring.reset();
+    }
+  }
+  if (ring == nullptr && !io_uring_disabled.load(std::memory_order_relaxed)) {
+    std::unique_ptr<IOUring> new_ring(new IOUring);
+    if (new_ring->Init(kIOUringEntries)) {
+      ring = std::move(new_ring);
+    } else {
+      io_uring_disabled.store(true, std::memory_order_relaxed);
+    }
+  }
+  return ring.get();
+}
+
+bool IOUring::Init(unsigned entries) {
+  io_uring_params p;
+  memset(&p, 0, sizeof(p));
+  ring_fd_ = IOUringSetup(entries, &p);
+  if (ring_fd_ < 0) {
+    return false;
+  }
+  sq_ring_size_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  void* ptr = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (ptr == MAP_FAILED) {
+    return false;
+  }
+  sq_ring_ = ptr;
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    ptr = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    if (ptr == MAP_FAILED) {
+      return false;
+    }
+    cq_ring_ = ptr;
+  }
+  sqes_size_ = p.sq_entries * sizeof(io_uring_sqe);
+  ptr = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (ptr == MAP_FAILED) {
+    return false;
+  }
+  sqes_ = static_cast<io_uring_sqe*>(ptr);
+
+  char* sq = static_cast<char*>(sq_ring_);
+  sq_tail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+  sq_mask_ = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+  char* cq = static_cast<char*>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+  sq_entries_ = p.sq_entries;
+  iovecs_.resize(sq_entries_);
+  return true;
+}
+
+bool IOUring::Read(Request* reqs, size_t n) {
+  assert(!broken_);
+  for (size_t i = 0; i < n; ++i) {
+    reqs[i].result = -ECANCELED;
+  }
+  for (size_t done = 0; done < n;) {
+    unsigned batch =
+        static_cast<unsigned>(std::min<size_t>(n - done, sq_entries_));
+    unsigned tail = *sq_tail_;
+    for (unsigned i = 0; i < batch; ++i) {
+      Request& req = reqs[done + i];
+      unsigned index = tail & sq_mask_;
+      io_uring_sqe* sqe = &sqes_[index];
+      memset(sqe, 0, sizeof(*sqe));
+      iovecs_[i].iov_base = req.scratch;
+      iovecs_[i].iov_len = req.len;
+      // Readv rather than read keeps the ring usable on kernels before 5.6
+      sqe->opcode = IORING_OP_READV;
+      sqe->fd = req.fd;
+      sqe->off = req.offset;
+      sqe->addr = reinterpret_cast<uint64_t>(&iovecs_[i]);
+      sqe->len = 1;
+      sqe->user_data = done + i;
+      sq_array_[index] = index;
+      ++tail;
+    }
+    __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+
+    unsigned to_submit = batch;
+    unsigned completed = 0;
+    while (completed < batch) {
+      // The callback fails the call without entering the kernel
+      int err = 0;
+      TEST_SYNC_POINT_CALLBACK("IOUring::Read:Enter", &err);
+      int ret = err != 0 ? -1
+                         : IOUringEnter(ring_fd_, to_submit, 1,
+                                        IORING_ENTER_GETEVENTS);
+      if (ret < 0) {
+        err = err != 0 ? err : errno;
+        if (err == EINTR) {
+          continue;
+        }
+        // The submitted requests still read into the buffers of the caller,
+        // wait for them before returning. The ones never submitted stay in
+        // the SQ ring, so the ring must not be used again.
+        broken_ = true;
+        in_flight_ = batch - to_submit - completed;
+        while (in_flight_ > 0) {
+          ret = IOUringEnter(ring_fd_, 0, in_flight_, IORING_ENTER_GETEVENTS);
+          if (ret < 0 && errno != EINTR && errno != EAGAIN &&
+              errno != EBUSY) {
+            // The kernel may still write to the buffers, keep the ring and
+            // stop using io_uring in this process
+            io_uring_disabled.store(true, std::memory_order_relaxed);
+            break;
+          }
+          in_flight_ -= Reap(reqs);
+        }
+        for (size_t i = done; i < n; ++i) {
+          if (reqs[i].result == -ECANCELED) {
+            reqs[i].result = -err;
+          }
+        }
+        return false;
+      }
+      to_submit -= std::min(to_submit, static_cast<unsigned>(ret));
+      completed += Reap(reqs);
+    }
+    done += batch;
+  }
+  return true;
+}
+
+unsigned IOUring::Reap(Request* reqs) {
+  unsigned reaped = 0;
+  unsigned head = *cq_head_;
+  unsigned cq_tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  for (; head != cq_tail; ++head) {
+    io_uring_cqe* cqe = &cqes_[head & cq_mask_];
+    reqs[cqe->user_data].result = cqe->res;
+    ++reaped;
+  }
+  __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  return reaped;
+}
+#endif  // ROCKSDB_IOURING_PRESENT
+
+// Returns false if the read is not done through io_uring, either because
+// it is not available or the ring failed, the caller reads with pread().
+// Otherwise r and errno are set like pread()
+static bool IOUringRead(int fd, char* scratch, size_t n, uint64_t offset,
+                        ssize_t* r) {
+#ifdef ROCKSDB_IOURING_PRESENT
+  IOUring* ring = IOUring::ThreadLocal();
+  if (ring == nullptr) {
+    return false;
+  }
+  IOUring::Request req{fd, offset, n, scratch, 0};
+  if (!ring->Read(&req, 1)) {
+    return false;
+  }
+  if (req.result < 0) {
+    errno = static_cast<int>(-req.result);
+    *r = -1;
+  } else {
+    *r = req.result;
+  }
+  return true;
+#else
+  (void)fd;
+  (void)scratch;
+  (void)n;
+  (void)offset;
+  (void)r;
+  return false;
+#endif
+}
+
 /*
  * PosixRandomAccessFile
  *
@@ -318,6 +564,7 @@ PosixRandomAccessFile::PosixRandomAccessFile(const std::string& fname, int fd,
       fd_(fd),
       use_direct_io_(options.use_direct_reads),
       use_aio_reads_(options.use_aio_reads),
+      use_io_uring_(options.use_io_uring),
       logical_sector_size_(GetLogicalBufferSize(fd_)) {
   assert(!options.use_direct_reads || !options.use_mmap_reads);
   assert(!options.use_mmap_reads || sizeof(void*) < 8);
@@ -329,8 +576,8 @@ bool PosixRandomAccessFile::use_aio_reads() const { return use_aio_reads_; }
 
 static Status PosixFsRead(uint64_t offset, size_t n, Slice* result,
                           char* scratch, int fd_, const std::string& filename_,
-                          bool use_aio_reads_, bool use_direct_io_,
-                          size_t filealign) {
+                          bool use_aio_reads_, bool use_io_uring_,
+                          bool use_direct_io_, size_t filealign) {
   Status s;
   ssize_t r = -1;
   size_t left = n;
@@ -340,7 +587,9 @@ static Status PosixFsRead(uint64_t offset, size_t n, Slice* result,
 #ifndef WITH_TERARK_ZIP
     use_aio_reads_ = false;
 #endif
-    if (use_aio_reads_) {
+    if (use_io_uring_ && IOUringRead(fd_, ptr, left, offset, &r)) {
+      // Read through the io_uring of this thread
+    } else if (use_aio_reads_) {
 #ifdef WITH_TERARK_ZIP
       r = terark::fiber_aio_read(fd_, ptr, left, static_cast<off_t>(offset));
 #endif
@@ -382,7 +631,53 @@ Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
   }
 #endif
   return PosixFsRead(offset, n, result, scratch, fd_, filename_, use_aio_reads_,
-                     use_direct_io_, GetRequiredBufferAlignment());
+                     use_io_uring_, use_direct_io_,
+                     GetRequiredBufferAlignment());
+}
+
+Status PosixRandomAccessFile::MultiRead(ReadRequest* reqs, size_t num_reqs) {
+#ifdef ROCKSDB_IOURING_PRESENT
+  IOUring* ring = use_io_uring_ ? IOUring::ThreadLocal() : nullptr;
+  if (ring != nullptr && num_reqs > 1) {
+    std::vector<IOUring::Request> ring_reqs(num_reqs);
+    for (size_t i = 0; i < num_reqs; ++i) {
+      ring_reqs[i] = IOUring::Request{fd_, reqs[i].offset, reqs[i].len,
+                                      reqs[i].scratch, 0};
+    }
+    bool ring_ok = ring->Read(ring_reqs.data(), num_reqs);
+    for (size_t i = 0; i < num_reqs; ++i) {
+      ReadRequest& req = reqs[i];
+      ssize_t r = ring_reqs[i].result;
+      if (r < 0 && !ring_ok) {
+        // Not completed by the failed ring, read with pread()
+        req.status = PosixFsRead(req.offset, req.len, &req.result, req.scratch,
+                                 fd_, filename_, use_aio_reads_,
+                                 false /* use_io_uring */, use_direct_io_,
+                                 GetRequiredBufferAlignment());
+      } else if (r < 0) {
+        req.result = Slice(req.scratch, 0);
+        req.status = IOError("While pread offset " + ToString(req.offset) +
+                                 " len " + ToString(req.len),
+                             filename_, static_cast<int>(-r));
+      } else if (static_cast<size_t>(r) == req.len || r == 0 ||
+                 (use_direct_io_ &&
+                  r % static_cast<ssize_t>(GetRequiredBufferAlignment()))) {
+        req.result = Slice(req.scratch, static_cast<size_t>(r));
+        req.status = Status::OK();
+      } else {
+        // Short read, the rest is read like Read() does
+        size_t n = static_cast<size_t>(r);
+        req.status = Read(req.offset + n, req.len - n, &req.result,
+                          req.scratch + n);
+        req.result = Slice(req.scratch, req.status.ok()
+                                            ? n + req.result.size()
+                                            : 0);
+      }
+    }
+    return Status::OK();
+  }
+#endif
+  return RandomAccessFile::MultiRead(reqs, num_reqs);
 }
 
 Status PosixRandomAccessFile::Prefetch(uint64_t offset, size_t n) {
@@ -474,6 +769,7 @@ PosixMmapReadableFile::PosixMmapReadableFile(const int fd,
     : fd_(fd), filename_(fname), mmapped_region_(base), length_(length) {
   fd_ = fd_ + 0;  // suppress the warning for used variables
   use_aio_reads_ = options.use_aio_reads;
+  use_io_uring_ = options.use_io_uring;
   assert(options.use_mmap_reads);
   assert(!options.use_direct_reads);
 }
@@ -511,7 +807,7 @@ Status PosixMmapReadableFile::FsRead(uint64_t offset, size_t len, Slice* result,
                                      void* buf) const {
   bool use_direct_io = false;
   return PosixFsRead(offset, len, result, (char*)buf, fd_, filename_,
-                     use_aio_reads_, use_direct_io, 0);
+                     use_aio_reads_, use_io_uring_, use_direct_io, 0);
 }
 
 Status PosixMmapReadableFile::InvalidateCache(size_t offset, size_t length) {
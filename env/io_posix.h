@@ -12,9 +12,15 @@
 
 #include <atomic>
 #include <string>
+#include <vector>
 
 #include "rocksdb/env.h"
 
+#ifdef ROCKSDB_IOURING_PRESENT
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+#endif
+
 // For non linux platform, the following macros are used only as place
 // holder.
 #if !(defined OS_LINUX) && !(defined CYGWIN) && !(defined OS_AIX)
@@ -54,6 +60,64 @@ class PosixHelper {
   static size_t GetUniqueIdFromFile(int fd, char* id, size_t max_size);
 };
 
+#ifdef ROCKSDB_IOURING_PRESENT
+// A minimal io_uring driven by the raw system calls. Every thread reading
+// with use_io_uring owns one ring, the reads it issues together are submitted
+// with a single io_uring_enter() and reaped as they complete.
+class IOUring {
+ public:
+  struct Request {
+    int fd;
+    uint64_t offset;
+    size_t len;
+    char* scratch;
+    // Bytes read, or -errno
+    ssize_t result;
+  };
+
+  // Returns the ring of the calling thread, nullptr if the kernel does not
+  // support io_uring. The first failure to set up a ring disables io_uring
+  // for the whole process, the callers fall back to pread().
+  static IOUring* ThreadLocal();
+
+  ~IOUring();
+
+  // Submit all requests and wait for their completion. Returns false if the
+  // ring failed, the requests not completed are left with a negative result.
+  // The requests already submitted are waited for before returning, the ring
+  // is set up again on the next ThreadLocal(). If they cannot be waited for,
+  // io_uring is disabled for the whole process.
+  bool Read(Request* reqs, size_t n);
+
+ private:
+  IOUring();
+
+  bool Init(unsigned entries);
+
+  // Consume the completion queue, returns the number of requests completed
+  unsigned Reap(Request* reqs);
+
+  int ring_fd_;
+  unsigned sq_entries_;
+  size_t sq_ring_size_;
+  size_t cq_ring_size_;
+  size_t sqes_size_;
+  void* sq_ring_;
+  void* cq_ring_;
+  io_uring_sqe* sqes_;
+  unsigned* sq_tail_;
+  unsigned sq_mask_;
+  unsigned* sq_array_;
+  unsigned* cq_head_;
+  unsigned* cq_tail_;
+  unsigned cq_mask_;
+  io_uring_cqe* cqes_;
+  std::vector<iovec> iovecs_;
+  unsigned in_flight_;
+  bool broken_;
+};
+#endif  // ROCKSDB_IOURING_PRESENT
+
 class PosixSequentialFile : public SequentialFile {
  private:
   std::string filename_;
@@ -84,6 +148,7 @@ class PosixRandomAccessFile : public RandomAccessFile {
   int fd_;
   bool use_direct_io_;
   bool use_aio_reads_;
+  bool use_io_uring_;
   size_t logical_sector_size_;
 
  public:
@@ -96,6 +161,8 @@ class PosixRandomAccessFile : public RandomAccessFile {
 
   virtual Status Prefetch(uint64_t offset, size_t n) override;
 
+  virtual Status MultiRead(ReadRequest* reqs, size_t num_reqs) override;
+
 #if defined(OS_LINUX) || defined(OS_MACOSX) || defined(OS_AIX)
   virtual size_t GetUniqueId(char* id, size_t max_size) const override;
 #endif
@@ -158,6 +225,7 @@ class PosixMmapReadableFile : public RandomAccessFile {
  private:
   int fd_;
   bool use_aio_reads_;
+  bool use_io_uring_;
   std::string filename_;
   void* mmapped_region_;
   size_t length_;
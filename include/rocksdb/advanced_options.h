@@ -602,6 +602,18 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   size_t max_successive_merges = 0;
 
+  // If true and the merge operator is associative (see
+  // MergeOperator::IsAssociative()), a merge into a key that already has an
+  // entry in the memtable is folded with the value of the key into a new
+  // value, and flushes merge the operand chains they write out with the
+  // value of the key in the SSTs. Reads then stop at the newest entry of a
+  // key instead of merging all its operands.
+  //
+  // Default: false
+  //
+  // Dynamically changeable through SetOptions() API
+  bool collapse_merge_operands = false;
+
   // This flag specifies that the implementation should optimize the filters
   // mainly for cases where keys are found rather than also optimize for keys
   // missed. This would be used in cases where the application knows that
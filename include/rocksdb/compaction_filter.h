@@ -56,6 +56,7 @@ class CompactionFilter
     kRemove,
     kChangeValue,
     kRemoveAndSkipUntil,
+    kUndetermined,
   };
 
   using Context = CompactionFilterContext;
@@ -186,6 +187,22 @@ class CompactionFilter
     return Decision::kKeep;
   }
 
+  // Called before FilterV2() for a value separated from its key (see
+  // ColumnFamilyOptions::blob_size), so that the decision can be made without
+  // reading the value from the blob SST. `value_meta` is what the
+  // ValueExtractor created by ColumnFamilyOptions::value_meta_extractor_factory
+  // extracted from the value when it was separated, it is empty if there was
+  // no value_meta_extractor_factory.
+  //
+  // Possible return values are kKeep, kRemove and kRemoveAndSkipUntil, with
+  // the same meaning as FilterV2(). kUndetermined, the default, falls back to
+  // FilterV2() with the value.
+  virtual Decision FilterValueMeta(int /*level*/, const Slice& /*key*/,
+                                   const Slice& /*value_meta*/,
+                                   std::string* /*skip_until*/) const {
+    return Decision::kUndetermined;
+  }
+
   // By default, compaction will only call Filter() on keys written after the
   // most recent call to GetSnapshot(). However, if the compaction filter
   // overrides IgnoreSnapshots to make it return true, the compaction filter
@@ -186,6 +186,30 @@ class DB {
       std::vector<ColumnFamilyHandle*>* handles, DB** dbptr,
       bool error_if_log_file_exist = false);
 
+  // Open the database as a secondary instance of a primary instance that may
+  // keep writing it. The secondary shares the files of the primary and never
+  // writes or deletes any of them, its info log is written to
+  // `secondary_path`. Call TryCatchUpWithPrimary() to see the latest writes of
+  // the primary. options.max_open_files must be -1, so that the table files
+  // deleted by the primary stay readable until the secondary catches up.
+  //
+  // Not supported in ROCKSDB_LITE, in which case the function will
+  // return Status::NotSupported.
+  static Status OpenAsSecondary(const Options& options, const std::string& name,
+                                const std::string& secondary_path, DB** dbptr);
+
+  // Open the database as a secondary instance with column families. Only a
+  // subset of the column families may be opened, the default column family is
+  // always needed.
+  //
+  // Not supported in ROCKSDB_LITE, in which case the function will
+  // return Status::NotSupported.
+  static Status OpenAsSecondary(
+      const DBOptions& db_options, const std::string& name,
+      const std::string& secondary_path,
+      const std::vector<ColumnFamilyDescriptor>& column_families,
+      std::vector<ColumnFamilyHandle*>* handles, DB** dbptr);
+
   // Open DB with column families.
   // db_options specify database specific options
   // column_families is the vector of all column families in the database,
@@ -375,6 +399,22 @@ class DB {
                      std::string* value) {
     return Get(options, DefaultColumnFamily(), key, value);
   }
+
+  // Same as Get() into a LazyBuffer, except that a value which is already
+  // resident in memory (memtable, block cache, mmap'ed or TerarkZip value
+  // store) is referenced in place instead of being copied. *value keeps the
+  // resources it references alive until it is reset or destroyed, so release
+  // it promptly, and always before the DB is closed.
+  // Default implementation falls back to the copying Get().
+  virtual Status GetPinned(const ReadOptions& options,
+                           ColumnFamilyHandle* column_family, const Slice& key,
+                           LazyBuffer* value) {
+    return Get(options, column_family, key, value);
+  }
+  virtual Status GetPinned(const ReadOptions& options, const Slice& key,
+                           LazyBuffer* value) {
+    return GetPinned(options, DefaultColumnFamily(), key, value);
+  }
 #ifdef BOOSTLIB
   static void CallOnMainStack(const std::function<void()>&);
   static void SubmitAsyncTask(std::function<void()>);
@@ -436,6 +476,30 @@ class DB {
         keys, values);
   }
 
+  // MultiGet() counterpart of GetPinned(), see there for the life cycle of
+  // the returned buffers. (*values) is resized to keys.size().
+  virtual std::vector<Status> MultiGetPinned(
+      const ReadOptions& options,
+      const std::vector<ColumnFamilyHandle*>& column_family,
+      const std::vector<Slice>& keys, std::vector<LazyBuffer>* values) {
+    assert(column_family.size() == keys.size());
+    std::vector<Status> stat_list(keys.size());
+    values->resize(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      stat_list[i] =
+          GetPinned(options, column_family[i], keys[i], &(*values)[i]);
+    }
+    return stat_list;
+  }
+  virtual std::vector<Status> MultiGetPinned(const ReadOptions& options,
+                                             const std::vector<Slice>& keys,
+                                             std::vector<LazyBuffer>* values) {
+    return MultiGetPinned(
+        options,
+        std::vector<ColumnFamilyHandle*>(keys.size(), DefaultColumnFamily()),
+        keys, values);
+  }
+
   // If the key definitely does not exist in the database, then this method
   // returns false, else true. If the caller wants to obtain value when the key
   // is found in memory, a bool for 'value_found' must be passed. 'value_found'
@@ -1268,6 +1332,13 @@ class DB {
   virtual Status EndTrace() {
     return Status::NotSupported("EndTrace() is not implemented.");
   }
+
+  // Make the secondary instance see the latest MANIFEST and WAL contents of
+  // the primary instance. The column family handles and the iterators created
+  // before stay valid, iterators keep reading the data of their creation.
+  virtual Status TryCatchUpWithPrimary() {
+    return Status::NotSupported("Supported only by secondary instance");
+  }
 #endif  // ROCKSDB_LITE
 
   // Needed for StackableDB
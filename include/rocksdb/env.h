@@ -85,6 +85,9 @@ struct EnvOptions {
 
   bool use_aio_reads = false;
 
+  // If true, random access files read through an io_uring if supported
+  bool use_io_uring = false;
+
   // Allows OS to incrementally sync files to disk while they are being
   // written, in the background. Issue one request for every bytes_per_sync
   // written. 0 turns it off.
@@ -418,6 +421,12 @@ class Env {
   // Lower CPU priority for threads from the specified pool.
   virtual void LowerThreadPoolCPUPriority(Priority /*pool*/ = LOW) {}
 
+  // Bind the threads from the specified pool to the NUMA nodes of the
+  // system, thread i of the pool runs on the cpus of node i % nodes.
+  // The pool is shared by all DBs using this env, see
+  // DBOptions::numa_aware.
+  virtual void BindThreadPoolToNumaNodes(Priority /*pool*/ = LOW) {}
+
   // Converts seconds-since-Jan-01-1970 to a printable string
   virtual std::string TimeToString(uint64_t time) = 0;
 
@@ -578,6 +587,25 @@ class SequentialFileWrapper : public SequentialFile {
   }
 };
 
+// A read request of RandomAccessFile::MultiRead
+struct ReadRequest {
+  // File offset in bytes
+  uint64_t offset;
+
+  // Length to read in bytes
+  size_t len;
+
+  // A buffer of at least len bytes the data may be placed in
+  char* scratch;
+
+  // Output parameter set by MultiRead() to point to the data, like the
+  // result of Read()
+  Slice result;
+
+  // Status of the read
+  Status status;
+};
+
 // A file abstraction for randomly reading the contents of a file.
 class RandomAccessFile {
  public:
@@ -602,6 +630,22 @@ class RandomAccessFile {
     return Status::OK();
   }
 
+  // Read all requests of reqs. The reads may be issued concurrently, the call
+  // returns after all of them completed, the outcome of each read is in its
+  // result and status. A non-ok return status means the reads could not be
+  // issued at all.
+  // The default implementation calls Read() for each request in turn.
+  // Safe for concurrent use by multiple threads.
+  // If Direct I/O enabled, offset, len, and scratch should be aligned
+  // properly.
+  virtual Status MultiRead(ReadRequest* reqs, size_t num_reqs) {
+    for (size_t i = 0; i < num_reqs; ++i) {
+      ReadRequest& req = reqs[i];
+      req.status = Read(req.offset, req.len, &req.result, req.scratch);
+    }
+    return Status::OK();
+  }
+
   // Tries to get an unique ID for this file that will be the same each time
   // the file is opened (and will stay the same while the file is open).
   // Furthermore, it tries to make this ID at most "max_size" bytes. If such an
@@ -676,6 +720,10 @@ class RandomAccessFileWrapper : public RandomAccessFile {
     return t_->Prefetch(offset, n);
   }
 
+  Status MultiRead(ReadRequest* reqs, size_t num_reqs) override {
+    return t_->MultiRead(reqs, num_reqs);
+  }
+
   size_t GetUniqueId(char* id, size_t max_size) const override {
     return t_->GetUniqueId(id, max_size);
   }
@@ -1355,6 +1403,10 @@ class EnvWrapper : public Env {
     target_->LowerThreadPoolCPUPriority(pool);
   }
 
+  void BindThreadPoolToNumaNodes(Priority pool = LOW) override {
+    target_->BindThreadPoolToNumaNodes(pool);
+  }
+
   std::string TimeToString(uint64_t time) override {
     return target_->TimeToString(time);
   }
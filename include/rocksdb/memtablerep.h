@@ -28,6 +28,9 @@
 // vector is sorted. It is intelligent about sorting; once the MarkReadOnly()
 // has been called, the vector will only be sorted once. It is optimized for
 // random-write-heavy workloads.
+//  - FlatSortedRep: Like VectorRep, but the entries are appended to per core
+// buffers and sorted in parallel once MarkReadOnly() has been called. It is
+// optimized for bulk loading.
 //
 // The last four implementations are designed for situations in which
 // iteration over the entire collection is rare since doing so requires all the
@@ -112,6 +115,17 @@ class MemTableRep {
   virtual bool InsertKeyValueConcurrently(const Slice& internal_key,
                                           const Slice& value);
 
+  // Insert count entries at once, internal_keys[i] pairs with values[i] and
+  // the entries are sorted by internal key, so that a rep may share the
+  // work of neighbouring keys. When concurrently is true this may be called
+  // concurrent with other inserts, as ::InsertKeyValueConcurrently. By
+  // default the entries are inserted one by one.
+  // Returns false if MemTableRepFactory::CanHandleDuplicatedKey() is true and
+  // any <key, seq> already exists, the other entries are still inserted.
+  virtual bool InsertKeyValueBatch(const Slice* internal_keys,
+                                   const Slice* values, size_t count,
+                                   bool concurrently);
+
   // Allocate a buf of len size for storing key. The idea is that a
   // specific memtable representation knows its underlying data structure
   // better. By allowing it to allocate memory, it can possibly put
@@ -263,6 +277,11 @@ class MemTableRep {
   // Default: true
   virtual bool IsSnapshotSupported() const { return true; }
 
+  // Return true if InsertKeyValueBatch() beats inserting the entries one by
+  // one, the write path then buffers the entries of a write batch for it.
+  // Default: false
+  virtual bool IsBatchInsertSupported() const { return false; }
+
  protected:
   // When *key is an internal key concatenated with the value, returns the
   // user key.
@@ -357,6 +376,45 @@ class VectorRepFactory : public MemTableRepFactory {
   virtual const char* Name() const override { return "VectorRepFactory"; }
 };
 
+// This uses a flat sorted array to store the data, for bulk loading where
+// the memtable is seldom read before it is flushed. Writers append their
+// entries to a buffer of their core without ordering them. MarkReadOnly()
+// sorts the entries of all buffers into one array on the LOW thread pool of
+// the DB's Env, by a parallel radix sort on the leading bytes of the keys, and
+// the readers of the immutable memtable binary search that array. A reader
+// needing the array before a pool thread picked the sort up sorts itself.
+// Reading the mutable memtable scans all the buffers.
+//
+// Parameters:
+//   sort_threads: Number of threads sorting an immutable memtable, the one
+//     that started the sort and threads of the LOW pool. 0 means the number
+//     of cores.
+class FlatSortedRepFactory : public MemTableRepFactory {
+  const size_t sort_threads_;
+
+ public:
+  explicit FlatSortedRepFactory(size_t sort_threads = 0)
+      : sort_threads_(sort_threads) {}
+
+  using MemTableRepFactory::CreateMemTableRep;
+  virtual MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&,
+                                         bool needs_dup_key_check, Allocator*,
+                                         const SliceTransform*,
+                                         Logger* logger) override;
+
+  // The sort runs on the LOW pool of ioptions.env, Env::Default() for the
+  // overload above
+  virtual MemTableRep* CreateMemTableRep(
+      const MemTableRep::KeyComparator&, bool needs_dup_key_check,
+      Allocator*, const ImmutableCFOptions& ioptions,
+      const MutableCFOptions& mutable_cf_options,
+      uint32_t column_family_id) override;
+
+  virtual const char* Name() const override { return "FlatSortedRepFactory"; }
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+};
+
 // This class contains a fixed array of buckets, each
 // pointing to a skiplist (null if the bucket is empty).
 // bucket_count: number of fixed array buckets
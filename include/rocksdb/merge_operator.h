@@ -207,6 +207,12 @@ class MergeOperator
   // Default as false, which means stability of outcome is not promised.
   virtual bool IsStableMerge() const { return false; }
 
+  // Determines whether the operands can be folded into the value beneath
+  // them as soon as they are written, see
+  // ColumnFamilyOptions::collapse_merge_operands.
+  // AssociativeMergeOperator returns true.
+  virtual bool IsAssociative() const { return false; }
+
   // Allows to control when to invoke a full merge during Get.
   // This could be used to limit the number of merge operands that are looked at
   // during a point lookup, thereby helping in limiting the number of levels to
@@ -251,6 +257,8 @@ class AssociativeMergeOperator : public MergeOperator {
                      const Slice& value, std::string* new_value,
                      Logger* logger) const = 0;
 
+  bool IsAssociative() const override { return true; }
+
  private:
   // Default implementations of the MergeOperator functions
   bool FullMergeV2(const MergeOperationInput& merge_in,
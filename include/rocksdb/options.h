@@ -465,6 +465,13 @@ struct DBOptions {
   // Default: 16
   int max_file_opening_threads = 16;
 
+  // If max_open_files is -1, only the map SSTs are opened by DB::Open(). The
+  // other table files are opened on first access, and by a background job
+  // that opens them from the top level down right after DB::Open() returns.
+  // Shortens DB::Open() on DBs with many table files.
+  // Default: false
+  bool lazy_open_table_files = false;
+
   //
   // Default: 0
   //
@@ -640,6 +647,15 @@ struct DBOptions {
   uint64_t max_manifest_file_size = 1024 * 1024 * 1024;
   uint64_t max_manifest_edit_count = 4096;
 
+  // If true, the snapshot of the versions a new manifest file starts with is
+  // written by a background job once the manifest file reaches the limits
+  // above, and the next manifest write switches to the new file. Otherwise
+  // the manifest write reaching the limits writes the snapshot itself, and
+  // the writes queued behind it wait. A manifest file growing past twice the
+  // limits is still rolled over by the manifest write.
+  // Default: false
+  bool background_manifest_rollover = false;
+
   // Number of shards used for table cache.
   int table_cache_numshardbits = 6;
 
@@ -707,6 +723,13 @@ struct DBOptions {
   // since aio on non-direct-io is really synchronous on linux
   bool use_aio_reads = false;
 
+  // If true, the reads of random access files go through an io_uring of the
+  // reading thread, several reads issued together are submitted with one
+  // system call. Falls back to pread() if the kernel does not support
+  // io_uring. Takes precedence over use_aio_reads.
+  // Default: false
+  bool use_io_uring = false;
+
   // if not zero, dump rocksdb.stats to LOG every stats_dump_period_sec
   //
   // Default: 600 (10 min)
@@ -944,6 +967,14 @@ struct DBOptions {
   // Not supported in ROCKSDB_LITE mode!
   std::shared_ptr<Cache> row_cache = nullptr;
 
+  // A global cache for the values returned by Get(), keyed by column family
+  // and user key. Unlike row_cache, the entries survive flushes and
+  // compactions, a write to the key invalidates them. Column families with a
+  // compaction filter bypass it.
+  // Default: nullptr (disabled)
+  // Not supported in ROCKSDB_LITE mode!
+  std::shared_ptr<Cache> hot_key_cache = nullptr;
+
   std::shared_ptr<MetricsReporterFactory> metrics_reporter_factory = nullptr;
 
 #ifndef ROCKSDB_LITE
@@ -1042,6 +1073,14 @@ struct DBOptions {
   // If set to true, takes precedence over
   // ReadOptions::background_purge_on_iterator_cleanup.
   bool avoid_unnecessary_blocking_io = false;
+
+  // If true, each column family is assigned to a NUMA node by its id, its
+  // memtables allocate their arenas on that node. Background jobs are not
+  // routed by node, the pools of env are shared by every DB using it and
+  // are bound with Env::BindThreadPoolToNumaNodes(). Only has effect if
+  // built with NUMA on a system with more than one node.
+  // Default: false
+  bool numa_aware = false;
 };
 
 // Options to control the behavior of a database (passed to DB::Open)
@@ -9,6 +9,10 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "rocksdb/env.h"
 #include "rocksdb/statistics.h"
 
@@ -27,6 +31,19 @@ class RateLimiter {
     kWritesOnly,
     kAllIo,
   };
+  // The kind of background job an I/O request belongs to. The engine tags the
+  // threads running these jobs, class-aware limiters (see FairIOScheduler) use
+  // the tag to schedule requests, others ignore it.
+  enum class IOClass {
+    kUnknown,
+    kFlush,
+    kL0Compaction,
+    kCompaction,
+    kGarbageCollection,
+    kBackup,
+    kIngest,
+    kNumIOClasses,
+  };
 
   // For API compatibility, default to rate-limiting writes only.
   explicit RateLimiter(Mode mode = Mode::kWritesOnly) : mode_(mode) {}
@@ -91,6 +108,11 @@ class RateLimiter {
 
   virtual int64_t GetBytesPerSecond() const = 0;
 
+  // Reports how long a rate limited I/O of `bytes` took on the device, after
+  // the tokens for it were granted. Limiters may use it to auto-tune.
+  virtual void ReportIOLatency(size_t /*bytes*/, uint64_t /*micros*/,
+                               OpType /*op_type*/) {}
+
   virtual bool IsRateLimited(OpType op_type) {
     if ((mode_ == RateLimiter::Mode::kWritesOnly &&
          op_type == RateLimiter::OpType::kRead) ||
@@ -136,4 +158,67 @@ extern RateLimiter* NewGenericRateLimiter(
     RateLimiter::Mode mode = RateLimiter::Mode::kWritesOnly,
     bool auto_tuned = false);
 
+// Returns the name of io_class, e.g. "flush", "l0_compaction".
+extern const char* IOClassName(RateLimiter::IOClass io_class);
+
+struct FairIOSchedulerOptions {
+  // Total I/O budget shared by all tenants of the scheduler.
+  int64_t rate_bytes_per_sec = 100 << 20;
+
+  // Same meaning as in NewGenericRateLimiter().
+  int64_t refill_period_us = 100 * 1000;
+
+  RateLimiter::Mode mode = RateLimiter::Mode::kWritesOnly;
+
+  // Relative share of each IOClass, indexed by RateLimiter::IOClass. The
+  // effective weight of a request is tenant weight * class weight. A zero
+  // weight is treated as 1.
+  std::vector<uint32_t> class_weights = {
+      1 /* kUnknown */,     8 /* kFlush */,  4 /* kL0Compaction */,
+      2 /* kCompaction */,  1 /* kGarbageCollection */,
+      1 /* kBackup */,      2 /* kIngest */,
+  };
+
+  // If non-zero, the budget is tuned within
+  // `[rate_bytes_per_sec / 20, rate_bytes_per_sec]` to keep the average device
+  // latency reported through RateLimiter::ReportIOLatency() around this value.
+  uint64_t target_io_latency_us = 0;
+};
+
+// Per (tenant, IOClass) counters of a FairIOScheduler.
+struct IOClassStats {
+  std::string tenant;
+  RateLimiter::IOClass io_class = RateLimiter::IOClass::kUnknown;
+  uint64_t requests = 0;
+  uint64_t bytes_through = 0;
+  // Requests that had to wait for tokens, and their accumulated wait time.
+  uint64_t waited_requests = 0;
+  uint64_t total_wait_micros = 0;
+  uint64_t max_wait_micros = 0;
+};
+
+// A weighted fair I/O scheduler shared among several DB instances (tenants).
+// Each tenant gets its own RateLimiter, which should be set as the
+// DBOptions::rate_limiter of that tenant's DB. Requests of all tenants share
+// one byte budget, queued requests are served by start-time fair queuing over
+// (tenant, IOClass) flows, so a busy flow can not starve a lighter one.
+class FairIOScheduler {
+ public:
+  virtual ~FairIOScheduler() {}
+
+  // Creates the RateLimiter of a new tenant. REQUIRED: weight > 0
+  virtual std::shared_ptr<RateLimiter> NewTenantRateLimiter(
+      const std::string& name, uint32_t weight = 1) = 0;
+
+  virtual void SetBytesPerSecond(int64_t bytes_per_second) = 0;
+
+  virtual int64_t GetBytesPerSecond() const = 0;
+
+  // Appends the counters of every (tenant, IOClass) flow that saw a request.
+  virtual void GetStats(std::vector<IOClassStats>* stats) const = 0;
+};
+
+extern std::shared_ptr<FairIOScheduler> NewFairIOScheduler(
+    const FairIOSchedulerOptions& options);
+
 }  // namespace rocksdb
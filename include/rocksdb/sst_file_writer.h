@@ -9,6 +9,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rocksdb/env.h"
 #include "rocksdb/options.h"
@@ -67,6 +68,9 @@ struct ExternalSstFileInfo {
   uint64_t num_entries;               // number of entries in file
   uint64_t num_range_del_entries;  // number of range deletion entries in file
   int32_t version;                 // file version
+  // blob sst files holding the separated values, see
+  // SstFileWriter::OpenWithBlob()
+  std::vector<std::string> blob_file_paths;
 };
 
 // SstFileWriter is used to create sst files that can be added to database later
@@ -100,6 +104,19 @@ class SstFileWriter {
   // Prepare SstFileWriter to write into file located at "file_path".
   Status Open(const std::string& file_path);
 
+  // Same as Open(), but separate large values like flush does: the value of a
+  // Put or Merge is written to a blob sst file and replaced by an index to it
+  // when value.size() >= options.blob_size and the key is small enough
+  // according to options.blob_large_key_ratio. Blob sst files are written
+  // next to "file_path" as "<file_path>.blob.<n>", each up to
+  // options.target_file_size_base. Finish() returns their paths in
+  // ExternalSstFileInfo::blob_file_paths.
+  // The file and its blob sst files must be passed to the same
+  // IngestExternalFile() call, which links them into the DB atomically.
+  // Values are kept inline if the table factory does not support separated
+  // values.
+  Status OpenWithBlob(const std::string& file_path);
+
   // Add a Put key with value to currently opened file (deprecated)
   // REQUIRES: key is after any previously added key according to comparator.
   ROCKSDB_DEPRECATED_FUNC Status Add(const Slice& user_key, const Slice& value);
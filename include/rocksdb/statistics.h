@@ -251,6 +251,14 @@ enum Tickers : uint32_t {
 
   NO_ITERATOR_CREATED,  // number of iterators created
   NO_ITERATOR_DELETED,  // number of iterators deleted
+
+  // # of times the table level point lookup index told a key is not in a
+  // table without reading any data block.
+  POINT_LOOKUP_INDEX_USEFUL,
+
+  // # of Get() served by / missing DBOptions::hot_key_cache.
+  HOT_KEY_CACHE_HIT,
+  HOT_KEY_CACHE_MISS,
   TICKER_ENUM_MAX
 };
 
@@ -115,6 +115,18 @@ struct BlockBasedTableOptions {
   // kDataBlockBinaryAndHash.
   double data_block_hash_table_util_ratio = 0.75;
 
+  // Build a table level hash from user key to the data block holding it, and
+  // let point lookups go straight to that block instead of seeking the index.
+  // Keys missing from the table are mostly rejected without reading any data
+  // block. Costs about 4 / point_lookup_index_util_ratio bytes per distinct
+  // user key, held in memory while the table is open. Only takes effect with
+  // comparators that never treat different bytes as equal keys.
+  // Tables are read with the index only when this option is set.
+  bool point_lookup_index = false;
+
+  // #distinct user keys/#buckets of the point lookup index.
+  double point_lookup_index_util_ratio = 0.75;
+
   // This option is now deprecated. No matter what value it is set to,
   // it will behave as if hash_index_allow_collision=true.
   bool hash_index_allow_collision = true;
@@ -258,6 +270,13 @@ struct BlockBasedTableOptions {
 
   // Align data blocks on lesser of page size and block size
   bool block_align = false;
+
+  // Keep the first 8 bytes of every restart key of data and index blocks in a
+  // packed array next to the cached block, and narrow the binary search over
+  // the restart points with a SIMD scan of that array before comparing full
+  // keys. It costs 8 bytes of memory per restart point and only takes effect
+  // with the bytewise comparator. It does not change the file format.
+  bool restart_key_prefix_search = false;
 };
 
 // Table Properties that are specific to block-based table properties.
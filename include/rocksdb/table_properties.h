@@ -72,6 +72,7 @@ struct TablePropertiesNames {
 extern const std::string kPropertiesBlock;
 extern const std::string kCompressionDictBlock;
 extern const std::string kRangeDelBlock;
+extern const std::string kPointLookupIndexBlock;
 
 // `TablePropertiesCollector` provides the mechanism for users to collect
 // their own properties that they are interested in. This class is essentially
@@ -36,6 +36,26 @@ class Checkpoint {
   virtual Status CreateCheckpoint(const std::string& checkpoint_dir,
                                   uint64_t log_size_for_flush = 0);
 
+  // Builds an openable snapshot like CreateCheckpoint(), on top of
+  // base_checkpoint_dir, an earlier checkpoint of the same DB usually kept on
+  // the backup disk. SST files already in the base, including the map, essence
+  // and blob SSTs held by lazy compaction, are hard linked from the base. Only
+  // SST files created since the base are linked or copied from the DB.
+  // Copies are done by up to max_background_copies threads, including the
+  // calling one. If verify_checksum is set, every copied file is read back and
+  // its crc32c compared with the one of the bytes read. Clearing it halves
+  // the read I/O of the copies.
+  // The SST files added and removed relative to the base are listed in the
+  // file CHECKPOINT_DELTA in checkpoint_dir, one per line:
+  //   "+ <file name> <size>"  created since the base
+  //   "- <file name> <size>"  in the base but no longer live
+  // followed by the MANIFEST of the checkpoint:
+  //   "manifest <file name> <size>"
+  virtual Status CreateIncrementalCheckpoint(
+      const std::string& base_checkpoint_dir,
+      const std::string& checkpoint_dir, uint64_t log_size_for_flush = 0,
+      int max_background_copies = 1, bool verify_checksum = true);
+
   virtual ~Checkpoint() {}
 };
 
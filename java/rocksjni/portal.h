@@ -3384,8 +3384,14 @@ class TickerTypeJni {
         return 0x5F;
       case rocksdb::Tickers::NO_ITERATOR_DELETED:
         return 0x60;
-      case rocksdb::Tickers::TICKER_ENUM_MAX:
+      case rocksdb::Tickers::POINT_LOOKUP_INDEX_USEFUL:
         return 0x61;
+      case rocksdb::Tickers::HOT_KEY_CACHE_HIT:
+        return 0x62;
+      case rocksdb::Tickers::HOT_KEY_CACHE_MISS:
+        return 0x63;
+      case rocksdb::Tickers::TICKER_ENUM_MAX:
+        return 0x64;
 
       default:
         // undefined/default
@@ -3592,6 +3598,12 @@ class TickerTypeJni {
       case 0x60:
         return rocksdb::Tickers::NO_ITERATOR_DELETED;
       case 0x61:
+        return rocksdb::Tickers::POINT_LOOKUP_INDEX_USEFUL;
+      case 0x62:
+        return rocksdb::Tickers::HOT_KEY_CACHE_HIT;
+      case 0x63:
+        return rocksdb::Tickers::HOT_KEY_CACHE_MISS;
+      case 0x64:
         return rocksdb::Tickers::TICKER_ENUM_MAX;
 
       default:
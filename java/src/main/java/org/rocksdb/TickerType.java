@@ -484,7 +484,23 @@ public enum TickerType {
      */
     NO_ITERATOR_DELETED((byte) 0x60),
 
-    TICKER_ENUM_MAX((byte) 0x61);
+    /**
+     * Number of times the table level point lookup index told a key is not
+     * in a table without reading any data block.
+     */
+    POINT_LOOKUP_INDEX_USEFUL((byte) 0x61),
+
+    /**
+     * Number of Get() served by the hot key cache.
+     */
+    HOT_KEY_CACHE_HIT((byte) 0x62),
+
+    /**
+     * Number of Get() missing the hot key cache.
+     */
+    HOT_KEY_CACHE_MISS((byte) 0x63),
+
+    TICKER_ENUM_MAX((byte) 0x64);
 
 
     private final byte value;
@@ -0,0 +1,588 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+#ifndef ROCKSDB_LITE
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "db/memtable.h"
+#include "options/cf_options.h"
+#include "port/port.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/env.h"
+#include "rocksdb/memtablerep.h"
+#include "util/arena.h"
+#include "util/core_local.h"
+#include "util/mutexlock.h"
+#include "util/string_util.h"
+
+namespace rocksdb {
+namespace {
+
+// The number of bits of the key prefixes distributing the entries over the
+// buckets sorted in parallel
+const int kRadixBits = 11;
+const size_t kNumBuckets = size_t(1) << kRadixBits;
+// Below this the entries are sorted by a single thread
+const size_t kMinEntriesPerThread = 1 << 16;
+
+class FlatSortedRep : public MemTableRep {
+ public:
+  FlatSortedRep(const KeyComparator& compare, Allocator* allocator,
+                size_t sort_threads, Env* env);
+
+  virtual void Insert(KeyHandle handle) override;
+
+  virtual void InsertConcurrently(KeyHandle handle) override;
+
+  // Returns true iff an entry that compares equal to key is in the collection.
+  virtual bool Contains(const Slice& internal_key) const override;
+
+  // Sorts the entries in the background, the readers wait for the sort.
+  virtual void MarkReadOnly() override;
+
+  virtual size_t ApproximateMemoryUsage() override;
+
+  virtual void Get(const LookupKey& k, void* callback_args,
+                   bool (*callback_func)(void* arg, const Slice& key,
+                                         const char* value)) override;
+
+  virtual ~FlatSortedRep() override;
+
+  // The entries are ordered by prefix first, then by compare_. The prefix
+  // is the leading 8 bytes of the user key if the user comparator is
+  // bytewise, 0 otherwise.
+  struct Entry {
+    uint64_t prefix;
+    const char* key;
+  };
+
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    // entries are owned by the iterator, unless it is null and the entries
+    // are the sorted array of an immutable rep
+    Iterator(const FlatSortedRep* rep, std::vector<Entry>* entries);
+
+    virtual ~Iterator() override {}
+
+    virtual bool Valid() const override { return cur_ != end_; }
+
+    virtual const char* EncodedKey() const override {
+      assert(Valid());
+      return cur_->key;
+    }
+
+    virtual void Next() override {
+      assert(Valid());
+      ++cur_;
+    }
+
+    virtual void Prev() override {
+      assert(Valid());
+      // Stepping back from the first entry invalidates the iterator
+      cur_ = cur_ == begin_ ? end_ : cur_ - 1;
+    }
+
+    virtual void Seek(const Slice& user_key, const char* memtable_key) override;
+
+    virtual void SeekForPrev(const Slice& user_key,
+                             const char* memtable_key) override;
+
+    virtual void SeekToFirst() override { cur_ = begin_; }
+
+    virtual void SeekToLast() override {
+      cur_ = begin_ == end_ ? end_ : end_ - 1;
+    }
+
+    virtual bool IsSeekForPrevSupported() const override { return true; }
+
+   private:
+    const FlatSortedRep* rep_;
+    std::unique_ptr<std::vector<Entry>> owned_entries_;
+    const Entry* begin_;
+    const Entry* end_;
+    const Entry* cur_;
+    std::string tmp_;  // For passing to EncodeKey
+  };
+
+  virtual MemTableRep::Iterator* GetIterator(Arena* arena) override;
+
+ private:
+  friend class Iterator;
+
+  // The append buffer of a core
+  struct ALIGN_AS(CACHE_LINE_SIZE) Shard {
+    SpinMutex mutex;
+    std::vector<const char*> keys;
+  };
+
+  uint64_t Prefix(const char* key) const;
+  Entry MakeEntry(const char* key) const;
+  bool Less(const Entry& a, const Entry& b) const;
+
+  // Run func(0) .. func(num_tasks - 1) on the calling thread and up to
+  // sort_threads_ - 1 threads of the env_ LOW pool. The caller runs what the
+  // pool has not picked up, so it never waits for a queued job.
+  void RunParallel(size_t num_tasks,
+                   const std::function<void(size_t)>& func) const;
+
+  // Collect the entries of all shards, not sorted
+  void CollectEntries(std::vector<Entry>* entries) const;
+  void SortEntries();
+  void WaitForSort() const;
+
+  // Shared with the scheduled sort, which may run after the rep is gone.
+  // The first of the sort job, a reader and the destructor to claim it owns
+  // the sort.
+  struct SortState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool claimed = false;
+    bool done = false;
+    FlatSortedRep* rep;
+  };
+  static void BGSort(void* arg);
+  static void UnscheduleSort(void* arg);
+  // Sort on this thread, false if the sort was claimed already. The rep is
+  // only accessed if it returns true.
+  static bool TrySort(SortState* state);
+
+  const KeyComparator& compare_;
+  const bool bytewise_;
+  const size_t sort_threads_;
+  Env* const env_;
+  // The shards keep their keys until the rep is destroyed, so that a reader
+  // that saw the rep mutable never misses entries moved to the sorted array
+  CoreLocalArray<Shard> shards_;
+  std::atomic<size_t> num_entries_;
+
+  // Set by MarkReadOnly()
+  std::atomic<bool> immutable_;
+  std::shared_ptr<SortState> sort_state_;
+  // entries_ is published before sorted_ is set
+  std::atomic<bool> sorted_;
+  std::vector<Entry> entries_;
+};
+
+FlatSortedRep::FlatSortedRep(const KeyComparator& compare,
+                             Allocator* allocator, size_t sort_threads,
+                             Env* env)
+    : MemTableRep(allocator),
+      compare_(compare),
+      bytewise_(compare.icomparator() != nullptr &&
+                compare.icomparator()->user_comparator() ==
+                    BytewiseComparator()),
+      sort_threads_(sort_threads != 0
+                        ? sort_threads
+                        : std::max<size_t>(1, port::Thread::hardware_concurrency())),
+      env_(env),
+      num_entries_(0),
+      immutable_(false),
+      sort_state_(std::make_shared<SortState>()),
+      sorted_(false) {
+  sort_state_->rep = this;
+}
+
+FlatSortedRep::~FlatSortedRep() {
+  SortState* state = sort_state_.get();
+  std::unique_lock<std::mutex> lock(state->mutex);
+  if (!state->claimed) {
+    // Cancel the sort, a job still queued finds it claimed
+    state->claimed = true;
+    state->done = true;
+  }
+  state->cv.wait(lock, [state] { return state->done; });
+  lock.unlock();
+  env_->UnSchedule(state, Env::Priority::LOW);
+}
+
+uint64_t FlatSortedRep::Prefix(const char* key) const {
+  if (!bytewise_) {
+    return 0;
+  }
+  Slice user_key = ExtractUserKey(GetLengthPrefixedSlice(key));
+  // Big endian, padded with zeros, so that the order of the prefixes agrees
+  // with the bytewise order of the keys
+  uint64_t prefix = 0;
+  size_t n = std::min<size_t>(user_key.size(), sizeof(prefix));
+  for (size_t i = 0; i < n; ++i) {
+    prefix |= uint64_t(static_cast<unsigned char>(user_key[i]))
+              << (56 - 8 * i);
+  }
+  return prefix;
+}
+
+FlatSortedRep::Entry FlatSortedRep::MakeEntry(const char* key) const {
+  return Entry{Prefix(key), key};
+}
+
+bool FlatSortedRep::Less(const Entry& a, const Entry& b) const {
+  if (a.prefix != b.prefix) {
+    return a.prefix < b.prefix;
+  }
+  return compare_(a.key, b.key) < 0;
+}
+
+void FlatSortedRep::Insert(KeyHandle handle) {
+  InsertConcurrently(handle);
+}
+
+void FlatSortedRep::InsertConcurrently(KeyHandle handle) {
+  assert(!immutable_.load(std::memory_order_relaxed));
+  Shard* shard = shards_.Access();
+  {
+    std::lock_guard<SpinMutex> lock(shard->mutex);
+    shard->keys.push_back(static_cast<const char*>(handle));
+  }
+  num_entries_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FlatSortedRep::CollectEntries(std::vector<Entry>* entries) const {
+  entries->reserve(num_entries_.load(std::memory_order_relaxed));
+  for (size_t i = 0; i < shards_.Size(); ++i) {
+    Shard* shard = shards_.AccessAtCore(i);
+    std::lock_guard<SpinMutex> lock(shard->mutex);
+    for (auto key : shard->keys) {
+      entries->emplace_back(MakeEntry(key));
+    }
+  }
+}
+
+bool FlatSortedRep::Contains(const Slice& internal_key) const {
+  std::string memtable_key;
+  EncodeKey(&memtable_key, internal_key);
+  if (immutable_.load(std::memory_order_acquire)) {
+    WaitForSort();
+    Entry target = MakeEntry(memtable_key.data());
+    auto it = std::lower_bound(
+        entries_.begin(), entries_.end(), target,
+        [this](const Entry& a, const Entry& b) { return Less(a, b); });
+    return it != entries_.end() && compare_(it->key, internal_key) == 0;
+  }
+  for (size_t i = 0; i < shards_.Size(); ++i) {
+    Shard* shard = shards_.AccessAtCore(i);
+    std::lock_guard<SpinMutex> lock(shard->mutex);
+    for (auto key : shard->keys) {
+      if (compare_(key, internal_key) == 0) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// The tasks of a RunParallel() call, outliving it in the jobs still queued
+struct ParallelTasks {
+  explicit ParallelTasks(size_t n, const std::function<void(size_t)>& f)
+      : num_tasks(n), func(f), next(0), finished(0) {}
+
+  // Returns once no task is left to start
+  void Run() {
+    size_t i;
+    while ((i = next.fetch_add(1, std::memory_order_relaxed)) < num_tasks) {
+      func(i);
+      std::lock_guard<std::mutex> lock(mutex);
+      if (++finished == num_tasks) {
+        cv.notify_all();
+      }
+    }
+  }
+
+  const size_t num_tasks;
+  // Only called for the tasks claimed before RunParallel() returns
+  const std::function<void(size_t)> func;
+  std::atomic<size_t> next;
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t finished;
+};
+
+void RunParallelTasks(void* arg) {
+  auto tasks = static_cast<std::shared_ptr<ParallelTasks>*>(arg);
+  (*tasks)->Run();
+  delete tasks;
+}
+
+void DeleteParallelTasks(void* arg) {
+  delete static_cast<std::shared_ptr<ParallelTasks>*>(arg);
+}
+
+void FlatSortedRep::RunParallel(
+    size_t num_tasks, const std::function<void(size_t)>& func) const {
+  auto tasks = std::make_shared<ParallelTasks>(num_tasks, func);
+  size_t num_jobs = std::min(num_tasks, sort_threads_) - 1;
+  for (size_t i = 0; i < num_jobs; ++i) {
+    env_->Schedule(&RunParallelTasks,
+                   new std::shared_ptr<ParallelTasks>(tasks),
+                   Env::Priority::LOW, tasks.get(), &DeleteParallelTasks);
+  }
+  tasks->Run();
+  std::unique_lock<std::mutex> lock(tasks->mutex);
+  tasks->cv.wait(lock, [&] { return tasks->finished == num_tasks; });
+  lock.unlock();
+  if (num_jobs > 0) {
+    env_->UnSchedule(tasks.get(), Env::Priority::LOW);
+  }
+}
+
+// A parallel MSD radix sort on the key prefixes. The entries are scattered
+// over kNumBuckets buckets by the kRadixBits prefix bits following the bits
+// all prefixes share, then the buckets are sorted independently.
+void FlatSortedRep::SortEntries() {
+  std::vector<Entry> entries;
+  CollectEntries(&entries);
+  auto less = [this](const Entry& a, const Entry& b) { return Less(a, b); };
+  const size_t n = entries.size();
+  const size_t num_threads =
+      std::min(sort_threads_, std::max<size_t>(1, n / kMinEntriesPerThread));
+  if (num_threads == 1 || !bytewise_) {
+    std::sort(entries.begin(), entries.end(), less);
+    entries_.swap(entries);
+    sorted_.store(true, std::memory_order_release);
+    return;
+  }
+
+  uint64_t diff = 0;
+  for (auto& e : entries) {
+    diff |= e.prefix ^ entries.front().prefix;
+  }
+  int shift = 0;
+  while (shift < 64 && (diff & (uint64_t(1) << (63 - shift))) == 0) {
+    ++shift;
+  }
+  auto bucket_of = [shift](uint64_t prefix) -> size_t {
+    return shift >= 64 ? 0
+                       : static_cast<size_t>((prefix << shift) >>
+                                             (64 - kRadixBits));
+  };
+
+  // Histogram of every chunk
+  const size_t chunk = (n + num_threads - 1) / num_threads;
+  std::vector<std::vector<size_t>> offsets(num_threads,
+                                           std::vector<size_t>(kNumBuckets));
+  RunParallel(num_threads, [&](size_t t) {
+    auto& count = offsets[t];
+    for (size_t i = t * chunk, end = std::min(n, i + chunk); i < end; ++i) {
+      ++count[bucket_of(entries[i].prefix)];
+    }
+  });
+  // Bucket b of chunk t starts after bucket b of the chunks before t
+  std::vector<size_t> bucket_begin(kNumBuckets + 1);
+  size_t pos = 0;
+  for (size_t b = 0; b < kNumBuckets; ++b) {
+    bucket_begin[b] = pos;
+    for (size_t t = 0; t < num_threads; ++t) {
+      size_t count = offsets[t][b];
+      offsets[t][b] = pos;
+      pos += count;
+    }
+  }
+  bucket_begin[kNumBuckets] = pos;
+  assert(pos == n);
+
+  std::vector<Entry> sorted(n);
+  RunParallel(num_threads, [&](size_t t) {
+    auto& offset = offsets[t];
+    for (size_t i = t * chunk, end = std::min(n, i + chunk); i < end; ++i) {
+      sorted[offset[bucket_of(entries[i].prefix)]++] = entries[i];
+    }
+  });
+  std::vector<Entry>().swap(entries);
+
+  std::atomic<size_t> next_bucket(0);
+  RunParallel(num_threads, [&](size_t /*t*/) {
+    size_t b;
+    while ((b = next_bucket.fetch_add(1, std::memory_order_relaxed)) <
+           kNumBuckets) {
+      std::sort(sorted.begin() + bucket_begin[b],
+                sorted.begin() + bucket_begin[b + 1], less);
+    }
+  });
+  entries_.swap(sorted);
+  sorted_.store(true, std::memory_order_release);
+}
+
+bool FlatSortedRep::TrySort(SortState* state) {
+  std::unique_lock<std::mutex> lock(state->mutex);
+  if (state->claimed) {
+    return false;
+  }
+  state->claimed = true;
+  lock.unlock();
+  state->rep->SortEntries();
+  lock.lock();
+  state->done = true;
+  state->cv.notify_all();
+  return true;
+}
+
+void FlatSortedRep::BGSort(void* arg) {
+  auto state = static_cast<std::shared_ptr<SortState>*>(arg);
+  // Claimed already if a reader sorted, or if the rep is being destroyed
+  TrySort(state->get());
+  delete state;
+}
+
+void FlatSortedRep::UnscheduleSort(void* arg) {
+  delete static_cast<std::shared_ptr<SortState>*>(arg);
+}
+
+void FlatSortedRep::MarkReadOnly() {
+  if (immutable_.exchange(true)) {
+    return;
+  }
+  if (num_entries_.load(std::memory_order_relaxed) < kMinEntriesPerThread) {
+    TrySort(sort_state_.get());
+  } else {
+    // MarkReadOnly() is called with the DB mutex held
+    env_->Schedule(&FlatSortedRep::BGSort,
+                   new std::shared_ptr<SortState>(sort_state_),
+                   Env::Priority::LOW, sort_state_.get(),
+                   &FlatSortedRep::UnscheduleSort);
+  }
+}
+
+void FlatSortedRep::WaitForSort() const {
+  assert(immutable_.load(std::memory_order_relaxed));
+  SortState* state = sort_state_.get();
+  if (!sorted_.load(std::memory_order_acquire) && !TrySort(state)) {
+    // Sorting in the background, or by another reader
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [state] { return state->done; });
+  }
+  assert(sorted_.load(std::memory_order_relaxed));
+}
+
+size_t FlatSortedRep::ApproximateMemoryUsage() {
+  // Every entry is appended to a shard, then copied to the sorted array
+  return num_entries_.load(std::memory_order_relaxed) *
+         (sizeof(const char*) + sizeof(Entry));
+}
+
+FlatSortedRep::Iterator::Iterator(const FlatSortedRep* rep,
+                                  std::vector<Entry>* entries)
+    : rep_(rep), owned_entries_(entries) {
+  const std::vector<Entry>& e =
+      entries != nullptr ? *entries : rep->entries_;
+  begin_ = e.data();
+  end_ = e.data() + e.size();
+  cur_ = end_;
+}
+
+// Advance to the first entry with a key >= target
+void FlatSortedRep::Iterator::Seek(const Slice& user_key,
+                                   const char* memtable_key) {
+  const char* encoded_key =
+      (memtable_key != nullptr) ? memtable_key : EncodeKey(&tmp_, user_key);
+  Entry target = rep_->MakeEntry(encoded_key);
+  cur_ = std::lower_bound(
+      begin_, end_, target,
+      [this](const Entry& a, const Entry& b) { return rep_->Less(a, b); });
+}
+
+// Advance to the first entry with a key <= target
+void FlatSortedRep::Iterator::SeekForPrev(const Slice& user_key,
+                                          const char* memtable_key) {
+  const char* encoded_key =
+      (memtable_key != nullptr) ? memtable_key : EncodeKey(&tmp_, user_key);
+  Entry target = rep_->MakeEntry(encoded_key);
+  cur_ = std::upper_bound(
+      begin_, end_, target,
+      [this](const Entry& a, const Entry& b) { return rep_->Less(a, b); });
+  cur_ = cur_ == begin_ ? end_ : cur_ - 1;
+}
+
+void FlatSortedRep::Get(const LookupKey& k, void* callback_args,
+                        bool (*callback_func)(void* arg, const Slice& key,
+                                              const char* value)) {
+  if (immutable_.load(std::memory_order_acquire)) {
+    WaitForSort();
+    Iterator iter(this, nullptr);
+    for (iter.Seek(k.user_key(), k.memtable_key().data());
+         iter.Valid() && callback_func(callback_args, iter.key(), iter.value());
+         iter.Next()) {
+    }
+    return;
+  }
+  // The entries of the user key visible to k, the smallest internal key of
+  // the user key has sequence number 0
+  std::string last_key;
+  last_key.reserve(k.user_key().size() + 8);
+  last_key.append(k.user_key().data(), k.user_key().size());
+  PutFixed64(&last_key, 0);
+  Slice first_key = k.internal_key();
+  std::vector<Entry>* entries = new std::vector<Entry>();
+  for (size_t i = 0; i < shards_.Size(); ++i) {
+    Shard* shard = shards_.AccessAtCore(i);
+    std::lock_guard<SpinMutex> lock(shard->mutex);
+    for (auto key : shard->keys) {
+      if (compare_(key, first_key) >= 0 && compare_(key, last_key) <= 0) {
+        entries->emplace_back(MakeEntry(key));
+      }
+    }
+  }
+  std::sort(entries->begin(), entries->end(),
+            [this](const Entry& a, const Entry& b) { return Less(a, b); });
+  Iterator iter(this, entries);
+  for (iter.SeekToFirst();
+       iter.Valid() && callback_func(callback_args, iter.key(), iter.value());
+       iter.Next()) {
+  }
+}
+
+MemTableRep::Iterator* FlatSortedRep::GetIterator(Arena* arena) {
+  std::vector<Entry>* entries = nullptr;
+  if (immutable_.load(std::memory_order_acquire)) {
+    WaitForSort();
+  } else {
+    // Sort a copy of the entries written so far
+    entries = new std::vector<Entry>();
+    CollectEntries(entries);
+    std::sort(entries->begin(), entries->end(),
+              [this](const Entry& a, const Entry& b) { return Less(a, b); });
+  }
+  if (arena == nullptr) {
+    return new Iterator(this, entries);
+  } else {
+    auto mem = arena->AllocateAligned(sizeof(Iterator));
+    return new (mem) Iterator(this, entries);
+  }
+}
+}  // namespace
+
+MemTableRep* FlatSortedRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, bool /*needs_dup_key_check*/,
+    Allocator* allocator, const SliceTransform*, Logger* /*logger*/) {
+  return new FlatSortedRep(compare, allocator, sort_threads_,
+                           Env::Default());
+}
+
+MemTableRep* FlatSortedRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, bool /*needs_dup_key_check*/,
+    Allocator* allocator, const ImmutableCFOptions& ioptions,
+    const MutableCFOptions& /*mutable_cf_options*/,
+    uint32_t /*column_family_id*/) {
+  return new FlatSortedRep(compare, allocator, sort_threads_, ioptions.env);
+}
+
+static MemTableRepFactory* NewFlatSortedRepFactory(
+    const std::unordered_map<std::string, std::string>& options, Status*) {
+  auto f = options.find("sort_threads");
+  size_t sort_threads = 0;
+  if (options.end() != f) {
+    sort_threads = ParseSizeT(f->second);
+  }
+  return new FlatSortedRepFactory(sort_threads);
+}
+
+ROCKSDB_REGISTER_MEM_TABLE("flat_sorted", FlatSortedRepFactory);
+
+}  // namespace rocksdb
+#endif  // ROCKSDB_LITE
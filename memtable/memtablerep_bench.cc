@@ -51,6 +51,9 @@ DEFINE_string(benchmarks, "fillrandom",
               "\tfillseq                -- write N values in sequential order\n"
               "\treadrandom             -- read N values in random order\n"
               "\treadseq                -- scan the DB\n"
+              "\tfreeze                 -- mark the memtable read only and "
+              "scan it once,\n"
+              "\t                          as a flush does\n"
               "\treadwrite              -- 1 thread writes while N - 1 threads "
               "do random\n"
               "\t                          reads\n"
@@ -63,6 +66,8 @@ DEFINE_string(memtablerep, "skiplist",
               "  more details. Options:\n"
               "\tskiplist            -- backed by a skiplist\n"
               "\tvector              -- backed by an std::vector\n"
+              "\tflat_sorted         -- backed by a flat array sorted on "
+              "freeze\n"
               "\thashskiplist        -- backed by a hash skip list\n"
               "\thashlinklist        -- backed by a hash linked list\n"
               "\tcuckoo              -- backed by a cuckoo hash table\n"
@@ -130,6 +135,11 @@ DEFINE_int32(prefix_length, 8,
 DEFINE_int64(vectorrep_count, 0,
              "Number of entries to reserve on VectorRep initialization");
 
+/* FlatSortedRep settings */
+DEFINE_int64(flat_sorted_sort_threads, 0,
+             "Number of threads sorting the FlatSortedRep on freeze, 0 for "
+             "the number of cores");
+
 DEFINE_int64(seed, 0,
              "Seed base for random number generators. "
              "When 0 it is deterministic.");
@@ -520,6 +530,22 @@ class SeqReadBenchmark : public Benchmark {
   }
 };
 
+class FreezeBenchmark : public Benchmark {
+ public:
+  explicit FreezeBenchmark(MemTableRep* table, uint64_t* sequence)
+      : Benchmark(table, nullptr, sequence, 1) {
+    num_read_ops_per_thread_ = 1;
+  }
+
+  void RunThreads(std::vector<port::Thread>* /*threads*/,
+                  uint64_t* bytes_written, uint64_t* bytes_read,
+                  bool /*write*/, uint64_t* read_hits) override {
+    table_->MarkReadOnly();
+    SeqReadBenchmarkThread(table_, key_gen_, bytes_written, bytes_read,
+                           sequence_, num_read_ops_per_thread_, read_hits)();
+  }
+};
+
 template <class ReadThreadType>
 class ReadWriteBenchmark : public Benchmark {
  public:
@@ -583,6 +609,9 @@ int main(int argc, char** argv) {
     factory.reset(rocksdb::NewPatriciaTrieRepFactory());
   } else if (FLAGS_memtablerep == "vector") {
     factory.reset(new rocksdb::VectorRepFactory);
+  } else if (FLAGS_memtablerep == "flat_sorted") {
+    factory.reset(new rocksdb::FlatSortedRepFactory(
+        static_cast<size_t>(FLAGS_flat_sorted_sort_threads)));
   } else if (FLAGS_memtablerep == "hashskiplist") {
     factory.reset(rocksdb::NewHashSkipListRepFactory(
         FLAGS_bucket_count, FLAGS_hashskiplist_height,
@@ -658,6 +687,9 @@ int main(int argc, char** argv) {
                                               FLAGS_num_operations));
       benchmark.reset(
           new rocksdb::SeqReadBenchmark(memtablerep.get(), &sequence));
+    } else if (name == rocksdb::Slice("freeze")) {
+      benchmark.reset(
+          new rocksdb::FreezeBenchmark(memtablerep.get(), &sequence));
     } else if (name == rocksdb::Slice("readwrite")) {
       memtablerep.reset(createMemtableRep());
       key_gen.reset(new rocksdb::KeyGenerator(&rng, rocksdb::RANDOM,
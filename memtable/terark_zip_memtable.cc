@@ -97,6 +97,7 @@ PatriciaTrieRep::PatriciaTrieRep(details::ConcurrentType concurrent_type,
   trie_vec_[0] =
       new MainPatricia(sizeof(uint32_t), write_buffer_size_, concurrent_level_);
   trie_vec_size_ = 1;
+  rolling_over_ = false;
   overhead_ = trie_vec_[0]->mem_size_inline();
 }
 
@@ -289,144 +290,177 @@ MemTableRep::Iterator* PatriciaTrieRep::GetIterator(Arena* arena) {
   return iter;
 }
 
-bool PatriciaTrieRep::InsertKeyValue(const Slice& internal_key,
-                                     const Slice& value) {
-  TERARK_VERIFY(!immutable_);
-  // immutable check
-  // if (immutable_) return false;
-  // prepare key
-  terark::fstring key(internal_key.data(), internal_key.size() - 8);
-  auto tag = ExtractInternalKeyFooter(internal_key);
-  // lambda impl fn for insert
-  auto fn_insert_impl = [&](MainPatricia* trie) {
-    auto token = trie->tls_writer_token_nn<MemWriterToken>();
-    assert(dynamic_cast<MemWriterToken*>(token) != nullptr);
-    token->reset_tag_value(tag, value);
-    token->acquire(trie);
-    TERARK_SCOPE_EXIT(token->idle());
-    uint32_t tmp_loc = UINT32_MAX;
-    if (!token->insert(key, &tmp_loc)) {
-      size_t vector_loc = token->value_of<uint32_t>();
-      auto* vector = (details::tag_vector_t*)trie->mem_get(vector_loc);
-      size_t value_size = VarintLength(value.size()) + value.size();
-      size_t value_loc = trie->mem_alloc(value_size);
-      if (value_loc == MainPatricia::mem_alloc_fail) {
-        return details::InsertResult::Fail;
-      }
-      auto valptr = (char*)trie->mem_get(value_loc);
-      valptr = EncodeVarint32(valptr, (uint32_t)value.size());
-      memcpy(valptr, value.data(), value.size());
-      uint64_t size_loc;
-      // row lock: infinite spin on LOCK_FLAG
+details::InsertResult PatriciaTrieRep::InsertWithToken(
+    MainPatricia* trie, MemWriterToken* token, terark::fstring key,
+    uint64_t tag, const Slice& value) {
+  token->reset_tag_value(tag, value);
+  uint32_t tmp_loc = UINT32_MAX;
+  if (!token->insert(key, &tmp_loc)) {
+    size_t vector_loc = token->value_of<uint32_t>();
+    auto* vector = (details::tag_vector_t*)trie->mem_get(vector_loc);
+    size_t value_size = VarintLength(value.size()) + value.size();
+    size_t value_loc = trie->mem_alloc(value_size);
+    if (value_loc == MainPatricia::mem_alloc_fail) {
+      return details::InsertResult::Fail;
+    }
+    auto valptr = (char*)trie->mem_get(value_loc);
+    valptr = EncodeVarint32(valptr, (uint32_t)value.size());
+    memcpy(valptr, value.data(), value.size());
+    uint64_t size_loc;
+    // row lock: infinite spin on LOCK_FLAG
+    do {
       do {
-        do {
-          size_loc = vector->size_loc.load(std::memory_order_relaxed);
-        } while (size_loc & LOCK_FLAG);
-        size_loc =
-            vector->size_loc.fetch_or(LOCK_FLAG, std::memory_order_acq_rel);
+        size_loc = vector->size_loc.load(std::memory_order_relaxed);
       } while (size_loc & LOCK_FLAG);
-      auto* data =
-          (details::tag_vector_t::data_t*)trie->mem_get((uint32_t)size_loc);
-      uint32_t size = (size_loc >> 32);
-      assert(size > 0);
-      size_t insert_pos = terark::lower_bound_ex_n(
-          data, 0, size, tag >> 8,
-          [](details::tag_vector_t::data_t& item) { return item.tag >> 8; });
-      if (insert_pos < size && (tag >> 8) == (data[insert_pos].tag >> 8)) {
-        vector->size_loc.store(size_loc, std::memory_order_release);
-        trie->mem_free(value_loc, value_size);
-        return details::InsertResult::Duplicated;
-      }
-      if (!details::tag_vector_t::full(size) && insert_pos == size) {
-        data[size].loc = (uint32_t)value_loc;
-        data[size].tag = tag;
-
-        // update 'size' and unlock
-        vector->size_loc.store(size_loc + (1ULL << 32),
-                               std::memory_order_release);
-        return details::InsertResult::Success;
-      }
-      size_t old_data_cap =
-          sizeof(details::tag_vector_t::data_t) *
-          (1u << (32 - details::tag_vector_t::full(size) - fast_clz32(size)));
-      size_t cow_data_loc = trie->mem_alloc(
-          old_data_cap * (1 + details::tag_vector_t::full(size)));
-      if (cow_data_loc == MainPatricia::mem_alloc_fail) {
-        vector->size_loc.store(size_loc, std::memory_order_release);
-        trie->mem_free(value_loc, value_size);
-        return details::InsertResult::Fail;
-      }
-      auto* cow_data =
-          (details::tag_vector_t::data_t*)trie->mem_get(cow_data_loc);
-      memcpy(cow_data, data,
-             sizeof(details::tag_vector_t::data_t) * insert_pos);
-      cow_data[insert_pos].loc = (uint32_t)value_loc;
-      cow_data[insert_pos].tag = tag;
-      memcpy(cow_data + insert_pos + 1, data + insert_pos,
-             sizeof(details::tag_vector_t::data_t) * (size - insert_pos));
-      vector->size_loc.store((uint64_t(size + 1) << 32) + cow_data_loc,
+      size_loc = vector->size_loc.fetch_or(LOCK_FLAG, std::memory_order_acq_rel);
+    } while (size_loc & LOCK_FLAG);
+    auto* data =
+        (details::tag_vector_t::data_t*)trie->mem_get((uint32_t)size_loc);
+    uint32_t size = (size_loc >> 32);
+    assert(size > 0);
+    size_t insert_pos = terark::lower_bound_ex_n(
+        data, 0, size, tag >> 8,
+        [](details::tag_vector_t::data_t& item) { return item.tag >> 8; });
+    if (insert_pos < size && (tag >> 8) == (data[insert_pos].tag >> 8)) {
+      vector->size_loc.store(size_loc, std::memory_order_release);
+      trie->mem_free(value_loc, value_size);
+      return details::InsertResult::Duplicated;
+    }
+    if (!details::tag_vector_t::full(size) && insert_pos == size) {
+      data[size].loc = (uint32_t)value_loc;
+      data[size].tag = tag;
+
+      // update 'size' and unlock
+      vector->size_loc.store(size_loc + (1ULL << 32),
                              std::memory_order_release);
-      trie->mem_lazy_free((uint32_t)size_loc, old_data_cap);
-      return details::InsertResult::Success;
-    } else if (token->value() != nullptr) {
-      const auto token_value_loc = token->value_of<uint32_t>();
-      TERARK_VERIFY(token_value_loc == tmp_loc);
       return details::InsertResult::Success;
-    } else
+    }
+    size_t old_data_cap =
+        sizeof(details::tag_vector_t::data_t) *
+        (1u << (32 - details::tag_vector_t::full(size) - fast_clz32(size)));
+    size_t cow_data_loc =
+        trie->mem_alloc(old_data_cap * (1 + details::tag_vector_t::full(size)));
+    if (cow_data_loc == MainPatricia::mem_alloc_fail) {
+      vector->size_loc.store(size_loc, std::memory_order_release);
+      trie->mem_free(value_loc, value_size);
       return details::InsertResult::Fail;
-  };
+    }
+    auto* cow_data =
+        (details::tag_vector_t::data_t*)trie->mem_get(cow_data_loc);
+    memcpy(cow_data, data, sizeof(details::tag_vector_t::data_t) * insert_pos);
+    cow_data[insert_pos].loc = (uint32_t)value_loc;
+    cow_data[insert_pos].tag = tag;
+    memcpy(cow_data + insert_pos + 1, data + insert_pos,
+           sizeof(details::tag_vector_t::data_t) * (size - insert_pos));
+    vector->size_loc.store((uint64_t(size + 1) << 32) + cow_data_loc,
+                           std::memory_order_release);
+    trie->mem_lazy_free((uint32_t)size_loc, old_data_cap);
+    return details::InsertResult::Success;
+  } else if (token->value() != nullptr) {
+    const auto token_value_loc = token->value_of<uint32_t>();
+    TERARK_VERIFY(token_value_loc == tmp_loc);
+    return details::InsertResult::Success;
+  } else
+    return details::InsertResult::Fail;
+}
+
+bool PatriciaTrieRep::ContainsTag(terark::fstring key, uint64_t tag) const {
+  for (size_t i = 0; i < trie_vec_size_; ++i) {
+    auto* trie = trie_vec_[i];
+    auto token = trie->tls_reader_token();
+    token->acquire(trie);
+    TERARK_SCOPE_EXIT(token->idle());
+    if (trie->lookup(key, token)) {
+      auto vector =
+          (details::tag_vector_t*)trie->mem_get(token->value_of<uint32_t>());
+      uint64_t size_loc = vector->size_loc.load(std::memory_order_relaxed);
+      auto data =
+          (details::tag_vector_t::data_t*)trie->mem_get((uint32_t)size_loc);
+      if (terark::binary_search_0(data, (size_loc >> 32) & SIZE_MASK, tag)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
 
-  auto fn_create_new_trie = [&]() {
+void PatriciaTrieRep::AddTrie(size_t curr_trie_vec_size, size_t bound) {
+  bool rolling = false;
+  if (!rolling_over_.compare_exchange_strong(rolling, true,
+                                             std::memory_order_acq_rel)) {
+    // another writer is adding a trie, retry on it
+    while (rolling_over_.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+    return;
+  }
+  // the trie may have been added since the caller failed on the last one
+  if (trie_vec_size_.load(std::memory_order_acquire) == curr_trie_vec_size) {
     if (write_buffer_size_ > 0) {
       if (write_buffer_size_ < size_limit_) write_buffer_size_ *= 2;
       if (write_buffer_size_ > size_limit_) write_buffer_size_ = size_limit_;
-      size_t bound = key.size() + VarintLength(value.size()) + value.size();
       if (size_t(write_buffer_size_) < bound)
         write_buffer_size_ = std::min(bound + (16 << 20), size_t(-1) >> 1);
     }
-    trie_vec_[trie_vec_size_] = new MainPatricia(
+    TERARK_VERIFY(curr_trie_vec_size < trie_vec_.size());
+    trie_vec_[curr_trie_vec_size] = new MainPatricia(
         sizeof(uint32_t), write_buffer_size_, concurrent_level_);
-    trie_vec_size_++;
-  };
-  // tool lambda fn end
-  // function start
-  if (handle_duplicate_) {
-    for (size_t i = 0; i < trie_vec_size_; ++i) {
-      auto* trie = trie_vec_[i];
-      auto token = trie->tls_reader_token();
-      token->acquire(trie);
-      TERARK_SCOPE_EXIT(token->idle());
-      if (trie->lookup(key, token)) {
-        auto vector =
-            (details::tag_vector_t*)trie->mem_get(token->value_of<uint32_t>());
-        uint64_t size_loc = vector->size_loc.load(std::memory_order_relaxed);
-        auto data =
-            (details::tag_vector_t::data_t*)trie->mem_get((uint32_t)size_loc);
-        if (terark::binary_search_0(data, (size_loc >> 32) & SIZE_MASK, tag)) {
-          return false;
+    // publish the trie before it can be seen by readers and writers
+    trie_vec_size_.store(curr_trie_vec_size + 1, std::memory_order_release);
+  }
+  rolling_over_.store(false, std::memory_order_release);
+}
+
+bool PatriciaTrieRep::InsertKeyValue(const Slice& internal_key,
+                                     const Slice& value) {
+  return InsertKeyValueBatch(&internal_key, &value, 1, true);
+}
+
+bool PatriciaTrieRep::InsertKeyValueBatch(const Slice* internal_keys,
+                                          const Slice* values, size_t count,
+                                          bool /*concurrently*/) {
+  TERARK_VERIFY(!immutable_);
+  bool ret = true;
+  size_t i = 0;
+  while (i < count) {
+    size_t curr_trie_vec_size = trie_vec_size_.load(std::memory_order_acquire);
+    auto* trie = trie_vec_[curr_trie_vec_size - 1];
+    auto token = trie->tls_writer_token_nn<MemWriterToken>();
+    assert(dynamic_cast<MemWriterToken*>(token) != nullptr);
+    // one acquire for all the keys going into this trie
+    token->acquire(trie);
+    details::InsertResult insert_result = details::InsertResult::Success;
+    for (; i < count; ++i) {
+      const Slice& internal_key = internal_keys[i];
+      terark::fstring key(internal_key.data(), internal_key.size() - 8);
+      auto tag = ExtractInternalKeyFooter(internal_key);
+      if (handle_duplicate_) {
+        token->idle();
+        bool duplicated = ContainsTag(key, tag);
+        token->acquire(trie);
+        if (duplicated) {
+          ret = false;
+          continue;
         }
       }
-    }
-  }
-  details::InsertResult insert_result = details::InsertResult::Fail;
-  for (;;) {
-    size_t curr_trie_vec_size = trie_vec_size_;
-    insert_result = fn_insert_impl(trie_vec_[curr_trie_vec_size - 1]);
-    if (insert_result == details::InsertResult::Duplicated) {
-      return !handle_duplicate_;
-    }
-    if (insert_result == details::InsertResult::Success) {
-      break;
-    } else {
-      assert(insert_result == details::InsertResult::Fail);
-      std::unique_lock<std::mutex> lock(mutex_);
-      if (curr_trie_vec_size == trie_vec_size_) {
-        fn_create_new_trie();
+      insert_result = InsertWithToken(trie, token, key, tag, values[i]);
+      if (insert_result == details::InsertResult::Fail) {
+        break;
       }
+      if (insert_result == details::InsertResult::Duplicated &&
+          handle_duplicate_) {
+        ret = false;
+      }
+    }
+    token->idle();
+    if (insert_result == details::InsertResult::Fail) {
+      // the trie is full, retry entry i on a new one
+      size_t bound = internal_keys[i].size() - 8 +
+                     VarintLength(values[i].size()) + values[i].size();
+      AddTrie(curr_trie_vec_size, bound);
     }
   }
-  assert(insert_result == details::InsertResult::Success);
-  return true;
+  return ret;
 }
 
 template <bool heap_mode>
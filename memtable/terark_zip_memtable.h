@@ -9,6 +9,7 @@
 #include <memory>
 #include <mutex>
 #include <numeric>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -74,11 +75,26 @@ class PatriciaTrieRep : public MemTableRep {
   bool handle_duplicate_;
   std::atomic_bool immutable_;
   terark_memtable_details::tries_t trie_vec_;
-  size_t trie_vec_size_;
+  // a trie is written to trie_vec_ before trie_vec_size_ is bumped
+  std::atomic<size_t> trie_vec_size_;
+  // set by the writer adding a trie when the last one is full
+  std::atomic<bool> rolling_over_;
   size_t overhead_;  // this overhead is for new memtable size check
   int64_t write_buffer_size_;
   static const int64_t size_limit_ = 1LL << 30;
-  std::mutex mutex_;
+
+  // Insert <key, tag> into trie, token is acquired on trie.
+  terark_memtable_details::InsertResult InsertWithToken(
+      terark::MainPatricia* trie, MemWriterToken* token, terark::fstring key,
+      uint64_t tag, const Slice& value);
+
+  // Return true if any trie contains <key, tag>.
+  bool ContainsTag(terark::fstring key, uint64_t tag) const;
+
+  // Add a trie after the last one of curr_trie_vec_size tries is full, bound
+  // is the size of the record which does not fit. Writers failing on the
+  // same trie race for rolling_over_, the others wait for the new trie.
+  void AddTrie(size_t curr_trie_vec_size, size_t bound);
 
  public:
   // Create a new patricia trie memtable rep with following options
@@ -123,6 +139,14 @@ class PatriciaTrieRep : public MemTableRep {
     return InsertKeyValue(internal_key, value);
   }
 
+  // Insert the sorted entries of a write batch with one acquire of the
+  // writer token per trie.
+  virtual bool InsertKeyValueBatch(const Slice* internal_keys,
+                                   const Slice* values, size_t count,
+                                   bool concurrently) override;
+
+  virtual bool IsBatchInsertSupported() const override { return true; }
+
   virtual void MarkReadOnly() override;
 };
 
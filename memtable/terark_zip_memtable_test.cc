@@ -12,6 +12,7 @@
 
 #include "db/dbformat.h"
 #include "gtest/gtest.h"
+#include "table/scoped_arena_iterator.h"
 
 namespace rocksdb {
 
@@ -194,6 +195,65 @@ TEST_F(TerarkZipMemtableTest, MultiThreadingTest) {
   printf("[SkipList] Multi-Thread Time Cost: %" PRId64 ", mem_->size = %" PRId64 "\n", dur, total_size);
   delete mem_;
 }
+
+// Test concurrent batch insertion, the tries roll over while writing
+TEST_F(TerarkZipMemtableTest, BatchTest) {
+  Options options;
+  options.allow_concurrent_memtable_write = true;
+  options.memtable_factory =
+      std::shared_ptr<MemTableRepFactory>(NewPatriciaTrieRepFactory());
+
+  InternalKeyComparator cmp(BytewiseComparator());
+  ImmutableCFOptions ioptions(options);
+  WriteBufferManager wb(options.db_write_buffer_size);
+
+  std::unique_ptr<MemTable> mem(
+      new MemTable(cmp, ioptions, MutableCFOptions(options),
+                   /* needs_dup_key_check */ false, &wb, kMaxSequenceNumber,
+                   0 /* column_family_id */));
+  ASSERT_TRUE(mem->IsBatchInsertSupported());
+
+  // more than the 64MB of the first trie
+  const size_t records = 1 << 21;
+  const size_t batch_size = 16;
+  const int thread_cnt = 8;
+  std::vector<std::thread> threads;
+  std::vector<MemTablePostProcessInfo> infos(thread_cnt);
+  std::atomic<SequenceNumber> atomic_seq{1};
+  for (int t = 0; t < thread_cnt; ++t) {
+    threads.emplace_back([&, t]() {
+      std::vector<std::string> keys(batch_size), values(batch_size);
+      std::vector<MemTable::BatchEntry> batch(batch_size);
+      for (size_t i = t * batch_size; i < records;
+           i += thread_cnt * batch_size) {
+        SequenceNumber seq = atomic_seq.fetch_add(batch_size);
+        for (size_t j = 0; j < batch_size; ++j) {
+          // unsorted, AddBatch sorts them
+          keys[j] = "key " + std::to_string(i + batch_size - 1 - j);
+          values[j] = "value " + std::to_string(i + batch_size - 1 - j);
+          batch[j] = {seq + j, kTypeValue, keys[j], values[j]};
+        }
+        mem->AddBatch(batch.data(), batch_size, true, &infos[t]);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  uint64_t total_size = 0;
+  for (auto& info : infos) {
+    total_size += info.num_entries;
+  }
+  ASSERT_EQ(records, total_size);
+
+  Arena arena;
+  ScopedArenaIterator iter(mem->NewIterator(ReadOptions(), &arena));
+  size_t count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ++count;
+  }
+  ASSERT_EQ(records, count);
+}
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
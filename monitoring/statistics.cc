@@ -134,6 +134,9 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {NUMBER_MULTIGET_KEYS_FOUND, "rocksdb.number.multiget.keys.found"},
     {NO_ITERATOR_CREATED, "rocksdb.num.iterator.created"},
     {NO_ITERATOR_DELETED, "rocksdb.num.iterator.deleted"},
+    {POINT_LOOKUP_INDEX_USEFUL, "rocksdb.point.lookup.index.useful"},
+    {HOT_KEY_CACHE_HIT, "rocksdb.hot.key.cache.hit"},
+    {HOT_KEY_CACHE_MISS, "rocksdb.hot.key.cache.miss"},
 };
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
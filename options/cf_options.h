@@ -145,6 +145,7 @@ struct MutableCFOptions {
             options.memtable_prefix_bloom_size_ratio),
         memtable_huge_page_size(options.memtable_huge_page_size),
         max_successive_merges(options.max_successive_merges),
+        collapse_merge_operands(options.collapse_merge_operands),
         inplace_update_num_locks(options.inplace_update_num_locks),
         prefix_extractor(options.prefix_extractor),
         disable_auto_compactions(options.disable_auto_compactions),
@@ -185,6 +186,7 @@ struct MutableCFOptions {
         memtable_prefix_bloom_size_ratio(0),
         memtable_huge_page_size(0),
         max_successive_merges(0),
+        collapse_merge_operands(false),
         inplace_update_num_locks(0),
         prefix_extractor(nullptr),
         disable_auto_compactions(false),
@@ -240,6 +242,7 @@ struct MutableCFOptions {
   double memtable_prefix_bloom_size_ratio;
   size_t memtable_huge_page_size;
   size_t max_successive_merges;
+  bool collapse_merge_operands;
   size_t inplace_update_num_locks;
   std::shared_ptr<const SliceTransform> prefix_extractor;
 
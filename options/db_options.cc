@@ -34,6 +34,7 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       info_log(options.info_log),
       info_log_level(options.info_log_level),
       max_file_opening_threads(options.max_file_opening_threads),
+      lazy_open_table_files(options.lazy_open_table_files),
       statistics(options.statistics),
       use_fsync(options.use_fsync),
       db_paths(options.db_paths),
@@ -47,6 +48,7 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       prepare_log_writer_num(options.prepare_log_writer_num),
       max_manifest_file_size(options.max_manifest_file_size),
       max_manifest_edit_count(options.max_manifest_edit_count),
+      background_manifest_rollover(options.background_manifest_rollover),
       table_cache_numshardbits(options.table_cache_numshardbits),
       wal_ttl_seconds(options.WAL_ttl_seconds),
       wal_size_limit_mb(options.WAL_size_limit_MB),
@@ -57,6 +59,7 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       use_direct_io_for_flush_and_compaction(
           options.use_direct_io_for_flush_and_compaction),
       use_aio_reads(options.use_aio_reads),
+      use_io_uring(options.use_io_uring),
       allow_fallocate(options.allow_fallocate),
       is_fd_close_on_exec(options.is_fd_close_on_exec),
       advise_random_on_open(options.advise_random_on_open),
@@ -81,6 +84,7 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       wal_recovery_mode(options.wal_recovery_mode),
       allow_2pc(options.allow_2pc),
       row_cache(options.row_cache),
+      hot_key_cache(options.hot_key_cache),
 #ifndef ROCKSDB_LITE
       wal_filter(options.wal_filter),
 #endif  // ROCKSDB_LITE
@@ -92,7 +96,8 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       two_write_queues(options.two_write_queues),
       manual_wal_flush(options.manual_wal_flush),
       atomic_flush(options.atomic_flush),
-      avoid_unnecessary_blocking_io(options.avoid_unnecessary_blocking_io) {
+      avoid_unnecessary_blocking_io(options.avoid_unnecessary_blocking_io),
+      numa_aware(options.numa_aware) {
 }
 
 void ImmutableDBOptions::Dump(Logger* log) const {
@@ -108,6 +113,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    info_log.get());
   ROCKS_LOG_HEADER(log, "               Options.max_file_opening_threads: %d",
                    max_file_opening_threads);
+  ROCKS_LOG_HEADER(log, "                  Options.lazy_open_table_files: %d",
+                   lazy_open_table_files);
   ROCKS_LOG_HEADER(log, "                             Options.statistics: %p",
                    statistics.get());
   ROCKS_LOG_HEADER(log, "                              Options.use_fsync: %d",
@@ -121,6 +128,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
   ROCKS_LOG_HEADER(log,
                    "                Options.max_manifest_edit_count: %" PRIu64,
                    max_manifest_edit_count);
+  ROCKS_LOG_HEADER(log, "           Options.background_manifest_rollover: %d",
+                   background_manifest_rollover);
   ROCKS_LOG_HEADER(
       log, "                  Options.log_file_time_to_roll: %" ROCKSDB_PRIszt,
       log_file_time_to_roll);
@@ -147,6 +156,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    use_direct_io_for_flush_and_compaction);
   ROCKS_LOG_HEADER(log, "                          Options.use_aio_reads: %d",
                    use_aio_reads);
+  ROCKS_LOG_HEADER(log, "                           Options.use_io_uring: %d",
+                   use_io_uring);
   ROCKS_LOG_HEADER(log, "         Options.create_missing_column_families: %d",
                    create_missing_column_families);
   ROCKS_LOG_HEADER(log, "                             Options.db_log_dir: %s",
@@ -227,6 +238,14 @@ void ImmutableDBOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "                              Options.row_cache: None");
   }
+  if (hot_key_cache) {
+    ROCKS_LOG_HEADER(
+        log, "                          Options.hot_key_cache: %" PRIu64,
+        hot_key_cache->GetCapacity());
+  } else {
+    ROCKS_LOG_HEADER(log,
+                     "                          Options.hot_key_cache: None");
+  }
 #ifndef ROCKSDB_LITE
   ROCKS_LOG_HEADER(log, "                             Options.wal_filter: %s",
                    wal_filter ? wal_filter->Name() : "None");
@@ -246,6 +265,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    atomic_flush);
   ROCKS_LOG_HEADER(log, "          Options.avoid_unnecessary_blocking_io: %d",
                    avoid_unnecessary_blocking_io);
+  ROCKS_LOG_HEADER(log, "                             Options.numa_aware: %d",
+                   numa_aware);
 }
 
 MutableDBOptions::MutableDBOptions()
@@ -29,6 +29,7 @@ struct ImmutableDBOptions {
   std::shared_ptr<Logger> info_log;
   InfoLogLevel info_log_level;
   int max_file_opening_threads;
+  bool lazy_open_table_files;
   std::shared_ptr<Statistics> statistics;
   bool use_fsync;
   std::vector<DbPath> db_paths;
@@ -43,6 +44,7 @@ struct ImmutableDBOptions {
   size_t prepare_log_writer_num;
   uint64_t max_manifest_file_size;
   uint64_t max_manifest_edit_count;
+  bool background_manifest_rollover;
   int table_cache_numshardbits;
   uint64_t wal_ttl_seconds;
   uint64_t wal_size_limit_mb;
@@ -52,6 +54,7 @@ struct ImmutableDBOptions {
   bool use_direct_reads;
   bool use_direct_io_for_flush_and_compaction;
   bool use_aio_reads;
+  bool use_io_uring;
   bool allow_fallocate;
   bool is_fd_close_on_exec;
   bool advise_random_on_open;
@@ -74,6 +77,7 @@ struct ImmutableDBOptions {
   WALRecoveryMode wal_recovery_mode;
   bool allow_2pc;
   std::shared_ptr<Cache> row_cache;
+  std::shared_ptr<Cache> hot_key_cache;
 #ifndef ROCKSDB_LITE
   WalFilter* wal_filter;
 #endif  // ROCKSDB_LITE
@@ -86,6 +90,7 @@ struct ImmutableDBOptions {
   bool manual_wal_flush;
   bool atomic_flush;
   bool avoid_unnecessary_blocking_io;
+  bool numa_aware;
 };
 
 struct MutableDBOptions {
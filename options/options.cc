@@ -85,6 +85,7 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       table_properties_collector_factories(
           options.table_properties_collector_factories),
       max_successive_merges(options.max_successive_merges),
+      collapse_merge_operands(options.collapse_merge_operands),
       optimize_filters_for_hits(options.optimize_filters_for_hits),
       paranoid_file_checks(options.paranoid_file_checks),
       force_consistency_checks(options.force_consistency_checks),
@@ -343,6 +344,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
   ROCKS_LOG_HEADER(
       log, "                  Options.max_successive_merges: %" ROCKSDB_PRIszt,
       max_successive_merges);
+  ROCKS_LOG_HEADER(log, "                Options.collapse_merge_operands: %d",
+                   collapse_merge_operands);
   ROCKS_LOG_HEADER(log, "              Options.optimize_filters_for_hits: %d",
                    optimize_filters_for_hits);
   ROCKS_LOG_HEADER(log, "                   Options.paranoid_file_checks: %d",
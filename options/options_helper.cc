@@ -45,6 +45,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.max_open_files = mutable_db_options.max_open_files;
   options.max_file_opening_threads =
       immutable_db_options.max_file_opening_threads;
+  options.lazy_open_table_files = immutable_db_options.lazy_open_table_files;
   options.max_wal_size = mutable_db_options.max_wal_size;
   options.max_total_wal_size = mutable_db_options.max_total_wal_size;
   options.statistics = immutable_db_options.statistics;
@@ -72,6 +73,8 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.max_manifest_file_size = immutable_db_options.max_manifest_file_size;
   options.max_manifest_edit_count =
       immutable_db_options.max_manifest_edit_count;
+  options.background_manifest_rollover =
+      immutable_db_options.background_manifest_rollover;
   options.table_cache_numshardbits =
       immutable_db_options.table_cache_numshardbits;
   options.WAL_ttl_seconds = immutable_db_options.wal_ttl_seconds;
@@ -84,6 +87,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.use_direct_io_for_flush_and_compaction =
       immutable_db_options.use_direct_io_for_flush_and_compaction;
   options.use_aio_reads = immutable_db_options.use_aio_reads;
+  options.use_io_uring = immutable_db_options.use_io_uring;
   options.allow_fallocate = immutable_db_options.allow_fallocate;
   options.is_fd_close_on_exec = immutable_db_options.is_fd_close_on_exec;
   options.stats_dump_period_sec = mutable_db_options.stats_dump_period_sec;
@@ -120,6 +124,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.wal_recovery_mode = immutable_db_options.wal_recovery_mode;
   options.allow_2pc = immutable_db_options.allow_2pc;
   options.row_cache = immutable_db_options.row_cache;
+  options.hot_key_cache = immutable_db_options.hot_key_cache;
 #ifndef ROCKSDB_LITE
   options.wal_filter = immutable_db_options.wal_filter;
 #endif  // ROCKSDB_LITE
@@ -137,6 +142,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.atomic_flush = immutable_db_options.atomic_flush;
   options.avoid_unnecessary_blocking_io =
       immutable_db_options.avoid_unnecessary_blocking_io;
+  options.numa_aware = immutable_db_options.numa_aware;
 
   return options;
 }
@@ -154,6 +160,7 @@ ColumnFamilyOptions BuildColumnFamilyOptions(
       mutable_cf_options.memtable_prefix_bloom_size_ratio;
   cf_opts.memtable_huge_page_size = mutable_cf_options.memtable_huge_page_size;
   cf_opts.max_successive_merges = mutable_cf_options.max_successive_merges;
+  cf_opts.collapse_merge_operands = mutable_cf_options.collapse_merge_operands;
   cf_opts.inplace_update_num_locks =
       mutable_cf_options.inplace_update_num_locks;
   cf_opts.prefix_extractor = mutable_cf_options.prefix_extractor;
@@ -1409,6 +1416,7 @@ std::unordered_map<std::string, OptionTypeInfo>
          // not yet supported
           Env* env;
           std::shared_ptr<Cache> row_cache;
+          std::shared_ptr<Cache> hot_key_cache;
           std::shared_ptr<DeleteScheduler> delete_scheduler;
           std::shared_ptr<Logger> info_log;
           std::shared_ptr<RateLimiter> rate_limiter;
@@ -1443,6 +1451,9 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"use_aio_reads",
          {offsetof(struct DBOptions, use_aio_reads), OptionType::kBoolean,
           OptionVerificationType::kNormal, false, 0}},
+        {"use_io_uring",
+         {offsetof(struct DBOptions, use_io_uring), OptionType::kBoolean,
+          OptionVerificationType::kNormal, false, 0}},
         {"allow_2pc",
          {offsetof(struct DBOptions, allow_2pc), OptionType::kBoolean,
           OptionVerificationType::kNormal, false, 0}},
@@ -1518,6 +1529,9 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"max_file_opening_threads",
          {offsetof(struct DBOptions, max_file_opening_threads),
           OptionType::kInt, OptionVerificationType::kNormal, false, 0}},
+        {"lazy_open_table_files",
+         {offsetof(struct DBOptions, lazy_open_table_files),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
         {"max_open_files",
          {offsetof(struct DBOptions, max_open_files), OptionType::kInt,
           OptionVerificationType::kNormal, true,
@@ -1581,6 +1595,9 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"max_manifest_edit_count",
          {offsetof(struct DBOptions, max_manifest_edit_count),
           OptionType::kUInt64T, OptionVerificationType::kNormal, false, 0}},
+        {"background_manifest_rollover",
+         {offsetof(struct DBOptions, background_manifest_rollover),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
         {"max_wal_size",
          {offsetof(struct DBOptions, max_wal_size), OptionType::kUInt64T,
           OptionVerificationType::kNormal, true,
@@ -1668,7 +1685,11 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"avoid_unnecessary_blocking_io",
          {offsetof(struct DBOptions, avoid_unnecessary_blocking_io),
           OptionType::kBoolean, OptionVerificationType::kNormal, false,
-          offsetof(struct ImmutableDBOptions, avoid_unnecessary_blocking_io)}}};
+          offsetof(struct ImmutableDBOptions, avoid_unnecessary_blocking_io)}},
+        {"numa_aware",
+         {offsetof(struct DBOptions, numa_aware), OptionType::kBoolean,
+          OptionVerificationType::kNormal, false,
+          offsetof(struct ImmutableDBOptions, numa_aware)}}};
 
 std::unordered_map<std::string, BlockBasedTableOptions::IndexType>
     OptionsHelper::block_base_table_index_type_string_map = {
@@ -1912,6 +1933,10 @@ std::unordered_map<std::string, OptionTypeInfo>
          {offset_of(&ColumnFamilyOptions::max_successive_merges),
           OptionType::kSizeT, OptionVerificationType::kNormal, true,
           offsetof(struct MutableCFOptions, max_successive_merges)}},
+        {"collapse_merge_operands",
+         {offset_of(&ColumnFamilyOptions::collapse_merge_operands),
+          OptionType::kBoolean, OptionVerificationType::kNormal, true,
+          offsetof(struct MutableCFOptions, collapse_merge_operands)}},
         {"memtable_huge_page_size",
          {offset_of(&ColumnFamilyOptions::memtable_huge_page_size),
           OptionType::kSizeT, OptionVerificationType::kNormal, true,
@@ -21,7 +21,11 @@
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <unistd.h>
+#include <algorithm>
 #include <cstdlib>
+#ifdef NUMA
+#include <numa.h>
+#endif
 #include "util/logging.h"
 
 namespace rocksdb {
@@ -201,6 +205,48 @@ void cacheline_aligned_free(void *memblock) {
   free(memblock);
 }
 
+int NumaNodeCount() {
+#ifdef NUMA
+  if (numa_available() >= 0) {
+    return std::max(numa_num_configured_nodes(), 1);
+  }
+#endif
+  return 1;
+}
+
+bool BindThreadToNumaNode(int node) {
+#ifdef NUMA
+  if (numa_available() >= 0) {
+    return numa_run_on_node(node) == 0;
+  }
+#else
+  (void)node;
+#endif
+  return false;
+}
+
+void *NumaAllocOnNode(size_t size, int node) {
+#ifdef NUMA
+  if (numa_available() >= 0) {
+    return numa_alloc_onnode(size, node);
+  }
+#else
+  (void)size;
+  (void)node;
+#endif
+  return nullptr;
+}
+
+void NumaFree(void *memblock, size_t size) {
+#ifdef NUMA
+  numa_free(memblock, size);
+#else
+  (void)memblock;
+  (void)size;
+  assert(false);
+#endif
+}
+
 
 }  // namespace port
 }  // namespace rocksdb
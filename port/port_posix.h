@@ -199,6 +199,21 @@ extern void *cacheline_aligned_alloc(size_t size);
 
 extern void cacheline_aligned_free(void *memblock);
 
+// Returns the number of NUMA nodes memory can be allocated on, 1 if the
+// library is built without NUMA or the system does not support it
+extern int NumaNodeCount();
+
+// Binds the calling thread to the cpus of NUMA node `node`.
+// Returns false if it is not supported
+extern bool BindThreadToNumaNode(int node);
+
+// Allocates `size` bytes of page aligned memory on NUMA node `node`.
+// Returns nullptr if it is not supported
+extern void *NumaAllocOnNode(size_t size, int node);
+
+// Frees the memory returned by NumaAllocOnNode
+extern void NumaFree(void *memblock, size_t size);
+
 #define ALIGN_AS(n) alignas(n)
 
 #define PREFETCH(addr, rw, locality) __builtin_prefetch(addr, rw, locality)
@@ -281,6 +281,14 @@ static inline void AsmVolatilePause() {
 
 extern int PhysicalCoreID();
 
+inline int NumaNodeCount() { return 1; }
+
+inline bool BindThreadToNumaNode(int /*node*/) { return false; }
+
+inline void *NumaAllocOnNode(size_t /*size*/, int /*node*/) { return nullptr; }
+
+inline void NumaFree(void * /*memblock*/, size_t /*size*/) { assert(false); }
+
 // For Thread Local Storage abstraction
 typedef DWORD pthread_key_t;
 
@@ -209,8 +209,10 @@ void DataBlockIter::Seek(const Slice& target) {
     return;
   }
   uint32_t index = 0;
-  bool ok = BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index,
-                                  comparator_);
+  uint32_t left = 0;
+  uint32_t right = num_restarts_ - 1;
+  NarrowRestartRange(seek_key, true /* key_is_internal */, &left, &right);
+  bool ok = BinarySeek<DecodeKey>(seek_key, left, right, &index, comparator_);
 
   if (!ok) {
     return;
@@ -355,12 +357,15 @@ void IndexBlockIter::Seek(const Slice& target) {
   bool ok = false;
   if (prefix_index_) {
     ok = PrefixSeek(target, &index);
-  } else if (value_delta_encoded_) {
-    ok = BinarySeek<DecodeKeyV4>(seek_key, 0, num_restarts_ - 1, &index,
-                                 comparator_);
   } else {
-    ok = BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index,
-                               comparator_);
+    uint32_t left = 0;
+    uint32_t right = num_restarts_ - 1;
+    NarrowRestartRange(seek_key, key_includes_seq_, &left, &right);
+    if (value_delta_encoded_) {
+      ok = BinarySeek<DecodeKeyV4>(seek_key, left, right, &index, comparator_);
+    } else {
+      ok = BinarySeek<DecodeKey>(seek_key, left, right, &index, comparator_);
+    }
   }
 
   if (!ok) {
@@ -383,8 +388,10 @@ void DataBlockIter::SeekForPrev(const Slice& target) {
     return;
   }
   uint32_t index = 0;
-  bool ok = BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index,
-                                  comparator_);
+  uint32_t left = 0;
+  uint32_t right = num_restarts_ - 1;
+  NarrowRestartRange(seek_key, true /* key_is_internal */, &left, &right);
+  bool ok = BinarySeek<DecodeKey>(seek_key, left, right, &index, comparator_);
 
   if (!ok) {
     return;
@@ -486,7 +493,8 @@ bool DataBlockIter::ParseNextDataKey(const char* limit) {
     if (global_seqno_ != kDisableGlobalSequenceNumber) {
       // If we are reading a file with a global sequence number we should
       // expect that all encoded sequence numbers are zeros and any value
-      // type is kTypeValue, kTypeMerge, kTypeDeletion, or kTypeRangeDeletion.
+      // type is kTypeValue, kTypeMerge, kTypeDeletion, kTypeRangeDeletion,
+      // or the index of a value separated into a blob sst.
       assert(GetInternalKeySeqno(key_.GetInternalKey()) == 0);
 
       uint64_t packed = ExtractInternalKeyFooter(key_.GetKey());
@@ -494,7 +502,9 @@ bool DataBlockIter::ParseNextDataKey(const char* limit) {
       assert(stored_value_type_ == ValueType::kTypeValue ||
              stored_value_type_ == ValueType::kTypeMerge ||
              stored_value_type_ == ValueType::kTypeDeletion ||
-             stored_value_type_ == ValueType::kTypeRangeDeletion);
+             stored_value_type_ == ValueType::kTypeRangeDeletion ||
+             stored_value_type_ == ValueType::kTypeValueIndex ||
+             stored_value_type_ == ValueType::kTypeMergeIndex);
 
       if (key_pinned_) {
         // TODO(tec): Investigate updating the seqno in the loaded block
@@ -771,6 +781,7 @@ Block::~Block() {
   // This sync point can be re-enabled if RocksDB can control the
   // initialization order of any/all static options created by the user.
   // TEST_SYNC_POINT("Block::~Block");
+  delete restart_prefix_index_.load(std::memory_order_relaxed);
 }
 
 Block::Block(BlockContents&& contents, SequenceNumber _global_seqno,
@@ -780,7 +791,8 @@ Block::Block(BlockContents&& contents, SequenceNumber _global_seqno,
       size_(contents_.data.size()),
       restart_offset_(0),
       num_restarts_(0),
-      global_seqno_(_global_seqno) {
+      global_seqno_(_global_seqno),
+      restart_prefix_index_(nullptr) {
   TEST_SYNC_POINT("Block::Block:0");
   if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
@@ -831,6 +843,28 @@ Block::Block(BlockContents&& contents, SequenceNumber _global_seqno,
   }
 }
 
+const RestartPrefixIndex* Block::GetRestartPrefixIndex(
+    bool key_includes_seq, bool value_is_full) const {
+  RestartPrefixIndex* index =
+      restart_prefix_index_.load(std::memory_order_acquire);
+  if (index != nullptr) {
+    return index;
+  }
+  index = RestartPrefixIndex::Build(data_, restart_offset_, num_restarts_,
+                                    key_includes_seq, !value_is_full);
+  if (index == nullptr) {
+    return nullptr;
+  }
+  RestartPrefixIndex* expected = nullptr;
+  if (!restart_prefix_index_.compare_exchange_strong(
+          expected, index, std::memory_order_acq_rel)) {
+    // Another iterator published its index first
+    delete index;
+    index = expected;
+  }
+  return index;
+}
+
 template <>
 DataBlockIter* Block::NewIterator(const Comparator* cmp, const Comparator* ucmp,
                                   DataBlockIter* iter, Statistics* stats,
@@ -838,7 +872,8 @@ DataBlockIter* Block::NewIterator(const Comparator* cmp, const Comparator* ucmp,
                                   bool /*key_includes_seq*/,
                                   bool /*value_is_full*/,
                                   bool block_contents_pinned,
-                                  BlockPrefixIndex* /*prefix_index*/) {
+                                  BlockPrefixIndex* /*prefix_index*/,
+                                  bool restart_prefix_search) {
   DataBlockIter* ret_iter;
   if (iter != nullptr) {
     ret_iter = iter;
@@ -858,6 +893,9 @@ DataBlockIter* Block::NewIterator(const Comparator* cmp, const Comparator* ucmp,
         cmp, ucmp, data_, restart_offset_, num_restarts_, global_seqno_,
         read_amp_bitmap_.get(), block_contents_pinned,
         data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr);
+    if (restart_prefix_search && ucmp == BytewiseComparator()) {
+      ret_iter->SetRestartPrefixIndex(GetRestartPrefixIndex(true, true));
+    }
     if (read_amp_bitmap_) {
       if (read_amp_bitmap_->GetStatistics() != stats) {
         // DB changed the Statistics pointer, we need to notify read_amp_bitmap_
@@ -875,7 +913,8 @@ IndexBlockIter* Block::NewIterator(const Comparator* cmp,
                                    Statistics* /*stats*/, bool total_order_seek,
                                    bool key_includes_seq, bool value_is_full,
                                    bool block_contents_pinned,
-                                   BlockPrefixIndex* prefix_index) {
+                                   BlockPrefixIndex* prefix_index,
+                                   bool restart_prefix_search) {
   IndexBlockIter* ret_iter;
   if (iter != nullptr) {
     ret_iter = iter;
@@ -897,6 +936,10 @@ IndexBlockIter* Block::NewIterator(const Comparator* cmp,
                          prefix_index_ptr, key_includes_seq, value_is_full,
                          block_contents_pinned,
                          nullptr /* data_block_hash_index */);
+    if (restart_prefix_search && ucmp == BytewiseComparator()) {
+      ret_iter->SetRestartPrefixIndex(
+          GetRestartPrefixIndex(key_includes_seq, value_is_full));
+    }
   }
 
   return ret_iter;
@@ -912,6 +955,11 @@ size_t Block::ApproximateMemoryUsage() const {
   if (read_amp_bitmap_) {
     usage += read_amp_bitmap_->ApproximateMemoryUsage();
   }
+  auto restart_prefix_index =
+      restart_prefix_index_.load(std::memory_order_relaxed);
+  if (restart_prefix_index != nullptr) {
+    usage += restart_prefix_index->ApproximateMemoryUsage();
+  }
   return usage;
 }
 
@@ -11,6 +11,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <atomic>
 #include <string>
 #include <vector>
 #ifdef ROCKSDB_MALLOC_USABLE_SIZE
@@ -31,6 +32,7 @@
 #include "table/block_prefix_index.h"
 #include "table/data_block_hash_index.h"
 #include "table/internal_iterator.h"
+#include "table/restart_prefix_index.h"
 #include "util/random.h"
 #include "util/sync_point.h"
 
@@ -178,6 +180,10 @@ class Block {
   // If `prefix_index` is not nullptr this block will do hash lookup for the key
   // prefix. If total_order_seek is true, prefix_index_ is ignored.
   //
+  // If `restart_prefix_search` is true and the user comparator is bytewise,
+  // seeks narrow the binary search with a RestartPrefixIndex, which is built
+  // on first use and shared by all iterators of the block.
+  //
   // If `block_contents_pinned` is true, the caller will guarantee that when
   // the cleanup functions are transferred from the iterator to other
   // classes, e.g. LazyBuffer, the pointer to the bytes will still be valid.
@@ -194,11 +200,19 @@ class Block {
       TBlockIter* iter = nullptr, Statistics* stats = nullptr,
       bool total_order_seek = true, bool key_includes_seq = true,
       bool value_is_full = true, bool block_contents_pinned = false,
-      BlockPrefixIndex* prefix_index = nullptr);
+      BlockPrefixIndex* prefix_index = nullptr,
+      bool restart_prefix_search = false);
 
   // Report an approximation of how much memory has been used.
   size_t ApproximateMemoryUsage() const;
 
+  // Build the RestartPrefixIndex iterators with restart_prefix_search would
+  // build on first use, so that ApproximateMemoryUsage() covers it before the
+  // block is charged to a cache.
+  void BuildRestartPrefixIndex(bool key_includes_seq, bool value_is_full) {
+    GetRestartPrefixIndex(key_includes_seq, value_is_full);
+  }
+
   SequenceNumber global_seqno() const { return global_seqno_; }
 
  private:
@@ -213,6 +227,11 @@ class Block {
   const SequenceNumber global_seqno_;
 
   DataBlockHashIndex data_block_hash_index_;
+  // Built on first use by an iterator asking for restart_prefix_search
+  mutable std::atomic<RestartPrefixIndex*> restart_prefix_index_;
+
+  const RestartPrefixIndex* GetRestartPrefixIndex(bool key_includes_seq,
+                                                  bool value_is_full) const;
 
   // No copying allowed
   Block(const Block&) = delete;
@@ -236,6 +255,13 @@ class BlockIter : public InternalIteratorBase<TValue> {
     restart_index_ = num_restarts_;
     global_seqno_ = global_seqno;
     block_contents_pinned_ = block_contents_pinned;
+    restart_prefix_index_ = nullptr;
+  }
+
+  void SetRestartPrefixIndex(const RestartPrefixIndex* restart_prefix_index) {
+    assert(restart_prefix_index == nullptr ||
+           restart_prefix_index->num_restarts() == num_restarts_);
+    restart_prefix_index_ = restart_prefix_index;
   }
 
   ~BlockIter() {
@@ -336,6 +362,8 @@ class BlockIter : public InternalIteratorBase<TValue> {
 
   Cache* cache_ = nullptr;
   Cache::Handle* cache_handle_ = nullptr;
+  // Owned by the block
+  const RestartPrefixIndex* restart_prefix_index_ = nullptr;
 
  public:
   // Return the offset in data_ just past the end of the current entry.
@@ -361,6 +389,17 @@ class BlockIter : public InternalIteratorBase<TValue> {
 
   void CorruptionError();
 
+  // Shrink the range of restart points to binary search for `target`
+  void NarrowRestartRange(const Slice& target, bool key_is_internal,
+                          uint32_t* left, uint32_t* right) const {
+    if (restart_prefix_index_ != nullptr) {
+      restart_prefix_index_->Narrow(
+          RestartPrefixIndex::KeyPrefix(key_is_internal ? ExtractUserKey(target)
+                                                        : target),
+          left, right);
+    }
+  }
+
   template <typename DecodeKeyFunc>
   inline bool BinarySeek(const Slice& target, uint32_t left, uint32_t right,
                          uint32_t* index, const Comparator* comp);
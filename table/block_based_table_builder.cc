@@ -38,6 +38,7 @@
 #include "table/full_filter_block.h"
 #include "table/index_builder.h"
 #include "table/partitioned_filter_block.h"
+#include "table/point_lookup_index.h"
 #include "table/table_builder.h"
 #include "util/coding.h"
 #include "util/compression.h"
@@ -267,6 +268,7 @@ struct BlockBasedTableBuilder::Rep {
   bool closed = false;  // Either Finish() or Abandon() has been called.
   const bool use_delta_encoding_for_index_values;
   std::unique_ptr<FilterBlockBuilder> filter_builder;
+  std::unique_ptr<PointLookupIndexBuilder> point_lookup_index_builder;
   char compressed_cache_key_prefix[BlockBasedTable::kMaxCacheKeyPrefixSize];
   size_t compressed_cache_key_prefix_size;
 
@@ -334,6 +336,12 @@ struct BlockBasedTableBuilder::Rep {
           builder_opt.ioptions, builder_opt.moptions, table_options,
           use_delta_encoding_for_index_values, p_index_builder_));
     }
+    if (table_options.point_lookup_index &&
+        !internal_comparator.user_comparator()
+             ->CanKeysWithDifferentByteContentsBeEqual()) {
+      point_lookup_index_builder.reset(new PointLookupIndexBuilder(
+          table_options.point_lookup_index_util_ratio));
+    }
 
     builder_opt.PushIntTblPropCollectors(&table_properties_collectors,
                                          column_family_id);
@@ -426,6 +434,9 @@ Status BlockBasedTableBuilder::Add(const Slice& key,
   if (r->filter_builder != nullptr) {
     r->filter_builder->Add(ExtractUserKey(key));
   }
+  if (r->point_lookup_index_builder != nullptr) {
+    r->point_lookup_index_builder->Add(ExtractUserKey(key));
+  }
 
   r->last_key.assign(key.data(), key.size());
   r->data_block.Add(key, value);
@@ -476,6 +487,9 @@ void BlockBasedTableBuilder::Flush() {
   if (r->filter_builder != nullptr) {
     r->filter_builder->StartBlock(r->offset);
   }
+  if (r->point_lookup_index_builder != nullptr && ok()) {
+    r->point_lookup_index_builder->FinishBlock(r->pending_handle);
+  }
   r->props.data_size = r->offset;
   ++r->props.num_data_blocks;
 }
@@ -871,6 +885,20 @@ void BlockBasedTableBuilder::WriteRangeDelBlock(
   }
 }
 
+void BlockBasedTableBuilder::WritePointLookupIndexBlock(
+    MetaIndexBuilder* meta_index_builder) {
+  if (ok() && rep_->point_lookup_index_builder != nullptr &&
+      rep_->point_lookup_index_builder->Valid()) {
+    BlockHandle point_lookup_index_block_handle;
+    WriteRawBlock(rep_->point_lookup_index_builder->Finish(), kNoCompression,
+                  &point_lookup_index_block_handle);
+    if (ok()) {
+      meta_index_builder->Add(kPointLookupIndexBlock,
+                              point_lookup_index_block_handle);
+    }
+  }
+}
+
 Status BlockBasedTableBuilder::Finish(
     const TablePropertyCache* prop,
     const std::vector<SequenceNumber>* snapshots) {
@@ -904,14 +932,16 @@ Status BlockBasedTableBuilder::Finish(
   //    2. [meta block: index]
   //    3. [meta block: compression dictionary]
   //    4. [meta block: range deletion tombstone]
-  //    5. [meta block: properties]
-  //    6. [metaindex block]
+  //    5. [meta block: point lookup index]
+  //    6. [meta block: properties]
+  //    7. [metaindex block]
   BlockHandle metaindex_block_handle, index_block_handle;
   MetaIndexBuilder meta_index_builder;
   WriteFilterBlock(&meta_index_builder);
   WriteIndexBlock(&meta_index_builder, &index_block_handle);
   WriteCompressionDictBlock(&meta_index_builder);
   WriteRangeDelBlock(&meta_index_builder);
+  WritePointLookupIndexBlock(&meta_index_builder);
   WritePropertiesBlock(&meta_index_builder);
   if (ok()) {
     // flush the meta index block
@@ -108,6 +108,7 @@ class BlockBasedTableBuilder : public TableBuilder {
   void WritePropertiesBlock(MetaIndexBuilder* meta_index_builder);
   void WriteCompressionDictBlock(MetaIndexBuilder* meta_index_builder);
   void WriteRangeDelBlock(MetaIndexBuilder* meta_index_builder);
+  void WritePointLookupIndexBlock(MetaIndexBuilder* meta_index_builder);
 
   struct Rep;
   class BlockBasedTablePropertiesCollectorFactory;
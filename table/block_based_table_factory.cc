@@ -258,6 +258,12 @@ Status BlockBasedTableFactory::SanitizeOptions(
         "data_block_hash_table_util_ratio should be greater than 0 when "
         "data_block_index_type is set to kDataBlockBinaryAndHash");
   }
+  if (table_options_.point_lookup_index &&
+      table_options_.point_lookup_index_util_ratio <= 0) {
+    return Status::InvalidArgument(
+        "point_lookup_index_util_ratio should be greater than 0 when "
+        "point_lookup_index is enabled");
+  }
   return Status::OK();
 }
 
@@ -291,6 +297,12 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  hash_index_allow_collision: %d\n",
            table_options_.hash_index_allow_collision);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  point_lookup_index: %d\n",
+           table_options_.point_lookup_index);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  point_lookup_index_util_ratio: %lf\n",
+           table_options_.point_lookup_index_util_ratio);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  checksum: %d\n", table_options_.checksum);
   ret.append(buffer);
   snprintf(buffer, kBufferSize, "  no_block_cache: %d\n",
@@ -375,6 +387,9 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  block_align: %d\n",
            table_options_.block_align);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  restart_key_prefix_search: %d\n",
+           table_options_.restart_key_prefix_search);
+  ret.append(buffer);
   return ret;
 }
 
@@ -131,6 +131,13 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct BlockBasedTableOptions,
                    data_block_hash_table_util_ratio),
           OptionType::kDouble, OptionVerificationType::kNormal, false, 0}},
+        {"point_lookup_index",
+         {offsetof(struct BlockBasedTableOptions, point_lookup_index),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"point_lookup_index_util_ratio",
+         {offsetof(struct BlockBasedTableOptions,
+                   point_lookup_index_util_ratio),
+          OptionType::kDouble, OptionVerificationType::kNormal, false, 0}},
         {"checksum",
          {offsetof(struct BlockBasedTableOptions, checksum),
           OptionType::kChecksumType, OptionVerificationType::kNormal, false,
@@ -184,6 +191,9 @@ static std::unordered_map<std::string, OptionTypeInfo>
         {"block_align",
          {offsetof(struct BlockBasedTableOptions, block_align),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"restart_key_prefix_search",
+         {offsetof(struct BlockBasedTableOptions, restart_key_prefix_search),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
         {"pin_top_level_index_and_filter",
          {offsetof(struct BlockBasedTableOptions,
                    pin_top_level_index_and_filter),
@@ -253,7 +253,9 @@ class PartitionIndexReader : public IndexReader, public Cleanable {
               index_value_is_full_),
           index_block_->NewIterator<IndexBlockIter>(
               icomparator_, icomparator_->user_comparator(), nullptr,
-              kNullStats, true, index_key_includes_seq_, index_value_is_full_));
+              kNullStats, true, index_key_includes_seq_, index_value_is_full_,
+              false /* block_contents_pinned */, nullptr /* prefix_index */,
+              table_->rep_->table_options.restart_key_prefix_search));
     } else {
       auto ro = ReadOptions();
       ro.fill_cache = fill_cache;
@@ -264,7 +266,9 @@ class PartitionIndexReader : public IndexReader, public Cleanable {
           table_, ro, *icomparator_,
           index_block_->NewIterator<IndexBlockIter>(
               icomparator_, icomparator_->user_comparator(), nullptr,
-              kNullStats, true, index_key_includes_seq_, index_value_is_full_),
+              kNullStats, true, index_key_includes_seq_, index_value_is_full_,
+              false /* block_contents_pinned */, nullptr /* prefix_index */,
+              table_->rep_->table_options.restart_key_prefix_search),
           false, true, /* prefix_extractor */ nullptr, kIsIndex,
           index_key_includes_seq_, index_value_is_full_);
     }
@@ -401,6 +405,7 @@ class BinarySearchIndexReader : public IndexReader {
                        const PersistentCacheOptions& cache_options,
                        const bool index_key_includes_seq,
                        const bool index_value_is_full,
+                       const bool restart_key_prefix_search,
                        MemoryAllocator* memory_allocator) {
     std::unique_ptr<Block> index_block;
     auto s = ReadBlockFromFile(
@@ -413,7 +418,8 @@ class BinarySearchIndexReader : public IndexReader {
     if (s.ok()) {
       *index_reader = new BinarySearchIndexReader(
           icomparator, std::move(index_block), ioptions.statistics,
-          index_key_includes_seq, index_value_is_full);
+          index_key_includes_seq, index_value_is_full,
+          restart_key_prefix_search);
     }
 
     return s;
@@ -427,7 +433,9 @@ class BinarySearchIndexReader : public IndexReader {
     // to set `block_contents_pinned`.
     return index_block_->NewIterator<IndexBlockIter>(
         icomparator_, icomparator_->user_comparator(), iter, kNullStats, true,
-        index_key_includes_seq_, index_value_is_full_);
+        index_key_includes_seq_, index_value_is_full_,
+        false /* block_contents_pinned */, nullptr /* prefix_index */,
+        restart_key_prefix_search_);
   }
 
   virtual size_t size() const override { return index_block_->size(); }
@@ -450,16 +458,19 @@ class BinarySearchIndexReader : public IndexReader {
   BinarySearchIndexReader(const InternalKeyComparator* icomparator,
                           std::unique_ptr<Block>&& index_block,
                           Statistics* stats, const bool index_key_includes_seq,
-                          const bool index_value_is_full)
+                          const bool index_value_is_full,
+                          const bool restart_key_prefix_search)
       : IndexReader(icomparator, stats),
         index_block_(std::move(index_block)),
         index_key_includes_seq_(index_key_includes_seq),
-        index_value_is_full_(index_value_is_full) {
+        index_value_is_full_(index_value_is_full),
+        restart_key_prefix_search_(restart_key_prefix_search) {
     assert(index_block_ != nullptr);
   }
   std::unique_ptr<Block> index_block_;
   const bool index_key_includes_seq_;
   const bool index_value_is_full_;
+  const bool restart_key_prefix_search_;
 };
 
 // Index that leverages an internal hash table to quicken the lookup for a given
@@ -1012,6 +1023,47 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
     }
   }
 
+  // Read the point lookup index meta block
+  if (rep->table_options.point_lookup_index) {
+    bool found_point_lookup_index;
+    BlockHandle point_lookup_index_handle;
+    s = SeekToPointLookupIndexBlock(meta_iter.get(), &found_point_lookup_index,
+                                    &point_lookup_index_handle);
+    if (!s.ok()) {
+      // Point lookups simply go through the regular index
+      ROCKS_LOG_WARN(
+          rep->ioptions.info_log,
+          "Error when seeking to point lookup index block from file: %s",
+          s.ToString().c_str());
+      s = Status::OK();
+    } else if (found_point_lookup_index &&
+               !point_lookup_index_handle.IsNull()) {
+      std::unique_ptr<BlockContents> point_lookup_index_cont{
+          new BlockContents()};
+      PersistentCacheOptions cache_options;
+      ReadOptions read_options;
+      BlockFetcher point_lookup_index_fetcher(
+          rep->file.get(), prefetch_buffer.get(), rep->footer, read_options,
+          point_lookup_index_handle, point_lookup_index_cont.get(),
+          rep->ioptions, false /* decompress */, false /*maybe_compressed*/,
+          Slice() /*compression dict*/, cache_options);
+      s = point_lookup_index_fetcher.ReadBlockContents();
+      if (s.ok()) {
+        s = rep->point_lookup_index.Initialize(point_lookup_index_cont->data);
+      }
+      if (!s.ok()) {
+        ROCKS_LOG_WARN(rep->ioptions.info_log,
+                       "Encountered error while reading data from point "
+                       "lookup index block %s",
+                       s.ToString().c_str());
+        rep->point_lookup_index = PointLookupIndex();
+        s = Status::OK();
+      } else {
+        rep->point_lookup_index_block = std::move(point_lookup_index_cont);
+      }
+    }
+  }
+
   bool need_upper_bound_check =
       PrefixExtractorChanged(rep->table_properties.get(), prefix_extractor);
 
@@ -1189,6 +1241,9 @@ size_t BlockBasedTable::ApproximateMemoryUsage() const {
   if (rep_->index_reader) {
     usage += rep_->index_reader->ApproximateMemoryUsage();
   }
+  if (rep_->point_lookup_index_block) {
+    usage += rep_->point_lookup_index_block->usable_size();
+  }
   return usage;
 }
 
@@ -1226,6 +1281,24 @@ Status BlockBasedTable::ReadMetaBlock(
   return Status::OK();
 }
 
+void BlockBasedTable::PrepareRestartPrefixIndex(const Rep* rep, Block* block,
+                                                bool is_index) {
+  // Iterators build the index lazily and ApproximateMemoryUsage() counts it,
+  // but a cache entry is charged only once, on insert
+  if (!rep->table_options.restart_key_prefix_search ||
+      rep->internal_comparator.user_comparator() != BytewiseComparator()) {
+    return;
+  }
+  if (is_index) {
+    block->BuildRestartPrefixIndex(
+        rep->table_properties_base.index_key_is_user_key == 0,
+        rep->table_properties_base.index_value_is_delta_encoded == 0);
+  } else {
+    block->BuildRestartPrefixIndex(true /* key_includes_seq */,
+                                   true /* value_is_full */);
+  }
+}
+
 Status BlockBasedTable::GetDataBlockFromCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed, Rep* rep,
@@ -1299,6 +1372,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
                   statistics);  // uncompressed block
     if (block_cache != nullptr && block->value->own_bytes() &&
         read_options.fill_cache) {
+      PrepareRestartPrefixIndex(rep, block->value, is_index);
       size_t charge = block->value->ApproximateMemoryUsage();
       s = block_cache->Insert(block_cache_key, block->value, charge,
                               &DeleteCachedEntry<Block>,
@@ -1348,7 +1422,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
 
 Status BlockBasedTable::PutDataBlockToCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
-    Cache* block_cache, Cache* block_cache_compressed,
+    Cache* block_cache, Cache* block_cache_compressed, const Rep* rep,
     const ReadOptions& /*read_options*/, const ImmutableCFOptions& ioptions,
     CachableEntry<Block>* cached_block, BlockContents* raw_block_contents,
     CompressionType raw_block_comp_type, uint32_t format_version,
@@ -1412,6 +1486,7 @@ Status BlockBasedTable::PutDataBlockToCache(
 
   // insert into uncompressed block cache
   if (block_cache != nullptr && cached_block->value->own_bytes()) {
+    PrepareRestartPrefixIndex(rep, cached_block->value, is_index);
     size_t charge = cached_block->value->ApproximateMemoryUsage();
     s = block_cache->Insert(block_cache_key, cached_block->value, charge,
                             &DeleteCachedEntry<Block>,
@@ -1805,7 +1880,8 @@ TBlockIter* BlockBasedTable::NewDataBlockIterator(
     iter = block.value->NewIterator<TBlockIter>(
         &rep->internal_comparator, rep->internal_comparator.user_comparator(),
         iter, rep->ioptions.statistics, kTotalOrderSeek, key_includes_seq,
-        index_key_is_full, block_contents_pinned);
+        index_key_is_full, block_contents_pinned, nullptr /* prefix_index */,
+        rep->table_options.restart_key_prefix_search);
     if (block.cache_handle != nullptr) {
       iter->SetReleaseCache(block_cache, block.cache_handle, false);
     } else {
@@ -1913,8 +1989,9 @@ Status BlockBasedTable::MaybeReadBlockAndLoadToCache(
         // If filling cache is allowed and a cache is configured, try to put the
         // block to the cache.
         s = PutDataBlockToCache(
-            key, ckey, block_cache, block_cache_compressed, ro, rep->ioptions,
-            block_entry, &raw_block_contents, raw_block_comp_type,
+            key, ckey, block_cache, block_cache_compressed, rep, ro,
+            rep->ioptions, block_entry, &raw_block_contents,
+            raw_block_comp_type,
             rep->table_options.format_version, compression_dict, seq_no,
             rep->table_options.read_amp_bytes_per_bit,
             GetMemoryAllocator(rep->table_options), is_index,
@@ -1965,7 +2042,9 @@ BlockBasedTable::PartitionedIndexIteratorState::NewSecondaryIterator(
     // to set `block_contents_pinned`.
     return block->second.value->NewIterator<IndexBlockIter>(
         &rep->internal_comparator, rep->internal_comparator.user_comparator(),
-        nullptr, kNullStats, true, index_key_includes_seq_, index_key_is_full_);
+        nullptr, kNullStats, true, index_key_includes_seq_, index_key_is_full_,
+        false /* block_contents_pinned */, nullptr /* prefix_index */,
+        rep->table_options.restart_key_prefix_search);
   }
   // Create an empty iterator
   return new IndexBlockIter();
@@ -2400,6 +2479,102 @@ bool BlockBasedTable::FullFilterKeyMayMatch(
   return may_match;
 }
 
+bool BlockBasedTable::GetFromDataBlock(const ReadOptions& read_options,
+                                       const Slice& key,
+                                       const BlockHandle& handle,
+                                       GetContext* get_context,
+                                       FilterBlockReader* filter,
+                                       const SliceTransform* prefix_extractor,
+                                       bool* matched, Status* s) {
+  const bool no_io = read_options.read_tier == kBlockCacheTier;
+  bool not_exist_in_filter =
+      filter != nullptr && filter->IsBlockBased() == true &&
+      !filter->KeyMayMatch(ExtractUserKey(key), prefix_extractor,
+                           handle.offset(), no_io);
+
+  if (not_exist_in_filter) {
+    // Not found
+    // TODO: think about interaction with Merge. If a user key cannot
+    // cross one data block, we should be fine.
+    RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
+    PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_useful, 1, rep_->level);
+    return false;
+  }
+
+  DataBlockIter biter;
+  NewDataBlockIterator<DataBlockIter>(rep_, read_options, handle, &biter,
+                                      false, true /* key_includes_seq */,
+                                      get_context);
+
+  if (no_io && biter.status().IsIncomplete()) {
+    // couldn't get block from block_cache
+    // Update Saver.state to Found because we are only looking for
+    // whether we can guarantee the key is not there when "no_io" is set
+    get_context->MarkKeyMayExist();
+    return false;
+  }
+  if (!biter.status().ok()) {
+    *s = biter.status();
+    return false;
+  }
+
+  bool may_exist = biter.SeekForGet(key);
+  if (!may_exist) {
+    // HashSeek cannot find the key this block and the the iter is not
+    // the end of the block, i.e. cannot be in the following blocks
+    // either. In this case, the seek_key cannot be found, so we break
+    // from the top level for-loop.
+    return false;
+  }
+
+  class LazyBufferStateImpl : public LazyBufferState {
+   public:
+    virtual void destroy(LazyBuffer* /*buffer*/) const override {}
+
+    virtual Status pin_buffer(LazyBuffer* buffer) const override {
+      if (buffer->size() <= sizeof(LazyBufferContext)) {
+        buffer->reset(buffer->slice(), true, buffer->file_number());
+        return Status::OK();
+      }
+      auto context = get_context(buffer);
+      DataBlockIter* iter = reinterpret_cast<DataBlockIter*>(context->data[0]);
+      assert(iter != nullptr);
+      Cleanable release_cached_entry = iter->RefCache();
+      if (release_cached_entry.Empty()) {
+        return Status::NotSupported();
+      }
+      buffer->reset(buffer->slice(), std::move(release_cached_entry),
+                    buffer->file_number());
+      return Status::OK();
+    }
+
+    Status fetch_buffer(LazyBuffer* /*buffer*/) const override {
+      return Status::OK();
+    }
+  };
+  static LazyBufferStateImpl static_state;
+
+  // Call the *saver function on each entry/block until it returns false
+  bool done = false;
+  for (; biter.Valid(); biter.Next()) {
+    ParsedInternalKey parsed_key;
+    if (!ParseInternalKey(biter.key(), &parsed_key)) {
+      *s = Status::Corruption(Slice());
+    }
+
+    if (!get_context->SaveValue(
+            parsed_key,
+            LazyBuffer(&static_state, {reinterpret_cast<uint64_t>(&biter)},
+                       biter.value(), rep_->file_number),
+            matched)) {
+      done = true;
+      break;
+    }
+  }
+  *s = biter.status();
+  return !done;
+}
+
 Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
                             GetContext* get_context,
                             const SliceTransform* prefix_extractor,
@@ -2422,127 +2597,52 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
     RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
     PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_useful, 1, rep_->level);
   } else {
-    IndexBlockIter iiter_on_stack;
-    // if prefix_extractor found in block differs from options, disable
-    // BlockPrefixIndex. Only do this check when index_type is kHashSearch.
-    bool need_upper_bound_check = false;
-    if (rep_->index_type == BlockBasedTableOptions::kHashSearch) {
-      need_upper_bound_check = PrefixExtractorChanged(
-          &rep_->table_properties_base, prefix_extractor);
-    }
-    auto iiter =
-        NewIndexIterator(read_options, need_upper_bound_check, &iiter_on_stack,
-                         /* index_entry */ nullptr, get_context);
-    std::unique_ptr<InternalIteratorBase<BlockHandle>> iiter_unique_ptr;
-    if (iiter != &iiter_on_stack) {
-      iiter_unique_ptr.reset(iiter);
-    }
-
     bool matched = false;  // if such user key mathced a key in SST
-    bool done = false;
-    for (iiter->Seek(key); iiter->Valid() && !done; iiter->Next()) {
-      BlockHandle handle = iiter->value();
-
-      bool not_exist_in_filter =
-          filter != nullptr && filter->IsBlockBased() == true &&
-          !filter->KeyMayMatch(ExtractUserKey(key), prefix_extractor,
-                               handle.offset(), no_io);
-
-      if (not_exist_in_filter) {
-        // Not found
-        // TODO: think about interaction with Merge. If a user key cannot
-        // cross one data block, we should be fine.
-        RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
-        PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_useful, 1, rep_->level);
-        break;
-      } else {
-        DataBlockIter biter;
-        NewDataBlockIterator<DataBlockIter>(
-            rep_, read_options, iiter->value(), &biter, false,
-            true /* key_includes_seq */, get_context);
-
-        if (read_options.read_tier == kBlockCacheTier &&
-            biter.status().IsIncomplete()) {
-          // couldn't get block from block_cache
-          // Update Saver.state to Found because we are only looking for
-          // whether we can guarantee the key is not there when "no_io" is set
-          get_context->MarkKeyMayExist();
-          break;
-        }
-        if (!biter.status().ok()) {
-          s = biter.status();
-          break;
-        }
+    PointLookupIndex::LookupResult point_lookup = PointLookupIndex::kUnknown;
+    BlockHandle point_lookup_handle;
+    if (rep_->point_lookup_index.Valid()) {
+      point_lookup = rep_->point_lookup_index.Lookup(ExtractUserKey(key),
+                                                     &point_lookup_handle);
+    }
+    if (point_lookup == PointLookupIndex::kFound) {
+      // All versions of the user key are in this block
+      GetFromDataBlock(read_options, key, point_lookup_handle, get_context,
+                       filter, prefix_extractor, &matched, &s);
+    } else if (point_lookup == PointLookupIndex::kUnknown) {
+      IndexBlockIter iiter_on_stack;
+      // if prefix_extractor found in block differs from options, disable
+      // BlockPrefixIndex. Only do this check when index_type is kHashSearch.
+      bool need_upper_bound_check = false;
+      if (rep_->index_type == BlockBasedTableOptions::kHashSearch) {
+        need_upper_bound_check = PrefixExtractorChanged(
+            &rep_->table_properties_base, prefix_extractor);
+      }
+      auto iiter = NewIndexIterator(read_options, need_upper_bound_check,
+                                    &iiter_on_stack,
+                                    /* index_entry */ nullptr, get_context);
+      std::unique_ptr<InternalIteratorBase<BlockHandle>> iiter_unique_ptr;
+      if (iiter != &iiter_on_stack) {
+        iiter_unique_ptr.reset(iiter);
+      }
 
-        bool may_exist = biter.SeekForGet(key);
-        if (!may_exist) {
-          // HashSeek cannot find the key this block and the the iter is not
-          // the end of the block, i.e. cannot be in the following blocks
-          // either. In this case, the seek_key cannot be found, so we break
-          // from the top level for-loop.
+      for (iiter->Seek(key); iiter->Valid(); iiter->Next()) {
+        if (!GetFromDataBlock(read_options, key, iiter->value(), get_context,
+                              filter, prefix_extractor, &matched, &s)) {
+          // Avoid the extra Next which is expensive in two-level indexes
           break;
         }
-
-        class LazyBufferStateImpl : public LazyBufferState {
-         public:
-          virtual void destroy(LazyBuffer* /*buffer*/) const override {}
-
-          virtual Status pin_buffer(LazyBuffer* buffer) const override {
-            if (buffer->size() <= sizeof(LazyBufferContext)) {
-              buffer->reset(buffer->slice(), true, buffer->file_number());
-              return Status::OK();
-            }
-            auto context = get_context(buffer);
-            DataBlockIter* iter =
-                reinterpret_cast<DataBlockIter*>(context->data[0]);
-            assert(iter != nullptr);
-            Cleanable release_cached_entry = iter->RefCache();
-            if (release_cached_entry.Empty()) {
-              return Status::NotSupported();
-            }
-            buffer->reset(buffer->slice(), std::move(release_cached_entry),
-                          buffer->file_number());
-            return Status::OK();
-          }
-
-          Status fetch_buffer(LazyBuffer* /*buffer*/) const override {
-            return Status::OK();
-          }
-        };
-        static LazyBufferStateImpl static_state;
-
-        // Call the *saver function on each entry/block until it returns false
-        for (; biter.Valid(); biter.Next()) {
-          ParsedInternalKey parsed_key;
-          if (!ParseInternalKey(biter.key(), &parsed_key)) {
-            s = Status::Corruption(Slice());
-          }
-
-          if (!get_context->SaveValue(
-                  parsed_key,
-                  LazyBuffer(&static_state,
-                             {reinterpret_cast<uint64_t>(&biter)},
-                             biter.value(), rep_->file_number),
-                  &matched)) {
-            done = true;
-            break;
-          }
-        }
-        s = biter.status();
       }
-      if (done) {
-        // Avoid the extra Next which is expensive in two-level indexes
-        break;
+      if (s.ok()) {
+        s = iiter->status();
       }
+    } else {
+      RecordTick(rep_->ioptions.statistics, POINT_LOOKUP_INDEX_USEFUL);
     }
     if (matched && filter != nullptr && !filter->IsBlockBased()) {
       RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_FULL_TRUE_POSITIVE);
       PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_full_true_positive, 1,
                                 rep_->level);
     }
-    if (s.ok()) {
-      s = iiter->status();
-    }
   }
 
   // if rep_->filter_entry is not set, we should call Release(); otherwise
@@ -2645,50 +2745,126 @@ Status BlockBasedTable::VerifyChecksum() {
 
 Status BlockBasedTable::VerifyChecksumInBlocks(
     InternalIteratorBase<BlockHandle>* index_iter) {
-  Status s;
+  std::vector<BlockHandle> handles;
   for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
-    s = index_iter->status();
-    if (!s.ok()) {
-      break;
-    }
-    BlockHandle handle = index_iter->value();
-    BlockContents contents;
-    Slice dummy_comp_dict;
-    BlockFetcher block_fetcher(
-        rep_->file.get(), nullptr /* prefetch buffer */, rep_->footer,
-        ReadOptions(), handle, &contents, rep_->ioptions,
-        false /* decompress */, false /*maybe_compressed*/,
-        dummy_comp_dict /*compression dict*/, rep_->persistent_cache_options);
-    s = block_fetcher.ReadBlockContents();
+    Status s = index_iter->status();
     if (!s.ok()) {
-      break;
+      return s;
     }
+    handles.emplace_back(index_iter->value());
   }
-  return s;
+  return VerifyChecksumInBlocks(handles);
 }
 
 Status BlockBasedTable::VerifyChecksumInBlocks(
     InternalIteratorBase<Slice>* index_iter) {
-  Status s;
+  std::vector<BlockHandle> handles;
   for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
-    s = index_iter->status();
+    Status s = index_iter->status();
     if (!s.ok()) {
-      break;
+      return s;
     }
     BlockHandle handle;
     Slice input = index_iter->value();
     s = handle.DecodeFrom(&input);
-    BlockContents contents;
-    Slice dummy_comp_dict;
-    BlockFetcher block_fetcher(
-        rep_->file.get(), nullptr /* prefetch buffer */, rep_->footer,
-        ReadOptions(), handle, &contents, rep_->ioptions,
-        false /* decompress */, false /*maybe_compressed*/,
-        dummy_comp_dict /*compression dict*/, rep_->persistent_cache_options);
-    s = block_fetcher.ReadBlockContents();
     if (!s.ok()) {
+      return s;
+    }
+    handles.emplace_back(handle);
+  }
+  return VerifyChecksumInBlocks(handles);
+}
+
+Status BlockBasedTable::VerifyChecksumInBlocks(
+    const std::vector<BlockHandle>& handles) {
+  const uint64_t kMaxBatchBytes = 4 << 20;
+  std::unique_ptr<char[]> buf;
+  size_t buf_size = 0;
+  std::vector<ReadRequest> reqs;
+  // The first block of each request
+  std::vector<size_t> req_first;
+  std::vector<const char*> data;
+  std::vector<size_t> block_size;
+  Status s;
+  for (size_t i = 0; i < handles.size();) {
+    // Runs of adjacent blocks are read with one request, the requests of a
+    // batch are issued together
+    reqs.clear();
+    req_first.clear();
+    size_t batch_bytes = 0;
+    size_t j = i;
+    while (j < handles.size() && batch_bytes < kMaxBatchBytes) {
+      uint64_t offset = handles[j].offset();
+      uint64_t end = offset + handles[j].size() + kBlockTrailerSize;
+      req_first.emplace_back(j);
+      for (++j; j < handles.size() && handles[j].offset() == end; ++j) {
+        uint64_t next_end = end + handles[j].size() + kBlockTrailerSize;
+        if (next_end - offset > kMaxBatchBytes) {
+          break;
+        }
+        end = next_end;
+      }
+      ReadRequest req;
+      req.offset = offset;
+      req.len = static_cast<size_t>(end - offset);
+      req.scratch = nullptr;
+      reqs.emplace_back(req);
+      batch_bytes += req.len;
+    }
+    if (batch_bytes > buf_size) {
+      buf.reset(new char[batch_bytes]);
+      buf_size = batch_bytes;
+    }
+    char* scratch = buf.get();
+    for (auto& req : reqs) {
+      req.scratch = scratch;
+      scratch += req.len;
+    }
+    s = rep_->file->MultiRead(reqs.data(), reqs.size());
+    if (!s.ok()) {
+      break;
+    }
+    data.clear();
+    block_size.clear();
+    for (size_t r = 0; r < reqs.size(); ++r) {
+      const ReadRequest& req = reqs[r];
+      if (!req.status.ok()) {
+        s = req.status;
+        break;
+      }
+      if (req.result.size() != req.len) {
+        s = Status::Corruption("truncated block read from " +
+                               rep_->file->file_name() + " offset " +
+                               ToString(req.offset) + ", expected " +
+                               ToString(req.len) + " bytes, got " +
+                               ToString(req.result.size()));
+        break;
+      }
+      size_t req_end = r + 1 < reqs.size() ? req_first[r + 1] : j;
+      for (size_t k = req_first[r]; k < req_end; ++k) {
+        data.emplace_back(req.result.data() +
+                          (handles[k].offset() - req.offset));
+        block_size.emplace_back(static_cast<size_t>(handles[k].size()));
+      }
+    }
+    if (!s.ok()) {
+      break;
+    }
+    size_t bad_index = 0;
+    {
+      PERF_TIMER_GUARD(block_checksum_time);
+      s = VerifyBlockChecksums(rep_->footer.checksum(), data.data(),
+                               block_size.data(), data.size(), &bad_index);
+    }
+    if (!s.ok()) {
+      const BlockHandle& handle = handles[i + bad_index];
+      s = Status::Corruption(s.getState(),
+                             "in " + rep_->file->file_name() + " offset " +
+                                 ToString(handle.offset()) + " size " +
+                                 ToString(handle.size()));
       break;
     }
+    i = j;
   }
   return s;
 }
@@ -2783,6 +2959,7 @@ Status BlockBasedTable::CreateIndexReader(
               rep_->table_properties_base.index_key_is_user_key == 0,
           !rep_->found_table_properties ||
               rep_->table_properties_base.index_value_is_delta_encoded == 0,
+          rep_->table_options.restart_key_prefix_search,
           GetMemoryAllocator(rep_->table_options));
     }
     case BlockBasedTableOptions::kHashSearch: {
@@ -2806,6 +2983,7 @@ Status BlockBasedTable::CreateIndexReader(
                   rep_->table_properties_base.index_key_is_user_key == 0,
               !rep_->found_table_properties ||
                   rep_->table_properties_base.index_value_is_delta_encoded == 0,
+              rep_->table_options.restart_key_prefix_search,
               GetMemoryAllocator(rep_->table_options));
         }
         meta_index_iter = meta_iter_guard.get();
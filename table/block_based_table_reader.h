@@ -28,6 +28,7 @@
 #include "table/filter_block.h"
 #include "table/format.h"
 #include "table/persistent_cache_helper.h"
+#include "table/point_lookup_index.h"
 #include "table/table_properties_internal.h"
 #include "table/table_reader.h"
 #include "table/two_level_iterator.h"
@@ -319,7 +320,7 @@ class BlockBasedTable : public TableReader {
   //    dictionary.
   static Status PutDataBlockToCache(
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
-      Cache* block_cache, Cache* block_cache_compressed,
+      Cache* block_cache, Cache* block_cache_compressed, const Rep* rep,
       const ReadOptions& read_options, const ImmutableCFOptions& ioptions,
       CachableEntry<Block>* block, BlockContents* raw_block_contents,
       CompressionType raw_block_comp_type, uint32_t format_version,
@@ -336,6 +337,11 @@ class BlockBasedTable : public TableReader {
 
   void ReadMeta(const Footer& footer);
 
+  // Build the restart prefix index of a block read from this table before it
+  // is charged to the block cache
+  static void PrepareRestartPrefixIndex(const Rep* rep, Block* block,
+                                        bool is_index);
+
   // Figure the index type, update it in rep_, and also return it.
   static BlockBasedTableOptions::IndexType GetIndexType(
       const TableProperties* table_properties);
@@ -354,6 +360,15 @@ class BlockBasedTable : public TableReader {
       const Slice& user_key, const bool no_io,
       const SliceTransform* prefix_extractor = nullptr) const;
 
+  // Feed the entries of the data block at `handle` starting from `key` to
+  // `get_context`. Return false if the following data blocks need not be
+  // looked at, either because the lookup is done or failed with `*s`.
+  bool GetFromDataBlock(const ReadOptions& read_options, const Slice& key,
+                        const BlockHandle& handle, GetContext* get_context,
+                        FilterBlockReader* filter,
+                        const SliceTransform* prefix_extractor, bool* matched,
+                        Status* s);
+
   // Read the meta block from sst.
   static Status ReadMetaBlock(
       Rep* rep, FilePrefetchBuffer* prefetch_buffer,
@@ -362,6 +377,10 @@ class BlockBasedTable : public TableReader {
 
   Status VerifyChecksumInBlocks(InternalIteratorBase<Slice>* index_iter);
   Status VerifyChecksumInBlocks(InternalIteratorBase<BlockHandle>* index_iter);
+  // Adjacent blocks are read with a single request, a batch of requests is
+  // issued together through MultiRead and their checksums are verified
+  // together
+  Status VerifyChecksumInBlocks(const std::vector<BlockHandle>& handles);
 
   // Create the filter from the filter block.
   virtual FilterBlockReader* ReadFilter(
@@ -496,6 +515,10 @@ struct BlockBasedTable::Rep {
   // is easier because the Slice member depends on the continued existence of
   // another member ("allocation").
   std::unique_ptr<const BlockContents> compression_dict_block;
+  // Block backing point_lookup_index, only loaded when
+  // table_options.point_lookup_index is set
+  std::unique_ptr<const BlockContents> point_lookup_index_block;
+  PointLookupIndex point_lookup_index;
   BlockBasedTableOptions::IndexType index_type;
   bool hash_index_allow_collision;
   bool whole_key_filtering;
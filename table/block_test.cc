@@ -603,6 +603,66 @@ TEST_F(BlockTest, ReadAmpBitmapPow2) {
   ASSERT_EQ(BlockReadAmpBitmap(100, 35, stats.get()).GetBytesPerBit(), 32);
 }
 
+TEST_F(BlockTest, RestartPrefixSearch) {
+  Random rnd(301);
+  InternalKeyComparator icmp(BytewiseComparator());
+
+  // Keys shorter than, equal to and longer than the 8 bytes prefix, many of
+  // them sharing the prefix
+  std::set<std::string> user_keys;
+  while (user_keys.size() < 2000) {
+    std::string k = RandomString(&rnd, 1 + rnd.Uniform(3));
+    if (rnd.OneIn(2)) {
+      k = "prefix" + k + RandomString(&rnd, rnd.Uniform(12));
+    }
+    user_keys.insert(k);
+  }
+  std::vector<std::string> keys;
+  for (auto& k : user_keys) {
+    keys.emplace_back(InternalKey(k, 100, kTypeValue).Encode().ToString());
+  }
+
+  for (int restart_interval : {1, 4, 16}) {
+    BlockBuilder builder(restart_interval);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      builder.Add(keys[i], std::to_string(i));
+    }
+    BlockContents contents;
+    contents.data = builder.Finish();
+    Block reader(std::move(contents), kDisableGlobalSequenceNumber);
+
+    std::unique_ptr<DataBlockIter> iter(reader.NewIterator<DataBlockIter>(
+        &icmp, icmp.user_comparator(), nullptr, nullptr, true, true, true,
+        false, nullptr, true /* restart_prefix_search */));
+    std::unique_ptr<DataBlockIter> ref_iter(reader.NewIterator<DataBlockIter>(
+        &icmp, icmp.user_comparator()));
+    for (int i = 0; i < 5000; i++) {
+      std::string target;
+      if (rnd.OneIn(2)) {
+        target = keys[rnd.Uniform(static_cast<int>(keys.size()))];
+      } else {
+        std::string k = RandomString(&rnd, rnd.Uniform(16));
+        if (rnd.OneIn(2)) {
+          k = "prefix" + k;
+        }
+        target = InternalKey(k, 100, kTypeValue).Encode().ToString();
+      }
+      iter->Seek(target);
+      ref_iter->Seek(target);
+      ASSERT_EQ(ref_iter->Valid(), iter->Valid());
+      if (iter->Valid()) {
+        ASSERT_EQ(ref_iter->key(), iter->key());
+      }
+      iter->SeekForPrev(target);
+      ref_iter->SeekForPrev(target);
+      ASSERT_EQ(ref_iter->Valid(), iter->Valid());
+      if (iter->Valid()) {
+        ASSERT_EQ(ref_iter->key(), iter->key());
+      }
+    }
+  }
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char **argv) {
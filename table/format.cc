@@ -10,6 +10,7 @@
 #include "table/format.h"
 
 #include <string>
+#include <vector>
 #include <inttypes.h>
 
 #include "monitoring/perf_context_imp.h"
@@ -277,6 +278,53 @@ Status ReadFooterFromFile(RandomAccessFileReader* file,
   return Status::OK();
 }
 
+Status VerifyBlockChecksums(ChecksumType checksum_type,
+                            const char* const* data, const size_t* block_size,
+                            size_t n, size_t* bad_index) {
+  // The checksum covers the contents and the compression type
+  std::vector<size_t> size(block_size, block_size + n);
+  for (auto& s : size) {
+    s += 1;
+  }
+  std::vector<uint32_t> actual(n, 0);
+  switch (checksum_type) {
+    case kNoChecksum:
+      return Status::OK();
+    case kCRC32c:
+      crc32c::MultiExtend(actual.data(), data, size.data(), n);
+      break;
+    case kxxHash:
+      for (size_t i = 0; i < n; ++i) {
+        actual[i] = XXH32(data[i], static_cast<int>(size[i]), 0);
+      }
+      break;
+    case kxxHash64:
+      for (size_t i = 0; i < n; ++i) {
+        actual[i] = static_cast<uint32_t>(
+            XXH64(data[i], static_cast<int>(size[i]), 0) &
+            uint64_t{0xffffffff});
+      }
+      break;
+    default:
+      *bad_index = 0;
+      return Status::Corruption("unknown checksum type " +
+                                ToString(checksum_type));
+  }
+  for (size_t i = 0; i < n; ++i) {
+    uint32_t value = DecodeFixed32(data[i] + size[i]);
+    if (checksum_type == kCRC32c) {
+      value = crc32c::Unmask(value);
+    }
+    if (actual[i] != value) {
+      *bad_index = i;
+      return Status::Corruption("block checksum mismatch: expected " +
+                                ToString(actual[i]) + ", got " +
+                                ToString(value));
+    }
+  }
+  return Status::OK();
+}
+
 Status UncompressBlockContentsForCompressionType(
     const UncompressionContext& uncompression_ctx, const char* data, size_t n,
     BlockContents* contents, uint32_t format_version,
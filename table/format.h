@@ -270,6 +270,16 @@ extern Status ReadBlockContents(
     bool do_uncompress = true, const Slice& compression_dict = Slice(),
     const PersistentCacheOptions& cache_options = PersistentCacheOptions());
 
+// Verify the checksums of n blocks at once. data[i] points to the raw
+// contents of a block of block_size[i] bytes followed by its trailer. On a
+// mismatch return Corruption and set *bad_index to the offending block.
+// Only BlockBasedTable::VerifyChecksum() has several blocks at hand, reads
+// and compactions fetch one block per call and verify it in BlockFetcher.
+extern Status VerifyBlockChecksums(ChecksumType checksum_type,
+                                   const char* const* data,
+                                   const size_t* block_size, size_t n,
+                                   size_t* bad_index);
+
 // The 'data' points to the raw block contents read in from file.
 // This method allocates a new heap buffer and the raw block
 // contents are uncompresed into this buffer. This buffer is
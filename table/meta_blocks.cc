@@ -498,6 +498,22 @@ Status FindMetaBlock(InternalIteratorBase<Slice>* meta_index_iter,
   }
 }
 
+Status SeekToMetaBlock(InternalIteratorBase<Slice>* meta_index_iter,
+                       const std::string& meta_block_name, bool* is_found,
+                       BlockHandle* block_handle) {
+  meta_index_iter->Seek(meta_block_name);
+  if (!meta_index_iter->status().ok()) {
+    return meta_index_iter->status();
+  }
+  *is_found = meta_index_iter->Valid() &&
+              meta_index_iter->key() == meta_block_name;
+  if (!*is_found) {
+    return Status::OK();
+  }
+  Slice v = meta_index_iter->value();
+  return block_handle->DecodeFrom(&v);
+}
+
 Status FindMetaBlock(RandomAccessFileReader* file, uint64_t file_size,
                      uint64_t table_magic_number,
                      const ImmutableCFOptions& ioptions,
@@ -546,6 +562,24 @@ Status ReadMetaBlock(RandomAccessFileReader* file,
                      const std::string& meta_block_name,
                      BlockContents* contents, bool /*compression_type_missing*/,
                      MemoryAllocator* memory_allocator) {
+  bool is_found = false;
+  Status status = ReadOptionalMetaBlock(
+      file, prefetch_buffer, file_size, table_magic_number, ioptions,
+      meta_block_name, contents, &is_found, memory_allocator);
+  if (status.ok() && !is_found) {
+    return Status::Corruption("Cannot find the meta block", meta_block_name);
+  }
+  return status;
+}
+
+Status ReadOptionalMetaBlock(RandomAccessFileReader* file,
+                             FilePrefetchBuffer* prefetch_buffer,
+                             uint64_t file_size, uint64_t table_magic_number,
+                             const ImmutableCFOptions& ioptions,
+                             const std::string& meta_block_name,
+                             BlockContents* contents, bool* is_found,
+                             MemoryAllocator* memory_allocator) {
+  *is_found = false;
   Status status;
   Footer footer;
   status = ReadFooterFromFile(file, prefetch_buffer, file_size, &footer,
@@ -582,9 +616,10 @@ Status ReadMetaBlock(RandomAccessFileReader* file,
       BytewiseComparator(), BytewiseComparator()));
 
   BlockHandle block_handle;
-  status = FindMetaBlock(meta_iter.get(), meta_block_name, &block_handle);
+  status = SeekToMetaBlock(meta_iter.get(), meta_block_name, is_found,
+                           &block_handle);
 
-  if (!status.ok()) {
+  if (!status.ok() || !*is_found) {
     return status;
   }
 
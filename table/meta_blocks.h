@@ -121,6 +121,12 @@ Status FindMetaBlock(InternalIteratorBase<Slice>* meta_index_iter,
                      const std::string& meta_block_name,
                      BlockHandle* block_handle);
 
+// Find the meta block from the meta index block. If the meta index has no
+// block of that name, OK is returned with *is_found set to false.
+Status SeekToMetaBlock(InternalIteratorBase<Slice>* meta_index_iter,
+                       const std::string& meta_block_name, bool* is_found,
+                       BlockHandle* block_handle);
+
 // Find the meta block
 Status FindMetaBlock(RandomAccessFileReader* file, uint64_t file_size,
                      uint64_t table_magic_number,
@@ -142,4 +148,14 @@ Status ReadMetaBlock(RandomAccessFileReader* file,
                      bool compression_type_missing = false,
                      MemoryAllocator* memory_allocator = nullptr);
 
+// Same as ReadMetaBlock(), but for a meta block the table may not have:
+// if it is missing, OK is returned with *is_found set to false.
+Status ReadOptionalMetaBlock(RandomAccessFileReader* file,
+                             FilePrefetchBuffer* prefetch_buffer,
+                             uint64_t file_size, uint64_t table_magic_number,
+                             const ImmutableCFOptions& ioptions,
+                             const std::string& meta_block_name,
+                             BlockContents* contents, bool* is_found,
+                             MemoryAllocator* memory_allocator = nullptr);
+
 }  // namespace rocksdb
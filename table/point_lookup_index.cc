@@ -0,0 +1,143 @@
+// Copyright (c) 2011-present, Facebook, Inc. All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/point_lookup_index.h"
+
+#include "port/port.h"
+#include "table/format.h"
+#include "util/coding.h"
+#include "util/hash.h"
+
+namespace rocksdb {
+
+namespace {
+
+const size_t kHandleEncodedLength = sizeof(uint64_t) + sizeof(uint32_t);
+const uint32_t kBlockMask = 0xFFFFFF;
+
+inline uint32_t BucketFingerprint(const Slice& user_key) {
+  return Hash(user_key.data(), user_key.size(), 0x7a3bd2f1) >> 24;
+}
+
+}  // namespace
+
+PointLookupIndexBuilder::PointLookupIndexBuilder(double util_ratio)
+    : valid_(true), num_blocks_(0) {
+  if (util_ratio <= 0) {
+    util_ratio = 0.75;  // sanity check
+  }
+  bucket_per_key_ = 1 / util_ratio;
+}
+
+void PointLookupIndexBuilder::Add(const Slice& user_key) {
+  if (!valid_) {
+    return;
+  }
+  if (!hash_and_blocks_.empty() && user_key == Slice(last_user_key_)) {
+    if ((hash_and_blocks_.back().second & kBlockMask) != num_blocks_) {
+      // The versions of this key span data blocks
+      hash_and_blocks_.back().second = kPointLookupCollision;
+    }
+    return;
+  }
+  last_user_key_.assign(user_key.data(), user_key.size());
+  hash_and_blocks_.emplace_back(GetSliceHash(user_key),
+                                (BucketFingerprint(user_key) << 24) |
+                                    num_blocks_);
+}
+
+void PointLookupIndexBuilder::FinishBlock(const BlockHandle& handle) {
+  if (!valid_) {
+    return;
+  }
+  if (num_blocks_ >= kMaxBlocksSupportedByPointLookupIndex ||
+      handle.size() > port::kMaxUint32) {
+    valid_ = false;
+    hash_and_blocks_.clear();
+    handles_.clear();
+    return;
+  }
+  PutFixed64(&handles_, handle.offset());
+  PutFixed32(&handles_, static_cast<uint32_t>(handle.size()));
+  ++num_blocks_;
+}
+
+Slice PointLookupIndexBuilder::Finish() {
+  assert(Valid());
+  uint32_t num_buckets =
+      static_cast<uint32_t>(hash_and_blocks_.size() * bucket_per_key_);
+  if (num_buckets == 0) {
+    num_buckets = 1;  // sanity check
+  }
+  // Same as DataBlockHashIndexBuilder, an odd number of buckets spreads the
+  // built-in hash better
+  num_buckets |= 1;
+
+  std::vector<uint32_t> buckets(num_buckets, kPointLookupNoEntry);
+  for (auto& entry : hash_and_blocks_) {
+    uint32_t& bucket = buckets[entry.first % num_buckets];
+    if (bucket == kPointLookupNoEntry) {
+      bucket = entry.second;
+    } else {
+      // Every user key is added once, so the bucket is shared
+      bucket = kPointLookupCollision;
+    }
+  }
+
+  buffer_.clear();
+  buffer_.reserve(num_buckets * sizeof(uint32_t) + handles_.size() +
+                  2 * sizeof(uint32_t));
+  for (uint32_t bucket : buckets) {
+    PutFixed32(&buffer_, bucket);
+  }
+  buffer_.append(handles_);
+  PutFixed32(&buffer_, num_blocks_);
+  PutFixed32(&buffer_, num_buckets);
+  return Slice(buffer_);
+}
+
+Status PointLookupIndex::Initialize(const Slice& data) {
+  if (data.size() < 2 * sizeof(uint32_t)) {
+    return Status::Corruption("bad point lookup index block");
+  }
+  const char* footer = data.data() + data.size() - 2 * sizeof(uint32_t);
+  uint32_t num_blocks = DecodeFixed32(footer);
+  uint32_t num_buckets = DecodeFixed32(footer + sizeof(uint32_t));
+  if (num_buckets == 0 ||
+      uint64_t(num_buckets) * sizeof(uint32_t) +
+              uint64_t(num_blocks) * kHandleEncodedLength +
+              2 * sizeof(uint32_t) !=
+          data.size()) {
+    return Status::Corruption("bad point lookup index block");
+  }
+  data_ = data.data();
+  num_blocks_ = num_blocks;
+  num_buckets_ = num_buckets;
+  return Status::OK();
+}
+
+PointLookupIndex::LookupResult PointLookupIndex::Lookup(
+    const Slice& user_key, BlockHandle* handle) const {
+  assert(Valid());
+  uint32_t idx = GetSliceHash(user_key) % num_buckets_;
+  uint32_t bucket = DecodeFixed32(data_ + idx * sizeof(uint32_t));
+  uint32_t block = bucket & kBlockMask;
+  if (block == kPointLookupNoEntry) {
+    return kNotFound;
+  }
+  if (block == kPointLookupCollision || block >= num_blocks_) {
+    return kUnknown;
+  }
+  if ((bucket >> 24) != BucketFingerprint(user_key)) {
+    return kNotFound;
+  }
+  const char* p = data_ + num_buckets_ * sizeof(uint32_t) +
+                  block * kHandleEncodedLength;
+  handle->set_offset(DecodeFixed64(p));
+  handle->set_size(DecodeFixed32(p + sizeof(uint64_t)));
+  return kFound;
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,102 @@
+// Copyright (c) 2011-present, Facebook, Inc. All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace rocksdb {
+
+class BlockHandle;
+
+// A table level hash from user key to the data block holding it, stored as
+// the meta block "rocksdb.point_lookup_index". BlockBasedTable::Get() uses it
+// to go straight to the data block instead of seeking the index, and to skip
+// keys that are not in the table without reading any data block.
+//
+// The meta block format is:
+//
+// POINT_LOOKUP_INDEX: [B B ... B H H ... H NUM_BLOCKS NUM_BUCK]
+//
+// B:          bucket, a fixed32 whose low 24 bits are a data block number
+//             and high 8 bits are a fingerprint of the user key.
+// H:          data block handle, fixed64 offset followed by fixed32 size.
+// NUM_BLOCKS: fixed32, number of data blocks.
+// NUM_BUCK:   fixed32, number of buckets.
+//
+// Two block numbers are reserved: kPointLookupNoEntry marks an empty bucket,
+// kPointLookupCollision a bucket where two different user keys fell, or whose
+// user key has versions in more than one data block. Lookups falling in a
+// collided bucket fall back to the regular index.
+//
+// Tables with more data blocks than kMaxBlocksSupportedByPointLookupIndex are
+// written without the index.
+
+const uint32_t kPointLookupNoEntry = 0xFFFFFF;
+const uint32_t kPointLookupCollision = 0xFFFFFE;
+const uint32_t kMaxBlocksSupportedByPointLookupIndex = 0xFFFFFD;
+
+class PointLookupIndexBuilder {
+ public:
+  explicit PointLookupIndexBuilder(double util_ratio);
+
+  // Add a user key of the data block being built. Versions of the same user
+  // key must be added consecutively.
+  void Add(const Slice& user_key);
+
+  // The data block holding the keys added since the last call is written at
+  // `handle`.
+  void FinishBlock(const BlockHandle& handle);
+
+  inline bool Valid() const { return valid_; }
+
+  // Serialize the index, REQUIRES: Valid()
+  Slice Finish();
+
+ private:
+  double bucket_per_key_;  // is the multiplicative inverse of util_ratio
+  bool valid_;
+  std::string last_user_key_;
+  // Hash of every distinct user key and its data block number
+  std::vector<std::pair<uint32_t, uint32_t>> hash_and_blocks_;
+  std::string handles_;
+  uint32_t num_blocks_;
+  std::string buffer_;
+};
+
+class PointLookupIndex {
+ public:
+  enum LookupResult {
+    // The key is not in the table
+    kNotFound,
+    // The key can only be in the data block returned
+    kFound,
+    // The index can't tell, use the regular index
+    kUnknown,
+  };
+
+  PointLookupIndex() : data_(nullptr), num_blocks_(0), num_buckets_(0) {}
+
+  // `data` must outlive this object
+  Status Initialize(const Slice& data);
+
+  LookupResult Lookup(const Slice& user_key, BlockHandle* handle) const;
+
+  inline bool Valid() const { return num_buckets_ != 0; }
+
+ private:
+  const char* data_;
+  uint32_t num_blocks_;
+  uint32_t num_buckets_;
+};
+
+}  // namespace rocksdb
@@ -0,0 +1,143 @@
+// Copyright (c) 2011-present, Facebook, Inc. All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/restart_prefix_index.h"
+
+#include <algorithm>
+#include <memory>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+#include "rocksdb/slice.h"
+#include "util/coding.h"
+
+namespace rocksdb {
+
+namespace {
+
+// The binary search stops once the candidate window is at most this wide, the
+// rest is counted with a branch free vector scan
+const uint32_t kScanWidth = 16;
+
+// Number of bits set in a 4 bits compare mask
+const uint8_t kMaskBits[16] = {0, 1, 1, 2, 1, 2, 2, 3,
+                               1, 2, 2, 3, 2, 3, 3, 4};
+
+uint32_t CountLessScan(const uint64_t* p, uint32_t n, uint64_t prefix) {
+  uint32_t count = 0;
+  uint32_t i = 0;
+#if defined(__AVX2__)
+  // There is no unsigned 64 bits compare, flip the sign bits instead
+  const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+  const __m256i target =
+      _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(prefix)), sign);
+  for (; i + 4 <= n; i += 4) {
+    __m256i v = _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), sign);
+    int mask = _mm256_movemask_pd(
+        _mm256_castsi256_pd(_mm256_cmpgt_epi64(target, v)));
+    count += kMaskBits[mask];
+  }
+#elif defined(__SSE4_2__)
+  const __m128i sign = _mm_set1_epi64x(INT64_MIN);
+  const __m128i target =
+      _mm_xor_si128(_mm_set1_epi64x(static_cast<int64_t>(prefix)), sign);
+  for (; i + 2 <= n; i += 2) {
+    __m128i v = _mm_xor_si128(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), sign);
+    int mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(target, v)));
+    count += kMaskBits[mask];
+  }
+#endif
+  for (; i < n; ++i) {
+    count += p[i] < prefix;
+  }
+  return count;
+}
+
+}  // namespace
+
+RestartPrefixIndex* RestartPrefixIndex::Build(const char* data,
+                                              uint32_t restarts,
+                                              uint32_t num_restarts,
+                                              bool key_is_internal,
+                                              bool value_delta_encoded) {
+  std::unique_ptr<RestartPrefixIndex> index(new RestartPrefixIndex);
+  index->prefixes_.reserve(num_restarts);
+  const char* limit = data + restarts;
+  for (uint32_t i = 0; i < num_restarts; ++i) {
+    uint32_t offset = DecodeFixed32(limit + i * sizeof(uint32_t));
+    if (offset >= restarts) {
+      return nullptr;
+    }
+    const char* p = data + offset;
+    uint32_t shared, non_shared, value_length;
+    if ((p = GetVarint32Ptr(p, limit, &shared)) == nullptr ||
+        (p = GetVarint32Ptr(p, limit, &non_shared)) == nullptr ||
+        (!value_delta_encoded &&
+         (p = GetVarint32Ptr(p, limit, &value_length)) == nullptr)) {
+      return nullptr;
+    }
+    if (shared != 0 || static_cast<uint32_t>(limit - p) < non_shared) {
+      return nullptr;
+    }
+    Slice key(p, non_shared);
+    if (key_is_internal) {
+      if (key.size() < 8) {
+        return nullptr;
+      }
+      key.remove_suffix(8);
+    }
+    index->prefixes_.push_back(KeyPrefix(key));
+  }
+  return index.release();
+}
+
+uint64_t RestartPrefixIndex::KeyPrefix(const Slice& user_key) {
+  const unsigned char* p =
+      reinterpret_cast<const unsigned char*>(user_key.data());
+  size_t n = std::min<size_t>(user_key.size(), 8);
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < n; ++i) {
+    prefix |= uint64_t(p[i]) << (56 - 8 * i);
+  }
+  return prefix;
+}
+
+uint32_t RestartPrefixIndex::CountLess(uint64_t prefix) const {
+  const uint64_t* p = prefixes_.data();
+  uint32_t lo = 0;
+  uint32_t hi = num_restarts();
+  while (hi - lo > kScanWidth) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (p[mid] < prefix) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo + CountLessScan(p + lo, hi - lo, prefix);
+}
+
+void RestartPrefixIndex::Narrow(uint64_t prefix, uint32_t* left,
+                                uint32_t* right) const {
+  // Restart points before `lo` are less than any key with `prefix` and those
+  // from `hi` on are greater, the answer of the binary search is the restart
+  // point right before the first of them not less than the target
+  uint32_t lo = CountLess(prefix);
+  uint32_t hi =
+      prefix == UINT64_MAX ? num_restarts() : CountLess(prefix + 1);
+  *left = std::max<uint32_t>(*left, std::max<uint32_t>(lo, 1) - 1);
+  *right = std::min<uint32_t>(*right, std::max<uint32_t>(hi, 1) - 1);
+  if (*left > *right) {
+    *left = *right;
+  }
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,63 @@
+// Copyright (c) 2011-present, Facebook, Inc. All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace rocksdb {
+
+class Slice;
+
+// In memory array of the first 8 bytes (big endian, zero padded) of the user
+// key at every restart point of a block. It is only valid for bytewise
+// ordered user keys, where the prefix order never contradicts the key order.
+//
+// A seek first locates the run of restart points sharing the prefix of the
+// target with a SIMD scan over the packed prefixes, and only compares full
+// keys inside that run. Blocks whose restart keys are mostly distinguished by
+// their first 8 bytes skip nearly all of the key decoding and memcmp of the
+// regular binary search.
+class RestartPrefixIndex {
+ public:
+  // Decode every restart key of the block.
+  // @params data: block contents.
+  // @params restarts: offset of the restart array in data.
+  // @params num_restarts: number of restart points.
+  // @params key_is_internal: keys carry the 8 bytes internal key footer.
+  // @params value_delta_encoded: entries are encoded in index block format
+  //         version 4, which omits the value length.
+  // Returns nullptr if any restart entry cannot be decoded.
+  static RestartPrefixIndex* Build(const char* data, uint32_t restarts,
+                                   uint32_t num_restarts, bool key_is_internal,
+                                   bool value_delta_encoded);
+
+  static uint64_t KeyPrefix(const Slice& user_key);
+
+  // Narrow the binary search range [*left, *right] over the restart points to
+  // the ones that could be the last restart point with a key less than or
+  // equal to a key starting with `prefix`.
+  void Narrow(uint64_t prefix, uint32_t* left, uint32_t* right) const;
+
+  uint32_t num_restarts() const {
+    return static_cast<uint32_t>(prefixes_.size());
+  }
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(RestartPrefixIndex) + prefixes_.capacity() * sizeof(uint64_t);
+  }
+
+ private:
+  RestartPrefixIndex() = default;
+
+  // Number of restart points whose prefix is less than `prefix`
+  uint32_t CountLess(uint64_t prefix) const;
+
+  std::vector<uint64_t> prefixes_;
+};
+
+}  // namespace rocksdb
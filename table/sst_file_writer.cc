@@ -5,12 +5,19 @@
 
 #include "rocksdb/sst_file_writer.h"
 
+#include <algorithm>
 #include <vector>
 #include "db/dbformat.h"
+#include "db/version_edit.h"
 #include "rocksdb/table.h"
+#include "rocksdb/value_extractor.h"
 #include "table/block_based_table_builder.h"
 #include "table/sst_file_writer_collectors.h"
 #include "util/file_reader_writer.h"
+#include "util/hash.h"
+#include "util/random.h"
+#include "util/rate_limiter.h"
+#include "util/string_util.h"
 #include "util/sync_point.h"
 
 namespace rocksdb {
@@ -24,6 +31,13 @@ const std::string ExternalSstFilePropertyNames::kGlobalSeqno =
 
 const size_t kFadviseTrigger = 1024 * 1024; // 1MB
 
+// Value indexes of a key-value separated file refer to its blob files by
+// numbers picked at random in this range, far above any real file number.
+// Ingestion gives the blob files real numbers and keeps these ones in their
+// inheritance chain, the same way GC outputs stand in for their inputs.
+const uint64_t kExternalBlobFileNumberBase = 1ull << 60;
+const uint64_t kExternalBlobFileNumberMask = kExternalBlobFileNumberBase - 1;
+
 struct SstFileWriter::Rep {
   Rep(const EnvOptions& _env_options, const Options& options,
       Env::IOPriority _io_priority, const Comparator* _user_comparator,
@@ -36,7 +50,11 @@ struct SstFileWriter::Rep {
         cfh(_cfh),
         invalidate_page_cache(_invalidate_page_cache),
         last_fadvise_size(0),
-        skip_filters(_skip_filters) {}
+        skip_filters(_skip_filters),
+        separate_value(false),
+        blob_large_key_ratio_lsh16(0),
+        next_blob_file_number(0),
+        compression_type(kNoCompression) {}
 
   std::unique_ptr<WritableFileWriter> file_writer;
   std::unique_ptr<TableBuilder> builder;
@@ -56,6 +74,101 @@ struct SstFileWriter::Rep {
   // cached pages from page cache.
   uint64_t last_fadvise_size;
   bool skip_filters;
+  // Key-value separation, see SstFileWriter::OpenWithBlob()
+  bool separate_value;
+  uint64_t blob_large_key_ratio_lsh16;
+  uint64_t next_blob_file_number;
+  uint32_t cf_id;
+  CompressionType compression_type;
+  CompressionOptions compression_opts;
+  std::vector<std::unique_ptr<IntTblPropCollectorFactory>>
+      int_tbl_prop_collector_factories;
+  std::unique_ptr<ValueExtractor> value_meta_extractor;
+  std::unique_ptr<WritableFileWriter> blob_file_writer;
+  std::unique_ptr<TableBuilder> blob_builder;
+  uint64_t blob_file_number;
+  // Dependence of the key sst on its blob files
+  TablePropertyCache prop;
+
+  bool ShouldSeparate(const Slice& user_key, const Slice& value,
+                      const ValueType value_type) const {
+    // (key.size << 16) <= value.size * large_key_ratio, as in compaction
+    return separate_value &&
+           (value_type == kTypeValue || value_type == kTypeMerge) &&
+           value.size() >= mutable_cf_options.blob_size &&
+           (uint64_t(user_key.size()) << 16) <=
+               value.size() * blob_large_key_ratio_lsh16;
+  }
+
+  Status OpenBlob() {
+    assert(!blob_builder);
+    std::string blob_file_path =
+        file_info.file_path + ".blob." +
+        ToString(file_info.blob_file_paths.size() + 1);
+    std::unique_ptr<WritableFile> blob_file;
+    Status s = ioptions.env->NewWritableFile(blob_file_path, &blob_file,
+                                             env_options);
+    if (!s.ok()) {
+      return s;
+    }
+    blob_file->SetIOPriority(io_priority);
+    file_info.blob_file_paths.push_back(blob_file_path);
+    blob_file_number = next_blob_file_number++;
+
+    TableBuilderOptions table_builder_options(
+        ioptions, mutable_cf_options, internal_comparator,
+        &int_tbl_prop_collector_factories, compression_type, compression_opts,
+        nullptr /* compression_dict */, true /* skip_filters */,
+        column_family_name, -1 /* level */, 0 /* compaction_load */);
+    blob_file_writer.reset(new WritableFileWriter(
+        std::move(blob_file), blob_file_path, env_options, nullptr /* stats */,
+        ioptions.listeners));
+    blob_builder.reset(ioptions.table_factory->NewTableBuilder(
+        table_builder_options, cf_id, blob_file_writer.get()));
+    return s;
+  }
+
+  Status FinishBlob() {
+    assert(blob_builder);
+    TablePropertyCache blob_prop;
+    blob_prop.purpose = kEssenceSst;
+    blob_prop.inheritance_chain.push_back(blob_file_number);
+    Status s = blob_builder->Finish(&blob_prop, nullptr);
+    if (s.ok()) {
+      prop.dependence.emplace_back(
+          Dependence{blob_file_number, blob_builder->NumEntries()});
+      s = blob_file_writer->Sync(ioptions.use_fsync);
+      if (s.ok()) {
+        s = blob_file_writer->Close();
+      }
+    }
+    blob_builder.reset();
+    blob_file_writer.reset();
+    return s;
+  }
+
+  // Write the value to the current blob file and replace it by its index
+  Status SeparateValue(const Slice& internal_key, LazyBuffer* value) {
+    Status s;
+    if (blob_builder &&
+        blob_builder->FileSize() > mutable_cf_options.target_file_size_base) {
+      s = FinishBlob();
+    }
+    if (s.ok() && !blob_builder) {
+      s = OpenBlob();
+    }
+    if (s.ok()) {
+      s = blob_builder->Add(internal_key, *value);
+    }
+    if (s.ok()) {
+      s = SeparateHelper::TransToSeparate(
+          internal_key, *value, blob_file_number, Slice(),
+          GetInternalKeyType(internal_key) == kTypeMerge, false,
+          value_meta_extractor.get());
+    }
+    return s;
+  }
+
   Status Add(const Slice& user_key, const Slice& value,
              const ValueType value_type) {
     if (!builder) {
@@ -89,7 +202,19 @@ struct SstFileWriter::Rep {
       default:
         return Status::InvalidArgument("Value type is not supported");
     }
-    builder->Add(ikey.Encode(), LazyBuffer(value));
+    IOClassGuard io_class_guard(RateLimiter::IOClass::kIngest);
+    if (ShouldSeparate(user_key, value, value_type)) {
+      LazyBuffer value_index(value);
+      Status s = SeparateValue(ikey.Encode(), &value_index);
+      if (!s.ok()) {
+        return s;
+      }
+      ikey.Set(user_key, 0 /* Sequence Number */,
+               value_type == kTypeValue ? kTypeValueIndex : kTypeMergeIndex);
+      builder->Add(ikey.Encode(), value_index);
+    } else {
+      builder->Add(ikey.Encode(), LazyBuffer(value));
+    }
 
     // update file info
     file_info.num_entries++;
@@ -173,6 +298,9 @@ SstFileWriter::~SstFileWriter() {
     // abandon the builder.
     rep_->builder->Abandon();
   }
+  if (rep_->blob_builder) {
+    rep_->blob_builder->Abandon();
+  }
 }
 
 Status SstFileWriter::Open(const std::string& file_path) {
@@ -204,8 +332,8 @@ Status SstFileWriter::Open(const std::string& file_path) {
     compression_opts = r->ioptions.compression_opts;
   }
 
-  std::vector<std::unique_ptr<IntTblPropCollectorFactory>>
-      int_tbl_prop_collector_factories;
+  auto& int_tbl_prop_collector_factories = r->int_tbl_prop_collector_factories;
+  int_tbl_prop_collector_factories.clear();
 
   // SstFileWriter properties collector to add SstFileWriter version.
   int_tbl_prop_collector_factories.emplace_back(
@@ -221,7 +349,7 @@ Status SstFileWriter::Open(const std::string& file_path) {
             user_collector_factories[i]));
   }
   int unknown_level = -1;
-  uint32_t cf_id;
+  uint32_t& cf_id = r->cf_id;
 
   if (r->cfh != nullptr) {
     // user explicitly specified that this file will be ingested into cfh,
@@ -250,6 +378,33 @@ Status SstFileWriter::Open(const std::string& file_path) {
   r->file_info = ExternalSstFileInfo();
   r->file_info.file_path = file_path;
   r->file_info.version = 2;
+  r->separate_value = false;
+  r->compression_type = compression_type;
+  r->compression_opts = compression_opts;
+  r->prop = TablePropertyCache();
+  return s;
+}
+
+Status SstFileWriter::OpenWithBlob(const std::string& file_path) {
+  Rep* r = rep_.get();
+  Status s = Open(file_path);
+  if (!s.ok() || r->ioptions.table_factory->IsBuilderNeedSecondPass()) {
+    return s;
+  }
+  r->separate_value = true;
+  r->blob_large_key_ratio_lsh16 = static_cast<uint64_t>(
+      r->mutable_cf_options.blob_large_key_ratio * 65536);
+  r->next_blob_file_number =
+      kExternalBlobFileNumberBase |
+      (Random64(r->ioptions.env->NowNanos() ^ GetSliceHash(file_path))
+           .Next() &
+       kExternalBlobFileNumberMask);
+  if (r->ioptions.value_meta_extractor_factory != nullptr) {
+    ValueExtractorContext context = {r->cf_id};
+    r->value_meta_extractor =
+        r->ioptions.value_meta_extractor_factory->CreateValueExtractor(
+            context);
+  }
   return s;
 }
 
@@ -284,7 +439,16 @@ Status SstFileWriter::Finish(ExternalSstFileInfo* file_info) {
     return Status::InvalidArgument("Cannot create sst file with no entries");
   }
 
-  Status s = r->builder->Finish(nullptr, nullptr);
+  IOClassGuard io_class_guard(RateLimiter::IOClass::kIngest);
+  Status s;
+  if (r->blob_builder) {
+    s = r->FinishBlob();
+  }
+  if (s.ok()) {
+    s = r->builder->Finish(r->separate_value ? &r->prop : nullptr, nullptr);
+  } else {
+    r->builder->Abandon();
+  }
   r->file_info.file_size = r->builder->FileSize();
 
   if (s.ok()) {
@@ -296,6 +460,9 @@ Status SstFileWriter::Finish(ExternalSstFileInfo* file_info) {
   }
   if (!s.ok()) {
     r->ioptions.env->DeleteFile(r->file_info.file_path);
+    for (auto& blob_file_path : r->file_info.blob_file_paths) {
+      r->ioptions.env->DeleteFile(blob_file_path);
+    }
   }
 
   if (file_info != nullptr) {
@@ -248,6 +248,7 @@ extern const std::string kPropertiesBlock = "rocksdb.properties";
 extern const std::string kPropertiesBlockOldName = "rocksdb.stats";
 extern const std::string kCompressionDictBlock = "rocksdb.compression_dict";
 extern const std::string kRangeDelBlock = "rocksdb.range_del";
+extern const std::string kPointLookupIndexBlock = "rocksdb.point_lookup_index";
 
 // Seek to the properties block.
 // Return true if it successfully seeks to the properties block.
@@ -274,4 +275,10 @@ Status SeekToRangeDelBlock(InternalIteratorBase<Slice>* meta_iter,
   return SeekToMetaBlock(meta_iter, kRangeDelBlock, is_found, block_handle);
 }
 
+Status SeekToPointLookupIndexBlock(InternalIteratorBase<Slice>* meta_iter,
+                                   bool* is_found, BlockHandle* block_handle) {
+  return SeekToMetaBlock(meta_iter, kPointLookupIndexBlock, is_found,
+                         block_handle);
+}
+
 }  // namespace rocksdb
@@ -28,4 +28,7 @@ Status SeekToCompressionDictBlock(InternalIteratorBase<Slice>* meta_iter,
 Status SeekToRangeDelBlock(InternalIteratorBase<Slice>* meta_iter,
                            bool* is_found, BlockHandle* block_handle);
 
+Status SeekToPointLookupIndexBlock(InternalIteratorBase<Slice>* meta_iter,
+                                   bool* is_found, BlockHandle* block_handle);
+
 }  // namespace rocksdb
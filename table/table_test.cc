@@ -3639,6 +3639,82 @@ TEST_P(BlockBasedTableTest, DataBlockHashIndex) {
   }
 }
 
+TEST_P(BlockBasedTableTest, PointLookupIndex) {
+  const int kNumKeys = 300;
+  const int kNumVersions = 20;
+
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.block_size = 256;
+  table_options.point_lookup_index = true;
+
+  Options options;
+  options.comparator = BytewiseComparator();
+  options.statistics = CreateDBStatistics();
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+
+  const InternalKeyComparator internal_comparator(options.comparator);
+  TableConstructor c(&internal_comparator);
+
+  static Random rnd(1048);
+  for (int i = 0; i < kNumKeys; i++) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%06d", i);
+    InternalKey k(buf, 0, kTypeValue);
+    c.Add(k.Encode().ToString(), RandomString(&rnd, 100));
+  }
+  // Versions of this key span several data blocks
+  for (int i = 1; i <= kNumVersions; i++) {
+    InternalKey k("key000100a", i, kTypeValue);
+    c.Add(k.Encode().ToString(), std::to_string(i) + RandomString(&rnd, 100));
+  }
+
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableCFOptions ioptions(options);
+  const MutableCFOptions moptions(options);
+  c.Finish(options, ioptions, moptions, table_options, internal_comparator,
+           &keys, &kvmap);
+  auto reader = c.GetTableReader();
+
+  auto get = [&](const Slice& user_key, SequenceNumber seq,
+                 std::string* result) {
+    LazyBuffer value;
+    GetContext get_context(options.comparator, nullptr, nullptr, nullptr,
+                           GetContext::kNotFound, user_key, &value, nullptr,
+                           nullptr, nullptr, nullptr, nullptr, nullptr);
+    InternalKey ikey(user_key, seq, kValueTypeForSeek);
+    ASSERT_OK(reader->Get(ReadOptions(), ikey.Encode(), &get_context,
+                          moptions.prefix_extractor.get()));
+    if (get_context.State() == GetContext::kFound) {
+      ASSERT_OK(value.fetch());
+      *result = value.ToString();
+    } else {
+      ASSERT_EQ(GetContext::kNotFound, get_context.State());
+      *result = "NOT_FOUND";
+    }
+  };
+
+  std::string result;
+  for (auto& kv : kvmap) {
+    ParsedInternalKey parsed;
+    ASSERT_TRUE(ParseInternalKey(kv.first, &parsed));
+    get(parsed.user_key, parsed.sequence, &result);
+    ASSERT_EQ(kv.second, result);
+  }
+  get("key000100a", kMaxSequenceNumber, &result);
+  ASSERT_EQ(std::to_string(kNumVersions), result.substr(0, 2));
+
+  for (int i = 0; i < kNumKeys; i++) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%06db", i);
+    get(buf, kMaxSequenceNumber, &result);
+    ASSERT_EQ("NOT_FOUND", result);
+  }
+  // Most missing keys are rejected without touching a data block
+  ASSERT_GT(options.statistics->getTickerCount(POINT_LOOKUP_INDEX_USEFUL),
+            kNumKeys / 2);
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
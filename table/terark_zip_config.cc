@@ -327,6 +327,7 @@ bool TerarkZipCFOptionsFromEnv(ColumnFamilyOptions& cfo,
   MyOverrideBool(tzo, useSuffixArrayLocalMatch);
   MyOverrideBool(tzo, warmUpIndexOnOpen);
   MyOverrideBool(tzo, warmUpValueOnOpen);
+  MyOverrideBool(tzo, warmUpIndexLazily);
   MyOverrideBool(tzo, disableSecondPassIter);
   MyOverrideBool(tzo, enableCompressionProbe);
   MyOverrideBool(tzo, disableCompressDict);
@@ -338,10 +339,14 @@ bool TerarkZipCFOptionsFromEnv(ColumnFamilyOptions& cfo,
   MyOverrideDouble(tzo, sampleRatio);
   MyOverrideDouble(tzo, indexCacheRatio);
   MyOverrideDouble(tzo, cbtMinKeyRatio);
+  MyOverrideDouble(tzo, adaptiveMinZipGain);
 
   MyOverrideInt(tzo, minDictZipValueSize);
   MyOverrideInt(tzo, minPreadLen);
   MyOverrideInt(tzo, cbtHashBits);
+  MyOverrideInt(tzo, bloomBitsPerKey);
+  MyOverrideInt(tzo, zipValueThreads);
+  MyOverrideInt(tzo, streamingLevels);
 
 
   MyOverrideXiB(tzo, softZipWorkingMemLimit);
@@ -349,10 +354,12 @@ bool TerarkZipCFOptionsFromEnv(ColumnFamilyOptions& cfo,
   MyOverrideXiB(tzo, smallTaskMemory);
   MyOverrideXiB(tzo, singleIndexMinSize);
   MyOverrideXiB(tzo, singleIndexMaxSize);
+  MyOverrideXiB(tzo, streamingChunkSize);
   MyOverrideXiB(tzo, cacheCapacityBytes);
   MyOverrideInt(tzo, cbtEntryPerTrie);
   MyOverrideInt(tzo, cbtMinKeySize);
   MyOverrideInt(tzo, cacheShards);
+  MyOverrideInt(tzo, recordCacheMaxValueSize);
 
   tzo.singleIndexMinSize = std::max<size_t>(tzo.singleIndexMinSize, 1ull << 20);
   tzo.singleIndexMaxSize =
@@ -57,11 +57,14 @@ extern const uint64_t kTerarkZipTableMagicNumber;
 
 extern const std::string kTerarkZipTableValueDictBlock;
 extern const std::string kTerarkZipTableOffsetBlock;
+extern const std::string kTerarkZipTableFilterBlock;
 extern const std::string kTerarkEmptyTableKey;
 extern const std::string kTerarkZipTableBuildTimestamp;
 extern const std::string kTerarkZipTableDictInfo;
 extern const std::string kTerarkZipTableDictSize;
 extern const std::string kTerarkZipTableEntropy;
+extern const std::string kTerarkZipTableAdaptiveDecision;
+extern const std::string kTerarkZipTableIndexResident;
 
 template <class ByteArray>
 inline Slice SliceOf(const ByteArray& ba) {
@@ -196,6 +199,13 @@ class TerarkZipTableFactory : public TableFactory, boost::noncopyable {
 
   LruReadonlyCache* cache() const { return cache_.get(); }
 
+  TableFactory* fallback_factory() const { return fallback_factory_.get(); }
+
+  Cache* record_cache() const { return table_options_.recordCache.get(); }
+  size_t record_cache_max_value_size() const {
+    return table_options_.recordCacheMaxValueSize;
+  }
+
   Status GetOptionString(std::string* opt_string,
                          const std::string& delimiter) const
       TERARK_ROCKSDB_5008(override);
@@ -72,6 +72,7 @@ const uint64_t kTerarkZipTableMagicNumber = 0x1122334455667788;
 const std::string kTerarkZipTableValueDictBlock =
     "TerarkZipTableValueDictBlock";
 const std::string kTerarkZipTableOffsetBlock = "TerarkZipTableOffsetBlock";
+const std::string kTerarkZipTableFilterBlock = "TerarkZipTableFilterBlock";
 const std::string kTerarkEmptyTableKey = "ThisIsAnEmptyTable";
 
 using terark::XXHash64;
@@ -80,6 +81,8 @@ const std::string kTerarkZipTableBuildTimestamp = "terark.build.timestamp";
 const std::string kTerarkZipTableDictInfo = "terark.build.dict_info";
 const std::string kTerarkZipTableDictSize = "terark.build.dict_size";
 const std::string kTerarkZipTableEntropy = "terark.build.entropy";
+const std::string kTerarkZipTableAdaptiveDecision = "terark.build.adaptive";
+const std::string kTerarkZipTableIndexResident = "terark.index.resident";
 
 const size_t CollectInfo::queue_size = 1024;
 
@@ -538,6 +541,9 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"warmUpValueOnOpen",
          {offsetof(struct TerarkZipTableOptions, warmUpValueOnOpen),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"warmUpIndexLazily",
+         {offsetof(struct TerarkZipTableOptions, warmUpIndexLazily),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
         {"disableSecondPassIter",
          {offsetof(struct TerarkZipTableOptions, disableSecondPassIter),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
@@ -556,9 +562,24 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"cbtHashBits",
          {offsetof(struct TerarkZipTableOptions, cbtHashBits),
           OptionType::kUInt, OptionVerificationType::kNormal, false, 0}},
+        {"bloomBitsPerKey",
+         {offsetof(struct TerarkZipTableOptions, bloomBitsPerKey),
+          OptionType::kUInt, OptionVerificationType::kNormal, false, 0}},
+        {"streamingLevels",
+         {offsetof(struct TerarkZipTableOptions, streamingLevels),
+          OptionType::kUInt32T, OptionVerificationType::kNormal, false, 0}},
+        {"streamingChunkSize",
+         {offsetof(struct TerarkZipTableOptions, streamingChunkSize),
+          OptionType::kUInt64T, OptionVerificationType::kNormal, false, 0}},
+        {"zipValueThreads",
+         {offsetof(struct TerarkZipTableOptions, zipValueThreads),
+          OptionType::kUInt, OptionVerificationType::kNormal, false, 0}},
         {"offsetArrayBlockUnits",
          {offsetof(struct TerarkZipTableOptions, offsetArrayBlockUnits),
           OptionType::kUInt, OptionVerificationType::kNormal, false, 0}},
+        {"adaptiveMinZipGain",
+         {offsetof(struct TerarkZipTableOptions, adaptiveMinZipGain),
+          OptionType::kDouble, OptionVerificationType::kNormal, false, 0}},
         {"sampleRatio",
          {offsetof(struct TerarkZipTableOptions, sampleRatio),
           OptionType::kDouble, OptionVerificationType::kNormal, false, 0}},
@@ -610,6 +631,9 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"cbtMinKeyRatio",
          {offsetof(struct TerarkZipTableOptions, cbtMinKeyRatio),
           OptionType::kDouble, OptionVerificationType::kNormal, false, 0}},
+        {"recordCacheMaxValueSize",
+         {offsetof(struct TerarkZipTableOptions, recordCacheMaxValueSize),
+          OptionType::kUInt32T, OptionVerificationType::kNormal, false, 0}},
 };
 
 // delimiter must be "\n"
@@ -676,12 +700,16 @@ Status TerarkZipTableOptions::Parse(Slice opt) {
   }
   int entropyAlgo, cbtHashBits;
   int debugLevel, indexNestScale, indexTempLevel, offsetArrayBlockUnits;
+  int bloomBitsPerKey = this->bloomBitsPerKey;
+  int zipValueThreads = this->zipValueThreads;
 #include "terark_zip_table_property_print.h"
 
   this->debugLevel = (byte_t)debugLevel;
   this->indexNestScale = (byte_t)indexNestScale;
   this->indexTempLevel = (byte_t)indexTempLevel;
   this->cbtHashBits = (byte_t)cbtHashBits;
+  this->bloomBitsPerKey = (byte_t)bloomBitsPerKey;
+  this->zipValueThreads = (byte_t)zipValueThreads;
   this->offsetArrayBlockUnits = (uint16_t)offsetArrayBlockUnits;
   this->entropyAlgo = (EntropyAlgo)entropyAlgo;
 
@@ -74,7 +74,19 @@ struct TerarkZipTableOptions {
   bool forceMetaInMemory = false;
   bool enableEntropyStore = true;
   uint8_t cbtHashBits = 0;
-  uint8_t reserveBytes0[5] = {};
+  /// bits per user key of the cache line blocked bloom filter checked by
+  /// Get() before searching the index, 0 : no filter
+  uint8_t bloomBitsPerKey = 0;
+  /// threads compressing the values of a table, > 1 cuts the table into
+  /// sub indexes of at most (target file size / zipValueThreads) raw bytes,
+  /// which share one dictionary and are compressed in parallel
+  uint8_t zipValueThreads = 1;
+  /// the index is neither touched nor dropped from the page cache by Open(),
+  /// it is used in place from the mmap with MADV_RANDOM and paged in later
+  /// by a background job, lower levels and newer files first, this takes
+  /// precedence over warmUpIndexOnOpen
+  bool warmUpIndexLazily = false;
+  uint8_t reserveBytes0[2] = {};
   uint16_t offsetArrayBlockUnits = 0;
 
   double sampleRatio = 0.03;
@@ -105,7 +117,32 @@ struct TerarkZipTableOptions {
   uint32_t cbtEntryPerTrie = 65536;
   uint32_t cbtMinKeySize = 16;
   double cbtMinKeyRatio = 0.5;
-  uint8_t reserveBytes1[8] = {};
+  /// bit i set : output files of level i are built in streaming mode, the
+  /// second pass iterator is never used, the value dictionary is sampled
+  /// from the first chunk and every following chunk is compressed as soon
+  /// as it is complete, this trades some compression ratio for one pass I/O
+  uint32_t streamingLevels = 0;
+  uint8_t reserveBytes1[4] = {};
+  /// keys and values of a streaming chunk, the values of the chunk being
+  /// filled and of the one being compressed are kept in memory
+  uint64_t streamingChunkSize = 64ULL << 20;  // 64M
+
+  /// point lookups keep the decompressed records in recordCache, it can be
+  /// the block_cache of BlockBasedTableOptions so that both share capacity,
+  /// iterators look records up but never insert them
+  /// nullptr : no record cache
+  std::shared_ptr<class Cache> recordCache;
+  /// records larger than recordCacheMaxValueSize are never cached
+  uint32_t recordCacheMaxValueSize = 4096;
+
+  /// with a fallback TableFactory, each output file decides at Finish() from
+  /// the entropy of its keys and values and the compression ratio observed
+  /// on recent TerarkZip files (CollectInfo::estimate()), if the projected
+  /// size reduction is below adaptiveMinZipGain the file is built by the
+  /// fallback factory, the decision is kept in the table properties,
+  /// streamingLevels is ignored when enabled
+  /// 0 : always TerarkZip
+  double adaptiveMinZipGain = 0;
 
   class Status Parse(class Slice);
 };
@@ -10,6 +10,7 @@
 #include <boost/range/algorithm.hpp>
 // rocksdb headers
 #include <db/version_edit.h>
+#include <options/cf_options.h>
 #include <rocksdb/compaction_filter.h>
 #include <rocksdb/merge_operator.h>
 #include <table/meta_blocks.h>
@@ -17,6 +18,7 @@
 #include <util/c_style_callback.h>
 #include <util/xxhash.h>
 #include <util/string_util.h>
+#include <util/sync_point.h>
 // terark headers
 #include <terark/io/MemStream.hpp>
 #include <terark/lcast.hpp>
@@ -68,6 +70,61 @@ static Status WriteBlock(const ByteArray& blockData, WritableFileWriter* file,
   return s;
 }
 
+namespace {
+// the collector factories of the DB outlive the builder
+class ForwardIntTblPropCollectorFactory : public IntTblPropCollectorFactory {
+ public:
+  explicit ForwardIntTblPropCollectorFactory(IntTblPropCollectorFactory* f)
+      : factory_(f) {}
+  IntTblPropCollector* CreateIntTblPropCollector(
+      const TablePropertiesCollectorFactory::Context& context) override {
+    return factory_->CreateIntTblPropCollector(context);
+  }
+  const char* Name() const override { return factory_->Name(); }
+
+ private:
+  IntTblPropCollectorFactory* factory_;
+};
+
+// records the adaptive decision in files built by the fallback factory
+class AdaptiveDecisionCollector : public IntTblPropCollector {
+ public:
+  explicit AdaptiveDecisionCollector(const std::string& decision)
+      : decision_(decision) {}
+  Status Finish(UserCollectedProperties* properties) override {
+    properties->emplace(kTerarkZipTableAdaptiveDecision, decision_);
+    return Status::OK();
+  }
+  const char* Name() const override { return "AdaptiveDecisionCollector"; }
+  Status InternalAdd(const Slice&, const Slice&, uint64_t) override {
+    return Status::OK();
+  }
+  UserCollectedProperties GetReadableProperties() const override {
+    return UserCollectedProperties{
+        {kTerarkZipTableAdaptiveDecision, decision_}};
+  }
+
+ private:
+  std::string decision_;
+};
+
+class AdaptiveDecisionCollectorFactory : public IntTblPropCollectorFactory {
+ public:
+  explicit AdaptiveDecisionCollectorFactory(const std::string& decision)
+      : decision_(decision) {}
+  IntTblPropCollector* CreateIntTblPropCollector(
+      const TablePropertiesCollectorFactory::Context&) override {
+    return new AdaptiveDecisionCollector(decision_);
+  }
+  const char* Name() const override {
+    return "AdaptiveDecisionCollectorFactory";
+  }
+
+ private:
+  std::string decision_;
+};
+}  // namespace
+
 static std::string GetTimestamp() {
   using namespace std::chrono;
   uint64_t timestamp =
@@ -175,6 +232,11 @@ TerarkZipTableBuilder::TerarkZipTableBuilder(
   tiopt_.cbtEntryPerTrie = table_options_.cbtEntryPerTrie;
   tiopt_.cbtMinKeySize = table_options_.cbtMinKeySize;
   tiopt_.cbtMinKeyRatio = table_options_.cbtMinKeyRatio;
+  if (!tbo.skip_filters && table_options_.bloomBitsPerKey > 0) {
+    filterPolicy_.reset(
+        NewBloomFilterPolicy(table_options_.bloomBitsPerKey, false));
+    filterBuilder_.reset(filterPolicy_->GetFilterBitsBuilder());
+  }
   try {
     if (IsCompactionWorkerNode()) {
       TerarkZipConfigCompactionWorkerFromEnv(table_options_);
@@ -182,6 +244,25 @@ TerarkZipTableBuilder::TerarkZipTableBuilder(
     singleIndexMaxSize_ = std::min(table_options_.softZipWorkingMemLimit,
                                    table_options_.singleIndexMaxSize);
     level_ = tbo.level;
+    adaptive_ = table_options_.adaptiveMinZipGain > 0 &&
+                table_factory_->fallback_factory() != nullptr;
+    if (adaptive_) {
+      fallbackTbo_.reset(new TableBuilderOptions(tbo));
+      fallbackSmallestUserKey_ = tbo.smallest_user_key.ToString();
+      fallbackLargestUserKey_ = tbo.largest_user_key.ToString();
+      fallbackTbo_->smallest_user_key = fallbackSmallestUserKey_;
+      fallbackTbo_->largest_user_key = fallbackLargestUserKey_;
+    }
+    streaming_ = !adaptive_ && tbo.level >= 0 && tbo.level < 32 &&
+                 (table_options_.streamingLevels >> tbo.level & 1) != 0;
+    if (table_options_.zipValueThreads > 1 && !streaming_) {
+      // a table compressed as a single range would use one thread only
+      zipRangeMaxSize_ = std::max<size_t>(
+          table_options_.singleIndexMinSize,
+          MaxFileSizeForLevel(tbo.moptions, std::max(tbo.level, 0),
+                              tbo.ioptions.compaction_style) /
+              table_options_.zipValueThreads);
+    }
     if (tbo.compaction_load > 0) {
       double load =
           tbo.compaction_load * tbo.ioptions.num_levels -
@@ -270,6 +351,9 @@ TerarkZipTableBuilder::~TerarkZipTableBuilder() {
 }
 
 uint64_t TerarkZipTableBuilder::FileSize() const {
+  if (fallback_) {
+    return fallback_->FileSize();
+  }
   if (offset_ == 0) {
     // for compaction caller to split file by increasing size
     return estimateOffset_;
@@ -279,6 +363,9 @@ uint64_t TerarkZipTableBuilder::FileSize() const {
 }
 
 TableProperties TerarkZipTableBuilder::GetTableProperties() const {
+  if (fallback_) {
+    return fallback_->GetTableProperties();
+  }
   TableProperties ret = properties_;
   if (!closed_) {
     // don't call MyRocksTablePropertiesCollectorHack before Finish()
@@ -295,6 +382,10 @@ TableProperties TerarkZipTableBuilder::GetTableProperties() const {
   }
   ret.user_collected_properties.emplace(kTerarkZipTableDictSize,
                                         lcast(dictSize_));
+  if (!adaptiveDecision_.empty()) {
+    ret.user_collected_properties.emplace(kTerarkZipTableAdaptiveDecision,
+                                          adaptiveDecision_);
+  }
   return ret;
 }
 
@@ -368,15 +459,29 @@ TerarkZipTableBuilder::KeyValueStatus::KeyValueStatus(
   assert(status.stat.keyCount == status.valueHist.m_cnt_sum);
 }
 
+// streaming build keeps the values of a chunk in memory instead of the
+// value temp file, see TerarkZipTableOptions::streamingChunkSize
+struct StreamFilePair : public FilePair {
+  struct ValueBuffer : NativeDataOutput<AutoGrownMemIO> {
+    fstring data() const { return fstring((char*)m_beg, m_pos - m_beg); }
+  };
+  std::unique_ptr<ValueBuffer> values{new ValueBuffer};
+};
+
 std::shared_ptr<FilePair> TerarkZipTableBuilder::NewFilePair() {
-  auto pair = std::make_shared<FilePair>();
+  std::shared_ptr<FilePair> pair;
   char buffer[32];
+  if (streaming_) {
+    pair = std::make_shared<StreamFilePair>();
+  } else {
+    pair = std::make_shared<FilePair>();
+    snprintf(buffer, sizeof buffer, ".value.%06zd", nameSeed_);
+    pair->value.path = tmpSentryFile_.path + buffer;
+    pair->value.open();
+  }
   snprintf(buffer, sizeof buffer, ".key.%06zd", nameSeed_);
   pair->key.path = tmpSentryFile_.path + buffer;
   pair->key.open();
-  snprintf(buffer, sizeof buffer, ".value.%06zd", nameSeed_);
-  pair->value.path = tmpSentryFile_.path + buffer;
-  pair->value.open();
   ++nameSeed_;
   return pair;
 };
@@ -420,6 +525,14 @@ Status TerarkZipTableBuilder::Add(const Slice& key,
     if (terark_unlikely(indexBuildMemSize > singleIndexMaxSize_)) {
       return true;
     }
+    if (streaming_ && r22_->stat.sumKeyLen + r22_->stat.sumValueLen >
+                          table_options_.streamingChunkSize) {
+      return true;
+    }
+    if (zipRangeMaxSize_ > 0 &&
+        r22_->stat.sumKeyLen + r22_->stat.sumValueLen > zipRangeMaxSize_) {
+      return true;
+    }
     return !MergeRangeStatus(
         r22_.get(), r11_.get(), r21_.get(),
         freq_hist_o1::estimate_size_unfinish(freq_[2]->k, freq_[1]->k));
@@ -427,8 +540,14 @@ Status TerarkZipTableBuilder::Add(const Slice& key,
   fstring prevUserKey =
       prevKey_.size() == 0 ? fstring() : fstringOf(prevKey_.user_key());
   size_t samePrefix = userKey.commonPrefixLen(prevUserKey);
+  if (filterBuilder_ && (!r00_ || prevUserKey != userKey)) {
+    filterBuilder_->AddKey(SliceOf(userKey));
+  }
+  // streaming chunks are cut between file pairs, bound their values too
+  size_t filePairSize =
+      streaming_ ? keyDataSize_ + valueDataSize_ : keyDataSize_;
   if (!r00_ || (prevUserKey != userKey &&
-                keyDataSize_ > table_options_.singleIndexMinSize)) {
+                filePairSize > table_options_.singleIndexMinSize)) {
     if (!r00_) {
       assert(prefixBuildInfos_.empty());
       t0 = g_pf.now();
@@ -469,6 +588,12 @@ Status TerarkZipTableBuilder::Add(const Slice& key,
         prefixBuildInfos_.emplace_back(kvs);
         BuildIndex(*kvs, freq_hist_o1::estimate_size_unfinish(freq_[2]->k));
         BuildStore(*kvs, nullptr, BuildStoreInit);
+        if (streaming_) {
+          s = StreamZipStore(*kvs);
+          if (!s.ok()) {
+            return s;
+          }
+        }
         r22_.swap(r11_);  // ignore
         *r21_ = *r10_;    // add last
         r20_.swap(r10_);  // add prev
@@ -490,7 +615,9 @@ Status TerarkZipTableBuilder::Add(const Slice& key,
     }
     if (filePair_) {
       filePair_->key.complete_write();
-      filePair_->value.complete_write();
+      if (!streaming_) {
+        filePair_->value.complete_write();
+      }
     }
     filePair_ = NewFilePair();
     r00_->fileVec.push_back(filePair_);
@@ -514,15 +641,21 @@ Status TerarkZipTableBuilder::Add(const Slice& key,
     tmpSampleFile_.writer << fstringOf(value);
     sampleLenSum_ += value.size();
   }
-  if (filePair_->isFullValue && second_pass_iter_ &&
+  // Streamed chunks keep their values in memory, they are read only once
+  if (!streaming_ && filePair_->isFullValue && second_pass_iter_ &&
       table_options_.debugLevel != 2 && valueDataSize_ > (1ull << 20) &&
       valueDataSize_ > keyDataSize_ * 2) {
     filePair_->isFullValue = false;
   }
-  assert(filePair_->value.fp);
-  filePair_->value.writer << seqType
-                          << fstringOf(filePair_->isFullValue ? value
-                                                              : Slice());
+  if (streaming_) {
+    *static_cast<StreamFilePair&>(*filePair_).values << seqType
+                                                     << fstringOf(value);
+  } else {
+    assert(filePair_->value.fp);
+    filePair_->value.writer << seqType
+                            << fstringOf(filePair_->isFullValue ? value
+                                                                : Slice());
+  }
 
   size_t freq_size = properties_.raw_key_size + properties_.raw_value_size;
   if (freq_size >= next_freq_size_) {
@@ -561,6 +694,10 @@ Status TerarkZipTableBuilder::AddTombstone(const Slice& key,
 
   assert(GetInternalKeyType(key) == kTypeRangeDeletion);
   range_del_block_.Add(key, value);
+  if (adaptive_) {
+    tombstones_.push_back(fstringOf(key));
+    tombstones_.push_back(fstringOf(value));
+  }
   ++properties_.num_range_deletions;
   size_t freq_size = properties_.raw_key_size + properties_.raw_value_size;
   if (freq_size >= next_freq_size_) {
@@ -719,6 +856,47 @@ Status TerarkZipTableBuilder::EmptyTableFinish() {
       });
 }
 
+Status TerarkZipTableBuilder::FallbackToFinish(
+    const TablePropertyCache* prop,
+    const std::vector<SequenceNumber>* snapshots) {
+  auto& tbo = *fallbackTbo_;
+  if (tbo.int_tbl_prop_collector_factories) {
+    for (auto& factory : *tbo.int_tbl_prop_collector_factories) {
+      fallbackCollectorFactories_.emplace_back(
+          new ForwardIntTblPropCollectorFactory(factory.get()));
+    }
+  }
+  fallbackCollectorFactories_.emplace_back(
+      new AdaptiveDecisionCollectorFactory(adaptiveDecision_));
+  TableBuilderOptions fallbackTbo(
+      tbo.ioptions, tbo.moptions, tbo.internal_comparator,
+      &fallbackCollectorFactories_, tbo.compression_type,
+      tbo.compression_opts, tbo.compression_dict, tbo.skip_filters,
+      tbo.column_family_name, tbo.level, tbo.compaction_load,
+      tbo.creation_time, tbo.oldest_key_time, tbo.sst_purpose);
+  fallbackTbo.smallest_user_key = tbo.smallest_user_key;
+  fallbackTbo.largest_user_key = tbo.largest_user_key;
+  fallback_.reset(table_factory_->fallback_factory()->NewTableBuilder(
+      fallbackTbo, uint32_t(properties_.column_family_id), file_));
+  // index building may still read the key files
+  Status s = WaitBuildIndex();
+  if (s.ok()) {
+    s = ReplayToFallback();
+  }
+  for (size_t i = 0; s.ok() && i < tombstones_.size(); i += 2) {
+    s = fallback_->AddTombstone(SliceOf(tombstones_[i]),
+                                LazyBuffer(SliceOf(tombstones_[i + 1])));
+  }
+  if (s.ok()) {
+    s = fallback_->Finish(prop, snapshots);
+  } else {
+    fallback_->Abandon();
+  }
+  // drop the temp files
+  TerarkZipTableBuilder::Abandon();
+  return s;
+}
+
 Status TerarkZipTableBuilder::Finish(
     const TablePropertyCache* prop,
     const std::vector<SequenceNumber>* snapshots) try {
@@ -743,29 +921,52 @@ Status TerarkZipTableBuilder::Finish(
   }
   AddPrevUserKey(0, {}, {r00_.get(), r10_.get(), r20_.get()});
   filePair_->key.complete_write();
-  filePair_->value.complete_write();
+  if (!streaming_) {
+    filePair_->value.complete_write();
+  }
   kv_freq_.add_hist(freq_[0]->k);
   kv_freq_.add_hist(freq_[0]->v);
+  // decided before the index of the last ranges is built, ranges cut by
+  // Add() already have their index build running
+  bool useFallback = false;
+  if (adaptive_) {
+    double rawSize = properties_.raw_key_size + properties_.raw_value_size;
+    double zipSize =
+        freq_hist_o1::estimate_size_unfinish(kv_freq_) * estimateRatio_;
+    double gain = rawSize > 0 ? 1 - zipSize / rawSize : 0;
+    useFallback = gain < table_options_.adaptiveMinZipGain;
+    char buffer[128];
+    snprintf(buffer, sizeof buffer, "%s: gain = %.4f, min gain = %.4f",
+             useFallback ? "fallback" : "TerarkZip", gain,
+             table_options_.adaptiveMinZipGain);
+    adaptiveDecision_ = buffer;
+    INFO(ioptions_.info_log,
+         "TerarkZipTableBuilder::Finish():this=%12p:\n  adaptive %s, raw "
+         "=%9.4f GB, projected zip =%9.4f GB\n",
+         this, buffer, rawSize / 1e9, zipSize / 1e9);
+  }
+  auto finishRange = [&](KeyValueStatus* kvs, size_t entropyLen) {
+    prefixBuildInfos_.emplace_back(kvs);
+    // a fallback table only replays the temp files
+    if (!useFallback) {
+      BuildIndex(*kvs, entropyLen);
+      BuildStore(*kvs, nullptr, BuildStoreInit);
+    }
+  };
   freq_[1]->k.add_hist(freq_[0]->k);
   freq_[1]->v.add_hist(freq_[0]->v);
   size_t freq_21_entropy_size =
       freq_hist_o1::estimate_size_unfinish(freq_[2]->k, freq_[1]->k);
   if (r22_ && !MergeRangeStatus(r22_.get(), r10_.get(), r20_.get(),
                                 freq_21_entropy_size)) {
-    auto kvs = new KeyValueStatus(std::move(*r22_), std::move(freq_[2]->v));
-    prefixBuildInfos_.emplace_back(kvs);
-    BuildIndex(*kvs, freq_hist_o1::estimate_size_unfinish(freq_[2]->k));
-    BuildStore(*kvs, nullptr, BuildStoreInit);
-    kvs = new KeyValueStatus(std::move(*r10_), std::move(freq_[1]->v));
-    prefixBuildInfos_.emplace_back(kvs);
-    BuildIndex(*kvs, freq_hist_o1::estimate_size_unfinish(freq_[1]->k));
-    BuildStore(*kvs, nullptr, BuildStoreInit);
+    finishRange(new KeyValueStatus(std::move(*r22_), std::move(freq_[2]->v)),
+                freq_hist_o1::estimate_size_unfinish(freq_[2]->k));
+    finishRange(new KeyValueStatus(std::move(*r10_), std::move(freq_[1]->v)),
+                freq_hist_o1::estimate_size_unfinish(freq_[1]->k));
   } else {
     freq_[2]->v.add_hist(freq_[1]->v);
-    auto kvs = new KeyValueStatus(std::move(*r20_), std::move(freq_[2]->v));
-    prefixBuildInfos_.emplace_back(kvs);
-    BuildIndex(*kvs, freq_21_entropy_size);
-    BuildStore(*kvs, nullptr, BuildStoreInit);
+    finishRange(new KeyValueStatus(std::move(*r20_), std::move(freq_[2]->v)),
+                freq_21_entropy_size);
   }
   freq_[0].reset();
   freq_[1].reset();
@@ -777,7 +978,9 @@ Status TerarkZipTableBuilder::Finish(
   r21_.reset();
   r22_.reset();
 
-  tmpSampleFile_.complete_write();
+  if (!streamDictReady_) {
+    tmpSampleFile_.complete_write();
+  }
   {
     long long rawBytes = properties_.raw_key_size + properties_.raw_value_size;
     long long tt = g_pf.now();
@@ -786,6 +989,9 @@ Status TerarkZipTableBuilder::Finish(
          "=%8.2f's,%8.3f'MB/sec\n",
          this, g_pf.sf(t0, tt), rawBytes * 1.0 / g_pf.uf(t0, tt));
   }
+  if (useFallback) {
+    return FallbackToFinish(prop, snapshots);
+  }
   Status s = prefixBuildInfos_.size() > 1 ? ZipValueToFinishMulti()
                                           : ZipValueToFinish();
   if (!s.ok()) {
@@ -1011,13 +1217,16 @@ Status TerarkZipTableBuilder::BuildStore(KeyValueStatus& kvs,
   };
 
   if (flag & BuildStoreInit) {
-    for (auto& pair : kvs.status.fileVec) {
-      pair->value.complete_write();
+    if (!streaming_) {
+      for (auto& pair : kvs.status.fileVec) {
+        pair->value.complete_write();
+      }
     }
     auto avgValueLen =
         kvs.status.valueHist.m_total_key_len / kvs.status.stat.keyCount;
     if (avgValueLen < table_options_.minDictZipValueSize) {
-      if (kvs.isFullValue && table_options_.debugLevel != 2) {
+      // adaptive builds keep the values until the format is decided
+      if (kvs.isFullValue && table_options_.debugLevel != 2 && !adaptive_) {
         kvs.isValueBuild = true;
         if (flag & BuildStoreSync) {
           return buildUncompressedStore();
@@ -1046,6 +1255,125 @@ Status TerarkZipTableBuilder::BuildStore(KeyValueStatus& kvs,
   return Status::OK();
 }
 
+Status TerarkZipTableBuilder::BuildZipStoreParallel(
+    const std::vector<KeyValueStatus*>& kvsVec,
+    const std::vector<DictZipBlobStore::ZipBuilder*>& zbuilders,
+    DictZipBlobStore::ZipStat* dzstat) {
+  size_t workers = zbuilders.size();
+  assert(workers > 1);
+  std::unique_ptr<AutoDeleteFile[]> partFiles(new AutoDeleteFile[workers]);
+  std::vector<size_t> partBegin(kvsVec.size()), partEnd(kvsVec.size());
+  // worker w compresses kvsVec[w], kvsVec[w + workers], ... into its own
+  // part file, parts are concatenated into tmpZipStoreFile_ afterwards
+  auto buildPart = [&](size_t w) {
+    TEST_SYNC_POINT_CALLBACK(
+        "TerarkZipTableBuilder::BuildZipStoreParallel:BuildPart", &w);
+    auto zbuilder = zbuilders[w];
+    auto& part = partFiles[w];
+    part.fpath = tmpZipStoreFile_.fpath + ".part" + std::to_string(w);
+    size_t partSize = 0;
+    Status s;
+    for (size_t i = w; i < kvsVec.size() && s.ok(); i += workers) {
+      auto& kvs = *kvsVec[i];
+      zbuilder->prepare(kvs.status.stat.keyCount, part.fpath, partSize);
+      s = BuilderWriteValues(
+          kvs, [&](fstring value) { zbuilder->addRecord(value); });
+      if (!s.ok()) {
+        zbuilder->abandon();
+        break;
+      }
+      zbuilder->finish(DictZipBlobStore::ZipBuilder::FinishNone);
+      if (i == 0) {
+        *dzstat = zbuilder->getZipStat();
+      }
+      partBegin[i] = partSize;
+      partSize = FileStream(part.fpath, "rb").fsize();
+      partEnd[i] = partSize;
+      assert((partEnd[i] - partBegin[i]) % 8 == 0);
+    }
+    return s;
+  };
+  std::vector<std::unique_ptr<AsyncTask<Status>>> partWait;
+  for (size_t w = 1; w < workers; ++w) {
+    partWait.emplace_back(Async(std::bind(buildPart, w), &storeTag));
+  }
+  TEST_SYNC_POINT("TerarkZipTableBuilder::BuildZipStoreParallel:Local");
+  Status s;
+  try {
+    s = buildPart(0);
+  } catch (const std::exception& ex) {
+    s = Status::Corruption(ex.what());
+  }
+  ioptions_.env->UnSchedule(&storeTag, rocksdb::Env::Priority::LOW);
+  for (auto& wait : partWait) {
+    auto ws = wait->get();
+    if (!ws.ok() && s.ok()) {
+      s = std::move(ws);
+    }
+  }
+  if (!s.ok()) {
+    return s;
+  }
+  std::unique_lock<std::mutex> l(storeBuildMutex_);
+  assert(tmpZipStoreFileSize_ == 0 ||
+         tmpZipStoreFileSize_ ==
+             FileStream(tmpZipStoreFile_.fpath, "rb").fsize());
+  FileStream output(tmpZipStoreFile_.fpath, "ab");
+  for (size_t w = 0; w < workers; ++w) {
+    if (partFiles[w].fpath.empty() ||
+        FileStream(partFiles[w].fpath, "rb").fsize() == 0) {
+      continue;
+    }
+    MmapWholeFile partMmap(partFiles[w].fpath);
+    for (size_t i = w; i < kvsVec.size(); i += workers) {
+      auto& kvs = *kvsVec[i];
+      size_t size = partEnd[i] - partBegin[i];
+      output.ensureWrite((const char*)partMmap.base + partBegin[i], size);
+      kvs.valueFileBegin = tmpZipStoreFileSize_;
+      tmpZipStoreFileSize_ += size;
+      kvs.valueFileEnd = tmpZipStoreFileSize_;
+      kvs.isValueBuild = true;
+    }
+  }
+  output.close();
+  return s;
+}
+
+Status TerarkZipTableBuilder::StreamZipStore(KeyValueStatus& kvs) {
+  if (!kvs.isUseDictZip || kvs.isValueBuild) {
+    return Status::OK();
+  }
+  TEST_SYNC_POINT("TerarkZipTableBuilder::StreamZipStore");
+  if (!streamDictReady_) {
+    // sample file is consumed here, stop sampling
+    streamDictReady_ = true;
+    sampleUpperBound_ = 0;
+    tmpSampleFile_.complete_write();
+    streamZipBuilder_.reset(createZipBuilder());
+    streamDictWaitHandle_ = LoadSample(streamZipBuilder_);
+    if (streamZipBuilder_) {
+      streamZipBuilder_->prepareDict();
+      tmpZipDictFile_.fpath = tmpSentryFile_.path + ".sdict";
+      streamDictWait_ = CompressDict(
+          tmpZipDictFile_.fpath, streamZipBuilder_->getDictionary().memory,
+          &streamDictInfo_, &streamDictTime_);
+      streamDictHash_ = streamZipBuilder_->getDictionary().xxhash;
+      dictSize_ = streamZipBuilder_->getDictionary().memory.size();
+    }
+  }
+  // the values of a chunk stay in memory until it is compressed, so only
+  // one chunk is compressed while the next one is filled
+  ioptions_.env->UnSchedule(&storeTag, rocksdb::Env::Priority::LOW);
+  for (auto& prev : prefixBuildInfos_) {
+    if (prev.get() != &kvs && prev->storeWait) {
+      prev->storeWait->wait();
+    }
+  }
+  // without a dictionary (compaction load too high) the chunk is stored
+  // uncompressed
+  return BuildStore(kvs, streamZipBuilder_.get(), 0);
+}
+
 std::unique_ptr<rocksdb::AsyncTask<rocksdb::Status>>
 TerarkZipTableBuilder::CompressDict(fstring tmpDictFile, fstring dict,
                                     std::string* info, long long* td) {
@@ -1087,7 +1415,11 @@ Status TerarkZipTableBuilder::WaitBuildIndex() {
   Status result = Status::OK();
   for (auto& kvs : prefixBuildInfos_) {
     assert(kvs);
-    assert(kvs->indexWait);
+    if (!kvs->indexWait) {
+      // see FallbackToFinish()
+      assert(adaptive_);
+      continue;
+    }
     assert(kvs->indexWait->valid());
     auto s = kvs->indexWait->get();
     if (terark_unlikely(!s.ok() && result.ok())) {
@@ -1196,7 +1528,8 @@ void TerarkZipTableBuilder::BuildReorderMap(std::unique_ptr<TerarkIndex>& index,
 }
 
 TerarkZipTableBuilder::WaitHandle TerarkZipTableBuilder::LoadSample(
-    std::unique_ptr<DictZipBlobStore::ZipBuilder>& zbuilder) {
+    std::unique_ptr<DictZipBlobStore::ZipBuilder>& zbuilder,
+    std::vector<std::unique_ptr<DictZipBlobStore::ZipBuilder>>* clones) {
   if (compaction_load_ > 0.99) {
     INFO(ioptions_.info_log,
          "TerarkZipTableBuilder::LoadSample():this=%12p:\n"
@@ -1204,13 +1537,33 @@ TerarkZipTableBuilder::WaitHandle TerarkZipTableBuilder::LoadSample(
          "%f\n",
          this, sampleLenSum_, level_, compaction_load_);
     zbuilder.reset();
+    if (clones) {
+      clones->clear();
+    }
     return WaitHandle();
   }
 
   size_t sampleMax =
       std::min<size_t>(INT32_MAX, table_options_.softZipWorkingMemLimit / 7);
   size_t dictWorkingMemory = std::min<size_t>(sampleMax, sampleLenSum_) * 6;
+  if (clones) {
+    // each clone builds its own copy of the dictionary
+    size_t maxBuilders = table_options_.softZipWorkingMemLimit /
+                         std::max<size_t>(dictWorkingMemory, 1);
+    if (clones->size() >= maxBuilders) {
+      clones->resize(maxBuilders > 0 ? maxBuilders - 1 : 0);
+    }
+    dictWorkingMemory *= 1 + clones->size();
+  }
   auto waitHandle = WaitForMemory("dictZip", dictWorkingMemory);
+  auto addSample = [&](fstring data) {
+    zbuilder->addSample(data);
+    if (clones) {
+      for (auto& clone : *clones) {
+        clone->addSample(data);
+      }
+    }
+  };
 
   valvec<byte_t> sample;
   NativeDataInput<InputBuffer> sampleInput(&tmpSampleFile_.fp);
@@ -1223,7 +1576,7 @@ TerarkZipTableBuilder::WaitHandle TerarkZipTableBuilder::LoadSample(
   if (newSampleLen >= sampleLenSum_) {
     for (size_t len = 0; len < sampleLenSum_;) {
       sampleInput >> sample;
-      zbuilder->addSample(sample);
+      addSample(fstring(sample));
       len += sample.size();
     }
     realSampleLenSum = sampleLenSum_;
@@ -1235,10 +1588,9 @@ TerarkZipTableBuilder::WaitHandle TerarkZipTableBuilder::LoadSample(
       if (randomGenerator_() < upperBoundSample) {
         realSampleLenSum += sample.size();
         if (realSampleLenSum < newSampleLen) {
-          zbuilder->addSample(sample);
+          addSample(fstring(sample));
         } else {
-          zbuilder->addSample(
-              fstring(sample).substr(0, realSampleLenSum - newSampleLen));
+          addSample(fstring(sample).substr(0, realSampleLenSum - newSampleLen));
           break;
         }
       }
@@ -1252,12 +1604,17 @@ TerarkZipTableBuilder::WaitHandle TerarkZipTableBuilder::LoadSample(
   }
   tmpSampleFile_.close();
   if (realSampleLenSum == 0) {  // prevent from empty
-    zbuilder->addSample(
+    addSample(
         sample.empty()
             ? fstring("Hello World!")
             : fstring(sample).substr(0, std::min(sample.size(), newSampleLen)));
   }
   zbuilder->finishSample();
+  if (clones) {
+    for (auto& clone : *clones) {
+      clone->finishSample();
+    }
+  }
   return waitHandle;
 }
 
@@ -1351,6 +1708,8 @@ Status TerarkZipTableBuilder::buildZipOffsetBlobStore(
 
 Status TerarkZipTableBuilder::ZipValueToFinish() {
   assert(prefixBuildInfos_.size() == 1);
+  // streaming build only samples the dictionary after the first chunk
+  assert(!streamDictReady_);
   auto& kvs = *prefixBuildInfos_.front();
   AutoDeleteFile tmpDictFile{tmpSentryFile_.path + ".dict"};
   std::unique_ptr<DictZipBlobStore::ZipBuilder> zbuilder;
@@ -1421,6 +1780,7 @@ Status TerarkZipTableBuilder::ZipValueToFinishMulti() {
   assert(prefixBuildInfos_.size() > 1);
   AutoDeleteFile tmpDictFile{tmpSentryFile_.path + ".dict"};
   std::unique_ptr<DictZipBlobStore::ZipBuilder> zbuilder;
+  std::vector<std::unique_ptr<DictZipBlobStore::ZipBuilder>> zbuilderClones;
   WaitHandle dictWaitHandle;
   std::unique_ptr<AsyncTask<Status>> dictWait;
   std::unique_ptr<AbstractBlobStore> store;
@@ -1442,20 +1802,89 @@ Status TerarkZipTableBuilder::ZipValueToFinishMulti() {
       BuildStore(*kvs, nullptr, 0);
     }
   }
-  if (isUseDictZip) {
+  if (streamDictReady_) {
+    // the dictionary was sampled and the complete chunks were compressed
+    // during Add(), the remaining ones use the same dictionary
+    zbuilder = std::move(streamZipBuilder_);
+    dictWaitHandle = std::move(streamDictWaitHandle_);
+    dictWait = std::move(streamDictWait_);
+    tmpDictFile.fpath = tmpZipDictFile_.fpath;
+    tmpZipDictFile_.fpath.clear();
+    dictHash = streamDictHash_;
+    for (auto& kvs : prefixBuildInfos_) {
+      if (kvs->isUseDictZip && !kvs->isValueBuild) {
+        s = BuildStore(*kvs, zbuilder.get(), BuildStoreSync);
+        if (!s.ok()) {
+          break;
+        }
+      }
+    }
+    // chunks compressed in background still use the dictionary
+    ioptions_.env->UnSchedule(&storeTag, rocksdb::Env::Priority::LOW);
+    for (auto& kvs : prefixBuildInfos_) {
+      if (kvs->storeWait) {
+        kvs->storeWait->wait();
+      }
+    }
+    if (zbuilder) {
+      dzstat = zbuilder->getZipStat();
+    }
+  } else if (isUseDictZip) {
+    // values held in the temp files of several ranges can be compressed in
+    // parallel, each worker has its own ZipBuilder on the same dictionary
+    std::vector<KeyValueStatus*> parallelKvs;
+    for (auto& kvs : prefixBuildInfos_) {
+      if (kvs->isUseDictZip && kvs->isFullValue && !kvs->isValueBuild) {
+        parallelKvs.push_back(kvs.get());
+      }
+    }
+    size_t zipThreads =
+        std::min<size_t>(table_options_.zipValueThreads, parallelKvs.size());
+    for (size_t i = 1; i < zipThreads; ++i) {
+      zbuilderClones.emplace_back(createZipBuilder());
+    }
     zbuilder.reset(createZipBuilder());
-    dictWaitHandle = LoadSample(zbuilder);
+    dictWaitHandle = LoadSample(zbuilder, &zbuilderClones);
     if (zbuilder) {
       assert(tmpZipStoreFileSize_ == 0);
+      std::vector<std::unique_ptr<AsyncTask<Status>>> cloneWait;
+      for (auto& clone : zbuilderClones) {
+        auto zb = clone.get();
+        cloneWait.emplace_back(Async(
+            [zb] {
+              zb->prepareDict();
+              return Status::OK();
+            },
+            &dictTag));
+      }
       // build dict in this thread
       zbuilder->prepareDict();
       dictWait = CompressDict(tmpDictFile, zbuilder->getDictionary().memory,
                               &dictInfo, &td);
       dictHash = zbuilder->getDictionary().xxhash;
       dictSize_ = zbuilder->getDictionary().memory.size();
+      std::vector<DictZipBlobStore::ZipBuilder*> zbuilders = {zbuilder.get()};
+      if (!cloneWait.empty()) {
+        // clones not yet picked by the pool are built in this thread
+        ioptions_.env->UnSchedule(&dictTag, rocksdb::Env::Priority::LOW);
+      }
+      for (size_t i = 0; i < cloneWait.size(); ++i) {
+        // a clone is only usable if it built exactly the same dictionary
+        if (cloneWait[i]->get().ok() &&
+            zbuilderClones[i]->getDictionary().xxhash == dictHash) {
+          zbuilders.push_back(zbuilderClones[i].get());
+        }
+      }
+      if (zbuilders.size() > 1) {
+        s = BuildZipStoreParallel(parallelKvs, zbuilders, &dzstat);
+        dictRefCount += parallelKvs.size();
+      }
     }
     for (auto& kvs : prefixBuildInfos_) {
-      if (kvs->isUseDictZip) {
+      if (!s.ok()) {
+        break;
+      }
+      if (kvs->isUseDictZip && !kvs->isValueBuild) {
         s = BuildStore(*kvs, zbuilder.get(), BuildStoreSync);
         if (!s.ok()) {
           break;
@@ -1476,6 +1905,9 @@ Status TerarkZipTableBuilder::ZipValueToFinishMulti() {
   }
   if (zbuilder) {
     zbuilder->freeDict();
+    for (auto& clone : zbuilderClones) {
+      clone->freeDict();
+    }
     t4 = g_pf.now();
     assert(dictWait->valid());
     s = dictWait->get();
@@ -1483,7 +1915,12 @@ Status TerarkZipTableBuilder::ZipValueToFinishMulti() {
     if (!s.ok()) {
       return s;
     }
+    if (streamDictReady_) {
+      dictInfo.swap(streamDictInfo_);
+      td = streamDictTime_;
+    }
     zbuilder.reset();
+    zbuilderClones.clear();
     dictWaitHandle.Release();
   } else {
     tmpDictFile.fpath.clear();
@@ -1507,35 +1944,53 @@ Status TerarkZipTableBuilder::ZipValueToFinishMulti() {
 class TerarkValueReader {
   const valvec<std::shared_ptr<FilePair>>& files;
   size_t index;
+  // values of StreamFilePair are read from memory
+  bool inMemory;
   NativeDataInput<InputBuffer> reader;
+  NativeDataInput<MemIO> memReader;
   valvec<byte_t> buffer;
 
-  void checkEOF(){
-    if (terark_unlikely(reader.eof())) {
-      FileStream* fp = &files[++index]->value.fp;
+  void attach(size_t i) {
+    index = i;
+    if (inMemory) {
+      fstring data =
+          static_cast<StreamFilePair&>(*files[index]).values->data();
+      memReader.set((void*)data.data(), data.size());
+    } else {
+      FileStream* fp = &files[index]->value.fp;
       fp->rewind();
       reader.attach(fp);
     }
   }
 
+  void checkEOF(){
+    if (terark_unlikely(inMemory ? memReader.eof() : reader.eof())) {
+      attach(index + 1);
+    }
+  }
+
 public:
-  TerarkValueReader(const valvec<std::shared_ptr<FilePair>>& _files) : files(_files) {}
+  TerarkValueReader(const valvec<std::shared_ptr<FilePair>>& _files,
+                    bool _inMemory)
+      : files(_files), inMemory(_inMemory) {}
 
   uint64_t readUInt64(){
     checkEOF();
-    return reader.load_as<uint64_t>();
+    return inMemory ? memReader.load_as<uint64_t>()
+                    : reader.load_as<uint64_t>();
   }
 
   void appendBuffer(valvec<byte_t>* buffer) {
     checkEOF();
-    reader.load_add(*buffer);
+    if (inMemory) {
+      memReader.load_add(*buffer);
+    } else {
+      reader.load_add(*buffer);
+    }
   }
 
   void rewind(){
-    index = 0;
-    FileStream* fp = &files.front()->value.fp;
-    fp->rewind();
-    reader.attach(fp);
+    attach(0);
   }
 };
 
@@ -1572,7 +2027,7 @@ Status TerarkZipTableBuilder::BuilderWriteValues(
     return SliceOf(key);
   };
 
-  TerarkValueReader input(kvs.status.fileVec);
+  TerarkValueReader input(kvs.status.fileVec, streaming_);
   input.rewind();
   if (kvs.isFullValue) {
     if (--kvs.keyFileRef == 0) {
@@ -1630,10 +2085,15 @@ Status TerarkZipTableBuilder::BuilderWriteValues(
     // so entryId may less than properties_.num_entries
     assert(entryId <= properties_.num_entries);
     for (auto& pair : kvs.status.fileVec) {
-      pair->value.close();
+      if (streaming_) {
+        static_cast<StreamFilePair&>(*pair).values.reset();
+      } else {
+        pair->value.close();
+      }
     }
   } else {
     assert(second_pass_iter_ != nullptr);
+    TEST_SYNC_POINT("TerarkZipTableBuilder::BuilderWriteValues:SecondPass");
     keyInput.reset(TerarkKeyReader::MakeReader(kvs.status.fileVec, false));
     keyInput->rewind();
 
@@ -1824,6 +2284,65 @@ Status TerarkZipTableBuilder::BuilderWriteValues(
   return Status::OK();
 }
 
+Status TerarkZipTableBuilder::ReplayToFallback() {
+  valvec<byte_t> key, value;
+  for (auto& kvs : prefixBuildInfos_) {
+    auto& stat = kvs->status.stat;
+    std::unique_ptr<TerarkKeyReader> keyInput(
+        TerarkKeyReader::MakeReader(kvs->status.fileVec, false));
+    keyInput->rewind();
+    TerarkValueReader input(kvs->status.fileVec, streaming_);
+    input.rewind();
+    if (!kvs->isFullValue) {
+      assert(second_pass_iter_ != nullptr);
+      std::string target;
+      target.reserve(stat.minKey.size() + 8);
+      target.assign((const char*)stat.minKey.data(), stat.minKey.size());
+      target.append((const char*)&kvs->status.seqType, 8);
+      second_pass_iter_->Seek(target);
+    }
+    size_t bitPos = 0;
+    for (size_t recId = 0; recId < stat.keyCount; recId++) {
+      fstring userKey = keyInput->next();
+      size_t oneSeqLen = kvs->status.valueBits.one_seq_len(bitPos);
+      for (size_t j = 0; j < oneSeqLen; j++) {
+        uint64_t seqType = input.readUInt64();
+        value.erase_all();
+        input.appendBuffer(&value);
+        key.assign(userKey);
+        key.append((byte_t*)&seqType, 8);
+        Status s;
+        if (kvs->isFullValue) {
+          s = fallback_->Add(SliceOf(key), LazyBuffer(SliceOf(value)));
+        } else {
+          if (!second_pass_iter_->Valid()) {
+            s = second_pass_iter_->status();
+            return s.ok() ? Status::Corruption(
+                                "TerarkZipTableBuilder::ReplayToFallback()",
+                                "second pass iter ends too early")
+                          : s;
+          }
+          // the fallback table must hold exactly the first pass keys
+          if (ioptions_.internal_comparator.Compare(second_pass_iter_->key(),
+                                                    SliceOf(key)) != 0) {
+            return Status::Corruption(
+                "TerarkZipTableBuilder::ReplayToFallback()",
+                "second pass iter key mismatch");
+          }
+          s = fallback_->Add(second_pass_iter_->key(),
+                             second_pass_iter_->value());
+          second_pass_iter_->Next();
+        }
+        if (!s.ok()) {
+          return s;
+        }
+      }
+      bitPos += oneSeqLen + 1;
+    }
+  }
+  return Status::OK();
+}
+
 Status TerarkZipTableBuilder::WriteIndexStore(
     fstring indexMmap, AbstractBlobStore* store, KeyValueStatus& kvs,
     BlockHandle& /*dataBlock*/, size_t kvs_index, long long& /*t5*/,
@@ -1915,6 +2434,7 @@ Status TerarkZipTableBuilder::WriteSSTFile(
   long long t5 = g_pf.now();
   Status s;
   BlockHandle dataBlock, dictBlock, offsetBlock, tombstoneBlock(0, 0);
+  BlockHandle filterBlock(0, 0);
   {
     size_t real_size =
         mmapIndexFile.size + store->mem_size() + bzvType.mem_size();
@@ -1955,6 +2475,10 @@ Status TerarkZipTableBuilder::WriteSSTFile(
       return s;
     }
   }
+  s = WriteFilterBlock(&filterBlock);
+  if (!s.ok()) {
+    return s;
+  }
   auto& stat = kvs.status.stat;
   properties_.num_data_blocks = stat.keyCount;
   kv_freq_.finish();
@@ -1965,6 +2489,8 @@ Status TerarkZipTableBuilder::WriteSSTFile(
           {!dict.memory.empty() ? &kTerarkZipTableValueDictBlock : NULL,
            dictBlock},
           {&kTerarkZipTableOffsetBlock, offsetBlock},
+          {!filterBlock.IsNull() ? &kTerarkZipTableFilterBlock : NULL,
+           filterBlock},
           {!tombstoneBlock.IsNull() ? &kRangeDelBlock : NULL, tombstoneBlock},
       });
 
@@ -2098,6 +2624,7 @@ Status TerarkZipTableBuilder::WriteSSTFileMulti(
   }
   Status s;
   BlockHandle dataBlock, dictBlock, offsetBlock, tombstoneBlock(0, 0);
+  BlockHandle filterBlock(0, 0);
   offset_info_.Init(prefixBuildInfos_.size());
   size_t typeSize = 0;
   for (auto& kvs : prefixBuildInfos_) {
@@ -2166,6 +2693,10 @@ Status TerarkZipTableBuilder::WriteSSTFileMulti(
       return s;
     }
   }
+  s = WriteFilterBlock(&filterBlock);
+  if (!s.ok()) {
+    return s;
+  }
   properties_.num_data_blocks = numKeys;
   kv_freq_.finish();
   size_t entropy = freq_hist_o1::estimate_size(kv_freq_.histogram());
@@ -2175,6 +2706,8 @@ Status TerarkZipTableBuilder::WriteSSTFileMulti(
           {!dict.memory.empty() ? &kTerarkZipTableValueDictBlock : NULL,
            dictBlock},
           {&kTerarkZipTableOffsetBlock, offsetBlock},
+          {!filterBlock.IsNull() ? &kTerarkZipTableFilterBlock : NULL,
+           filterBlock},
           {!tombstoneBlock.IsNull() ? &kRangeDelBlock : NULL, tombstoneBlock},
       });
   size_t dictBlockSize = dict.memory.empty() ? 0 : dictBlock.size();
@@ -2282,6 +2815,21 @@ Status TerarkZipTableBuilder::WriteSSTFileMulti(
   return s;
 }
 
+Status TerarkZipTableBuilder::WriteFilterBlock(BlockHandle* filterBlock) {
+  if (!filterBuilder_) {
+    return Status::OK();
+  }
+  std::unique_ptr<const char[]> buf;
+  Slice filter = filterBuilder_->Finish(&buf);
+  filterBuilder_.reset();
+  Status s = WriteBlock(filter, file_, &offset_, filterBlock);
+  if (s.ok()) {
+    properties_.filter_size = filter.size();
+    properties_.filter_policy_name = filterPolicy_->Name();
+  }
+  return s;
+}
+
 Status TerarkZipTableBuilder::WriteMetaData(
     const std::string& dictInfo, size_t entropy,
     std::initializer_list<std::pair<const std::string*, BlockHandle>> blocks) {
@@ -2318,6 +2866,9 @@ Status TerarkZipTableBuilder::WriteMetaData(
   if (!dictInfo.empty()) {
     propBlockBuilder.Add(kTerarkZipTableDictInfo, dictInfo);
   }
+  if (!adaptiveDecision_.empty()) {
+    propBlockBuilder.Add(kTerarkZipTableAdaptiveDecision, adaptiveDecision_);
+  }
   BlockHandle propBlock, metaindexBlock;
   Status s = WriteBlock(propBlockBuilder.Finish(), file_, &offset_, &propBlock);
   if (!s.ok()) {
@@ -2374,6 +2925,11 @@ void TerarkZipTableBuilder::Abandon() {
     }
   }
   prefixBuildInfos_.clear();
+  if (streamDictWait_ && streamDictWait_->valid()) {
+    streamDictWait_->wait();
+  }
+  streamDictWait_.reset();
+  streamZipBuilder_.reset();
   if (tmpSentryFile_.fp) {
     tmpSentryFile_.complete_write();
   }
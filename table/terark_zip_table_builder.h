@@ -19,6 +19,7 @@
 #include <random>
 // rocksdb headers
 #include <options/options_helper.h>
+#include <rocksdb/filter_policy.h>
 #include <options/options_parser.h>
 #include <table/block_builder.h>
 #include <table/format.h>
@@ -81,9 +82,11 @@ class TerarkZipTableBuilder : public TableBuilder, boost::noncopyable {
   uint64_t NumEntries() const override { return properties_.num_entries; }
   uint64_t FileSize() const override;
   TableProperties GetTableProperties() const override;
-  bool NeedCompact() const override { return false; }
+  bool NeedCompact() const override {
+    return fallback_ ? fallback_->NeedCompact() : false;
+  }
   void SetSecondPassIterator(InternalIterator* reader) override {
-    if (!table_options_.disableSecondPassIter) {
+    if (!table_options_.disableSecondPassIter && !streaming_) {
       second_pass_iter_ = reader;
     }
   }
@@ -146,6 +149,11 @@ class TerarkZipTableBuilder : public TableBuilder, boost::noncopyable {
   };
   WaitHandle WaitForMemory(const char* who, size_t memorySize);
   Status EmptyTableFinish();
+  // adaptiveMinZipGain, let the fallback factory build this file from the
+  // temp files (or the second pass iterator) instead
+  Status FallbackToFinish(const TablePropertyCache* prop,
+                          const std::vector<SequenceNumber>* snapshots);
+  Status ReplayToFallback();
   std::unique_ptr<AsyncTask<Status>> Async(std::function<Status()> func,
                                            void* tag);
   void BuildIndex(KeyValueStatus& kvs, size_t entropyLen);
@@ -155,6 +163,9 @@ class TerarkZipTableBuilder : public TableBuilder, boost::noncopyable {
   };
   Status BuildStore(KeyValueStatus& kvs, DictZipBlobStore::ZipBuilder* zbuilder,
                     uint64_t flag);
+  // streaming build, compress a complete chunk with the dictionary sampled
+  // from the values seen so far
+  Status StreamZipStore(KeyValueStatus& kvs);
   std::unique_ptr<AsyncTask<Status>> CompressDict(fstring tmpDictFile,
                                                   fstring dict,
                                                   std::string* type,
@@ -175,8 +186,11 @@ class TerarkZipTableBuilder : public TableBuilder, boost::noncopyable {
                        BuildReorderParams& params, KeyValueStatus& kvs,
                        fstring mmap_memory, AbstractBlobStore* store,
                        long long& t6);
+  // clones, if not null, are fed the same samples as zbuilder
   WaitHandle LoadSample(
-      std::unique_ptr<DictZipBlobStore::ZipBuilder>& zbuilder);
+      std::unique_ptr<DictZipBlobStore::ZipBuilder>& zbuilder,
+      std::vector<std::unique_ptr<DictZipBlobStore::ZipBuilder>>* clones =
+          nullptr);
   struct BuildStoreParams {
     KeyValueStatus& kvs;
     WaitHandle handle;
@@ -189,6 +203,11 @@ class TerarkZipTableBuilder : public TableBuilder, boost::noncopyable {
   Status buildZipOffsetBlobStore(BuildStoreParams& params);
   Status ZipValueToFinish();
   Status ZipValueToFinishMulti();
+  // compress kvsVec with zbuilders, which share the same dictionary
+  Status BuildZipStoreParallel(
+      const std::vector<KeyValueStatus*>& kvsVec,
+      const std::vector<DictZipBlobStore::ZipBuilder*>& zbuilders,
+      DictZipBlobStore::ZipStat* dzstat);
   Status BuilderWriteValues(KeyValueStatus& kvs,
                             std::function<void(fstring val)> write);
   void DoWriteAppend(const void* data, size_t size);
@@ -204,6 +223,8 @@ class TerarkZipTableBuilder : public TableBuilder, boost::noncopyable {
                            fstring tmpDictFile, const std::string& dictType,
                            uint64_t dicthash,
                            const DictZipBlobStore::ZipStat& dzstat);
+  // the filter is written only if bloomBitsPerKey > 0
+  Status WriteFilterBlock(BlockHandle* filterBlock);
   Status WriteMetaData(
       const std::string& dictType, size_t entropy,
       std::initializer_list<std::pair<const std::string*, BlockHandle>> blocks);
@@ -216,6 +237,8 @@ class TerarkZipTableBuilder : public TableBuilder, boost::noncopyable {
   const ImmutableCFOptions& ioptions_;
   TerarkZipMultiOffsetInfo offset_info_;
   std::vector<std::unique_ptr<IntTblPropCollector>> collectors_;
+  std::unique_ptr<const FilterPolicy> filterPolicy_;
+  std::unique_ptr<FilterBitsBuilder> filterBuilder_;
   InternalIterator* second_pass_iter_ = nullptr;
   size_t nameSeed_ = 0;
   size_t keyDataSize_ = 0;
@@ -247,6 +270,8 @@ class TerarkZipTableBuilder : public TableBuilder, boost::noncopyable {
   uint64_t sampleUpperBound_;
   size_t sampleLenSum_ = 0;
   size_t singleIndexMaxSize_ = 0;
+  // ranges are cut at this raw size so Finish() has one per zipValueThreads
+  size_t zipRangeMaxSize_ = 0;
   WritableFileWriter* file_;
   uint64_t offset_ = 0;
   uint64_t estimateOffset_ = 0;
@@ -260,6 +285,25 @@ class TerarkZipTableBuilder : public TableBuilder, boost::noncopyable {
   valvec<byte_t> valueTestBuf_;
   uint64_t next_freq_size_ = 1ULL << 20;
   bool waitInited_ = false;
+  // see TerarkZipTableOptions::adaptiveMinZipGain
+  bool adaptive_ = false;
+  std::unique_ptr<TableBuilderOptions> fallbackTbo_;
+  std::string fallbackSmallestUserKey_;
+  std::string fallbackLargestUserKey_;
+  std::vector<std::unique_ptr<IntTblPropCollectorFactory>>
+      fallbackCollectorFactories_;
+  std::unique_ptr<TableBuilder> fallback_;
+  std::string adaptiveDecision_;
+  fstrvec tombstones_;  // key, value, key, value ...
+  // see TerarkZipTableOptions::streamingLevels
+  bool streaming_ = false;
+  bool streamDictReady_ = false;
+  std::unique_ptr<DictZipBlobStore::ZipBuilder> streamZipBuilder_;
+  WaitHandle streamDictWaitHandle_;
+  std::unique_ptr<AsyncTask<Status>> streamDictWait_;
+  std::string streamDictInfo_;
+  uint64_t streamDictHash_ = 0;
+  long long streamDictTime_ = 0;
   bool closed_ = false;  // Either Finish() or Abandon() has been called.
   bool isReverseBytewiseOrder_;
   int level_;
@@ -16,12 +16,16 @@
   M_Boolea(useSuffixArrayLocalMatch);
   M_Boolea(warmUpIndexOnOpen);
   M_Boolea(warmUpValueOnOpen);
+  M_Boolea(warmUpIndexLazily);
   M_Boolea(disableSecondPassIter);
   M_Boolea(disableCompressDict);
   M_Boolea(optimizeCpuL3Cache);
   M_Boolea(forceMetaInMemory);
   M_Boolea(enableEntropyStore);
   M_NumFmt(cbtHashBits              , "%d");
+  M_NumFmt(bloomBitsPerKey          , "%d");
+  M_NumFmt(zipValueThreads          , "%d");
+  M_NumFmt(streamingLevels          , "%u");
   M_NumFmt(minPreadLen              , "%d");
   M_NumFmt(offsetArrayBlockUnits    , "%d");
   M_NumFmt(sampleRatio              , "%lf");
@@ -31,11 +35,14 @@
   M_NumGiB(smallTaskMemory);
   M_NumGiB(singleIndexMinSize);
   M_NumGiB(singleIndexMaxSize);
+  M_NumGiB(streamingChunkSize);
   M_NumGiB(cacheCapacityBytes);
   M_NumFmt(cacheShards              , "%d");
   M_NumFmt(cbtEntryPerTrie          , "%u");
   M_NumFmt(cbtMinKeySize            , "%u");
   M_NumFmt(cbtMinKeyRatio           , "%lf");
+  M_NumFmt(adaptiveMinZipGain       , "%lf");
+  M_NumFmt(recordCacheMaxValueSize  , "%u");
 
 #undef M_NumFmt
 #undef M_NumGiB
@@ -2,11 +2,21 @@
 #include "terark_zip_table_reader.h"
 
 #include "terark_zip_common.h"
+// std headers
+#include <algorithm>
+#include <condition_variable>
+#include <limits>
+#include <map>
+#include <set>
+#include <tuple>
 // rocksdb headers
+#include <monitoring/statistics.h>
 #include <table/get_context.h>
 #include <table/internal_iterator.h>
 #include <table/meta_blocks.h>
 #include <table/sst_file_writer_collectors.h>
+#include <util/coding.h>
+#include <util/sync_point.h>
 #include <util/util.h>
 // terark headers
 #include <terark/lcast.hpp>
@@ -185,6 +195,32 @@ static void MmapAdviseSequential(fstring mem) {
   MmapAdviseSequential(mem.data(), mem.size());
 }
 
+static size_t MmapResidentBytes(fstring mem) {
+#ifndef _MSC_VER
+  size_t low = terark::align_down(size_t(mem.data()), 4096);
+  size_t hig = terark::align_up(size_t(mem.data()) + mem.size(), 4096);
+  if (low >= hig) {
+    return 0;
+  }
+  std::vector<unsigned char> pages((hig - low) / 4096);
+#ifdef OS_MACOSX
+  int err = mincore((void*)low, hig - low, (char*)pages.data());
+#else
+  int err = mincore((void*)low, hig - low, pages.data());
+#endif
+  if (err != 0) {
+    return 0;
+  }
+  size_t resident = 0;
+  for (unsigned char page : pages) {
+    resident += page & 1;
+  }
+  return std::min(resident * 4096, mem.size());
+#else
+  return mem.size();
+#endif
+}
+
 void UpdateCollectInfo(const TerarkZipTableFactory* table_factory,
                        const TerarkZipTableOptions* /*tzopt*/,
                        TableProperties* props, size_t file_size) {
@@ -221,6 +257,7 @@ Status ReadMetaBlockAdapte(RandomAccessFileReader* file, uint64_t file_size,
                        table_magic_number, ioptions, meta_block_name, contents);
 }
 
+
 using terark::AbstractBlobStore;
 using terark::BadCrc16cException;
 using terark::BadCrc32cException;
@@ -797,10 +834,11 @@ class IterZO : public Base {
 Status TerarkZipTableReaderBase::LoadTombstone(RandomAccessFileReader* file,
                                                uint64_t file_size) {
   BlockContents tombstoneBlock;
-  Status s = ReadMetaBlockAdapte(file, file_size, kTerarkZipTableMagicNumber,
-                                 table_reader_options_.ioptions, kRangeDelBlock,
-                                 &tombstoneBlock);
-  if (s.ok()) {
+  bool found = false;
+  Status s = ReadOptionalMetaBlock(
+      file, nullptr, file_size, kTerarkZipTableMagicNumber,
+      table_reader_options_.ioptions, kRangeDelBlock, &tombstoneBlock, &found);
+  if (s.ok() && found) {
     auto block = DetachBlockContents(tombstoneBlock, GetSequenceNumber());
     auto icomp = &table_reader_options_.internal_comparator;
     auto iter = std::unique_ptr<InternalIteratorBase<Slice>>(
@@ -816,6 +854,37 @@ Status TerarkZipTableReaderBase::LoadTombstone(RandomAccessFileReader* file,
   return s;
 }
 
+Status TerarkZipTableReaderBase::LoadFilter(RandomAccessFileReader* file,
+                                            uint64_t file_size) {
+  bool found = false;
+  Status s = ReadOptionalMetaBlock(
+      file, nullptr, file_size, kTerarkZipTableMagicNumber,
+      table_reader_options_.ioptions, kTerarkZipTableFilterBlock,
+      &filterBlock_, &found);
+  if (s.ok() && found) {
+    // the reader only depends on the block, bits per key is taken from it
+    std::unique_ptr<const FilterPolicy> policy(NewBloomFilterPolicy(10, false));
+    filter_.reset(policy->GetFilterBitsReader(filterBlock_.data));
+    // filter probes are random, keep the whole block resident
+    MmapWarmUp(fstringOf(filterBlock_.data));
+  }
+  return s;
+}
+
+bool TerarkZipTableReaderBase::KeyMayMatch(const Slice& user_key,
+                                           bool skip_filters) const {
+  if (skip_filters || !filter_) {
+    return true;
+  }
+  auto statistics = table_reader_options_.ioptions.statistics;
+  if (filter_->MayMatch(user_key)) {
+    RecordTick(statistics, BLOOM_FILTER_FULL_POSITIVE);
+    return true;
+  }
+  RecordTick(statistics, BLOOM_FILTER_USEFUL);
+  return false;
+}
+
 FragmentedRangeTombstoneIterator*
 TerarkZipTableReaderBase::NewRangeTombstoneIterator(
     const ReadOptions& read_options) {
@@ -831,11 +900,161 @@ TerarkZipTableReaderBase::NewRangeTombstoneIterator(
                                               snapshot);
 }
 
+// Readers opened with warmUpIndexLazily wait here until a background job
+// pages their index in, lower levels first and newer files first in the
+// same level, tables of unknown level go last. There is one queue per Env,
+// its job runs in the LOW pool of that Env, warms up at most kBytesPerJob
+// and schedules itself again while readers are waiting.
+class LazyIndexWarmUpQueue : boost::noncopyable {
+ public:
+  static const size_t kBytesPerJob = 64 << 20;
+
+  static LazyIndexWarmUpQueue& Instance(Env* env) {
+    static std::mutex mutex;
+    // never destroyed, the jobs may outlive static destruction
+    static auto queues = new std::map<Env*, LazyIndexWarmUpQueue*>;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& queue = (*queues)[env];
+    if (queue == nullptr) {
+      queue = new LazyIndexWarmUpQueue(env);
+    }
+    return *queue;
+  }
+
+  void Add(TerarkZipTableReaderBase* reader) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.emplace(KeyOf(reader));
+    if (!running_) {
+      running_ = true;
+      env_->Schedule(&LazyIndexWarmUpQueue::BGWork, this, Env::Priority::LOW);
+    }
+  }
+
+  // returns after the job has left the index of reader alone
+  void Remove(TerarkZipTableReaderBase* reader) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    queue_.erase(KeyOf(reader));
+    if (current_ == reader) {
+      cancel_ = true;
+      cond_.wait(lock, [&] { return current_ != reader; });
+    }
+  }
+
+ private:
+  typedef std::tuple<int, uint64_t, TerarkZipTableReaderBase*> Key;
+
+  explicit LazyIndexWarmUpQueue(Env* env) : env_(env) {}
+
+  static Key KeyOf(TerarkZipTableReaderBase* reader) {
+    auto& tro = reader->table_reader_options_;
+    int level = tro.level < 0 ? std::numeric_limits<int>::max() : tro.level;
+    return Key(level, ~tro.file_number, reader);
+  }
+
+  static void BGWork(void* arg) {
+    static_cast<LazyIndexWarmUpQueue*>(arg)->Run();
+  }
+
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    size_t budget = kBytesPerJob;
+    while (!queue_.empty() && budget > 0) {
+      auto key = *queue_.begin();
+      queue_.erase(queue_.begin());
+      current_ = std::get<2>(key);
+      cancel_ = false;
+      lock.unlock();
+      bool done = current_->WarmUpIndexLazily(cancel_, &budget);
+      lock.lock();
+      if (!done && !cancel_) {
+        // resumed by the next job
+        queue_.emplace(key);
+      }
+      current_ = nullptr;
+      cond_.notify_all();
+    }
+    if (queue_.empty()) {
+      running_ = false;
+    } else {
+      env_->Schedule(&LazyIndexWarmUpQueue::BGWork, this, Env::Priority::LOW);
+    }
+  }
+
+  Env* const env_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::set<Key> queue_;
+  TerarkZipTableReaderBase* current_ = nullptr;
+  std::atomic<bool> cancel_{false};
+  bool running_ = false;
+};
+
+TerarkZipTableReaderBase::~TerarkZipTableReaderBase() {
+  if (lazyWarmUp_) {
+    LazyIndexWarmUpQueue::Instance(table_reader_options_.ioptions.env)
+        .Remove(this);
+  }
+}
+
+void TerarkZipTableReaderBase::StartLazyWarmUp() {
+  for (fstring mem : indexMem_) {
+    MmapAdviseRandom(mem);
+  }
+  lazyWarmUp_ = true;
+  indexResident_ = IndexResidentSize();
+  LazyIndexWarmUpQueue::Instance(table_reader_options_.ioptions.env)
+      .Add(this);
+}
+
+bool TerarkZipTableReaderBase::WarmUpIndexLazily(
+    const std::atomic<bool>& cancel, size_t* budget) {
+  // small steps, a reader being destroyed waits for the current one
+  const size_t kStep = 1 << 20;
+  long long t0 = g_pf.now();
+  size_t indexSize = 0;
+  bool done = true;
+  for (fstring mem : indexMem_) {
+    size_t end = indexSize + mem.size();
+    while (done && lazyWarmUpPos_ < end) {
+      if (*budget == 0 || cancel.load(std::memory_order_relaxed)) {
+        done = false;
+        break;
+      }
+      size_t pos = lazyWarmUpPos_ - indexSize;
+      size_t len = std::min({kStep, mem.size() - pos, *budget});
+      MmapWarmUpBytes(mem.data() + pos, len);
+      lazyWarmUpPos_ += len;
+      *budget -= len;
+    }
+    indexSize = end;
+  }
+  // GetTableProperties() reports this instead of calling mincore
+  indexResident_ = IndexResidentSize();
+  if (done) {
+    TEST_SYNC_POINT("TerarkZipTableReader::WarmUpIndexLazily:Done");
+  }
+  long long t1 = g_pf.now();
+  INFO(table_reader_options_.ioptions.info_log,
+       "TerarkZipTableReader::WarmUpIndexLazily(): file = %llu, level = %d,"
+       " %s, index resident = %zd of %zd bytes, warm up time = %6.3f'sec\n",
+       (unsigned long long)table_reader_options_.file_number,
+       table_reader_options_.level, done ? "done" : "paused",
+       size_t(indexResident_), indexSize, g_pf.sf(t0, t1));
+  return done;
+}
+
+size_t TerarkZipTableReaderBase::IndexResidentSize() const {
+  size_t resident = 0;
+  for (fstring mem : indexMem_) {
+    resident += MmapResidentBytes(mem);
+  }
+  return resident;
+}
+
 std::shared_ptr<const TableProperties>
 TerarkZipTableReaderBase::GetTableProperties() const {
-  if (table_properties_) {
-    return table_properties_;
-  } else {
+  std::shared_ptr<const TableProperties> ret = table_properties_;
+  if (!ret) {
     TableProperties* props = nullptr;
     uint64_t filesize = uint64_t(-1);
     auto& ioptions = table_reader_options_.ioptions;
@@ -850,8 +1069,21 @@ TerarkZipTableReaderBase::GetTableProperties() const {
     }
     props->compression_name = "TERARK";
     assert(props != nullptr);
-    return std::shared_ptr<const TableProperties>(props);
+    ret.reset(props);
+  }
+  if (lazyWarmUp_) {
+    size_t resident = indexResident_;
+    std::lock_guard<std::mutex> lock(residentPropsMutex_);
+    if (!residentProps_ || residentPropsSize_ != resident) {
+      auto props = std::make_shared<TableProperties>(*ret);
+      props->user_collected_properties[kTerarkZipTableIndexResident] =
+          lcast(resident);
+      residentProps_ = std::move(props);
+      residentPropsSize_ = resident;
+    }
+    ret = residentProps_;
   }
+  return ret;
 }
 
 void TerarkZipTableReaderBase::MmapColdize(const void* addr, size_t len) {
@@ -875,6 +1107,49 @@ void TerarkZipSubReader::InitUsePread(int minPreadLen) {
   estimateUnzipCap_ = size_t(avgUnzipSize * 1.62);  // a bit larger than 1.618
 }
 
+void TerarkZipSubReader::InitRecordCache(
+    const TerarkZipTableFactory* table_factory) {
+  recordCache_ = table_factory->record_cache();
+  if (recordCache_ != nullptr) {
+    recordCacheId_ = recordCache_->NewId();
+  }
+  recordCacheMaxValueSize_ = table_factory->record_cache_max_value_size();
+}
+
+static Slice RecordCacheKey(uint64_t cacheId, size_t recId, char* buf) {
+  char* end = EncodeVarint64(buf, cacheId);
+  end = EncodeVarint64(end, recId);
+  return Slice(buf, end - buf);
+}
+
+bool TerarkZipSubReader::LookupRecordCache(size_t recId,
+                                           valvec<byte_t>* tbuf) const {
+  char buf[kMaxVarint64Length * 2];
+  Slice key = RecordCacheKey(recordCacheId_, recId, buf);
+  Cache::Handle* handle = recordCache_->Lookup(key);
+  if (handle == nullptr) {
+    return false;
+  }
+  auto record = static_cast<const std::string*>(recordCache_->Value(handle));
+  tbuf->append((const byte_t*)record->data(), record->size());
+  recordCache_->Release(handle);
+  return true;
+}
+
+void TerarkZipSubReader::InsertRecordCache(size_t recId,
+                                           fstring record) const {
+  if (record.size() > recordCacheMaxValueSize_) {
+    return;
+  }
+  char buf[kMaxVarint64Length * 2];
+  Slice key = RecordCacheKey(recordCacheId_, recId, buf);
+  auto value = new std::string(record.data(), record.size());
+  recordCache_->Insert(key, value, value->capacity() + sizeof(std::string),
+                       [](const Slice& /*key*/, void* v) {
+                         delete static_cast<std::string*>(v);
+                       });
+}
+
 static const byte_t* FsPread(void* vself, size_t offset, size_t len,
                              valvec<byte_t>* buf) {
   TerarkZipSubReader* self = (TerarkZipSubReader*)vself;
@@ -890,6 +1165,10 @@ static const byte_t* FsPread(void* vself, size_t offset, size_t len,
 
 void TerarkZipSubReader::GetRecordAppend(size_t recId,
                                          valvec<byte_t>* tbuf) const {
+  size_t pos = tbuf->size();
+  if (recordCache_ && LookupRecordCache(recId, tbuf)) {
+    return;
+  }
   if (storeUsePread_) {
     auto cache = cache_;
     if (cache)
@@ -900,10 +1179,17 @@ void TerarkZipSubReader::GetRecordAppend(size_t recId,
   } else {
     store_->get_record_append(recId, tbuf);
   }
+  if (recordCache_) {
+    InsertRecordCache(recId, fstring(tbuf->data() + pos, tbuf->size() - pos));
+  }
 }
 
 void TerarkZipSubReader::GetRecordAppend(
     size_t recId, terark::BlobStore::CacheOffsets* co) const {
+  // iterators only look up, a scan must not evict the records of Get
+  if (recordCache_ && LookupRecordCache(recId, &co->recData)) {
+    return;
+  }
   if (storeUsePread_) {
     auto cache = cache_;
     if (cache)
@@ -1145,6 +1431,13 @@ Status TerarkZipTableReader::Open(RandomAccessFileReader* file,
                                            lcast(dict.size()));
   // PlainBlobStore & MixedLenBlobStore no dict
   s = LoadTombstone(file, file_size);
+  if (!s.ok()) {
+    return s;
+  }
+  s = LoadFilter(file, file_size);
+  if (!s.ok()) {
+    return s;
+  }
   if (global_seqno_ == kDisableGlobalSequenceNumber) {
     global_seqno_ = 0;
   }
@@ -1178,6 +1471,7 @@ Status TerarkZipTableReader::Open(RandomAccessFileReader* file,
   if (!s.ok()) {
     return s;
   }
+  indexMem_.emplace_back(file_data.data(), indexSize);
   size_t recNum = subReader_.index_->NumKeys();
   if (typeSize > 0) {
     subReader_.type_.risk_set_data(
@@ -1253,7 +1547,7 @@ Status TerarkZipTableReader::Open(RandomAccessFileReader* file,
     subReader_.store_->detach_meta_blocks(store_meta_data);
   }
   long long t0 = g_pf.now();
-  if (tzto_.warmUpIndexOnOpen) {
+  if (tzto_.warmUpIndexOnOpen && !tzto_.warmUpIndexLazily) {
     MmapWarmUp(fstring(file_data.data(), indexSize));
     if (!tzto_.warmUpValueOnOpen) {
       for (fstring block : subReader_.store_->get_meta_blocks()) {
@@ -1274,6 +1568,7 @@ Status TerarkZipTableReader::Open(RandomAccessFileReader* file,
     }
   }
   subReader_.file_number_ = table_reader_options_.file_number;
+  subReader_.InitRecordCache(table_factory_);
   long long t1 = g_pf.now();
   subReader_.index_->BuildCache(tzto_.indexCacheRatio);
   long long t2 = g_pf.now();
@@ -1285,7 +1580,9 @@ Status TerarkZipTableReader::Open(RandomAccessFileReader* file,
        subReader_.index_->NumKeys(), size_t(props->index_size),
        size_t(props->data_size), g_pf.sf(t0, t1), g_pf.sf(t1, t2));
 
-  if (!tzto_.warmUpIndexOnOpen) {
+  if (tzto_.warmUpIndexLazily) {
+    StartLazyWarmUp();
+  } else if (!tzto_.warmUpIndexOnOpen) {
     MmapColdize(fstring(file_data.data(), file_data.size()));
   }
   for (fstring meta_item : meta_data_in_mmap) {
@@ -1370,6 +1667,9 @@ Status TerarkZipTableReader::Get(const ReadOptions& ro, const Slice& ikey,
                                  bool skip_filters) {
   int flag = skip_filters ? TerarkZipSubReader::FlagSkipFilter
                           : TerarkZipSubReader::FlagNone;
+  if (ikey.size() >= 8 && !KeyMayMatch(ExtractUserKey(ikey), skip_filters)) {
+    return Status::OK();
+  }
   return subReader_.Get(global_seqno_, ro, ikey, get_context, flag);
 }
 
@@ -1451,7 +1751,8 @@ Status TerarkZipTableMultiReader::SubIndex::Init(
     fstring offsetMemory, const byte_t* baseAddress,
     AbstractBlobStore::Dictionary dict, int minPreadLen,
     RandomAccessFile* fileObj, LruReadonlyCache* cache, uint64_t file_number,
-    bool warmUpIndexOnOpen, bool reverse) {
+    bool warmUpIndexOnOpen, bool reverse,
+    const TerarkZipTableFactory* table_factory) {
   TerarkZipMultiOffsetInfo offsetInfo;
   if (!offsetInfo.risk_set_memory(offsetMemory.data(), offsetMemory.size())) {
     return Status::Corruption("bad offset block");
@@ -1501,6 +1802,7 @@ Status TerarkZipTableMultiReader::SubIndex::Init(
         offset += curr.type;
       }
       part.file_number_ = file_number;
+      part.InitRecordCache(table_factory);
       if (part.storeUsePread_ && cache) {
         if (cache_fi_ < 0) {
           cache_fi_ = cache->open(fileFD);
@@ -1594,6 +1896,9 @@ Status TerarkZipTableMultiReader::Get(
     return Status::InvalidArgument("TerarkZipTableMultiReader::Get()",
                                    "param target.size() < 8 + PrefixLen");
   }
+  if (!KeyMayMatch(ExtractUserKey(ikey), skip_filters)) {
+    return Status::OK();
+  }
   const TerarkZipSubReader* subReader;
   if (isReverseBytewiseOrder_) {
     subReader = subIndex_.LowerBoundSubReaderReverse(
@@ -1724,6 +2029,13 @@ Status TerarkZipTableMultiReader::Open(RandomAccessFileReader* file,
   props->user_collected_properties.emplace(kTerarkZipTableDictSize,
                                            lcast(dict.size()));
   s = LoadTombstone(file, file_size);
+  if (!s.ok()) {
+    return s;
+  }
+  s = LoadFilter(file, file_size);
+  if (!s.ok()) {
+    return s;
+  }
   if (global_seqno_ == kDisableGlobalSequenceNumber) {
     global_seqno_ = 0;
   }
@@ -1733,11 +2045,17 @@ Status TerarkZipTableMultiReader::Open(RandomAccessFileReader* file,
           ? AbstractBlobStore::Dictionary(fstringOf(dict), 0, false)
           : getVerifyDict(dict),
       tzto_.minPreadLen, file_->file(), table_factory_->cache(),
-      table_reader_options_.file_number, tzto_.warmUpIndexOnOpen,
-      isReverseBytewiseOrder_);
+      table_reader_options_.file_number,
+      tzto_.warmUpIndexOnOpen && !tzto_.warmUpIndexLazily,
+      isReverseBytewiseOrder_, table_factory_);
   if (!s.ok()) {
     return s;
   }
+  for (size_t i = 0; i < subIndex_.GetSubCount(); ++i) {
+    auto part = subIndex_.GetSubReader(i);
+    indexMem_.emplace_back(file_data.data() + part->rawReaderOffset_,
+                           part->storeOffset_ - part->rawReaderOffset_);
+  }
   valvec<fstring> meta_data_in_mmap;
   if (tzto_.forceMetaInMemory) {
     valvec<std::pair<valvec<fstring>, valvec<fstring>>> meta_data;
@@ -1791,7 +2109,7 @@ Status TerarkZipTableMultiReader::Open(RandomAccessFileReader* file,
   }
   long long t0 = g_pf.now();
 
-  if (tzto_.warmUpIndexOnOpen) {
+  if (tzto_.warmUpIndexOnOpen && !tzto_.warmUpIndexLazily) {
     if (!tzto_.warmUpValueOnOpen) {
       MmapWarmUp(fstringOf(valueDictBlock.data));
       for (size_t i = 0; i < subIndex_.GetSubCount(); ++i) {
@@ -1837,7 +2155,9 @@ Status TerarkZipTableMultiReader::Open(RandomAccessFileReader* file,
        size_t(props->index_size), size_t(props->data_size), g_pf.sf(t0, t1),
        g_pf.sf(t1, t2));
 
-  if (!tzto_.warmUpIndexOnOpen) {
+  if (tzto_.warmUpIndexLazily) {
+    StartLazyWarmUp();
+  } else if (!tzto_.warmUpIndexOnOpen) {
     MmapColdize(fstring(file_data.data(), file_data.size()));
   }
   for (fstring meta_item : meta_data_in_mmap) {
@@ -10,12 +10,16 @@
 #ifndef TERARK_ZIP_TABLE_READER_H_
 #define TERARK_ZIP_TABLE_READER_H_
 
+#include <atomic>
+#include <mutex>
+
 // project headers
 #include "terark_zip_internal.h"
 #include "terark_zip_table.h"
 // boost headers
 #include <boost/noncopyable.hpp>
 // rocksdb headers
+#include <rocksdb/filter_policy.h>
 #include <rocksdb/options.h>
 #include <table/block.h>
 #include <table/table_builder.h>
@@ -43,7 +47,23 @@ Status ReadMetaBlockAdapte(class RandomAccessFileReader* file,
 
 class TerarkZipTableReaderBase : public TableReader, boost::noncopyable {
  private:
+  friend class LazyIndexWarmUpQueue;
+
   std::shared_ptr<const FragmentedRangeTombstoneList> fragmented_range_dels_;
+  bool lazyWarmUp_ = false;
+  // bytes of indexMem_ already warmed up, only used by the background job
+  size_t lazyWarmUpPos_ = 0;
+  // IndexResidentSize() as of the last warm up step
+  std::atomic<size_t> indexResident_{0};
+  // table properties reporting residentPropsSize_
+  mutable std::mutex residentPropsMutex_;
+  mutable std::shared_ptr<const TableProperties> residentProps_;
+  mutable size_t residentPropsSize_ = 0;
+
+  // called by the background job of LazyIndexWarmUpQueue, warms up at most
+  // *budget bytes and subtracts them, returns false if it stopped early
+  // because the budget ran out or cancel was set
+  bool WarmUpIndexLazily(const std::atomic<bool>& cancel, size_t* budget);
 
  protected:
   const TableReaderOptions table_reader_options_;
@@ -51,11 +71,31 @@ class TerarkZipTableReaderBase : public TableReader, boost::noncopyable {
   std::shared_ptr<const TableProperties> table_properties_;
   unique_ptr<RandomAccessFileReader> file_;
   Slice file_data_;
+  BlockContents filterBlock_;
+  unique_ptr<FilterBitsReader> filter_;
+  // the index of every sub reader, in place in the mmap
+  valvec<fstring> indexMem_;
 
   virtual SequenceNumber GetSequenceNumber() const = 0;
 
   Status LoadTombstone(RandomAccessFileReader* file, uint64_t file_size);
 
+  // the filter block is optional, tables built with bloomBitsPerKey == 0
+  // have none
+  Status LoadFilter(RandomAccessFileReader* file, uint64_t file_size);
+
+  // returns false only if user_key is definitely not in the table
+  bool KeyMayMatch(const Slice& user_key, bool skip_filters) const;
+
+  // queues indexMem_ for the background warm up of warmUpIndexLazily, the
+  // reader leaves the queue when it is destroyed
+  void StartLazyWarmUp();
+
+  size_t FilterMemoryUsage() const {
+    return filter_ && filterBlock_.own_bytes() ? filterBlock_.usable_size()
+                                               : 0;
+  }
+
   uint64_t FileNumber() const override {
     return table_reader_options_.file_number;
   }
@@ -64,11 +104,18 @@ class TerarkZipTableReaderBase : public TableReader, boost::noncopyable {
       : table_reader_options_(tro) {}
 
  public:
+  virtual ~TerarkZipTableReaderBase();
+
   virtual FragmentedRangeTombstoneIterator* NewRangeTombstoneIterator(
       const ReadOptions& read_options) override;
 
+  // the tables opened with warmUpIndexLazily also report
+  // kTerarkZipTableIndexResident
   std::shared_ptr<const TableProperties> GetTableProperties() const override;
 
+  // bytes of the index currently in the page cache
+  size_t IndexResidentSize() const;
+
   void MmapColdize(const void* addr, size_t len);
   void MmapColdize(terark::fstring mem) { MmapColdize(mem.data(), mem.size()); }
   template <class Vec>
@@ -145,6 +192,11 @@ struct TerarkZipSubReader {
   unique_ptr<terark::AbstractBlobStore> store_;
   bitfield_array<2> type_;
   uint64_t file_number_;
+  Cache* recordCache_ = nullptr;
+  // Cache::NewId() of this sub reader, file numbers are not unique across
+  // DBs sharing the cache
+  uint64_t recordCacheId_ = 0;
+  size_t recordCacheMaxValueSize_ = 0;
 
   enum {
     FlagNone = 0,
@@ -152,6 +204,12 @@ struct TerarkZipSubReader {
   };
 
   void InitUsePread(int minPreadLen);
+  void InitRecordCache(const TerarkZipTableFactory* table_factory);
+
+  // the record cache only holds records read by GetRecordAppend(valvec),
+  // which is the point lookup path
+  bool LookupRecordCache(size_t recId, valvec<byte_t>* tbuf) const;
+  void InsertRecordCache(size_t recId, fstring record) const;
 
   void GetRecordAppend(size_t recId, valvec<byte_t>* tbuf) const;
   void GetRecordAppend(size_t recId, terark::BlobStore::CacheOffsets*) const;
@@ -193,7 +251,9 @@ class TerarkZipTableReader : public TerarkZipTableReaderBase {
   uint64_t ApproximateOffsetOf(const Slice& key) override;
   void SetupForCompaction() override {}
 
-  size_t ApproximateMemoryUsage() const override { return file_data_.size(); }
+  size_t ApproximateMemoryUsage() const override {
+    return file_data_.size() + FilterMemoryUsage();
+  }
 
   virtual ~TerarkZipTableReader();
   TerarkZipTableReader(const TerarkZipTableFactory* table_factory,
@@ -241,7 +301,9 @@ class TerarkZipTableMultiReader : public TerarkZipTableReaderBase {
   uint64_t ApproximateOffsetOf(const Slice& key) override;
   void SetupForCompaction() override {}
 
-  size_t ApproximateMemoryUsage() const override { return file_data_.size(); }
+  size_t ApproximateMemoryUsage() const override {
+    return file_data_.size() + FilterMemoryUsage();
+  }
 
   virtual ~TerarkZipTableMultiReader();
   TerarkZipTableMultiReader(const TerarkZipTableFactory* table_factory,
@@ -270,7 +332,8 @@ class TerarkZipTableMultiReader : public TerarkZipTableReaderBase {
     Status Init(fstring offsetMemory, const byte_t* baseAddress,
                 terark::AbstractBlobStore::Dictionary dict, int minPreadLen,
                 RandomAccessFile* fileObj, LruReadonlyCache* cache,
-                uint64_t file_number, bool warmUpIndexOnOpen, bool reverse);
+                uint64_t file_number, bool warmUpIndexOnOpen, bool reverse,
+                const TerarkZipTableFactory* table_factory);
 
     size_t GetSubCount() const;
     const TerarkZipSubReader* GetSubReader(size_t i) const;
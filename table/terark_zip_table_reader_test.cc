@@ -8,6 +8,9 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
 
 #include "db/db_test_util.h"
 #include "port/port.h"
@@ -1012,6 +1015,309 @@ TEST_F(TerarkZipReaderTest, IndexBuildTest) {
   IterTest(data_list, test_list, true , 4, 64, 1024, 1);
 }
 
+TEST_F(TerarkZipReaderTest, BloomFilter) {
+  for (uint32_t prefix : {0, 1}) {
+    Options options = CurrentOptions();
+    TerarkZipTableOptions tzto;
+    tzto.keyPrefixLen = prefix;
+    tzto.bloomBitsPerKey = 10;
+    tzto.localTempDir = dbname_;
+    options.allow_mmap_reads = true;
+    options.statistics = CreateDBStatistics();
+    options.table_factory.reset(NewTerarkZipTableFactory(tzto, nullptr));
+    DestroyAndReopen(options);
+
+    const size_t count = 1000;
+    for (size_t i = 0; i < count; i += 2) {
+      ASSERT_OK(Put(get_key(i), get_value(i)));
+    }
+    ASSERT_OK(Flush());
+    std::string value;
+    for (size_t i = 0; i < count; i += 2) {
+      ASSERT_OK(db_->Get(ReadOptions(), get_key(i), &value));
+      ASSERT_EQ(get_value(i), value);
+    }
+    ASSERT_EQ(0, TestGetTickerCount(options, BLOOM_FILTER_USEFUL));
+    for (size_t i = 1; i < count; i += 2) {
+      ASSERT_TRUE(db_->Get(ReadOptions(), get_key(i), &value).IsNotFound());
+    }
+    // 10 bits per key, about 1% false positive
+    ASSERT_GT(TestGetTickerCount(options, BLOOM_FILTER_USEFUL),
+              count / 2 * 9 / 10);
+  }
+}
+
+TEST_F(TerarkZipReaderTest, RecordCache) {
+  for (uint32_t prefix : {0, 1}) {
+    Options options = CurrentOptions();
+    TerarkZipTableOptions tzto;
+    tzto.keyPrefixLen = prefix;
+    tzto.localTempDir = dbname_;
+    tzto.recordCache = NewLRUCache(1 << 20);
+    tzto.recordCacheMaxValueSize = 64;
+    options.allow_mmap_reads = true;
+    options.table_factory.reset(NewTerarkZipTableFactory(tzto, nullptr));
+    DestroyAndReopen(options);
+
+    const size_t count = 1000;
+    for (size_t i = 0; i < count; ++i) {
+      // every 10th value is too large to be cached
+      ASSERT_OK(Put(get_key(i), get_value(i, i % 10 == 0 ? 100 : 10)));
+    }
+    ASSERT_OK(Flush());
+    ASSERT_EQ(0, tzto.recordCache->GetUsage());
+    std::string value;
+    for (int pass = 0; pass < 2; ++pass) {
+      for (size_t i = 0; i < count; ++i) {
+        ASSERT_OK(db_->Get(ReadOptions(), get_key(i), &value));
+        ASSERT_EQ(get_value(i, i % 10 == 0 ? 100 : 10), value);
+      }
+    }
+    size_t usage = tzto.recordCache->GetUsage();
+    ASSERT_GT(usage, 0);
+    std::unique_ptr<Iterator> it(db_->NewIterator(ReadOptions()));
+    size_t i = 0;
+    for (it->SeekToFirst(); it->Valid(); it->Next(), ++i) {
+      ASSERT_EQ(get_key(i), it->key().ToString());
+      ASSERT_EQ(get_value(i, i % 10 == 0 ? 100 : 10), it->value().ToString());
+    }
+    ASSERT_EQ(count, i);
+    // iterators never insert
+    ASSERT_EQ(usage, tzto.recordCache->GetUsage());
+
+    // Another DB sharing the factory and the cache has the same file numbers
+    std::string other_dbname = dbname_ + "_other";
+    ASSERT_OK(DestroyDB(other_dbname, options));
+    DB* other_db = nullptr;
+    ASSERT_OK(DB::Open(options, other_dbname, &other_db));
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_OK(other_db->Put(WriteOptions(), get_key(i), "other"));
+    }
+    ASSERT_OK(other_db->Flush(FlushOptions()));
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_OK(other_db->Get(ReadOptions(), get_key(i), &value));
+      ASSERT_EQ("other", value);
+      ASSERT_OK(db_->Get(ReadOptions(), get_key(i), &value));
+      ASSERT_EQ(get_value(i, i % 10 == 0 ? 100 : 10), value);
+    }
+    delete other_db;
+    ASSERT_OK(DestroyDB(other_dbname, options));
+  }
+}
+
+TEST_F(TerarkZipReaderTest, ZipValueThreads) {
+  for (uint32_t prefix : {0, 1}) {
+    Options options = CurrentOptions();
+    TerarkZipTableOptions tzto;
+    tzto.disableSecondPassIter = true;
+    tzto.keyPrefixLen = prefix;
+    tzto.localTempDir = dbname_;
+    tzto.minDictZipValueSize = 0;
+    tzto.singleIndexMinSize = 512;
+    tzto.zipValueThreads = 4;
+    options.allow_mmap_reads = true;
+    // ranges of 64K, a single range without zipValueThreads
+    options.target_file_size_base = 256 << 10;
+    options.table_factory.reset(NewTerarkZipTableFactory(tzto, nullptr));
+    DestroyAndReopen(options);
+    env_->SetBackgroundThreads(4, Env::LOW);
+
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    rocksdb::SyncPoint::GetInstance()->LoadDependency(
+        {{"TerarkZipTableBuilder::BuildZipStoreParallel:BuildPart",
+          "TerarkZipTableBuilder::BuildZipStoreParallel:Local"}});
+    rocksdb::SyncPoint::GetInstance()->SetCallBack(
+        "TerarkZipTableBuilder::BuildZipStoreParallel:BuildPart",
+        [&](void* /*arg*/) {
+          std::lock_guard<std::mutex> lock(mutex);
+          threads.insert(std::this_thread::get_id());
+        });
+    rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+    const size_t count = 5000;
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_OK(Put(get_key(i), get_value(i, 40 + i % 64)));
+    }
+    ASSERT_OK(Flush());
+    rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+    rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+    // the values were compressed by several threads at the same time
+    ASSERT_GT(threads.size(), 1);
+    std::string value;
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_OK(db_->Get(ReadOptions(), get_key(i), &value));
+      ASSERT_EQ(get_value(i, 40 + i % 64), value);
+    }
+    std::unique_ptr<Iterator> it(db_->NewIterator(ReadOptions()));
+    size_t i = 0;
+    for (it->SeekToFirst(); it->Valid(); it->Next(), ++i) {
+      ASSERT_EQ(get_key(i), it->key().ToString());
+      ASSERT_EQ(get_value(i, 40 + i % 64), it->value().ToString());
+    }
+    ASSERT_EQ(count, i);
+  }
+}
+
+TEST_F(TerarkZipReaderTest, StreamingBuild) {
+  struct Case {
+    uint32_t prefix;
+    size_t count;
+    size_t minValueLen;
+    uint64_t chunkSize;
+  };
+  // large values pass the limit that makes non streaming builds re read the
+  // values through the second pass iterator
+  for (auto c : {Case{0, 5000, 40, 16 << 10}, Case{1, 5000, 40, 16 << 10},
+                 Case{0, 400, 16 << 10, 2 << 20}}) {
+    auto value_len = [&](size_t i) { return c.minValueLen + i % 64; };
+    Options options = CurrentOptions();
+    TerarkZipTableOptions tzto;
+    tzto.keyPrefixLen = c.prefix;
+    tzto.localTempDir = dbname_;
+    tzto.minDictZipValueSize = 0;
+    tzto.singleIndexMinSize = 512;
+    tzto.streamingChunkSize = c.chunkSize;
+    tzto.streamingLevels = ~0u;
+    options.allow_mmap_reads = true;
+    options.table_factory.reset(NewTerarkZipTableFactory(tzto, nullptr));
+    DestroyAndReopen(options);
+
+    // values of the chunks are never spilled to localTempDir, nor read again
+    size_t chunks = 0, valueFiles = 0, secondPass = 0;
+    rocksdb::SyncPoint::GetInstance()->SetCallBack(
+        "TerarkZipTableBuilder::StreamZipStore", [&](void* /*arg*/) {
+          std::vector<std::string> children;
+          ASSERT_OK(env_->GetChildren(dbname_, &children));
+          for (auto& name : children) {
+            valueFiles += name.find(".value.") != std::string::npos;
+          }
+          ++chunks;
+        });
+    rocksdb::SyncPoint::GetInstance()->SetCallBack(
+        "TerarkZipTableBuilder::BuilderWriteValues:SecondPass",
+        [&](void* /*arg*/) { ++secondPass; });
+    rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+    for (size_t i = 0; i < c.count; ++i) {
+      ASSERT_OK(Put(get_key(i), get_value(i, value_len(i))));
+    }
+    ASSERT_OK(Flush());
+    ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+    rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+    rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+    ASSERT_GT(chunks, 1);
+    ASSERT_EQ(0, valueFiles);
+    ASSERT_EQ(0, secondPass);
+    std::string value;
+    for (size_t i = 0; i < c.count; ++i) {
+      ASSERT_OK(db_->Get(ReadOptions(), get_key(i), &value));
+      ASSERT_EQ(get_value(i, value_len(i)), value);
+    }
+    std::unique_ptr<Iterator> it(db_->NewIterator(ReadOptions()));
+    size_t i = 0;
+    for (it->SeekToFirst(); it->Valid(); it->Next(), ++i) {
+      ASSERT_EQ(get_key(i), it->key().ToString());
+      ASSERT_EQ(get_value(i, value_len(i)), it->value().ToString());
+    }
+    ASSERT_EQ(c.count, i);
+  }
+}
+
+TEST_F(TerarkZipReaderTest, AdaptiveFallback) {
+  Random rnd(301);
+  for (double minGain : {0.0001, 0.9999}) {
+    Options options = CurrentOptions();
+    TerarkZipTableOptions tzto;
+    tzto.localTempDir = dbname_;
+    tzto.adaptiveMinZipGain = minGain;
+    options.allow_mmap_reads = true;
+    options.table_factory.reset(NewTerarkZipTableFactory(
+        tzto, std::shared_ptr<TableFactory>(NewBlockBasedTableFactory())));
+    DestroyAndReopen(options);
+
+    const size_t count = 2000;
+    std::vector<std::string> values(count);
+    for (size_t i = 0; i < count; ++i) {
+      // incompressible values
+      values[i] = RandomString(&rnd, 64);
+      ASSERT_OK(Put(get_key(i), values[i]));
+    }
+    ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                               get_key(100), get_key(200)));
+    ASSERT_OK(Flush());
+
+    TablePropertiesCollection props;
+    ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+    ASSERT_EQ(1, props.size());
+    auto& user_props = props.begin()->second->user_collected_properties;
+    auto find = user_props.find("terark.build.adaptive");
+    ASSERT_TRUE(find != user_props.end());
+    bool fallback = minGain > 0.5;
+    ASSERT_EQ(fallback ? "fallback" : "TerarkZip",
+              find->second.substr(0, find->second.find(':')));
+
+    std::string value;
+    for (size_t i = 0; i < count; ++i) {
+      auto s = db_->Get(ReadOptions(), get_key(i), &value);
+      if (i >= 100 && i < 200) {
+        ASSERT_TRUE(s.IsNotFound());
+      } else {
+        ASSERT_OK(s);
+        ASSERT_EQ(values[i], value);
+      }
+    }
+  }
+}
+
+TEST_F(TerarkZipReaderTest, LazyIndexWarmUp) {
+  for (uint32_t prefix : {0, 1}) {
+    Options options = CurrentOptions();
+    TerarkZipTableOptions tzto;
+    tzto.keyPrefixLen = prefix;
+    tzto.localTempDir = dbname_;
+    tzto.warmUpIndexLazily = true;
+    options.allow_mmap_reads = true;
+    options.table_factory.reset(NewTerarkZipTableFactory(tzto, nullptr));
+    DestroyAndReopen(options);
+
+    const size_t count = 1000;
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_OK(Put(get_key(i), get_value(i, 16)));
+    }
+    ASSERT_OK(Flush());
+    // the job runs on the Env of the DB
+    std::atomic<int> warm_ups{0};
+    rocksdb::SyncPoint::GetInstance()->SetCallBack(
+        "TerarkZipTableReader::WarmUpIndexLazily:Done",
+        [&](void* /*arg*/) { ++warm_ups; });
+    rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+    Reopen(options);
+    for (int i = 0; i < 1000 && warm_ups == 0; ++i) {
+      env_->SleepForMicroseconds(10000);
+    }
+    rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+    rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+    ASSERT_GT(warm_ups, 0);
+
+    std::string value;
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_OK(db_->Get(ReadOptions(), get_key(i), &value));
+      ASSERT_EQ(get_value(i, 16), value);
+    }
+    TablePropertiesCollection props;
+    ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+    ASSERT_EQ(1, props.size());
+    auto& table_props = *props.begin()->second;
+    auto find = table_props.user_collected_properties.find(
+        "terark.index.resident");
+    ASSERT_TRUE(find != table_props.user_collected_properties.end());
+    uint64_t resident = std::stoull(find->second);
+    ASSERT_GT(resident, 0);
+    ASSERT_LE(resident, table_props.index_size);
+  }
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
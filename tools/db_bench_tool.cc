@@ -119,6 +119,7 @@ DEFINE_string(
     "randomwithverify,"
     "fill100K,"
     "crc32c,"
+    "crc32c_multi,"
     "xxhash,"
     "compress,"
     "uncompress,"
@@ -178,6 +179,8 @@ DEFINE_string(
     "\tseekrandomwhilemerging -- seekrandom and 1 thread doing "
     "merge\n"
     "\tcrc32c        -- repeated crc32c of 4K of data\n"
+    "\tcrc32c_multi  -- repeated crc32c of 16 blocks of 4K of data "
+    "checksummed together\n"
     "\txxhash        -- repeated xxHash of 4K of data\n"
     "\tacquireload   -- load N*1000 times\n"
     "\tfillseekseq   -- write N values in sequential key, then read "
@@ -484,6 +487,10 @@ DEFINE_bool(enable_index_compression,
 DEFINE_bool(block_align, rocksdb::BlockBasedTableOptions().block_align,
             "Align data blocks on page size");
 
+DEFINE_bool(restart_key_prefix_search,
+            rocksdb::BlockBasedTableOptions().restart_key_prefix_search,
+            "Narrow restart point binary search with packed key prefixes");
+
 DEFINE_bool(use_data_block_hash_index, false,
             "if use kDataBlockBinaryAndHash "
             "instead of kDataBlockBinarySearch. "
@@ -494,6 +501,15 @@ DEFINE_double(data_block_hash_table_util_ratio, 0.75,
               "This is only valid if use_data_block_hash_index is "
               "set to true");
 
+DEFINE_bool(point_lookup_index,
+            rocksdb::BlockBasedTableOptions().point_lookup_index,
+            "Build and use a table level hash from user key to data block "
+            "for point lookups");
+
+DEFINE_double(point_lookup_index_util_ratio,
+              rocksdb::BlockBasedTableOptions().point_lookup_index_util_ratio,
+              "util ratio for the table level point lookup index");
+
 DEFINE_int64(compressed_cache_size, -1,
              "Number of bytes to use as a cache of compressed data.");
 
@@ -977,6 +993,9 @@ DEFINE_bool(use_direct_io_for_flush_and_compaction,
 DEFINE_bool(use_aio_reads, rocksdb::Options().use_aio_reads,
             "Use aio_read+fiber for reading data");
 
+DEFINE_bool(use_io_uring, rocksdb::Options().use_io_uring,
+            "Use an io_uring per thread for reading data");
+
 DEFINE_bool(advise_random_on_open, rocksdb::Options().advise_random_on_open,
             "Advise random access on table file open");
 
@@ -2720,6 +2739,8 @@ class Benchmark {
         CompactAll();
       } else if (name == "crc32c") {
         method = &Benchmark::Crc32c;
+      } else if (name == "crc32c_multi") {
+        method = &Benchmark::Crc32cMulti;
       } else if (name == "xxhash") {
         method = &Benchmark::xxHash;
       } else if (name == "acquireload") {
@@ -3006,6 +3027,36 @@ class Benchmark {
     thread->stats.AddMessage(label);
   }
 
+  void Crc32cMulti(ThreadState* thread) {
+    // Checksum about 500MB of data total, kBlocks blocks per op
+    const size_t kBlocks = 16;
+    const size_t size = FLAGS_block_size;
+    std::string labels = "(" + ToString(kBlocks) + " x " +
+                         ToString(FLAGS_block_size) + " per op)";
+    const char* label = labels.c_str();
+
+    std::vector<std::string> blocks(kBlocks);
+    std::vector<const char*> data(kBlocks);
+    std::vector<size_t> sizes(kBlocks, size);
+    for (size_t i = 0; i < kBlocks; ++i) {
+      blocks[i].assign(size, static_cast<char>('a' + i));
+      data[i] = blocks[i].data();
+    }
+    std::vector<uint32_t> crc(kBlocks);
+    int64_t bytes = 0;
+    while (bytes < 500 * 1048576) {
+      std::fill(crc.begin(), crc.end(), 0);
+      crc32c::MultiExtend(crc.data(), data.data(), sizes.data(), kBlocks);
+      thread->stats.FinishedOps(nullptr, nullptr, 1, kCrc);
+      bytes += size * kBlocks;
+    }
+    // Print so result is not dead
+    fprintf(stderr, "... crc=0x%x\r", static_cast<unsigned int>(crc[0]));
+
+    thread->stats.AddBytes(bytes);
+    thread->stats.AddMessage(label);
+  }
+
   void xxHash(ThreadState* thread) {
     // Checksum about 500MB of data total
     const int size = 4096;
@@ -3197,6 +3248,7 @@ class Benchmark {
     options.use_direct_io_for_flush_and_compaction =
         FLAGS_use_direct_io_for_flush_and_compaction;
     options.use_aio_reads = FLAGS_use_aio_reads;
+    options.use_io_uring = FLAGS_use_io_uring;
 #ifndef ROCKSDB_LITE
     options.compaction_options_fifo = CompactionOptionsFIFO(
         FLAGS_fifo_compaction_max_table_files_size_mb * 1024 * 1024,
@@ -3375,6 +3427,8 @@ class Benchmark {
       block_based_options.enable_index_compression =
           FLAGS_enable_index_compression;
       block_based_options.block_align = FLAGS_block_align;
+      block_based_options.restart_key_prefix_search =
+          FLAGS_restart_key_prefix_search;
       if (FLAGS_use_data_block_hash_index) {
         block_based_options.data_block_index_type =
             rocksdb::BlockBasedTableOptions::kDataBlockBinaryAndHash;
@@ -3384,6 +3438,9 @@ class Benchmark {
       }
       block_based_options.data_block_hash_table_util_ratio =
           FLAGS_data_block_hash_table_util_ratio;
+      block_based_options.point_lookup_index = FLAGS_point_lookup_index;
+      block_based_options.point_lookup_index_util_ratio =
+          FLAGS_point_lookup_index_util_ratio;
       if (FLAGS_read_cache_path != "") {
 #ifndef ROCKSDB_LITE
         Status rc_status;
@@ -48,8 +48,11 @@ size_t OptimizeBlockSize(size_t block_size) {
   return block_size;
 }
 
-Arena::Arena(size_t block_size, AllocTracker* tracker, size_t huge_page_size)
-    : kBlockSize(OptimizeBlockSize(block_size)), tracker_(tracker) {
+Arena::Arena(size_t block_size, AllocTracker* tracker, size_t huge_page_size,
+             int numa_node)
+    : kBlockSize(OptimizeBlockSize(block_size)),
+      numa_node_(numa_node),
+      tracker_(tracker) {
   assert(kBlockSize >= kMinBlockSize && kBlockSize <= kMaxBlockSize &&
          kBlockSize % kAlignUnit == 0);
   TEST_SYNC_POINT_CALLBACK("Arena::Arena:0", const_cast<size_t*>(&kBlockSize));
@@ -78,6 +81,11 @@ Arena::~Arena() {
   for (const auto& block : blocks_) {
     delete[] block;
   }
+  for (const auto& numa_info : numa_blocks_) {
+    if (numa_info.addr_ != nullptr) {
+      port::NumaFree(numa_info.addr_, numa_info.length_);
+    }
+  }
 
 #ifdef MAP_HUGETLB
   for (const auto& mmap_info : huge_blocks_) {
@@ -205,6 +213,12 @@ char* Arena::AllocateAligned(size_t bytes, size_t huge_page_size,
 }
 
 char* Arena::AllocateNewBlock(size_t block_bytes) {
+  if (numa_node_ >= 0) {
+    char* block = AllocateFromNumaNode(block_bytes);
+    if (block != nullptr) {
+      return block;
+    }
+  }
   // Reserve space in `blocks_` before allocating memory via new.
   // Use `emplace_back()` instead of `reserve()` to let std::vector manage its
   // own memory and do fewer reallocations.
@@ -236,4 +250,21 @@ char* Arena::AllocateNewBlock(size_t block_bytes) {
   return block;
 }
 
+char* Arena::AllocateFromNumaNode(size_t block_bytes) {
+  // Same as `huge_blocks_`, reserve the slot before allocating
+  numa_blocks_.emplace_back(nullptr /* addr */, 0 /* length */);
+
+  void* addr = port::NumaAllocOnNode(block_bytes, numa_node_);
+  if (addr == nullptr) {
+    numa_blocks_.pop_back();
+    return nullptr;
+  }
+  numa_blocks_.back() = MmapInfo(addr, block_bytes);
+  blocks_memory_ += block_bytes;
+  if (tracker_ != nullptr) {
+    tracker_->Allocate(block_bytes);
+  }
+  return reinterpret_cast<char*>(addr);
+}
+
 }  // namespace rocksdb
@@ -38,8 +38,12 @@ class Arena : public Allocator {
   // huge_page_size: if 0, don't use huge page TLB. If > 0 (should set to the
   // supported hugepage size of the system), block allocation will try huge
   // page TLB first. If allocation fails, will fall back to normal case.
+  // numa_node: if >= 0, blocks are allocated on that NUMA node when the
+  // library is built with NUMA, otherwise they come from the default
+  // allocator.
   explicit Arena(size_t block_size = kMinBlockSize,
-                 AllocTracker* tracker = nullptr, size_t huge_page_size = 0);
+                 AllocTracker* tracker = nullptr, size_t huge_page_size = 0,
+                 int numa_node = -1);
   ~Arena();
 
   char* Allocate(size_t bytes) override;
@@ -96,6 +100,9 @@ class Arena : public Allocator {
     MmapInfo(void* addr, size_t length) : addr_(addr), length_(length) {}
   };
   std::vector<MmapInfo> huge_blocks_;
+  // Blocks allocated on numa_node_
+  std::vector<MmapInfo> numa_blocks_;
+  int numa_node_;
   size_t irregular_block_num = 0;
 
   // Stats for current active block.
@@ -114,6 +121,7 @@ class Arena : public Allocator {
   char* AllocateFromHugePage(size_t bytes);
   char* AllocateFallback(size_t bytes, bool aligned);
   char* AllocateNewBlock(size_t block_bytes);
+  char* AllocateFromNumaNode(size_t block_bytes);
 
   // Bytes of memory in blocks allocated so far
   size_t blocks_memory_ = 0;
@@ -8,6 +8,8 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #include "util/arena.h"
+#include <string.h>
+#include "port/port.h"
 #include "util/random.h"
 #include "util/testharness.h"
 
@@ -196,6 +198,29 @@ TEST_F(ArenaTest, Simple) {
   SimpleTest(0);
   SimpleTest(kHugePageSize);
 }
+
+TEST_F(ArenaTest, NumaNode) {
+  // Falls back to the default allocator if NUMA is not supported
+  const size_t kBlockSize = 8192;
+  int node = port::NumaNodeCount() - 1;
+  Arena arena(kBlockSize, nullptr, 0, node);
+  std::vector<std::pair<char*, size_t>> allocated;
+  size_t bytes = 0;
+  for (size_t i = 1; i < 1000; ++i) {
+    size_t size = (i % 7 == 0) ? kBlockSize : i;
+    char* r = (i % 2 == 0) ? arena.AllocateAligned(size) : arena.Allocate(size);
+    memset(r, static_cast<int>(i % 256), size);
+    allocated.emplace_back(r, size);
+    bytes += size;
+  }
+  ASSERT_GE(arena.MemoryAllocatedBytes(), bytes);
+  for (size_t i = 0; i < allocated.size(); ++i) {
+    for (size_t b = 0; b < allocated[i].second; ++b) {
+      ASSERT_EQ(static_cast<int>((i + 1) % 256),
+                allocated[i].first[b] & 0xff);
+    }
+  }
+}
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
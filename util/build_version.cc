@@ -0,0 +1,4 @@
+#include "build_version.h"
+const char* rocksdb_build_git_sha = "rocksdb_build_git_sha:@e249f78237db51a117cedf386cb938290073f22b@";
+const char* rocksdb_build_git_date = "rocksdb_build_git_date:@2026/10/19 00:55:55@";
+const char* rocksdb_build_compile_date = __DATE__;
@@ -11,6 +11,7 @@
 // four bytes at a time.
 #include "util/crc32c.h"
 #include <stdint.h>
+#include <algorithm>
 #ifdef HAVE_SSE42
 #include <nmmintrin.h>
 #include <wmmintrin.h>
@@ -1226,6 +1227,62 @@ uint32_t Extend(uint32_t crc, const char* buf, size_t size) {
   return ChosenExtend(crc, buf, size);
 }
 
+typedef void (*MultiFunction)(uint32_t*, const char* const*, const size_t*,
+                              size_t);
+
+static void MultiExtendImpl(uint32_t* crc, const char* const* data,
+                            const size_t* size, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    crc[i] = ChosenExtend(crc[i], data[i], size[i]);
+  }
+}
+
+#if defined(HAVE_SSE42) && (defined(__LP64__) || defined(_WIN64))
+// The crc32 instruction has a latency of 3 cycles and a throughput of 1 per
+// cycle, so three buffers are processed side by side up to the length of the
+// shortest one. The tails are left to Extend().
+static void MultiExtendSSE42(uint32_t* crc, const char* const* data,
+                             const size_t* size, size_t n) {
+  size_t i = 0;
+  for (; i + 3 <= n; i += 3) {
+    const uint8_t* p0 = reinterpret_cast<const uint8_t*>(data[i]);
+    const uint8_t* p1 = reinterpret_cast<const uint8_t*>(data[i + 1]);
+    const uint8_t* p2 = reinterpret_cast<const uint8_t*>(data[i + 2]);
+    uint64_t l0 = crc[i] ^ 0xffffffffu;
+    uint64_t l1 = crc[i + 1] ^ 0xffffffffu;
+    uint64_t l2 = crc[i + 2] ^ 0xffffffffu;
+    size_t len = std::min(size[i], std::min(size[i + 1], size[i + 2])) & ~7;
+    for (size_t k = 0; k < len; k += 8) {
+      l0 = _mm_crc32_u64(l0, LE_LOAD64(p0 + k));
+      l1 = _mm_crc32_u64(l1, LE_LOAD64(p1 + k));
+      l2 = _mm_crc32_u64(l2, LE_LOAD64(p2 + k));
+    }
+    crc[i] = ChosenExtend(static_cast<uint32_t>(l0 ^ 0xffffffffu),
+                          data[i] + len, size[i] - len);
+    crc[i + 1] = ChosenExtend(static_cast<uint32_t>(l1 ^ 0xffffffffu),
+                              data[i + 1] + len, size[i + 1] - len);
+    crc[i + 2] = ChosenExtend(static_cast<uint32_t>(l2 ^ 0xffffffffu),
+                              data[i + 2] + len, size[i + 2] - len);
+  }
+  MultiExtendImpl(crc + i, data + i, size + i, n - i);
+}
+#endif
+
+static inline MultiFunction Choose_MultiExtend() {
+#if defined(HAVE_SSE42) && (defined(__LP64__) || defined(_WIN64))
+  if (isSSE42()) {
+    return MultiExtendSSE42;
+  }
+#endif
+  return MultiExtendImpl;
+}
+
+static MultiFunction ChosenMultiExtend = Choose_MultiExtend();
+void MultiExtend(uint32_t* crc, const char* const* data, const size_t* size,
+                 size_t n) {
+  ChosenMultiExtend(crc, data, size, n);
+}
+
 
 }  // namespace crc32c
 }  // namespace rocksdb
@@ -27,6 +27,12 @@ inline uint32_t Value(const char* data, size_t n) {
   return Extend(0, data, n);
 }
 
+// Extend crc[i] with data[i][0,size[i]-1] for every i in [0,n). The crc32
+// instructions of independent buffers are interleaved to hide their latency,
+// which pays off for many small buffers such as blocks or records.
+extern void MultiExtend(uint32_t* crc, const char* const* data,
+                        const size_t* size, size_t n);
+
 static const uint32_t kMaskDelta = 0xa282ead8ul;
 
 // Return a masked representation of crc.
@@ -129,6 +129,26 @@ TEST(CRC, Extend) {
             Extend(Value("hello ", 6), "world", 5));
 }
 
+TEST(CRC, MultiExtend) {
+  // Unaligned buffers of different lengths, with a partial group at the end
+  const size_t kNum = 10;
+  const char* data[kNum];
+  size_t size[kNum];
+  uint32_t crc[kNum];
+  uint32_t expected[kNum];
+  for (size_t i = 0; i < kNum; ++i) {
+    data[i] = buffer + i * 10007;
+    size[i] = (i * 7919) % 10000;
+    crc[i] = Value(buffer + i, i);
+    expected[i] = Extend(crc[i], data[i], size[i]);
+  }
+  MultiExtend(crc, data, size, kNum);
+  for (size_t i = 0; i < kNum; ++i) {
+    ASSERT_EQ(expected[i], crc[i]);
+  }
+  MultiExtend(crc, data, size, 0);
+}
+
 TEST(CRC, Mask) {
   uint32_t crc = Value("foo", 3);
   ASSERT_NE(crc, Mask(crc));
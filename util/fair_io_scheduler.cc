@@ -0,0 +1,356 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/fair_io_scheduler.h"
+
+#include <algorithm>
+
+#include "monitoring/statistics.h"
+#include "util/mutexlock.h"
+#include "util/rate_limiter.h"
+#include "util/sync_point.h"
+
+namespace rocksdb {
+
+namespace {
+
+class FairTenantRateLimiter : public RateLimiter {
+ public:
+  FairTenantRateLimiter(std::shared_ptr<FairIOSchedulerImpl> scheduler,
+                        size_t tenant)
+      : RateLimiter(scheduler->mode()),
+        scheduler_(std::move(scheduler)),
+        tenant_(tenant) {}
+
+  // The budget is shared, this changes it for all tenants
+  virtual void SetBytesPerSecond(int64_t bytes_per_second) override {
+    scheduler_->SetBytesPerSecond(bytes_per_second);
+  }
+
+  using RateLimiter::Request;
+  virtual void Request(const int64_t bytes, const Env::IOPriority pri,
+                       Statistics* stats) override {
+    scheduler_->Request(tenant_, bytes, pri, stats);
+  }
+
+  virtual void ReportIOLatency(size_t bytes, uint64_t micros,
+                               OpType /*op_type*/) override {
+    scheduler_->ReportIOLatency(bytes, micros);
+  }
+
+  virtual int64_t GetSingleBurstBytes() const override {
+    return scheduler_->GetSingleBurstBytes();
+  }
+
+  virtual int64_t GetTotalBytesThrough(
+      const Env::IOPriority pri = Env::IO_TOTAL) const override {
+    return scheduler_->GetTotalBytesThrough(tenant_, pri);
+  }
+
+  virtual int64_t GetTotalRequests(
+      const Env::IOPriority pri = Env::IO_TOTAL) const override {
+    return scheduler_->GetTotalRequests(tenant_, pri);
+  }
+
+  virtual int64_t GetBytesPerSecond() const override {
+    return scheduler_->GetBytesPerSecond();
+  }
+
+ private:
+  std::shared_ptr<FairIOSchedulerImpl> scheduler_;
+  size_t tenant_;
+};
+
+}  // namespace
+
+// Pending request
+struct FairIOSchedulerImpl::Req {
+  Req(int64_t _bytes, double _start_tag, uint64_t _seq, port::Mutex* _mu)
+      : request_bytes(_bytes),
+        start_tag(_start_tag),
+        seq(_seq),
+        cv(_mu),
+        granted(false) {}
+  int64_t request_bytes;
+  double start_tag;
+  uint64_t seq;
+  port::CondVar cv;
+  bool granted;
+};
+
+bool FairIOSchedulerImpl::ReqCompare::operator()(const Req* a,
+                                                 const Req* b) const {
+  if (a->start_tag != b->start_tag) {
+    return a->start_tag < b->start_tag;
+  }
+  return a->seq < b->seq;
+}
+
+FairIOSchedulerImpl::FairIOSchedulerImpl(const FairIOSchedulerOptions& options,
+                                         Env* env)
+    : env_(env),
+      mode_(options.mode),
+      refill_period_us_(options.refill_period_us),
+      target_io_latency_us_(options.target_io_latency_us),
+      max_bytes_per_sec_(options.rate_bytes_per_sec),
+      rate_bytes_per_sec_(options.rate_bytes_per_sec),
+      refill_bytes_per_period_(
+          CalculateRefillBytesPerPeriod(options.rate_bytes_per_sec)),
+      available_bytes_(0),
+      next_refill_us_(NowMicrosMonotonic()),
+      virtual_time_(0),
+      next_seq_(0),
+      leader_(nullptr),
+      refills_since_tune_(0),
+      latency_sum_us_(0),
+      latency_count_(0) {
+  for (size_t i = 0; i < static_cast<size_t>(
+                             RateLimiter::IOClass::kNumIOClasses);
+       ++i) {
+    class_weights_[i] = 1;
+    if (i < options.class_weights.size() && options.class_weights[i] > 0) {
+      class_weights_[i] = options.class_weights[i];
+    }
+  }
+}
+
+FairIOSchedulerImpl::~FairIOSchedulerImpl() {
+  // Every tenant limiter holds a reference, nobody can be waiting here
+  assert(queue_.empty());
+}
+
+std::shared_ptr<RateLimiter> FairIOSchedulerImpl::NewTenantRateLimiter(
+    const std::string& name, uint32_t weight) {
+  assert(weight > 0);
+  size_t tenant;
+  {
+    MutexLock g(&mutex_);
+    tenant = tenants_.size();
+    tenants_.emplace_back();
+    tenants_.back().name = name;
+    tenants_.back().weight = std::max<uint32_t>(weight, 1);
+  }
+  return std::make_shared<FairTenantRateLimiter>(shared_from_this(), tenant);
+}
+
+void FairIOSchedulerImpl::SetBytesPerSecond(int64_t bytes_per_second) {
+  assert(bytes_per_second > 0);
+  MutexLock g(&mutex_);
+  max_bytes_per_sec_ = bytes_per_second;
+  SetBytesPerSecondLocked(bytes_per_second);
+}
+
+void FairIOSchedulerImpl::SetBytesPerSecondLocked(int64_t bytes_per_second) {
+  rate_bytes_per_sec_.store(bytes_per_second, std::memory_order_relaxed);
+  refill_bytes_per_period_.store(
+      CalculateRefillBytesPerPeriod(bytes_per_second),
+      std::memory_order_relaxed);
+}
+
+void FairIOSchedulerImpl::GetStats(std::vector<IOClassStats>* stats) const {
+  MutexLock g(&mutex_);
+  for (auto& tenant : tenants_) {
+    for (auto& flow : tenant.flows) {
+      if (flow.stats.requests > 0) {
+        stats->push_back(flow.stats);
+        stats->back().tenant = tenant.name;
+      }
+    }
+  }
+}
+
+int64_t FairIOSchedulerImpl::GetTotalBytesThrough(size_t tenant,
+                                                  Env::IOPriority pri) const {
+  MutexLock g(&mutex_);
+  auto& t = tenants_[tenant];
+  if (pri == Env::IO_TOTAL) {
+    return t.total_bytes_through[Env::IO_LOW] +
+           t.total_bytes_through[Env::IO_HIGH];
+  }
+  return t.total_bytes_through[pri];
+}
+
+int64_t FairIOSchedulerImpl::GetTotalRequests(size_t tenant,
+                                              Env::IOPriority pri) const {
+  MutexLock g(&mutex_);
+  auto& t = tenants_[tenant];
+  if (pri == Env::IO_TOTAL) {
+    return t.total_requests[Env::IO_LOW] + t.total_requests[Env::IO_HIGH];
+  }
+  return t.total_requests[pri];
+}
+
+RateLimiter::IOClass FairIOSchedulerImpl::Classify(Env::IOPriority pri) {
+  auto io_class = IOClassGuard::Current();
+  if (io_class == RateLimiter::IOClass::kUnknown) {
+    // Untagged threads: RocksDB issues flush I/O with high priority and
+    // compaction I/O with low priority
+    io_class = pri == Env::IO_HIGH ? RateLimiter::IOClass::kFlush
+                                   : RateLimiter::IOClass::kCompaction;
+  }
+  return io_class;
+}
+
+void FairIOSchedulerImpl::Request(size_t tenant, int64_t bytes,
+                                  Env::IOPriority pri, Statistics* stats) {
+  assert(bytes <= refill_bytes_per_period_.load(std::memory_order_relaxed));
+  TEST_SYNC_POINT("FairIOSchedulerImpl::Request");
+  auto io_class = Classify(pri);
+  MutexLock g(&mutex_);
+
+  auto& t = tenants_[tenant];
+  auto& flow = t.flows[static_cast<size_t>(io_class)];
+  flow.stats.io_class = io_class;
+  ++flow.stats.requests;
+  ++t.total_requests[pri];
+
+  double weight = static_cast<double>(t.weight) *
+                  class_weights_[static_cast<size_t>(io_class)];
+  double start_tag = std::max(virtual_time_, flow.finish_tag);
+  flow.finish_tag = start_tag + bytes / weight;
+
+  if (queue_.empty() && available_bytes_ >= bytes) {
+    available_bytes_ -= bytes;
+    virtual_time_ = start_tag;
+    flow.stats.bytes_through += bytes;
+    t.total_bytes_through[pri] += bytes;
+    return;
+  }
+
+  // Request cannot be satisfied at this moment, enqueue
+  uint64_t wait_start = NowMicrosMonotonic();
+  Req r(bytes, start_tag, next_seq_++, &mutex_);
+  queue_.insert(&r);
+  TEST_SYNC_POINT_CALLBACK("FairIOSchedulerImpl::Request:Enqueued", &r);
+  while (!r.granted) {
+    if (leader_ == nullptr) {
+      leader_ = &r;
+    }
+    if (leader_ == &r) {
+      uint64_t now = NowMicrosMonotonic();
+      if (now >= next_refill_us_) {
+        Refill();
+      } else {
+        RecordTick(stats, NUMBER_RATE_LIMITER_DRAINS);
+        r.cv.TimedWait(env_->NowMicros() + (next_refill_us_ - now));
+      }
+    } else {
+      // Waken up either granted or asked to participate leader election
+      r.cv.Wait();
+    }
+  }
+  if (leader_ == &r) {
+    leader_ = nullptr;
+    if (!queue_.empty()) {
+      (*queue_.begin())->cv.Signal();
+    }
+  }
+
+  uint64_t waited = NowMicrosMonotonic() - wait_start;
+  ++flow.stats.waited_requests;
+  flow.stats.total_wait_micros += waited;
+  flow.stats.max_wait_micros = std::max(flow.stats.max_wait_micros, waited);
+  flow.stats.bytes_through += bytes;
+  t.total_bytes_through[pri] += bytes;
+}
+
+void FairIOSchedulerImpl::Refill() {
+  TEST_SYNC_POINT("FairIOSchedulerImpl::Refill");
+  next_refill_us_ = NowMicrosMonotonic() + refill_period_us_;
+  // Carry over the left over quota from the last period
+  auto refill_bytes_per_period =
+      refill_bytes_per_period_.load(std::memory_order_relaxed);
+  if (available_bytes_ < refill_bytes_per_period) {
+    available_bytes_ += refill_bytes_per_period;
+  }
+
+  while (!queue_.empty()) {
+    auto* next_req = *queue_.begin();
+    if (available_bytes_ < next_req->request_bytes) {
+      // avoid starvation
+      next_req->request_bytes -= available_bytes_;
+      available_bytes_ = 0;
+      break;
+    }
+    available_bytes_ -= next_req->request_bytes;
+    next_req->request_bytes = 0;
+    queue_.erase(queue_.begin());
+    virtual_time_ = std::max(virtual_time_, next_req->start_tag);
+
+    next_req->granted = true;
+    if (next_req != leader_) {
+      // Quota granted, signal the thread
+      next_req->cv.Signal();
+    }
+  }
+
+  if (target_io_latency_us_ > 0) {
+    static const uint64_t kRefillsPerTune = 10;
+    if (++refills_since_tune_ >= kRefillsPerTune) {
+      Tune();
+    }
+  }
+}
+
+void FairIOSchedulerImpl::ReportIOLatency(size_t /*bytes*/, uint64_t micros) {
+  if (target_io_latency_us_ == 0) {
+    return;
+  }
+  MutexLock g(&mutex_);
+  latency_sum_us_ += micros;
+  ++latency_count_;
+}
+
+void FairIOSchedulerImpl::Tune() {
+  const int kAdjustFactorPct = 5;
+  // computed rate limit will be in
+  // `[max_bytes_per_sec_ / kAllowedRangeFactor, max_bytes_per_sec_]`.
+  const int kAllowedRangeFactor = 20;
+
+  refills_since_tune_ = 0;
+  if (latency_count_ == 0) {
+    return;
+  }
+  uint64_t avg_latency_us = latency_sum_us_ / latency_count_;
+  latency_sum_us_ = 0;
+  latency_count_ = 0;
+
+  int64_t prev_bytes_per_sec = GetBytesPerSecond();
+  int64_t new_bytes_per_sec = prev_bytes_per_sec;
+  if (avg_latency_us > target_io_latency_us_) {
+    new_bytes_per_sec =
+        std::max(max_bytes_per_sec_ / kAllowedRangeFactor,
+                 prev_bytes_per_sec / (100 + kAdjustFactorPct) * 100);
+  } else if (avg_latency_us < target_io_latency_us_ / 2 && !queue_.empty()) {
+    // Device has headroom and there is demand
+    new_bytes_per_sec =
+        std::min(max_bytes_per_sec_,
+                 prev_bytes_per_sec / 100 * (100 + kAdjustFactorPct));
+  }
+  if (new_bytes_per_sec != prev_bytes_per_sec) {
+    SetBytesPerSecondLocked(new_bytes_per_sec);
+  }
+}
+
+int64_t FairIOSchedulerImpl::CalculateRefillBytesPerPeriod(
+    int64_t rate_bytes_per_sec) const {
+  if (port::kMaxInt64 / rate_bytes_per_sec < refill_period_us_) {
+    // Avoid unexpected result in the overflow case. The result now is still
+    // inaccurate but is a number that is large enough.
+    return port::kMaxInt64 / 1000000;
+  } else {
+    return std::max(kMinRefillBytesPerPeriod,
+                    rate_bytes_per_sec * refill_period_us_ / 1000000);
+  }
+}
+
+std::shared_ptr<FairIOScheduler> NewFairIOScheduler(
+    const FairIOSchedulerOptions& options) {
+  assert(options.rate_bytes_per_sec > 0);
+  assert(options.refill_period_us > 0);
+  return std::make_shared<FairIOSchedulerImpl>(options, Env::Default());
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,123 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/env.h"
+#include "rocksdb/rate_limiter.h"
+
+namespace rocksdb {
+
+// Start-time fair queuing over (tenant, IOClass) flows. Every request gets a
+// start tag max(virtual time, finish tag of its flow) and advances the finish
+// tag of the flow by bytes / weight. Tokens are refilled every
+// refill_period_us and handed to the queued requests in start tag order.
+class FairIOSchedulerImpl
+    : public FairIOScheduler,
+      public std::enable_shared_from_this<FairIOSchedulerImpl> {
+ public:
+  FairIOSchedulerImpl(const FairIOSchedulerOptions& options, Env* env);
+
+  virtual ~FairIOSchedulerImpl();
+
+  virtual std::shared_ptr<RateLimiter> NewTenantRateLimiter(
+      const std::string& name, uint32_t weight) override;
+
+  virtual void SetBytesPerSecond(int64_t bytes_per_second) override;
+
+  virtual int64_t GetBytesPerSecond() const override {
+    return rate_bytes_per_sec_.load(std::memory_order_relaxed);
+  }
+
+  virtual void GetStats(std::vector<IOClassStats>* stats) const override;
+
+  // Entry points of the tenant limiters
+  void Request(size_t tenant, int64_t bytes, Env::IOPriority pri,
+               Statistics* stats);
+
+  void ReportIOLatency(size_t bytes, uint64_t micros);
+
+  int64_t GetSingleBurstBytes() const {
+    return refill_bytes_per_period_.load(std::memory_order_relaxed);
+  }
+
+  int64_t GetTotalBytesThrough(size_t tenant, Env::IOPriority pri) const;
+
+  int64_t GetTotalRequests(size_t tenant, Env::IOPriority pri) const;
+
+  RateLimiter::Mode mode() const { return mode_; }
+
+ private:
+  struct Req;
+  struct ReqCompare {
+    bool operator()(const Req* a, const Req* b) const;
+  };
+
+  struct Flow {
+    double finish_tag = 0;
+    IOClassStats stats;
+  };
+
+  struct Tenant {
+    std::string name;
+    uint32_t weight;
+    Flow flows[static_cast<size_t>(RateLimiter::IOClass::kNumIOClasses)];
+    int64_t total_requests[Env::IO_TOTAL] = {0, 0};
+    int64_t total_bytes_through[Env::IO_TOTAL] = {0, 0};
+  };
+
+  static RateLimiter::IOClass Classify(Env::IOPriority pri);
+
+  // REQUIRED: mutex_ held
+  void Refill();
+  void Tune();
+  void SetBytesPerSecondLocked(int64_t bytes_per_second);
+
+  int64_t CalculateRefillBytesPerPeriod(int64_t rate_bytes_per_sec) const;
+
+  uint64_t NowMicrosMonotonic() const {
+    return env_->NowNanos() / std::milli::den;
+  }
+
+  mutable port::Mutex mutex_;
+  Env* const env_;
+  const RateLimiter::Mode mode_;
+  const int64_t kMinRefillBytesPerPeriod = 100;
+  const int64_t refill_period_us_;
+  const uint64_t target_io_latency_us_;
+  uint32_t class_weights_[static_cast<size_t>(
+      RateLimiter::IOClass::kNumIOClasses)];
+
+  // Upper bound of the auto tuned rate, the rate set by user
+  int64_t max_bytes_per_sec_;
+  std::atomic<int64_t> rate_bytes_per_sec_;
+  std::atomic<int64_t> refill_bytes_per_period_;
+
+  int64_t available_bytes_;
+  uint64_t next_refill_us_;
+  double virtual_time_;
+  uint64_t next_seq_;
+  std::set<Req*, ReqCompare> queue_;
+  // The queued request which waits for the next refill, all others wait for
+  // being granted or for becoming the leader
+  Req* leader_;
+
+  // Never shrinks, tenants are addressed by index
+  std::deque<Tenant> tenants_;
+
+  uint64_t refills_since_tune_;
+  uint64_t latency_sum_us_;
+  uint64_t latency_count_;
+};
+
+}  // namespace rocksdb
@@ -10,6 +10,7 @@
 #include "util/file_reader_writer.h"
 
 #include <algorithm>
+#include <chrono>
 #include <mutex>
 
 #include "monitoring/histogram.h"
@@ -25,6 +26,14 @@
 
 namespace rocksdb {
 
+namespace {
+uint64_t ElapsedMicros(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+}  // namespace
+
 #ifndef NDEBUG
 namespace {
 bool IsFileSectorAligned(const size_t off, size_t sector_size) {
@@ -183,6 +192,11 @@ Status RandomAccessFileReader::Read(uint64_t offset, size_t n, Slice* result,
           start_ts = std::chrono::system_clock::now();
         }
 #endif
+        const bool report_latency = for_compaction_ && rate_limiter_ != nullptr;
+        std::chrono::steady_clock::time_point io_start;
+        if (report_latency) {
+          io_start = std::chrono::steady_clock::now();
+        }
         // this is a workaround for resolve non-TerarkZipTable using mmap read
         // will OOM use 'static' for 'init on first use'
         if (use_fsread_) {
@@ -190,6 +204,10 @@ Status RandomAccessFileReader::Read(uint64_t offset, size_t n, Slice* result,
         } else {
           s = file_->Read(offset + pos, allowed, &tmp_result, scratch + pos);
         }
+        if (report_latency) {
+          rate_limiter_->ReportIOLatency(allowed, ElapsedMicros(io_start),
+                                         RateLimiter::OpType::kRead);
+        }
 #ifndef ROCKSDB_LITE
         if (ShouldNotifyListeners()) {
           auto finish_ts = std::chrono::system_clock::now();
@@ -221,6 +239,53 @@ Status RandomAccessFileReader::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+Status RandomAccessFileReader::MultiRead(ReadRequest* reqs,
+                                         size_t num_reqs) const {
+  if (use_direct_io() || use_fsread_ ||
+      (for_compaction_ && rate_limiter_ != nullptr)) {
+    for (size_t i = 0; i < num_reqs; ++i) {
+      ReadRequest& req = reqs[i];
+      req.status = Read(req.offset, req.len, &req.result, req.scratch);
+    }
+    return Status::OK();
+  }
+  Status s;
+  uint64_t elapsed = 0;
+  {
+    StopWatch sw(env_, stats_, hist_type_,
+                 (stats_ != nullptr) ? &elapsed : nullptr, true /*overwrite*/,
+                 true /*delay_enabled*/);
+    IOSTATS_TIMER_GUARD(read_nanos);
+#ifndef ROCKSDB_LITE
+    FileOperationInfo::TimePoint start_ts;
+    if (ShouldNotifyListeners()) {
+      start_ts = std::chrono::system_clock::now();
+    }
+#endif
+    s = file_->MultiRead(reqs, num_reqs);
+    for (size_t i = 0; i < num_reqs; ++i) {
+      ReadRequest& req = reqs[i];
+      if (s.ok()) {
+        IOSTATS_ADD_IF_POSITIVE(bytes_read, req.result.size());
+      } else {
+        req.status = s;
+        req.result = Slice(req.scratch, 0);
+      }
+#ifndef ROCKSDB_LITE
+      if (ShouldNotifyListeners()) {
+        auto finish_ts = std::chrono::system_clock::now();
+        NotifyOnFileReadFinish(req.offset, req.result.size(), start_ts,
+                               finish_ts, req.status);
+      }
+#endif
+    }
+  }
+  if (stats_ != nullptr && file_read_hist_ != nullptr) {
+    file_read_hist_->Add(elapsed);
+  }
+  return s;
+}
+
 Status WritableFileWriter::Append(const Slice& data) {
   const char* src = data.data();
   size_t left = data.size();
@@ -418,11 +483,22 @@ Status WritableFileWriter::SyncInternal(bool use_fsync) {
   Status s;
   IOSTATS_TIMER_GUARD(fsync_nanos);
   TEST_SYNC_POINT("WritableFileWriter::SyncInternal:0");
+  // Buffered appends only reach the page cache, the device latency of a
+  // buffered file shows up here and in RangeSync()
+  std::chrono::steady_clock::time_point io_start;
+  if (rate_limiter_ != nullptr) {
+    io_start = std::chrono::steady_clock::now();
+  }
   if (use_fsync) {
     s = writable_file_->Fsync();
   } else {
     s = writable_file_->Sync();
   }
+  if (rate_limiter_ != nullptr) {
+    rate_limiter_->ReportIOLatency(
+        static_cast<size_t>(filesize_ - last_sync_size_),
+        ElapsedMicros(io_start), RateLimiter::OpType::kWrite);
+  }
   return s;
 }
 
@@ -461,7 +537,15 @@ Status WritableFileWriter::AutoRangeSync(uint64_t filesize_for_sync) {
 Status WritableFileWriter::RangeSync(uint64_t offset, uint64_t nbytes) {
   IOSTATS_TIMER_GUARD(range_sync_nanos);
   TEST_SYNC_POINT("WritableFileWriter::RangeSync:0");
-  return writable_file_->RangeSync(offset, nbytes);
+  if (rate_limiter_ == nullptr) {
+    return writable_file_->RangeSync(offset, nbytes);
+  }
+  auto io_start = std::chrono::steady_clock::now();
+  Status s = writable_file_->RangeSync(offset, nbytes);
+  rate_limiter_->ReportIOLatency(static_cast<size_t>(nbytes),
+                                 ElapsedMicros(io_start),
+                                 RateLimiter::OpType::kWrite);
+  return s;
 }
 
 // This method writes to disk the specified data and makes use of the rate
@@ -575,7 +659,15 @@ Status WritableFileWriter::WriteDirect() {
         start_ts = std::chrono::system_clock::now();
       }
       // direct writes must be positional
+      std::chrono::steady_clock::time_point io_start;
+      if (rate_limiter_ != nullptr) {
+        io_start = std::chrono::steady_clock::now();
+      }
       s = writable_file_->PositionedAppend(Slice(src, size), write_offset);
+      if (rate_limiter_ != nullptr) {
+        rate_limiter_->ReportIOLatency(
+            size, ElapsedMicros(io_start), RateLimiter::OpType::kWrite);
+      }
       if (ShouldNotifyListeners()) {
         auto finish_ts = std::chrono::system_clock::now();
         NotifyOnFileWriteFinish(write_offset, size, start_ts, finish_ts, s);
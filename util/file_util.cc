@@ -14,6 +14,7 @@
 #include <string>
 
 #include "rocksdb/env.h"
+#include "util/crc32c.h"
 #include "util/file_reader_writer.h"
 #include "util/sst_file_manager_impl.h"
 
@@ -21,9 +22,13 @@ namespace rocksdb {
 
 // Utility function to copy a file up to a specified length
 Status CopyFile(Env* env, const std::string& source,
-                const std::string& destination, uint64_t size, bool use_fsync) {
+                const std::string& destination, uint64_t size, bool use_fsync,
+                uint32_t* checksum) {
   const EnvOptions soptions;
   Status s;
+  if (checksum != nullptr) {
+    *checksum = 0;
+  }
   std::unique_ptr<SequentialFileReader> src_reader;
   std::unique_ptr<WritableFileWriter> dest_writer;
 
@@ -66,6 +71,9 @@ Status CopyFile(Env* env, const std::string& source,
     if (!s.ok()) {
       return s;
     }
+    if (checksum != nullptr) {
+      *checksum = crc32c::Extend(*checksum, slice.data(), slice.size());
+    }
     size -= slice.size();
   }
   return dest_writer->Sync(use_fsync);
@@ -14,9 +14,10 @@
 namespace rocksdb {
 // use_fsync maps to options.use_fsync, which determines the way that
 // the file is synced after copying.
+// If checksum is not null, it is set to the crc32c of the bytes copied.
 extern Status CopyFile(Env* env, const std::string& source,
                        const std::string& destination, uint64_t size,
-                       bool use_fsync);
+                       bool use_fsync, uint32_t* checksum = nullptr);
 
 extern Status CreateFile(Env* env, const std::string& destination,
                          const std::string& contents, bool use_fsync);
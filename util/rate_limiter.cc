@@ -16,6 +16,53 @@
 
 namespace rocksdb {
 
+#ifdef ROCKSDB_SUPPORT_THREAD_LOCAL
+static __thread RateLimiter::IOClass tls_io_class =
+    RateLimiter::IOClass::kUnknown;
+#endif
+
+IOClassGuard::IOClassGuard(RateLimiter::IOClass io_class)
+    : prev_(Current()) {
+#ifdef ROCKSDB_SUPPORT_THREAD_LOCAL
+  tls_io_class = io_class;
+#else
+  (void)io_class;
+#endif
+}
+
+IOClassGuard::~IOClassGuard() {
+#ifdef ROCKSDB_SUPPORT_THREAD_LOCAL
+  tls_io_class = prev_;
+#endif
+}
+
+RateLimiter::IOClass IOClassGuard::Current() {
+#ifdef ROCKSDB_SUPPORT_THREAD_LOCAL
+  return tls_io_class;
+#else
+  return RateLimiter::IOClass::kUnknown;
+#endif
+}
+
+const char* IOClassName(RateLimiter::IOClass io_class) {
+  switch (io_class) {
+    case RateLimiter::IOClass::kFlush:
+      return "flush";
+    case RateLimiter::IOClass::kL0Compaction:
+      return "l0_compaction";
+    case RateLimiter::IOClass::kCompaction:
+      return "compaction";
+    case RateLimiter::IOClass::kGarbageCollection:
+      return "garbage_collection";
+    case RateLimiter::IOClass::kBackup:
+      return "backup";
+    case RateLimiter::IOClass::kIngest:
+      return "ingest";
+    default:
+      return "unknown";
+  }
+}
+
 size_t RateLimiter::RequestToken(size_t bytes, size_t alignment,
                                  Env::IOPriority io_priority, Statistics* stats,
                                  RateLimiter::OpType op_type) {
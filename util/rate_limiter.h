@@ -110,4 +110,22 @@ class GenericRateLimiter : public RateLimiter {
   std::chrono::microseconds tuned_time_;
 };
 
+// Tags the rate limited I/O issued by the calling thread with an IOClass for
+// the lifetime of the guard. Guards nest, the innermost one wins.
+class IOClassGuard {
+ public:
+  explicit IOClassGuard(RateLimiter::IOClass io_class);
+  ~IOClassGuard();
+
+  IOClassGuard(const IOClassGuard&) = delete;
+  IOClassGuard& operator=(const IOClassGuard&) = delete;
+
+  // IOClass of the calling thread, kUnknown if no guard is alive or thread
+  // local storage is not supported.
+  static RateLimiter::IOClass Current();
+
+ private:
+  RateLimiter::IOClass prev_;
+};
+
 }  // namespace rocksdb
@@ -14,11 +14,14 @@
 #include "util/rate_limiter.h"
 
 #include <inttypes.h>
+#include <atomic>
 #include <chrono>
 #include <limits>
+#include <thread>
 
 #include "db/db_test_util.h"
 #include "rocksdb/env.h"
+#include "util/fair_io_scheduler.h"
 #include "util/random.h"
 #include "util/sync_point.h"
 #include "util/testharness.h"
@@ -231,6 +234,127 @@ TEST_F(RateLimiterTest, AutoTuneIncreaseWhenFull) {
   ASSERT_LT(new_bytes_per_sec, orig_bytes_per_sec);
 }
 
+TEST_F(RateLimiterTest, IOClassGuard) {
+  ASSERT_EQ(RateLimiter::IOClass::kUnknown, IOClassGuard::Current());
+  {
+    IOClassGuard flush(RateLimiter::IOClass::kFlush);
+    ASSERT_EQ(RateLimiter::IOClass::kFlush, IOClassGuard::Current());
+    {
+      IOClassGuard backup(RateLimiter::IOClass::kBackup);
+      ASSERT_EQ(RateLimiter::IOClass::kBackup, IOClassGuard::Current());
+    }
+    ASSERT_EQ(RateLimiter::IOClass::kFlush, IOClassGuard::Current());
+  }
+  ASSERT_EQ(RateLimiter::IOClass::kUnknown, IOClassGuard::Current());
+}
+
+TEST_F(RateLimiterTest, FairIOSchedulerWeights) {
+  // The clock only moves when the test advances it, every advance by one
+  // refill period grants exactly one queued request
+  SpecialEnv special_env(Env::Default());
+  special_env.no_slowdown_ = true;
+  special_env.time_elapse_only_sleep_ = true;
+  FairIOSchedulerOptions options;
+  options.rate_bytes_per_sec = 100 * 1024;
+  options.refill_period_us = 10 * 1000;
+  auto scheduler = std::make_shared<FairIOSchedulerImpl>(options, &special_env);
+  auto warmup = scheduler->NewTenantRateLimiter("warmup", 1);
+  auto light = scheduler->NewTenantRateLimiter("light", 1);
+  auto heavy = scheduler->NewTenantRateLimiter("heavy", 3);
+  const int64_t burst = light->GetSingleBurstBytes();
+  ASSERT_EQ(burst, heavy->GetSingleBurstBytes());
+
+  // Consume the initial refill, so that every later request has to queue
+  warmup->Request(burst, Env::IO_LOW, nullptr /* stats */,
+                  RateLimiter::OpType::kWrite);
+
+  std::atomic<int> enqueued(0);
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "FairIOSchedulerImpl::Request:Enqueued",
+      [&](void* /*arg*/) { enqueued.fetch_add(1); });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  const int kRequestsPerTenant = 4;
+  port::Mutex mutex;
+  std::vector<std::string> granted;
+  std::vector<std::thread> threads;
+  for (auto* tenant : {"light", "heavy"}) {
+    auto limiter = std::string(tenant) == "light" ? light : heavy;
+    for (int i = 0; i < kRequestsPerTenant; ++i) {
+      threads.emplace_back([&, tenant, limiter] {
+        IOClassGuard io_class_guard(RateLimiter::IOClass::kCompaction);
+        limiter->Request(burst, Env::IO_LOW, nullptr /* stats */,
+                         RateLimiter::OpType::kWrite);
+        MutexLock l(&mutex);
+        granted.emplace_back(tenant);
+      });
+    }
+  }
+  while (enqueued.load() < 2 * kRequestsPerTenant) {
+    std::this_thread::yield();
+  }
+  for (size_t i = 1; i <= 2 * kRequestsPerTenant; ++i) {
+    special_env.SleepForMicroseconds(
+        static_cast<int>(options.refill_period_us));
+    size_t num_granted = 0;
+    while (num_granted < i) {
+      std::this_thread::yield();
+      MutexLock l(&mutex);
+      num_granted = granted.size();
+    }
+    ASSERT_EQ(i, num_granted);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // Start tags of light are 0, 1, 2, 3 bursts, of heavy 0, 1/3, 2/3, 1 burst
+  int heavy_first = 0;
+  for (int i = 0; i < kRequestsPerTenant; ++i) {
+    heavy_first += granted[i] == "heavy";
+  }
+  ASSERT_EQ(3, heavy_first);
+  ASSERT_EQ("light", granted.back());
+
+  ASSERT_EQ(kRequestsPerTenant * burst, light->GetTotalBytesThrough());
+  ASSERT_EQ(kRequestsPerTenant * burst, heavy->GetTotalBytesThrough());
+  std::vector<IOClassStats> stats;
+  scheduler->GetStats(&stats);
+  ASSERT_EQ(3, stats.size());
+  for (auto& s : stats) {
+    ASSERT_EQ(RateLimiter::IOClass::kCompaction, s.io_class);
+    if (s.tenant != "warmup") {
+      ASSERT_EQ(kRequestsPerTenant * burst,
+                static_cast<int64_t>(s.bytes_through));
+      ASSERT_EQ(static_cast<uint64_t>(kRequestsPerTenant), s.waited_requests);
+    }
+  }
+}
+
+TEST_F(RateLimiterTest, FairIOSchedulerClassifyByPriority) {
+  FairIOSchedulerOptions options;
+  options.rate_bytes_per_sec = 1024 * 1024;
+  auto scheduler = NewFairIOScheduler(options);
+  auto limiter = scheduler->NewTenantRateLimiter("t");
+  limiter->Request(10, Env::IO_HIGH, nullptr, RateLimiter::OpType::kWrite);
+  limiter->Request(20, Env::IO_LOW, nullptr, RateLimiter::OpType::kWrite);
+  // Reads are not limited in kWritesOnly mode
+  limiter->Request(40, Env::IO_LOW, nullptr, RateLimiter::OpType::kRead);
+  ASSERT_EQ(10, limiter->GetTotalBytesThrough(Env::IO_HIGH));
+  ASSERT_EQ(20, limiter->GetTotalBytesThrough(Env::IO_LOW));
+  ASSERT_EQ(2, limiter->GetTotalRequests());
+
+  std::vector<IOClassStats> stats;
+  scheduler->GetStats(&stats);
+  ASSERT_EQ(2, stats.size());
+  ASSERT_EQ(RateLimiter::IOClass::kFlush, stats[0].io_class);
+  ASSERT_EQ(10, stats[0].bytes_through);
+  ASSERT_EQ(RateLimiter::IOClass::kCompaction, stats[1].io_class);
+  ASSERT_EQ(20, stats[1].bytes_through);
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
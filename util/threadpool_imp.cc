@@ -57,6 +57,8 @@ struct ThreadPoolImpl::Impl {
 
   void LowerCPUPriority();
 
+  void BindToNumaNodes();
+
   void WakeUpAllThreads() { bgsignal_.notify_all(); }
 
   void BGThread(size_t thread_id);
@@ -99,6 +101,7 @@ struct ThreadPoolImpl::Impl {
 
   bool low_io_priority_;
   bool low_cpu_priority_;
+  bool numa_bind_;
   Env::Priority priority_;
   Env* env_;
 
@@ -125,6 +128,7 @@ struct ThreadPoolImpl::Impl {
 inline ThreadPoolImpl::Impl::Impl()
     : low_io_priority_(false),
       low_cpu_priority_(false),
+      numa_bind_(false),
       priority_(Env::LOW),
       env_(nullptr),
       total_threads_limit_(0),
@@ -172,9 +176,15 @@ inline void ThreadPoolImpl::Impl::LowerCPUPriority() {
   low_cpu_priority_ = true;
 }
 
+inline void ThreadPoolImpl::Impl::BindToNumaNodes() {
+  std::lock_guard<std::mutex> lock(mu_);
+  numa_bind_ = true;
+}
+
 void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
   bool low_io_priority = false;
   bool low_cpu_priority = false;
+  bool numa_bind = false;
 
   while (true) {
     // Wait until there is an item that is ready to run
@@ -215,8 +225,17 @@ void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
 
     bool decrease_io_priority = (low_io_priority != low_io_priority_);
     bool decrease_cpu_priority = (low_cpu_priority != low_cpu_priority_);
+    bool bind_numa_node = (numa_bind != numa_bind_);
     lock.unlock();
 
+    if (bind_numa_node) {
+      int nodes = port::NumaNodeCount();
+      if (nodes > 1) {
+        port::BindThreadToNumaNode(static_cast<int>(thread_id % nodes));
+      }
+      numa_bind = true;
+    }
+
 #ifdef OS_LINUX
     if (decrease_cpu_priority) {
       setpriority(PRIO_PROCESS,
@@ -428,6 +447,8 @@ void ThreadPoolImpl::LowerIOPriority() { impl_->LowerIOPriority(); }
 
 void ThreadPoolImpl::LowerCPUPriority() { impl_->LowerCPUPriority(); }
 
+void ThreadPoolImpl::BindToNumaNodes() { impl_->BindToNumaNodes(); }
+
 void ThreadPoolImpl::IncBackgroundThreadsIfNeeded(int num) {
   impl_->SetBackgroundThreadsInternal(num, false);
 }
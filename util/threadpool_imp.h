@@ -53,6 +53,10 @@ class ThreadPoolImpl : public ThreadPool {
   // Currently only has effect on Linux
   void LowerCPUPriority();
 
+  // Make thread i to run on the cpus of NUMA node i % nodes
+  // Only has effect if built with NUMA
+  void BindToNumaNodes();
+
   // Ensure there is at aleast num threads in the pool
   // but do not kill threads if there are more
   void IncBackgroundThreadsIfNeeded(int num);
@@ -19,6 +19,7 @@
 #include "util/file_reader_writer.h"
 #include "util/filename.h"
 #include "util/logging.h"
+#include "util/rate_limiter.h"
 #include "util/string_util.h"
 #include "util/sync_point.h"
 #include "utilities/checkpoint/checkpoint_impl.h"
@@ -1219,6 +1220,7 @@ Status BackupEngineImpl::CopyOrCreateFile(
     RateLimiter* rate_limiter, uint64_t* size, uint32_t* checksum_value,
     uint64_t size_limit, std::function<void()> progress_callback) {
   assert(src.empty() != contents.empty());
+  IOClassGuard io_class_guard(RateLimiter::IOClass::kBackup);
   Status s;
   std::unique_ptr<WritableFile> dst_file;
   std::unique_ptr<SequentialFile> src_file;
@@ -17,6 +17,8 @@
 
 #include <inttypes.h>
 #include <algorithm>
+#include <atomic>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -26,8 +28,11 @@
 #include "rocksdb/env.h"
 #include "rocksdb/transaction_log.h"
 #include "rocksdb/utilities/checkpoint.h"
+#include "util/crc32c.h"
+#include "util/file_reader_writer.h"
 #include "util/file_util.h"
 #include "util/filename.h"
+#include "util/string_util.h"
 #include "util/sync_point.h"
 
 namespace rocksdb {
@@ -42,6 +47,41 @@ Status Checkpoint::CreateCheckpoint(const std::string& /*checkpoint_dir*/,
   return Status::NotSupported("");
 }
 
+Status Checkpoint::CreateIncrementalCheckpoint(
+    const std::string& /*base_checkpoint_dir*/,
+    const std::string& /*checkpoint_dir*/, uint64_t /*log_size_for_flush*/,
+    int /*max_background_copies*/, bool /*verify_checksum*/) {
+  return Status::NotSupported("");
+}
+
+namespace {
+
+const char* kCheckpointDeltaFileName = "/CHECKPOINT_DELTA";
+const size_t kChecksumBufferSize = 1 << 20;
+
+Status ComputeFileChecksum(Env* env, const std::string& fname,
+                           uint32_t* checksum) {
+  *checksum = 0;
+  std::unique_ptr<SequentialFile> file;
+  Status s = env->NewSequentialFile(fname, &file, EnvOptions());
+  if (!s.ok()) {
+    return s;
+  }
+  SequentialFileReader reader(std::move(file), fname);
+  std::unique_ptr<char[]> buffer(new char[kChecksumBufferSize]);
+  Slice data;
+  do {
+    s = reader.Read(kChecksumBufferSize, &data, buffer.get());
+    if (!s.ok()) {
+      return s;
+    }
+    *checksum = crc32c::Extend(*checksum, data.data(), data.size());
+  } while (data.size() > 0);
+  return s;
+}
+
+}  // namespace
+
 void CheckpointImpl::CleanStagingDirectory(
     const std::string& full_private_path, Logger* info_log) {
     std::vector<std::string> subchildren;
@@ -64,9 +104,11 @@ void CheckpointImpl::CleanStagingDirectory(
                  full_private_path.c_str(), s.ToString().c_str());
 }
 
-// Builds an openable snapshot of RocksDB
-Status CheckpointImpl::CreateCheckpoint(const std::string& checkpoint_dir,
-                                        uint64_t log_size_for_flush) {
+Status CheckpointImpl::CreateCheckpointThroughStaging(
+    const std::string& checkpoint_dir,
+    const std::function<Status(const std::string& staging_dir,
+                               const DBOptions& db_options,
+                               uint64_t* sequence_number)>& build) {
   DBOptions db_options = db_->GetDBOptions();
 
   Status s = db_->GetEnv()->FileExists(checkpoint_dir);
@@ -103,27 +145,7 @@ Status CheckpointImpl::CreateCheckpoint(const std::string& checkpoint_dir,
   uint64_t sequence_number = 0;
   if (s.ok()) {
     db_->DisableFileDeletions();
-    s = CreateCustomCheckpoint(
-        db_options,
-        [&](const std::string& src_dirname, const std::string& fname,
-            FileType) {
-          ROCKS_LOG_INFO(db_options.info_log, "Hard Linking %s", fname.c_str());
-          return db_->GetEnv()->LinkFile(src_dirname + fname,
-                                         full_private_path + fname);
-        } /* link_file_cb */,
-        [&](const std::string& src_dirname, const std::string& fname,
-            uint64_t size_limit_bytes, FileType) {
-          ROCKS_LOG_INFO(db_options.info_log, "Copying %s", fname.c_str());
-          return CopyFile(db_->GetEnv(), src_dirname + fname,
-                          full_private_path + fname, size_limit_bytes,
-                          db_options.use_fsync);
-        } /* copy_file_cb */,
-        [&](const std::string& fname, const std::string& contents, FileType) {
-          ROCKS_LOG_INFO(db_options.info_log, "Creating %s", fname.c_str());
-          return CreateFile(db_->GetEnv(), full_private_path + fname, contents,
-                            db_options.use_fsync);
-        } /* create_file_cb */,
-        &sequence_number, log_size_for_flush);
+    s = build(full_private_path, db_options, &sequence_number);
     // we copied all the files, enable file deletions
     db_->EnableFileDeletions(false);
   }
@@ -154,6 +176,240 @@ Status CheckpointImpl::CreateCheckpoint(const std::string& checkpoint_dir,
   return s;
 }
 
+// Builds an openable snapshot of RocksDB
+Status CheckpointImpl::CreateCheckpoint(const std::string& checkpoint_dir,
+                                        uint64_t log_size_for_flush) {
+  return CreateCheckpointThroughStaging(
+      checkpoint_dir, [&](const std::string& full_private_path,
+                          const DBOptions& db_options,
+                          uint64_t* sequence_number) {
+        return CreateCustomCheckpoint(
+            db_options,
+            [&](const std::string& src_dirname, const std::string& fname,
+                FileType) {
+              ROCKS_LOG_INFO(db_options.info_log, "Hard Linking %s",
+                             fname.c_str());
+              return db_->GetEnv()->LinkFile(src_dirname + fname,
+                                             full_private_path + fname);
+            } /* link_file_cb */,
+            [&](const std::string& src_dirname, const std::string& fname,
+                uint64_t size_limit_bytes, FileType) {
+              ROCKS_LOG_INFO(db_options.info_log, "Copying %s", fname.c_str());
+              return CopyFile(db_->GetEnv(), src_dirname + fname,
+                              full_private_path + fname, size_limit_bytes,
+                              db_options.use_fsync);
+            } /* copy_file_cb */,
+            [&](const std::string& fname, const std::string& contents,
+                FileType) {
+              ROCKS_LOG_INFO(db_options.info_log, "Creating %s", fname.c_str());
+              return CreateFile(db_->GetEnv(), full_private_path + fname,
+                                contents, db_options.use_fsync);
+            } /* create_file_cb */,
+            sequence_number, log_size_for_flush);
+      });
+}
+
+Status CheckpointImpl::CreateIncrementalCheckpoint(
+    const std::string& base_checkpoint_dir, const std::string& checkpoint_dir,
+    uint64_t log_size_for_flush, int max_background_copies,
+    bool verify_checksum) {
+  if (base_checkpoint_dir.empty()) {
+    return Status::InvalidArgument("invalid base checkpoint directory name");
+  }
+  return CreateCheckpointThroughStaging(
+      checkpoint_dir, [&](const std::string& full_private_path,
+                          const DBOptions& db_options,
+                          uint64_t* sequence_number) {
+        return BuildIncrementalCheckpoint(
+            base_checkpoint_dir, full_private_path, db_options,
+            log_size_for_flush, max_background_copies, verify_checksum,
+            sequence_number);
+      });
+}
+
+Status CheckpointImpl::BuildIncrementalCheckpoint(
+    const std::string& base_checkpoint_dir,
+    const std::string& full_private_path, const DBOptions& db_options,
+    uint64_t log_size_for_flush, int max_background_copies,
+    bool verify_checksum, uint64_t* sequence_number) {
+  // SST files of the base checkpoint, file number to name and size. The SST
+  // files linked from the base are removed, what remains was deleted since.
+  std::map<uint64_t, std::pair<std::string, uint64_t>> base_files;
+  std::vector<std::string> children;
+  Status s = db_->GetEnv()->GetChildren(base_checkpoint_dir, &children);
+  for (size_t i = 0; s.ok() && i < children.size(); ++i) {
+    uint64_t number;
+    FileType type;
+    if (!ParseFileName(children[i], &number, &type) || type != kTableFile) {
+      continue;
+    }
+    uint64_t size;
+    s = db_->GetEnv()->GetFileSize(base_checkpoint_dir + "/" + children[i],
+                                   &size);
+    base_files.emplace(number, std::make_pair(children[i], size));
+  }
+  if (!s.ok()) {
+    return s;
+  }
+
+  std::vector<CopyJob> copy_jobs;
+  std::vector<std::string> new_table_files;
+  std::string manifest_fname;
+  uint64_t manifest_file_size = 0;
+
+  // SST files never change once written, the one of the base with the same
+  // number and size is the same file
+  auto link_base_file = [&](const std::string& src_dirname,
+                            const std::string& fname, FileType type) {
+    uint64_t number, size;
+    auto it = base_files.end();
+    if (type == kTableFile && ParseFileName(fname, &number, &type)) {
+      it = base_files.find(number);
+    }
+    if (it == base_files.end() ||
+        !db_->GetEnv()->GetFileSize(src_dirname + fname, &size).ok() ||
+        size != it->second.second) {
+      return false;
+    }
+    Status link_status = db_->GetEnv()->LinkFile(
+        base_checkpoint_dir + "/" + it->second.first,
+        full_private_path + fname);
+    if (!link_status.ok()) {
+      ROCKS_LOG_WARN(db_options.info_log,
+                     "Hard linking %s from base checkpoint failed -- %s",
+                     fname.c_str(), link_status.ToString().c_str());
+      return false;
+    }
+    ROCKS_LOG_INFO(db_options.info_log, "Hard Linking %s from base checkpoint",
+                   fname.c_str());
+    base_files.erase(it);
+    return true;
+  };
+
+  s = CreateCustomCheckpoint(
+      db_options,
+      [&](const std::string& src_dirname, const std::string& fname,
+          FileType type) {
+        if (link_base_file(src_dirname, fname, type)) {
+          return Status::OK();
+        }
+        ROCKS_LOG_INFO(db_options.info_log, "Hard Linking %s", fname.c_str());
+        Status link_status = db_->GetEnv()->LinkFile(
+            src_dirname + fname, full_private_path + fname);
+        if (link_status.ok() && type == kTableFile) {
+          new_table_files.push_back(fname);
+        }
+        return link_status;
+      } /* link_file_cb */,
+      [&](const std::string& src_dirname, const std::string& fname,
+          uint64_t size_limit_bytes, FileType type) {
+        if (link_base_file(src_dirname, fname, type)) {
+          return Status::OK();
+        }
+        if (type == kTableFile) {
+          new_table_files.push_back(fname);
+        } else if (type == kDescriptorFile) {
+          manifest_fname = fname;
+          manifest_file_size = size_limit_bytes;
+        }
+        // Copies are deferred so that they may run in parallel
+        copy_jobs.push_back(CopyJob{src_dirname + fname,
+                                    full_private_path + fname,
+                                    size_limit_bytes});
+        return Status::OK();
+      } /* copy_file_cb */,
+      [&](const std::string& fname, const std::string& contents, FileType) {
+        ROCKS_LOG_INFO(db_options.info_log, "Creating %s", fname.c_str());
+        return CreateFile(db_->GetEnv(), full_private_path + fname, contents,
+                          db_options.use_fsync);
+      } /* create_file_cb */,
+      sequence_number, log_size_for_flush);
+  if (s.ok()) {
+    s = CopyFiles(copy_jobs, max_background_copies, verify_checksum,
+                  db_options);
+  }
+  if (!s.ok()) {
+    return s;
+  }
+
+  std::string delta;
+  for (auto& fname : new_table_files) {
+    uint64_t size = 0;
+    s = db_->GetEnv()->GetFileSize(full_private_path + fname, &size);
+    if (!s.ok()) {
+      return s;
+    }
+    delta.append("+ " + fname.substr(1) + " " + ToString(size) + "\n");
+  }
+  for (auto& pair : base_files) {
+    delta.append("- " + pair.second.first + " " +
+                 ToString(pair.second.second) + "\n");
+  }
+  if (!manifest_fname.empty()) {
+    delta.append("manifest " + manifest_fname.substr(1) + " " +
+                 ToString(manifest_file_size) + "\n");
+  }
+  ROCKS_LOG_INFO(db_options.info_log,
+                 "Incremental snapshot -- %" ROCKSDB_PRIszt
+                 " new SST files, %" ROCKSDB_PRIszt " deleted since base",
+                 new_table_files.size(), base_files.size());
+  return CreateFile(db_->GetEnv(), full_private_path + kCheckpointDeltaFileName,
+                    delta, db_options.use_fsync);
+}
+
+Status CheckpointImpl::CopyFiles(const std::vector<CopyJob>& jobs,
+                                 int max_background_copies,
+                                 bool verify_checksum,
+                                 const DBOptions& db_options) {
+  Env* env = db_->GetEnv();
+  std::atomic<size_t> next_job(0);
+  std::atomic<bool> failed(false);
+  auto copy_files = [&]() {
+    for (size_t i = next_job.fetch_add(1); i < jobs.size() && !failed.load();
+         i = next_job.fetch_add(1)) {
+      const CopyJob& job = jobs[i];
+      ROCKS_LOG_INFO(db_options.info_log, "Copying %s", job.src.c_str());
+      uint32_t checksum = 0;
+      uint32_t copied_checksum = 0;
+      Status s = CopyFile(env, job.src, job.dst, job.size_limit,
+                          db_options.use_fsync,
+                          verify_checksum ? &checksum : nullptr);
+      if (s.ok() && verify_checksum) {
+        s = ComputeFileChecksum(env, job.dst, &copied_checksum);
+        if (s.ok() && checksum != copied_checksum) {
+          s = Status::Corruption("Checksum mismatch after copying", job.src);
+        }
+      }
+      if (!s.ok()) {
+        failed.store(true);
+        return s;
+      }
+    }
+    return Status::OK();
+  };
+  // Dedicated threads, file deletions are disabled until the copies are done,
+  // they must neither wait for nor hold up the background jobs of the DB
+  size_t num_threads = std::min(
+      jobs.size(), static_cast<size_t>(std::max(max_background_copies, 1)));
+  std::vector<Status> statuses(num_threads);
+  std::vector<port::Thread> threads;
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back([&, i] { statuses[i] = copy_files(); });
+  }
+  if (num_threads > 0) {
+    statuses[0] = copy_files();
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& status : statuses) {
+    if (!status.ok()) {
+      return status;
+    }
+  }
+  return Status::OK();
+}
+
 Status CheckpointImpl::CreateCustomCheckpoint(
     const DBOptions& db_options,
     std::function<Status(const std::string& src_dirname,
@@ -8,7 +8,9 @@
 
 #include "rocksdb/utilities/checkpoint.h"
 
+#include <functional>
 #include <string>
+#include <vector>
 #include "rocksdb/db.h"
 #include "util/filename.h"
 
@@ -30,6 +32,14 @@ class CheckpointImpl : public Checkpoint {
   virtual Status CreateCheckpoint(const std::string& checkpoint_dir,
                                   uint64_t log_size_for_flush) override;
 
+  // Builds an openable snapshot on top of an earlier checkpoint, linking the
+  // SST files the base already has and copying the others in parallel
+  using Checkpoint::CreateIncrementalCheckpoint;
+  virtual Status CreateIncrementalCheckpoint(
+      const std::string& base_checkpoint_dir,
+      const std::string& checkpoint_dir, uint64_t log_size_for_flush,
+      int max_background_copies, bool verify_checksum) override;
+
   // Checkpoint logic can be customized by providing callbacks for link, copy,
   // or create.
   Status CreateCustomCheckpoint(
@@ -47,6 +57,34 @@ class CheckpointImpl : public Checkpoint {
       uint64_t* sequence_number, uint64_t log_size_for_flush);
 
  private:
+  struct CopyJob {
+    std::string src;
+    std::string dst;
+    uint64_t size_limit;
+  };
+
+  // Validate checkpoint_dir, let build fill a staging directory with file
+  // deletions disabled, then rename it to checkpoint_dir. The staging
+  // directory is removed on failure.
+  Status CreateCheckpointThroughStaging(
+      const std::string& checkpoint_dir,
+      const std::function<Status(const std::string& staging_dir,
+                                 const DBOptions& db_options,
+                                 uint64_t* sequence_number)>& build);
+  // Fill full_private_path with the files of an incremental checkpoint and
+  // its CHECKPOINT_DELTA
+  Status BuildIncrementalCheckpoint(const std::string& base_checkpoint_dir,
+                                    const std::string& full_private_path,
+                                    const DBOptions& db_options,
+                                    uint64_t log_size_for_flush,
+                                    int max_background_copies,
+                                    bool verify_checksum,
+                                    uint64_t* sequence_number);
+  // Run the copies on the calling thread and up to max_background_copies - 1
+  // dedicated threads, re-reading every copied file to compare its checksum
+  // if verify_checksum is set
+  Status CopyFiles(const std::vector<CopyJob>& jobs, int max_background_copies,
+                   bool verify_checksum, const DBOptions& db_options);
   void CleanStagingDirectory(const std::string& path, Logger* info_log);
   DB* db_;
 };
@@ -13,7 +13,9 @@
 #ifndef OS_WIN
 #include <unistd.h>
 #endif
+#include <algorithm>
 #include <iostream>
+#include <set>
 #include <thread>
 #include <utility>
 #include "db/db_impl.h"
@@ -24,6 +26,8 @@
 #include "rocksdb/utilities/checkpoint.h"
 #include "rocksdb/utilities/transaction_db.h"
 #include "util/fault_injection_test_env.h"
+#include "util/filename.h"
+#include "util/string_util.h"
 #include "util/sync_point.h"
 #include "util/testharness.h"
 
@@ -685,6 +689,104 @@ TEST_F(CheckpointTest, CheckpointReadOnlyDBWithMultipleColumnFamilies) {
   delete snapshot_db;
 }
 
+namespace {
+// Hard links out of the DB directory fail, as if the checkpoints were on
+// another device, so that SST files are copied unless the base has them
+class NoLinkFromDBEnv : public EnvWrapper {
+ public:
+  NoLinkFromDBEnv(Env* base, const std::string& dbname)
+      : EnvWrapper(base), dbname_(dbname) {}
+
+  Status LinkFile(const std::string& src, const std::string& target) override {
+    if (src.compare(0, dbname_.size(), dbname_) == 0) {
+      return Status::NotSupported("cross device link");
+    }
+    return EnvWrapper::LinkFile(src, target);
+  }
+
+ private:
+  std::string dbname_;
+};
+}  // namespace
+
+TEST_F(CheckpointTest, IncrementalCheckpoint) {
+  NoLinkFromDBEnv env(env_, dbname_);
+  Options options = CurrentOptions();
+  options.env = &env;
+  Reopen(options);
+  std::string inc_name = snapshot_name_ + "_inc";
+  ASSERT_OK(DestroyDB(inc_name, options));
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put("a" + ToString(i), "v1_" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+  Checkpoint* checkpoint = nullptr;
+  ASSERT_OK(Checkpoint::Create(db_, &checkpoint));
+  ASSERT_OK(checkpoint->CreateCheckpoint(snapshot_name_));
+  std::vector<std::string> base_children;
+  ASSERT_OK(env_->GetChildren(snapshot_name_, &base_children));
+  std::set<std::string> base_files(base_children.begin(), base_children.end());
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put("b" + ToString(i), "v2_" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("a0", "v3"));
+  ASSERT_NOK(checkpoint->CreateIncrementalCheckpoint(dbname_ + "_no_base",
+                                                     inc_name));
+  ASSERT_OK(checkpoint->CreateIncrementalCheckpoint(
+      snapshot_name_, inc_name, 0 /* log_size_for_flush */,
+      4 /* max_background_copies */, true /* verify_checksum */));
+  delete checkpoint;
+
+  // Only the SST files flushed since the base are new
+  std::string delta;
+  ASSERT_OK(ReadFileToString(env_, inc_name + "/CHECKPOINT_DELTA", &delta));
+  size_t num_new = 0;
+  bool has_manifest = false;
+  std::vector<std::string> inc_children;
+  ASSERT_OK(env_->GetChildren(inc_name, &inc_children));
+  for (auto& line : StringSplit(delta, '\n')) {
+    ASSERT_NE('-', line[0]);
+    if (line[0] == '+') {
+      std::string fname = line.substr(2, line.find(' ', 2) - 2);
+      ASSERT_EQ(0, base_files.count(fname));
+      ASSERT_NE(inc_children.end(), std::find(inc_children.begin(),
+                                              inc_children.end(), fname));
+      ++num_new;
+    } else if (line.compare(0, 9, "manifest ") == 0) {
+      has_manifest = true;
+    }
+  }
+  ASSERT_GE(num_new, 1);
+  ASSERT_TRUE(has_manifest);
+  for (auto& fname : base_children) {
+    uint64_t number;
+    FileType type;
+    if (ParseFileName(fname, &number, &type) && type == kTableFile) {
+      ASSERT_NE(inc_children.end(), std::find(inc_children.begin(),
+                                              inc_children.end(), fname));
+    }
+  }
+
+  DB* snapshot_db = nullptr;
+  options.create_if_missing = false;
+  ASSERT_OK(DB::Open(options, inc_name, &snapshot_db));
+  std::string result;
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(snapshot_db->Get(ReadOptions(), "b" + ToString(i), &result));
+    ASSERT_EQ("v2_" + ToString(i), result);
+  }
+  ASSERT_OK(snapshot_db->Get(ReadOptions(), "a0", &result));
+  ASSERT_EQ("v3", result);
+  ASSERT_OK(snapshot_db->Get(ReadOptions(), "a1", &result));
+  ASSERT_EQ("v1_1", result);
+  delete snapshot_db;
+  Close();
+  ASSERT_OK(DestroyDB(inc_name, options));
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -102,6 +102,22 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
       const std::vector<Slice>& keys,
       std::vector<std::string>* values) override;
 
+  // Visibility is decided by Get(), which copies the value
+  using DB::GetPinned;
+  virtual Status GetPinned(const ReadOptions& options,
+                           ColumnFamilyHandle* column_family, const Slice& key,
+                           LazyBuffer* value) override {
+    return Get(options, column_family, key, value);
+  }
+  using DB::MultiGetPinned;
+  virtual std::vector<Status> MultiGetPinned(
+      const ReadOptions& options,
+      const std::vector<ColumnFamilyHandle*>& column_family,
+      const std::vector<Slice>& keys,
+      std::vector<LazyBuffer>* values) override {
+    return DB::MultiGetPinned(options, column_family, keys, values);
+  }
+
   using DB::NewIterator;
   virtual Iterator* NewIterator(const ReadOptions& options,
                                 ColumnFamilyHandle* column_family) override;
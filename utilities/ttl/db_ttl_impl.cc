@@ -17,13 +17,25 @@ namespace rocksdb {
 
 void DBWithTTLImpl::SanitizeOptions(int32_t ttl, ColumnFamilyOptions* options,
                                     Env* env) {
+  // Without a value meta extractor of the user, the timestamps of separated
+  // values are kept in their value meta
+  bool ts_in_value_meta = false;
+  if (!options->value_meta_extractor_factory) {
+    options->value_meta_extractor_factory =
+        std::make_shared<TtlValueMetaExtractorFactory>();
+    ts_in_value_meta = true;
+  } else if (Slice(options->value_meta_extractor_factory->Name()) ==
+             TtlValueMetaExtractorFactory::kClassName()) {
+    ts_in_value_meta = true;
+  }
+
   if (options->compaction_filter) {
-    options->compaction_filter =
-        new TtlCompactionFilter(ttl, env, options->compaction_filter);
+    options->compaction_filter = new TtlCompactionFilter(
+        ttl, env, ts_in_value_meta, options->compaction_filter);
   } else {
     options->compaction_filter_factory =
         std::shared_ptr<CompactionFilterFactory>(new TtlCompactionFilterFactory(
-            ttl, env, options->compaction_filter_factory));
+            ttl, env, ts_in_value_meta, options->compaction_filter_factory));
   }
 
   if (options->merge_operator) {
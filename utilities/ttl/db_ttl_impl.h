@@ -15,6 +15,7 @@
 #include "rocksdb/merge_operator.h"
 #include "rocksdb/utilities/utility_db.h"
 #include "rocksdb/utilities/db_ttl.h"
+#include "rocksdb/value_extractor.h"
 #include "db/db_impl.h"
 
 #ifdef _WIN32
@@ -60,6 +61,22 @@ class DBWithTTLImpl : public DBWithTTL {
       const std::vector<Slice>& keys,
       std::vector<std::string>* values) override;
 
+  // Stored values carry the timestamp suffix, strip it through Get()
+  using StackableDB::GetPinned;
+  virtual Status GetPinned(const ReadOptions& options,
+                           ColumnFamilyHandle* column_family, const Slice& key,
+                           LazyBuffer* value) override {
+    return Get(options, column_family, key, value);
+  }
+  using StackableDB::MultiGetPinned;
+  virtual std::vector<Status> MultiGetPinned(
+      const ReadOptions& options,
+      const std::vector<ColumnFamilyHandle*>& column_family,
+      const std::vector<Slice>& keys,
+      std::vector<LazyBuffer>* values) override {
+    return DB::MultiGetPinned(options, column_family, keys, values);
+  }
+
   using StackableDB::KeyMayExist;
   virtual bool KeyMayExist(const ReadOptions& options,
                            ColumnFamilyHandle* column_family, const Slice& key,
@@ -142,14 +159,46 @@ class TtlIterator : public Iterator {
   Iterator* iter_;
 };
 
+// The value meta of a separated value is its timestamp, so that expired
+// values are dropped by compactions without reading them
+class TtlValueMetaExtractor : public ValueExtractor {
+ public:
+  virtual Status Extract(const Slice& /*key*/, const Slice& value,
+                         std::string* output) const override {
+    if (value.size() < DBWithTTLImpl::kTSLength) {
+      output->clear();
+    } else {
+      output->assign(value.data() + value.size() - DBWithTTLImpl::kTSLength,
+                     DBWithTTLImpl::kTSLength);
+    }
+    return Status::OK();
+  }
+};
+
+class TtlValueMetaExtractorFactory : public ValueExtractorFactory {
+ public:
+  virtual std::unique_ptr<ValueExtractor> CreateValueExtractor(
+      const Context& /*context*/) const override {
+    return std::unique_ptr<ValueExtractor>(new TtlValueMetaExtractor());
+  }
+
+  static const char* kClassName() { return "TtlValueMetaExtractorFactory"; }
+
+  virtual const char* Name() const override { return kClassName(); }
+};
+
 class TtlCompactionFilter : public CompactionFilter {
  public:
+  // If ts_in_value_meta, the value meta of the separated values is extracted
+  // by TtlValueMetaExtractor
   TtlCompactionFilter(
-      int32_t ttl, Env* env, const CompactionFilter* user_comp_filter,
+      int32_t ttl, Env* env, bool ts_in_value_meta,
+      const CompactionFilter* user_comp_filter,
       std::unique_ptr<const CompactionFilter> user_comp_filter_from_factory =
           nullptr)
       : ttl_(ttl),
         env_(env),
+        ts_in_value_meta_(ts_in_value_meta),
         user_comp_filter_(user_comp_filter),
         user_comp_filter_from_factory_(
             std::move(user_comp_filter_from_factory)) {
@@ -184,11 +233,32 @@ class TtlCompactionFilter : public CompactionFilter {
     return false;
   }
 
+  virtual Decision FilterValueMeta(int level, const Slice& key,
+                                   const Slice& value_meta,
+                                   std::string* skip_until) const override {
+    // Values separated before the timestamp went to the value meta, or
+    // written without a timestamp, are checked by Filter()
+    if (!ts_in_value_meta_ ||
+        value_meta.size() != DBWithTTLImpl::kTSLength ||
+        !DBWithTTLImpl::SanityCheckTimestamp(value_meta).ok()) {
+      return Decision::kUndetermined;
+    }
+    if (DBWithTTLImpl::IsStale(value_meta, ttl_, env_)) {
+      return Decision::kRemove;
+    }
+    if (user_comp_filter_ == nullptr) {
+      return Decision::kKeep;
+    }
+    // The user has no value meta of its own
+    return user_comp_filter_->FilterValueMeta(level, key, Slice(), skip_until);
+  }
+
   virtual const char* Name() const override { return "Delete By TTL"; }
 
  private:
   int32_t ttl_;
   Env* env_;
+  bool ts_in_value_meta_;
   const CompactionFilter* user_comp_filter_;
   std::unique_ptr<const CompactionFilter> user_comp_filter_from_factory_;
 };
@@ -196,9 +266,12 @@ class TtlCompactionFilter : public CompactionFilter {
 class TtlCompactionFilterFactory : public CompactionFilterFactory {
  public:
   TtlCompactionFilterFactory(
-      int32_t ttl, Env* env,
+      int32_t ttl, Env* env, bool ts_in_value_meta,
       std::shared_ptr<CompactionFilterFactory> comp_filter_factory)
-      : ttl_(ttl), env_(env), user_comp_filter_factory_(comp_filter_factory) {}
+      : ttl_(ttl),
+        env_(env),
+        ts_in_value_meta_(ts_in_value_meta),
+        user_comp_filter_factory_(comp_filter_factory) {}
 
   virtual std::unique_ptr<CompactionFilter> CreateCompactionFilter(
       const CompactionFilter::Context& context) override {
@@ -209,8 +282,9 @@ class TtlCompactionFilterFactory : public CompactionFilterFactory {
           user_comp_filter_factory_->CreateCompactionFilter(context);
     }
 
-    return std::unique_ptr<TtlCompactionFilter>(new TtlCompactionFilter(
-        ttl_, env_, nullptr, std::move(user_comp_filter_from_factory)));
+    return std::unique_ptr<TtlCompactionFilter>(
+        new TtlCompactionFilter(ttl_, env_, ts_in_value_meta_, nullptr,
+                                std::move(user_comp_filter_from_factory)));
   }
 
   void SetTtl(int32_t ttl) {
@@ -224,6 +298,7 @@ class TtlCompactionFilterFactory : public CompactionFilterFactory {
  private:
   int32_t ttl_;
   Env* env_;
+  bool ts_in_value_meta_;
   std::shared_ptr<CompactionFilterFactory> user_comp_filter_factory_;
 };
 
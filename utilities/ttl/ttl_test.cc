@@ -10,6 +10,7 @@
 #include "rocksdb/utilities/db_ttl.h"
 #include "util/string_util.h"
 #include "util/testharness.h"
+#include "utilities/ttl/db_ttl_impl.h"
 #ifndef OS_WIN
 #include <unistd.h>
 #endif
@@ -285,6 +286,12 @@ class TtlTest : public testing::Test {
     delete dbiter;
   }
 
+  // Separate every value from its key
+  void SeparateValues() {
+    options_.blob_size = 0;
+    options_.blob_large_key_ratio = 100;
+  }
+
   // Set ttl on open db
   void SetTtl(int32_t ttl, ColumnFamilyHandle* cf = nullptr) {
     ASSERT_TRUE(db_ttl_);
@@ -553,6 +560,51 @@ TEST_F(TtlTest, CompactionFilter) {
   CloseTtl();
 }
 
+// Same as CompactionFilter, with the values separated from the keys
+TEST_F(TtlTest, CompactionFilterSeparatedValues) {
+  SeparateValues();
+  MakeKVMap(kSampleSize_);
+
+  OpenTtlWithTestCompaction(1);
+  PutValues(0, kSampleSize_);                  // T=0:Insert Set1. Delete at t=1
+  // T=2: Dropped by the timestamps in the value meta
+  SleepCompactCheck(2, 0, kSampleSize_, false);
+  CloseTtl();
+
+  OpenTtlWithTestCompaction(3);
+  PutValues(0, kSampleSize_);                   // T=0:Insert Set1.
+  int64_t partition = kSampleSize_ / 3;
+  SleepCompactCheck(1, 0, partition, false);                  // Part dropped
+  SleepCompactCheck(0, partition, partition);                 // Part kept
+  SleepCompactCheck(0, 2 * partition, partition, true, true); // Part changed
+  CloseTtl();
+}
+
+// Expiration is decided by the value meta, without reading the value
+TEST_F(TtlTest, FilterValueMeta) {
+  std::string value;
+  ASSERT_OK(DBWithTTLImpl::AppendTS("value", &value, env_.get()));
+  std::string value_meta;
+  ASSERT_OK(TtlValueMetaExtractor().Extract("key", value, &value_meta));
+  ASSERT_EQ(size_t{DBWithTTLImpl::kTSLength}, value_meta.size());
+
+  TtlCompactionFilter filter(1, env_.get(), true /* ts_in_value_meta */,
+                             nullptr);
+  ASSERT_TRUE(filter.FilterValueMeta(0, "key", value_meta, nullptr) ==
+              CompactionFilter::Decision::kKeep);
+  env_->Sleep(2);
+  ASSERT_TRUE(filter.FilterValueMeta(0, "key", value_meta, nullptr) ==
+              CompactionFilter::Decision::kRemove);
+  // Separated before the timestamps went to the value meta
+  ASSERT_TRUE(filter.FilterValueMeta(0, "key", "", nullptr) ==
+              CompactionFilter::Decision::kUndetermined);
+
+  TtlCompactionFilter user_value_meta_filter(1, env_.get(), false, nullptr);
+  ASSERT_TRUE(user_value_meta_filter.FilterValueMeta(0, "key", value_meta,
+                                                     nullptr) ==
+              CompactionFilter::Decision::kUndetermined);
+}
+
 // Insert some key-values which KeyMayExist should be able to get and check that
 // values returned are fine
 TEST_F(TtlTest, KeyMayExist) {